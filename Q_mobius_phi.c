@@ -0,0 +1,705 @@
+/********************
+ * Q_mobius_phi.c
+ *
+ * PURPOSE:
+ * - domain wall operator on fields in the s-innermost
+ *   layout (_GSI5) in a single sweep over the 4d sites;
+ *   each link is loaded once per site and direction and
+ *   applied to all L5 spinors of the neighbour
+ * - Moebius generalization with parameters g_b5, g_c5:
+ *     D = H B + Dd,
+ *     B  = b5 + c5 P,
+ *     Dd = ((4-M5) b5 + 1) + ((4-M5) c5 - 1) P,
+ *   H is the 4d hopping term of Q_DW_Wilson_4d_phi,
+ *   P the hopping in the fifth dimension with factor -m0
+ *   across the boundary (-P is Q_DW_Wilson_5th_phi) and
+ *   4 - M5 = 1/(2 kappa5d) - 1;
+ *   b5 = 1, c5 = 0 gives Q_DW_Wilson_phi
+ * - P, B and Dd act on the upper (P_R) and lower (P_L)
+ *   spin components separately and are real L5 x L5
+ *   matrices for each chirality
+ * - even/odd preconditioning in 4d, Schur complement on
+ *   the odd sites
+ *     Mhat = Dd - H_oe K H_eo B,   K = B Dd^{-1}
+ * - init_Q_DW_Mobius must be called again whenever
+ *   g_b5, g_c5, g_kappa5d or g_m0 change; with unchanged
+ *   parameters it returns at once, so the drivers set up
+ *   the tables once per run and free them at the end
+ ********************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+#include "cvc_complex.h"
+#include "global.h"
+#include "cvc_linalg.h"
+#include "cvc_geometry.h"
+#include "cvc_utils.h"
+#include "Q_mobius_phi.h"
+#include "Q_phi_projectors.h"
+
+/* operator in the fifth dimension, acting on the L5 spinors of a site;
+ * mat != NULL: a mat, with mat the L5 x L5 matrices for upper and lower
+ *              spin components, (mat psi)_s = sum_t mat[(c*L5+s)*L5+t] psi_t
+ * mat == NULL: a + b P (dag = 0) or a + b P^+ (dag = 1) */
+typedef struct {
+  const double *mat;
+  double a, b;
+  int dag;
+} s5_operator;
+
+static int mobius_initialized = 0;
+static int s5_shift[2];
+static double mobius_diag = 0., mobius_offdiag = 0.;
+static double *mat_ddinv = NULL, *mat_k = NULL, *mat_kdag = NULL;
+static double *mobius_aux = NULL, *mobius_aux_eo = NULL;
+static double mobius_param[4];
+/* per-thread work space of hopping_sinner, 3*24*L5 doubles per thread */
+static double *hopping_work = NULL;
+static int hopping_work_threads = 0, hopping_work_l5 = 0;
+#ifdef MPI
+static MPI_Datatype spinor5_point, spinor5_time_slice_cont;
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
+static MPI_Datatype spinor5_x_subslice_cont, spinor5_x_slice_vector, spinor5_x_slice_cont;
+#  endif
+#  if defined PARALLELTXY || defined PARALLELTXYZ
+static MPI_Datatype spinor5_y_slice_vector, spinor5_y_slice_cont;
+#  endif
+#  if defined PARALLELTXYZ
+static MPI_Datatype spinor5_z_slice_vector, spinor5_z_slice_cont;
+#  endif
+#endif
+
+/********************
+ * out = op in for the L5 spinors of one site, out != in
+ ********************/
+static void s5_apply(double *out, const double *in, const s5_operator *op) {
+  int s, t, c, k;
+  double w;
+  double *out_;
+  const double *in_, *m_;
+
+  if(op->mat != NULL) {
+    for(s=0; s<L5; s++) {
+    for(c=0; c<2; c++) {
+      out_ = out + 24*s + 12*c;
+      m_ = op->mat + (c*L5 + s)*L5;
+      for(k=0; k<12; k++) out_[k] = 0.;
+      for(t=0; t<L5; t++) {
+        w = op->a * m_[t];
+        if(w == 0.) continue;
+        in_ = in + 24*t + 12*c;
+        for(k=0; k<12; k++) out_[k] += w * in_[k];
+      }
+    }}
+  } else {
+    for(s=0; s<L5; s++) {
+    for(c=0; c<2; c++) {
+      out_ = out + 24*s + 12*c;
+      t = op->dag ? s - s5_shift[c] : s + s5_shift[c];
+      w = op->b;
+      if(t < 0) {
+        t += L5; w *= -g_m0;
+      } else if(t >= L5) {
+        t -= L5; w *= -g_m0;
+      }
+      in_ = in + 24*t + 12*c;
+      for(k=0; k<12; k++) out_[k] = op->a * in[24*s+12*c+k] + w * in_[k];
+    }}
+  }
+}
+
+/********************
+ * inverse of an n x n matrix by Gauss-Jordan elimination
+ * with partial pivoting; returns 1 if a is singular
+ ********************/
+static int invert_s5_matrix(double *ainv, const double *a, const int n) {
+  int i, j, k, ipiv;
+  double *w = (double*)malloc(2*n*n*sizeof(double));
+  double f, amax;
+
+  if(w == NULL) return(1);
+  for(i=0; i<n; i++) {
+    for(j=0; j<n; j++) {
+      w[i*2*n + j]   = a[i*n+j];
+      w[i*2*n + n+j] = i==j ? 1. : 0.;
+    }
+  }
+
+  for(k=0; k<n; k++) {
+    ipiv = k;
+    amax = fabs(w[k*2*n+k]);
+    for(i=k+1; i<n; i++) {
+      if(fabs(w[i*2*n+k]) > amax) { amax = fabs(w[i*2*n+k]); ipiv = i; }
+    }
+    if(amax == 0.) {
+      free(w);
+      return(1);
+    }
+    if(ipiv != k) {
+      for(j=0; j<2*n; j++) {
+        f = w[k*2*n+j]; w[k*2*n+j] = w[ipiv*2*n+j]; w[ipiv*2*n+j] = f;
+      }
+    }
+    f = 1. / w[k*2*n+k];
+    for(j=0; j<2*n; j++) w[k*2*n+j] *= f;
+    for(i=0; i<n; i++) {
+      if(i == k) continue;
+      f = w[i*2*n+k];
+      if(f == 0.) continue;
+      for(j=0; j<2*n; j++) w[i*2*n+j] -= f * w[k*2*n+j];
+    }
+  }
+
+  for(i=0; i<n; i++) {
+    for(j=0; j<n; j++) ainv[i*n+j] = w[i*2*n + n+j];
+  }
+  free(w);
+  return(0);
+}
+
+/********************
+ * hopping term in the s-inner layout
+ *
+ * for the sites g_eo2lexic[ieo*VOLUME/2 + i] (ieo = 0, 1)
+ * or all sites (ieo = -1), with output index i:
+ *   xi_i = op_a H pre phi + op_c chi_i
+ * - dag = 1 uses H^+ = gamma_5 H gamma_5
+ * - pre, op_a, op_c may be NULL (identity, identity, zero)
+ * - phi must have been exchanged
+ * - xi may be identical to chi
+ ********************/
+static void hopping_sinner(double *xi, double *phi, double *chi, const int ieo, const int dag,
+    const s5_operator *pre, const s5_operator *op_a, const s5_operator *op_c) {
+
+  const int N = ieo < 0 ? VOLUME : VOLUME / 2;
+  const int offset = ieo < 0 ? 0 : ieo * (VOLUME / 2);
+  const int VOL3 = LX*LY*LZ;
+  const int L5_24 = 24*L5;
+#if (defined HAVE_QUDA) && ( (defined PARALLELTX) || (defined PARALLELTXY) )
+  const int tproc_dir = 3;
+#else
+  const int tproc_dir = 0;
+#endif
+  const double psign = ( g_proc_coords[tproc_dir] == g_nproc_t-1 ) ? -1. : 1.;
+  const double nsign = ( g_proc_coords[tproc_dir] == 0           ) ? -1. : 1.;
+#ifdef OPENMP
+  const int nthreads = omp_get_max_threads();
+#else
+  const int nthreads = 1;
+#endif
+
+  /* the work space is only reallocated if the number of threads grew */
+  if(nthreads > hopping_work_threads || L5 != hopping_work_l5) {
+    free(hopping_work);
+    hopping_work = (double*)malloc((size_t)nthreads*3*L5_24*sizeof(double));
+    if(hopping_work == NULL) {
+      fprintf(stderr, "[hopping_sinner] Error, could not allocate work space\n");
+      EXIT(1);
+    }
+    hopping_work_threads = nthreads;
+    hopping_work_l5 = L5;
+  }
+
+#ifdef OPENMP
+#pragma omp parallel
+#endif
+{
+  int i, k, c, ix, iy, it, mu, dir, is, ii, jj, hs;
+  int q0, q1;
+  double sg, f0, f1, tsign, ur, ui;
+  double U_[18], h[12], v[12];
+  double *acc, *nb, *res, *a_;
+  const double *p_, *q_;
+
+#ifdef OPENMP
+  acc = hopping_work + (size_t)omp_get_thread_num()*3*L5_24;
+#else
+  acc = hopping_work;
+#endif
+  nb  = acc + L5_24;
+  res = nb  + L5_24;
+
+#ifdef OPENMP
+#pragma omp for
+#endif
+  for(i=0; i<N; i++) {
+    ix = ieo < 0 ? i : g_eo2lexic[offset + i];
+    it = ix / VOL3;
+
+    memset(acc, 0, L5_24*sizeof(double));
+
+    for(mu=0; mu<4; mu++) {
+    for(dir=0; dir<2; dir++) {
+      /* dir = 0: (1 - gamma_mu) U_mu(x) phi(x+mu),
+       * dir = 1: (1 + gamma_mu) U_mu(x-mu)^+ phi(x-mu),
+       * opposite projectors for dag = 1 */
+      if(dir == 0) {
+        iy = g_iup[ix][mu];
+        memcpy(U_, g_gauge_field + _GGI(ix, mu), 18*sizeof(double));
+        tsign = (mu == 0 && it == T-1) ? psign : 1.;
+      } else {
+        iy = g_idn[ix][mu];
+        memcpy(U_, g_gauge_field + _GGI(iy, mu), 18*sizeof(double));
+        tsign = (mu == 0 && it == 0) ? nsign : 1.;
+      }
+      if(tsign != 1.) {
+        for(k=0; k<18; k++) U_[k] *= tsign;
+      }
+
+      if(pre != NULL) {
+        s5_apply(nb, phi + _GSI5(iy,0), pre);
+        p_ = nb;
+      } else {
+        p_ = phi + _GSI5(iy,0);
+      }
+
+      sg = dag ? (double)(1 - 2*dir) : (double)(2*dir - 1);
+      f0 = sg * proj_sign[mu][0];
+      f1 = sg * proj_sign[mu][1];
+      q0 = 6*proj_spin[mu][0];
+      q1 = 6*proj_spin[mu][1];
+
+      for(is=0; is<L5; is++) {
+        q_ = p_ + 24*is;
+
+        /* half spinor h_a = phi_a + f_a phi_{q_a} */
+        for(c=0; c<3; c++) {
+          if(proj_imag[mu]) {
+            h[  2*c  ] = q_[  2*c  ] - f0 * q_[q0+2*c+1];
+            h[  2*c+1] = q_[  2*c+1] + f0 * q_[q0+2*c  ];
+            h[6+2*c  ] = q_[6+2*c  ] - f1 * q_[q1+2*c+1];
+            h[6+2*c+1] = q_[6+2*c+1] + f1 * q_[q1+2*c  ];
+          } else {
+            h[  2*c  ] = q_[  2*c  ] + f0 * q_[q0+2*c  ];
+            h[  2*c+1] = q_[  2*c+1] + f0 * q_[q0+2*c+1];
+            h[6+2*c  ] = q_[6+2*c  ] + f1 * q_[q1+2*c  ];
+            h[6+2*c+1] = q_[6+2*c+1] + f1 * q_[q1+2*c+1];
+          }
+        }
+
+        /* v = U h (dir = 0) or v = U^+ h (dir = 1) */
+        for(k=0; k<12; k++) v[k] = 0.;
+        for(ii=0; ii<3; ii++) {
+        for(jj=0; jj<3; jj++) {
+          ur = U_[2*(3*ii+jj)  ];
+          ui = U_[2*(3*ii+jj)+1];
+          for(hs=0; hs<2; hs++) {
+            if(dir == 0) {
+              v[6*hs+2*ii  ] += ur * h[6*hs+2*jj  ] - ui * h[6*hs+2*jj+1];
+              v[6*hs+2*ii+1] += ur * h[6*hs+2*jj+1] + ui * h[6*hs+2*jj  ];
+            } else {
+              v[6*hs+2*jj  ] += ur * h[6*hs+2*ii  ] + ui * h[6*hs+2*ii+1];
+              v[6*hs+2*jj+1] += ur * h[6*hs+2*ii+1] - ui * h[6*hs+2*ii  ];
+            }
+          }
+        }}
+
+        /* reconstruct: spin 0,1 = v_0,1; spin 2,3 = g_a v_{r_a} */
+        a_ = acc + 24*is;
+        for(k=0; k<12; k++) a_[k] += v[k];
+        for(c=0; c<3; c++) {
+          if(proj_imag[mu]) {
+            a_[12+2*c  ] -= sg * rec_sign[mu][0] * v[6*rec_spin[mu][0]+2*c+1];
+            a_[12+2*c+1] += sg * rec_sign[mu][0] * v[6*rec_spin[mu][0]+2*c  ];
+            a_[18+2*c  ] -= sg * rec_sign[mu][1] * v[6*rec_spin[mu][1]+2*c+1];
+            a_[18+2*c+1] += sg * rec_sign[mu][1] * v[6*rec_spin[mu][1]+2*c  ];
+          } else {
+            a_[12+2*c  ] += sg * rec_sign[mu][0] * v[6*rec_spin[mu][0]+2*c  ];
+            a_[12+2*c+1] += sg * rec_sign[mu][0] * v[6*rec_spin[mu][0]+2*c+1];
+            a_[18+2*c  ] += sg * rec_sign[mu][1] * v[6*rec_spin[mu][1]+2*c  ];
+            a_[18+2*c+1] += sg * rec_sign[mu][1] * v[6*rec_spin[mu][1]+2*c+1];
+          }
+        }
+      }  /* of is */
+    }}  /* of mu, dir */
+
+    /* multiplication with -1/2 */
+    for(k=0; k<L5_24; k++) acc[k] *= -0.5;
+
+    if(op_a != NULL) {
+      s5_apply(res, acc, op_a);
+    } else {
+      memcpy(res, acc, L5_24*sizeof(double));
+    }
+    if(op_c != NULL) {
+      s5_apply(nb, chi + (size_t)L5_24*i, op_c);
+      for(k=0; k<L5_24; k++) res[k] += nb[k];
+    }
+    memcpy(xi + (size_t)L5_24*i, res, L5_24*sizeof(double));
+  }  /* of i */
+
+}  /* end of parallel region */
+}  /* end of hopping_sinner */
+
+/********************
+ * copy between an even/odd half field and the sites of
+ * parity ieo of a full field in the s-inner layout
+ ********************/
+static void spinor_field_eo_to_sinner(double *s, double *t, const int ieo) {
+  const int N = VOLUME / 2;
+  const int offset = ieo * N;
+  const size_t bytes = 24*L5*sizeof(double);
+  int i;
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i=0; i<N; i++) {
+    memcpy(s + _GSI5(g_eo2lexic[offset+i],0), t + _GSI5(i,0), bytes);
+  }
+}
+
+static void spinor_field_sinner_to_eo(double *s, double *t, const int ieo) {
+  const int N = VOLUME / 2;
+  const int offset = ieo * N;
+  const size_t bytes = 24*L5*sizeof(double);
+  int i;
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i=0; i<N; i++) {
+    memcpy(s + _GSI5(i,0), t + _GSI5(g_eo2lexic[offset+i],0), bytes);
+  }
+}
+
+/********************
+ * conversion between the layout _G5DI (fifth dimension
+ * outermost) and the s-inner layout, s <- t
+ ********************/
+void spinor_field_5d_to_sinner(double *s, double *t) {
+  int ix, is;
+#ifdef OPENMP
+#pragma omp parallel for private(is)
+#endif
+  for(ix=0; ix<VOLUME; ix++) {
+    for(is=0; is<L5; is++) {
+      _fv_eq_fv(s + _GSI5(ix,is), t + _GSI(_G5DI(is,ix)));
+    }
+  }
+}
+
+void spinor_field_sinner_to_5d(double *s, double *t) {
+  int ix, is;
+#ifdef OPENMP
+#pragma omp parallel for private(is)
+#endif
+  for(ix=0; ix<VOLUME; ix++) {
+    for(is=0; is<L5; is++) {
+      _fv_eq_fv(s + _GSI(_G5DI(is,ix)), t + _GSI5(ix,is));
+    }
+  }
+}
+
+/********************
+ * boundary exchange for a field in the s-inner layout;
+ * same pattern as xchange_field with a site of 24*L5 reals
+ ********************/
+void xchange_field_sinner(double *phi) {
+#ifdef MPI
+  const size_t L5_24 = 24*L5;
+  int cntr=0;
+
+  MPI_Request request[16];
+  MPI_Status status[16];
+
+  MPI_Isend(&phi[0],                       1, spinor5_time_slice_cont, g_nb_t_dn, 183, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[L5_24*VOLUME],            1, spinor5_time_slice_cont, g_nb_t_up, 183, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&phi[L5_24*(T-1)*LX*LY*LZ],    1, spinor5_time_slice_cont, g_nb_t_up, 184, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[L5_24*(T+1)*LX*LY*LZ],    1, spinor5_time_slice_cont, g_nb_t_dn, 184, g_cart_grid, &request[cntr]);
+  cntr++;
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  MPI_Isend(&phi[0],                                  1, spinor5_x_slice_vector, g_nb_x_dn, 185, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[L5_24*(VOLUME+2*LX*LY*LZ)],          1, spinor5_x_slice_cont,   g_nb_x_up, 185, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&phi[L5_24*(LX-1)*LY*LZ],                 1, spinor5_x_slice_vector, g_nb_x_up, 186, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[L5_24*(VOLUME+2*LX*LY*LZ+T*LY*LZ)],  1, spinor5_x_slice_cont,   g_nb_x_dn, 186, g_cart_grid, &request[cntr]);
+  cntr++;
+#endif
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  MPI_Isend(&phi[0],                                            1, spinor5_y_slice_vector, g_nb_y_dn, 187, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[L5_24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ))],          1, spinor5_y_slice_cont,   g_nb_y_up, 187, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&phi[L5_24*(LY-1)*LZ],                              1, spinor5_y_slice_vector, g_nb_y_up, 188, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[L5_24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ)+T*LX*LZ)],  1, spinor5_y_slice_cont,   g_nb_y_dn, 188, g_cart_grid, &request[cntr]);
+  cntr++;
+#endif
+#if defined PARALLELTXYZ
+  MPI_Isend(&phi[0],                                                     1, spinor5_z_slice_vector, g_nb_z_dn, 189, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[L5_24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))],           1, spinor5_z_slice_cont,   g_nb_z_up, 189, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&phi[L5_24*(LZ-1)],                                          1, spinor5_z_slice_vector, g_nb_z_up, 190, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[L5_24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY)],   1, spinor5_z_slice_cont,   g_nb_z_dn, 190, g_cart_grid, &request[cntr]);
+  cntr++;
+#endif
+  MPI_Waitall(cntr, request, status);
+#endif
+}
+
+/********************
+ * set the L5 x L5 matrices from g_b5, g_c5, g_kappa5d, g_m0,
+ * allocate the auxiliary fields and the MPI data types
+ ********************/
+int init_Q_DW_Mobius(void) {
+#if !(defined RIGHTHANDED_BWD) && !(defined RIGHTHANDED_FWD)
+  if(g_cart_id==0) fprintf(stderr, "[init_Q_DW_Mobius] Error, chiral projectors undefined\n");
+  return(1);
+#else
+  int c, s, t;
+  const int n2 = L5*L5;
+  const double four_m_m5 = 0.5 / g_kappa5d - 1.;
+  double *mat_p = NULL, *mat_dd = NULL;
+
+  if(mobius_initialized) {
+    if(mobius_param[0] == g_b5 && mobius_param[1] == g_c5 && mobius_param[2] == g_kappa5d && mobius_param[3] == g_m0) return(0);
+    free_Q_DW_Mobius();
+  }
+
+  /* (P psi)_s = psi_{s + s5_shift[c]} for the upper (c = 0) and
+   * lower (c = 1) spin components, cf. Q_DW_Wilson_5th_phi */
+#if (defined RIGHTHANDED_FWD)
+  s5_shift[0] = -1;
+  s5_shift[1] = +1;
+#else
+  s5_shift[0] = +1;
+  s5_shift[1] = -1;
+#endif
+  mobius_diag    = four_m_m5 * g_b5 + 1.;
+  mobius_offdiag = four_m_m5 * g_c5 - 1.;
+
+  mat_p     = (double*)calloc(2*n2, sizeof(double));
+  mat_dd    = (double*)calloc(2*n2, sizeof(double));
+  mat_ddinv = (double*)calloc(2*n2, sizeof(double));
+  mat_k     = (double*)calloc(2*n2, sizeof(double));
+  mat_kdag  = (double*)calloc(2*n2, sizeof(double));
+  if(mat_p==NULL || mat_dd==NULL || mat_ddinv==NULL || mat_k==NULL || mat_kdag==NULL) {
+    if(g_cart_id==0) fprintf(stderr, "[init_Q_DW_Mobius] Error, could not allocate matrices\n");
+    return(2);
+  }
+
+  for(c=0; c<2; c++) {
+    for(s=0; s<L5; s++) {
+      t = s + s5_shift[c];
+      if(t < 0 || t >= L5) {
+        mat_p[c*n2 + s*L5 + (t+L5)%L5] = -g_m0;
+      } else {
+        mat_p[c*n2 + s*L5 + t] = 1.;
+      }
+    }
+    for(s=0; s<n2; s++) {
+      mat_dd[c*n2 + s] = mobius_offdiag * mat_p[c*n2 + s];
+    }
+    for(s=0; s<L5; s++) mat_dd[c*n2 + s*L5 + s] += mobius_diag;
+
+    if(invert_s5_matrix(mat_ddinv + c*n2, mat_dd + c*n2, L5) != 0) {
+      if(g_cart_id==0) fprintf(stderr, "[init_Q_DW_Mobius] Error, Dd is singular\n");
+      free(mat_p); free(mat_dd);
+      return(3);
+    }
+
+    /* K = B Dd^{-1} = b5 Dd^{-1} + c5 P Dd^{-1} */
+    for(s=0; s<L5; s++) {
+    for(t=0; t<L5; t++) {
+      int r;
+      double w = g_b5 * mat_ddinv[c*n2 + s*L5 + t];
+      for(r=0; r<L5; r++) w += g_c5 * mat_p[c*n2 + s*L5 + r] * mat_ddinv[c*n2 + r*L5 + t];
+      mat_k[c*n2 + s*L5 + t] = w;
+    }}
+    for(s=0; s<L5; s++) {
+    for(t=0; t<L5; t++) {
+      mat_kdag[c*n2 + s*L5 + t] = mat_k[c*n2 + t*L5 + s];
+    }}
+  }
+  free(mat_p);
+  free(mat_dd);
+
+  if( alloc_spinor_field(&mobius_aux, (VOLUME+RAND)*L5) != 0 || alloc_spinor_field(&mobius_aux_eo, VOLUME/2*L5) != 0 ) {
+    if(g_cart_id==0) fprintf(stderr, "[init_Q_DW_Mobius] Error, could not allocate auxiliary fields\n");
+    return(4);
+  }
+
+#ifdef MPI
+  MPI_Type_contiguous(24*L5, MPI_DOUBLE, &spinor5_point);
+  MPI_Type_commit(&spinor5_point);
+
+  MPI_Type_contiguous(LX*LY*LZ, spinor5_point, &spinor5_time_slice_cont);
+  MPI_Type_commit(&spinor5_time_slice_cont);
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
+  MPI_Type_contiguous(LY*LZ, spinor5_point, &spinor5_x_subslice_cont);
+  MPI_Type_commit(&spinor5_x_subslice_cont);
+
+  MPI_Type_vector(T, 1, LX, spinor5_x_subslice_cont, &spinor5_x_slice_vector);
+  MPI_Type_commit(&spinor5_x_slice_vector);
+
+  MPI_Type_contiguous(T*LY*LZ, spinor5_point, &spinor5_x_slice_cont);
+  MPI_Type_commit(&spinor5_x_slice_cont);
+#  endif
+#  if defined PARALLELTXY || defined PARALLELTXYZ
+  MPI_Type_vector(T*LX, LZ, LY*LZ, spinor5_point, &spinor5_y_slice_vector);
+  MPI_Type_commit(&spinor5_y_slice_vector);
+
+  MPI_Type_contiguous(T*LX*LZ, spinor5_point, &spinor5_y_slice_cont);
+  MPI_Type_commit(&spinor5_y_slice_cont);
+#  endif
+#  if defined PARALLELTXYZ
+  MPI_Type_vector(T*LX*LY, 1, LZ, spinor5_point, &spinor5_z_slice_vector);
+  MPI_Type_commit(&spinor5_z_slice_vector);
+
+  MPI_Type_contiguous(T*LX*LY, spinor5_point, &spinor5_z_slice_cont);
+  MPI_Type_commit(&spinor5_z_slice_cont);
+#  endif
+#endif
+
+  if(g_cart_id==0) {
+    fprintf(stdout, "# [init_Q_DW_Mobius] b5 = %e, c5 = %e, 4 - M5 = %e, m0 = %e, L5 = %d\n", g_b5, g_c5, four_m_m5, g_m0, L5);
+  }
+  mobius_param[0] = g_b5;
+  mobius_param[1] = g_c5;
+  mobius_param[2] = g_kappa5d;
+  mobius_param[3] = g_m0;
+  mobius_initialized = 1;
+  return(0);
+#endif
+}
+
+void free_Q_DW_Mobius(void) {
+  if(!mobius_initialized) return;
+  free(mat_ddinv); mat_ddinv = NULL;
+  free(mat_k);     mat_k     = NULL;
+  free(mat_kdag);  mat_kdag  = NULL;
+  free(mobius_aux);    mobius_aux    = NULL;
+  free(mobius_aux_eo); mobius_aux_eo = NULL;
+  free(hopping_work);  hopping_work  = NULL;
+  hopping_work_threads = 0;
+#ifdef MPI
+  MPI_Type_free(&spinor5_time_slice_cont);
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
+  MPI_Type_free(&spinor5_x_slice_cont);
+  MPI_Type_free(&spinor5_x_slice_vector);
+  MPI_Type_free(&spinor5_x_subslice_cont);
+#  endif
+#  if defined PARALLELTXY || defined PARALLELTXYZ
+  MPI_Type_free(&spinor5_y_slice_cont);
+  MPI_Type_free(&spinor5_y_slice_vector);
+#  endif
+#  if defined PARALLELTXYZ
+  MPI_Type_free(&spinor5_z_slice_cont);
+  MPI_Type_free(&spinor5_z_slice_vector);
+#  endif
+  MPI_Type_free(&spinor5_point);
+#endif
+  mobius_initialized = 0;
+}
+
+/********************
+ * xi = D phi, D^+ phi on full fields in the s-inner layout;
+ * phi must have been exchanged
+ ********************/
+void Q_DW_Mobius_phi(double *xi, double *phi) {
+  const s5_operator op_b  = { NULL, g_b5, g_c5, 0 };
+  const s5_operator op_dd = { NULL, mobius_diag, mobius_offdiag, 0 };
+
+  hopping_sinner(xi, phi, phi, -1, 0, (g_b5==1. && g_c5==0.) ? NULL : &op_b, NULL, &op_dd);
+}
+
+void Q_DW_Mobius_dag_phi(double *xi, double *phi) {
+  const s5_operator op_bdag  = { NULL, g_b5, g_c5, 1 };
+  const s5_operator op_dddag = { NULL, mobius_diag, mobius_offdiag, 1 };
+
+  hopping_sinner(xi, phi, phi, -1, 1, NULL, (g_b5==1. && g_c5==0.) ? NULL : &op_bdag, &op_dddag);
+}
+
+/********************
+ * xi = Mhat phi, Mhat^+ phi on odd half fields
+ *   Mhat   = Dd   - H_oe K H_eo B
+ *   Mhat^+ = Dd^+ - B^+ (H^+)_oe K^+ (H^+)_eo
+ * xi may be identical to phi
+ ********************/
+void Q_DW_Mobius_eo_phi(double *xi, double *phi) {
+  const s5_operator op_b   = { NULL, g_b5, g_c5, 0 };
+  const s5_operator op_k   = { mat_k, 1., 0., 0 };
+  const s5_operator op_m1  = { NULL, -1., 0., 0 };
+  const s5_operator op_dd  = { NULL, mobius_diag, mobius_offdiag, 0 };
+
+  spinor_field_eo_to_sinner(mobius_aux, phi, 1);
+  xchange_field_sinner(mobius_aux);
+  hopping_sinner(mobius_aux_eo, mobius_aux, NULL, 0, 0, (g_b5==1. && g_c5==0.) ? NULL : &op_b, &op_k, NULL);
+  spinor_field_eo_to_sinner(mobius_aux, mobius_aux_eo, 0);
+  xchange_field_sinner(mobius_aux);
+  hopping_sinner(xi, mobius_aux, phi, 1, 0, NULL, &op_m1, &op_dd);
+}
+
+void Q_DW_Mobius_eo_dag_phi(double *xi, double *phi) {
+  const s5_operator op_kdag   = { mat_kdag, 1., 0., 0 };
+  const s5_operator op_mbdag  = { NULL, -g_b5, -g_c5, 1 };
+  const s5_operator op_dddag  = { NULL, mobius_diag, mobius_offdiag, 1 };
+
+  spinor_field_eo_to_sinner(mobius_aux, phi, 1);
+  xchange_field_sinner(mobius_aux);
+  hopping_sinner(mobius_aux_eo, mobius_aux, NULL, 0, 1, NULL, &op_kdag, NULL);
+  spinor_field_eo_to_sinner(mobius_aux, mobius_aux_eo, 0);
+  xchange_field_sinner(mobius_aux);
+  hopping_sinner(xi, mobius_aux, phi, 1, 1, NULL, &op_mbdag, &op_dddag);
+}
+
+/********************
+ * source for the odd sites from a full field phi (s-inner,
+ * interior sites only)
+ *   r_e = Dd^{-1} phi_e,  b_o = phi_o - H_oe B r_e
+ * then Mhat x_o = b_o and x is obtained from
+ * Q_DW_Mobius_eo_reconstruct
+ ********************/
+void Q_DW_Mobius_eo_prepare(double *b_o, double *r_e, double *phi) {
+  const s5_operator op_b     = { NULL, g_b5, g_c5, 0 };
+  const s5_operator op_ddinv = { mat_ddinv, 1., 0., 0 };
+  const s5_operator op_m1    = { NULL, -1., 0., 0 };
+  const s5_operator op_id    = { NULL, 1., 0., 0 };
+  int i;
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i=0; i<VOLUME/2; i++) {
+    s5_apply(r_e + _GSI5(i,0), phi + _GSI5(g_eo2lexic[i],0), &op_ddinv);
+  }
+  spinor_field_eo_to_sinner(mobius_aux, r_e, 0);
+  xchange_field_sinner(mobius_aux);
+  spinor_field_sinner_to_eo(b_o, phi, 1);
+  hopping_sinner(b_o, mobius_aux, b_o, 1, 0, (g_b5==1. && g_c5==0.) ? NULL : &op_b, &op_m1, &op_id);
+}
+
+/********************
+ * full solution x (s-inner) from the odd solution x_o and
+ * r_e from Q_DW_Mobius_eo_prepare
+ *   x_e = r_e - Dd^{-1} H_eo B x_o
+ ********************/
+void Q_DW_Mobius_eo_reconstruct(double *x, double *x_o, double *r_e) {
+  const s5_operator op_b      = { NULL, g_b5, g_c5, 0 };
+  const s5_operator op_mddinv = { mat_ddinv, -1., 0., 0 };
+  const s5_operator op_id     = { NULL, 1., 0., 0 };
+
+  spinor_field_eo_to_sinner(x, x_o, 1);
+  xchange_field_sinner(x);
+  hopping_sinner(mobius_aux_eo, x, r_e, 0, 0, (g_b5==1. && g_c5==0.) ? NULL : &op_b, &op_mddinv, &op_id);
+  spinor_field_eo_to_sinner(x, mobius_aux_eo, 0);
+}
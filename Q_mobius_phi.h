@@ -0,0 +1,28 @@
+#ifndef _Q_MOBIUS_PHI_H
+#define _Q_MOBIUS_PHI_H
+
+/********************
+ * s-innermost layout of 5d spinor fields: the L5 spinors
+ * of a 4d site are stored contiguously, 4d sites (including
+ * the boundary) in the order of g_ipt,
+ *   component k of (is, ix) is at _GSI5(ix,is) + k
+ * even/odd half fields hold the sites g_eo2lexic[ieo*VOLUME/2 + i]
+ * at _GSI5(i,is)
+ ********************/
+#define _GSI5(_ix,_is) (24*((_ix)*L5+(_is)))
+
+int init_Q_DW_Mobius(void);
+void free_Q_DW_Mobius(void);
+
+void spinor_field_5d_to_sinner(double *s, double *t);
+void spinor_field_sinner_to_5d(double *s, double *t);
+void xchange_field_sinner(double *phi);
+
+void Q_DW_Mobius_phi(double *xi, double *phi);
+void Q_DW_Mobius_dag_phi(double *xi, double *phi);
+
+void Q_DW_Mobius_eo_phi(double *xi, double *phi);
+void Q_DW_Mobius_eo_dag_phi(double *xi, double *phi);
+void Q_DW_Mobius_eo_prepare(double *b_o, double *r_e, double *phi);
+void Q_DW_Mobius_eo_reconstruct(double *x, double *x_o, double *r_e);
+#endif
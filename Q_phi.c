@@ -344,6 +344,238 @@ void Q_phi_tbc(double *xi, double *phi) {
 }
 #endif  // of ifndef OPENMP
 
+/********************
+ Q_phi_tbc_block
+ - xi[k] = Q phi[k], k = 0, ..., nrhs-1, with Q as in Q_phi_tbc
+ - each gauge link is loaded and multiplied with the boundary
+   phase once per site and applied to all nrhs fields
+ - call xchange_field for all phi[k] in calling process
+*/
+void Q_phi_tbc_block(double **xi, double **phi, int nrhs) {
+  const double _1_2_kappa = 0.5 / g_kappa;
+  unsigned int index_s;
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(index_s = 0; index_s < VOLUME; index_s++) {
+    int mu, k;
+    unsigned int iix = _GSI(index_s), iup, idn;
+    double SU3_up[18], SU3_dn[18];
+    double spinor1[24], spinor2[24];
+    double *xi_, *phi_;
+
+    for(k=0; k<nrhs; k++) {
+      _fv_eq_zero(xi[k]+iix);
+    }
+
+    for(mu=0; mu<4; mu++) {
+      idn = g_idn[index_s][mu];
+      iup = g_iup[index_s][mu];
+      _cm_eq_cm_ti_co(SU3_dn, g_gauge_field+_GGI(idn, mu), &co_phase_up[mu]);
+      _cm_eq_cm_ti_co(SU3_up, g_gauge_field+_GGI(index_s, mu), &co_phase_up[mu]);
+
+      for(k=0; k<nrhs; k++) {
+        xi_ = xi[k] + iix;
+
+        /* negative mu-direction */
+        phi_ = phi[k] + _GSI(idn);
+        _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+        _fv_pl_eq_fv(spinor1, phi_);
+        _fv_eq_cm_dag_ti_fv(spinor2, SU3_dn, spinor1);
+        _fv_pl_eq_fv(xi_, spinor2);
+
+        /* positive mu-direction */
+        phi_ = phi[k] + _GSI(iup);
+        _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+        _fv_mi(spinor1);
+        _fv_pl_eq_fv(spinor1, phi_);
+        _fv_eq_cm_ti_fv(spinor2, SU3_up, spinor1);
+        _fv_pl_eq_fv(xi_, spinor2);
+      }
+    }
+
+    for(k=0; k<nrhs; k++) {
+      xi_  = xi[k]  + iix;
+      phi_ = phi[k] + iix;
+
+      /* multiplication with -1/2 */
+      _fv_ti_eq_re(xi_, -0.5);
+
+      /* diagonal elements */
+      _fv_eq_fv_ti_re(spinor1, phi_, _1_2_kappa);
+      _fv_pl_eq_fv(xi_, spinor1);
+
+      _fv_eq_gamma_ti_fv(spinor1, 5, phi_);
+      _fv_eq_fv_ti_im(spinor2, spinor1, g_mu);
+      _fv_pl_eq_fv(xi_, spinor2);
+    }
+  }
+}  /* end of Q_phi_tbc_block */
+
+/********************
+ site kernels for the operators with
+ communication / computation overlap
+ - xi(x) = (Q phi)(x) for one site x = index_s
+*/
+static void Q_phi_tbc_site(double *xi, double *phi, unsigned int index_s, double _1_2_kappa) {
+  int mu;
+  double SU3_1[18];
+  double spinor1[24], spinor2[24];
+  double *xi_, *phi_, *U_;
+
+  xi_ = xi + _GSI(index_s);
+
+  _fv_eq_zero(xi_);
+
+  for(mu=0; mu<4; mu++) {
+    /* negative mu-direction */
+    phi_ = phi + _GSI(g_idn[index_s][mu]);
+
+    _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+    _fv_pl_eq_fv(spinor1, phi_);
+
+    U_ = g_gauge_field + _GGI(g_idn[index_s][mu], mu);
+
+    _cm_eq_cm_ti_co(SU3_1, U_, &co_phase_up[mu]);
+    _fv_eq_cm_dag_ti_fv(spinor2, SU3_1, spinor1);
+    _fv_pl_eq_fv(xi_, spinor2);
+
+    /* positive mu-direction */
+    phi_ = phi + _GSI(g_iup[index_s][mu]);
+
+    _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+    _fv_mi(spinor1);
+    _fv_pl_eq_fv(spinor1, phi_);
+
+    U_ = g_gauge_field + _GGI(index_s, mu);
+
+    _cm_eq_cm_ti_co(SU3_1, U_, &co_phase_up[mu]);
+    _fv_eq_cm_ti_fv(spinor2, SU3_1, spinor1);
+    _fv_pl_eq_fv(xi_, spinor2);
+  }
+
+  /* multiplication with -1/2 */
+  _fv_ti_eq_re(xi_, -0.5);
+
+  /* diagonal elements */
+  phi_ = phi + _GSI(index_s);
+
+  _fv_eq_fv_ti_re(spinor1, phi_, _1_2_kappa);
+  _fv_pl_eq_fv(xi_, spinor1);
+
+  _fv_eq_gamma_ti_fv(spinor1, 5, phi_);
+  _fv_eq_fv_ti_im(spinor2, spinor1, g_mu);
+  _fv_pl_eq_fv(xi_, spinor2);
+}
+
+static void Q_Wilson_phi_site(double *xi, double *phi, unsigned int index_s, double _1_2_kappa) {
+  int mu, it;
+  double SU3_1[18];
+  double spinor1[24], spinor2[24];
+  double *xi_, *phi_, *U_;
+  double phase_neg, phase_pos;
+
+  it = index_s / (LX*LY*LZ);
+  phase_neg = it==0 && g_proc_coords[0]==0  ? -1. : +1.;
+  phase_pos = it==T-1 && g_proc_coords[0]==g_nproc_t-1 ? -1. : +1.;
+
+  xi_ = xi + _GSI(index_s);
+
+  _fv_eq_zero(xi_);
+
+  for(mu=0; mu<4; mu++) {
+    /* negative mu-direction */
+    phi_ = phi + _GSI(g_idn[index_s][mu]);
+
+    _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+    _fv_pl_eq_fv(spinor1, phi_);
+
+    U_ = g_gauge_field + _GGI(g_idn[index_s][mu], mu);
+
+    _cm_eq_cm_ti_re(SU3_1, U_, (mu==0 ? phase_neg : 1.));
+    _fv_eq_cm_dag_ti_fv(spinor2, SU3_1, spinor1);
+    _fv_pl_eq_fv(xi_, spinor2);
+
+    /* positive mu-direction */
+    phi_ = phi + _GSI(g_iup[index_s][mu]);
+
+    _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+    _fv_mi(spinor1);
+    _fv_pl_eq_fv(spinor1, phi_);
+
+    U_ = g_gauge_field + _GGI(index_s, mu);
+
+    _cm_eq_cm_ti_re(SU3_1, U_, (mu==0 ? phase_pos : 1.));
+    _fv_eq_cm_ti_fv(spinor2, SU3_1, spinor1);
+    _fv_pl_eq_fv(xi_, spinor2);
+  }
+
+  /* multiplication with -1/2 */
+  _fv_ti_eq_re(xi_, -0.5);
+
+  /* diagonal elements */
+  phi_ = phi + _GSI(index_s);
+
+  _fv_eq_fv_ti_re(spinor1, phi_, _1_2_kappa);
+  _fv_pl_eq_fv(xi_, spinor1);
+}
+
+/********************
+ Q_phi_tbc_overlap, Q_Wilson_phi_overlap
+ - same as Q_phi_tbc and Q_Wilson_phi, but do the
+   exchange of phi themselves
+ - the boundary of phi is sent with xchange_field_start,
+   the interior sites (g_interior2lexic) are computed while
+   the messages are in flight, the boundary sites
+   (g_boundary2lexic) after xchange_field_wait
+*/
+void Q_phi_tbc_overlap(double *xi, double *phi) {
+  const double _1_2_kappa = 0.5 / g_kappa;
+  int i;
+
+  xchange_field_start(phi);
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < g_interior_volume; i++) {
+    Q_phi_tbc_site(xi, phi, g_interior2lexic[i], _1_2_kappa);
+  }
+
+  xchange_field_wait();
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < g_boundary_volume; i++) {
+    Q_phi_tbc_site(xi, phi, g_boundary2lexic[i], _1_2_kappa);
+  }
+}  /* end of Q_phi_tbc_overlap */
+
+void Q_Wilson_phi_overlap(double *xi, double *phi) {
+  const double _1_2_kappa = 0.5 / g_kappa;
+  int i;
+
+  xchange_field_start(phi);
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < g_interior_volume; i++) {
+    Q_Wilson_phi_site(xi, phi, g_interior2lexic[i], _1_2_kappa);
+  }
+
+  xchange_field_wait();
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < g_boundary_volume; i++) {
+    Q_Wilson_phi_site(xi, phi, g_boundary2lexic[i], _1_2_kappa);
+  }
+}  /* end of Q_Wilson_phi_overlap */
+
 #ifndef OPENMP
 void g5_phi(double *phi) {
   double spinor1[24];
@@ -1542,8 +1774,8 @@ void Q_g5_Wilson_phi(double *xi, double *phi) {
   double _1_2_kappa = 0.5 / g_kappa;
 
   for(it = 0; it < T; it++) {
-    phase_neg = it==0   ? -1. : +1.;
-    phase_pos = it==T-1 ? -1. : +1.;
+    phase_neg = it==0 && g_proc_coords[0]==0  ? -1. : +1.;
+    phase_pos = it==T-1 && g_proc_coords[0]==g_nproc_t-1 ? -1. : +1.;
   for(ix = 0; ix < LX; ix++) {
   for(iy = 0; iy < LY; iy++) {
   for(iz = 0; iz < LZ; iz++) {
@@ -1834,8 +2066,8 @@ void Q_Wilson_phi_threads(double *xi, double *phi) {
 
 #pragma omp parallel for private(it,ix,index_s,phi_,xi_,spinor1,spinor2,U_,SU3_1,phase_pos,phase_neg)  shared(phi,xi,T,V3,_1_2_kappa,g_gauge_field,g_iup,g_idn)
   for(it=0; it < T; it++) {
-    phase_neg = it==0   ? -1. : +1.;
-    phase_pos = it==T-1 ? -1. : +1.;
+    phase_neg = it==0 && g_proc_coords[0]==0  ? -1. : +1.;
+    phase_pos = it==T-1 && g_proc_coords[0]==g_nproc_t-1 ? -1. : +1.;
 
     for(ix = 0; ix < V3; ix++) {
 
@@ -3258,3 +3490,307 @@ void spinor_5d_to_4d_L5h_sign(double*s, double*t, int isign) {
  return;
 }
 
+
+/*********************************************************************
+ * single precision operators
+ *
+ * - Q_phi_tbc_flt as Q_phi_tbc, Q_Wilson_phi_flt as Q_Wilson_phi,
+ *   but for float spinor fields and a float copy of the gauge field
+ *   in the same layout as g_gauge_field (including the boundary)
+ * - call xchange_field_flt for phi in calling process
+ *********************************************************************/
+void Q_phi_tbc_flt(float *xi, float *phi, float *gauge) {
+  const float _1_2_kappa = 0.5 / g_kappa;
+  const float mutm = g_mu;
+  unsigned int index_s;
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(index_s = 0; index_s < VOLUME; index_s++) {
+    int mu;
+    float SU3_1[18];
+    float spinor1[24], spinor2[24];
+    float *xi_, *phi_, *U_;
+
+    xi_ = xi + _GSI(index_s);
+
+    _fv_eq_zero(xi_);
+
+    for(mu=0; mu<4; mu++) {
+      /* negative mu-direction */
+      phi_ = phi + _GSI(g_idn[index_s][mu]);
+
+      _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+      _fv_pl_eq_fv(spinor1, phi_);
+
+      U_ = gauge + _GGI(g_idn[index_s][mu], mu);
+
+      _cm_eq_cm_ti_co(SU3_1, U_, &co_phase_up[mu]);
+      _fv_eq_cm_dag_ti_fv(spinor2, SU3_1, spinor1);
+      _fv_pl_eq_fv(xi_, spinor2);
+
+      /* positive mu-direction */
+      phi_ = phi + _GSI(g_iup[index_s][mu]);
+
+      _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+      _fv_mi(spinor1);
+      _fv_pl_eq_fv(spinor1, phi_);
+
+      U_ = gauge + _GGI(index_s, mu);
+
+      _cm_eq_cm_ti_co(SU3_1, U_, &co_phase_up[mu]);
+      _fv_eq_cm_ti_fv(spinor2, SU3_1, spinor1);
+      _fv_pl_eq_fv(xi_, spinor2);
+    }
+
+    /* multiplication with -1/2 */
+    _fv_ti_eq_re(xi_, -0.5f);
+
+    /* diagonal elements */
+    phi_ = phi + _GSI(index_s);
+
+    _fv_eq_fv_ti_re(spinor1, phi_, _1_2_kappa);
+    _fv_pl_eq_fv(xi_, spinor1);
+
+    _fv_eq_gamma_ti_fv(spinor1, 5, phi_);
+    _fv_eq_fv_ti_im(spinor2, spinor1, mutm);
+    _fv_pl_eq_fv(xi_, spinor2);
+  }
+}  /* end of Q_phi_tbc_flt */
+
+void Q_Wilson_phi_flt(float *xi, float *phi, float *gauge) {
+  const float _1_2_kappa = 0.5 / g_kappa;
+  const unsigned int VOL3 = LX*LY*LZ;
+  unsigned int index_s;
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(index_s = 0; index_s < VOLUME; index_s++) {
+    int mu, it;
+    float SU3_1[18];
+    float spinor1[24], spinor2[24];
+    float *xi_, *phi_, *U_;
+    float phase_neg, phase_pos;
+
+    it = index_s / VOL3;
+    phase_neg = it==0 && g_proc_coords[0]==0  ? -1. : +1.;
+    phase_pos = it==T-1 && g_proc_coords[0]==g_nproc_t-1 ? -1. : +1.;
+
+    xi_ = xi + _GSI(index_s);
+
+    _fv_eq_zero(xi_);
+
+    for(mu=0; mu<4; mu++) {
+      /* negative mu-direction */
+      phi_ = phi + _GSI(g_idn[index_s][mu]);
+
+      _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+      _fv_pl_eq_fv(spinor1, phi_);
+
+      U_ = gauge + _GGI(g_idn[index_s][mu], mu);
+
+      _cm_eq_cm_ti_re(SU3_1, U_, (mu==0 ? phase_neg : 1.f));
+      _fv_eq_cm_dag_ti_fv(spinor2, SU3_1, spinor1);
+      _fv_pl_eq_fv(xi_, spinor2);
+
+      /* positive mu-direction */
+      phi_ = phi + _GSI(g_iup[index_s][mu]);
+
+      _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+      _fv_mi(spinor1);
+      _fv_pl_eq_fv(spinor1, phi_);
+
+      U_ = gauge + _GGI(index_s, mu);
+
+      _cm_eq_cm_ti_re(SU3_1, U_, (mu==0 ? phase_pos : 1.f));
+      _fv_eq_cm_ti_fv(spinor2, SU3_1, spinor1);
+      _fv_pl_eq_fv(xi_, spinor2);
+    }
+
+    /* multiplication with -1/2 */
+    _fv_ti_eq_re(xi_, -0.5f);
+
+    /* diagonal elements */
+    phi_ = phi + _GSI(index_s);
+
+    _fv_eq_fv_ti_re(spinor1, phi_, _1_2_kappa);
+    _fv_pl_eq_fv(xi_, spinor1);
+  }
+}  /* end of Q_Wilson_phi_flt */
+
+/*********************************************************************
+ * even/odd preconditioning
+ *
+ * - all fields are full lattice fields in lexicographic order;
+ *   only the sites of one parity are read / written,
+ *   g_eo2lexic[0, ..., VOLUME/2-1] are the even sites,
+ *   g_eo2lexic[VOLUME/2, ..., VOLUME-1] are the odd sites
+ * - Q = ( M_ee  H_eo )
+ *       ( H_oe  M_oo )
+ *   with M = 1 / (2 kappa) + i mu gamma_5 and
+ *   H the off-diagonal part of Q_phi_tbc
+ * - fermion_type = _TM_FERMION uses the twisted boundary conditions
+ *   from co_phase_up as in Q_phi_tbc, fermion_type = _WILSON_FERMION
+ *   uses the explicit anti-periodic boundary conditions in t as in
+ *   Q_Wilson_phi
+ *********************************************************************/
+
+/*********************************************************************
+ * xi_{ieo} = H_{ieo,1-ieo} phi_{1-ieo}
+ * - off-diagonal part as:
+ *   -1/2 sum over mu [ (1 - gamma_mu) U_mu(x) phi(x+mu) + 
+ *       (1 + gamma_mu) U_mu(x-mu)^+ phi(x-mu) ]
+ * - call xchange_field for phi in calling process
+ *********************************************************************/
+void Hopping_eo(double *xi, double *phi, int ieo, int fermion_type) {
+  const unsigned int N = VOLUME / 2;
+  const unsigned int offset = ieo * N;
+  const int VOL3 = LX*LY*LZ;
+  unsigned int i;
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < N; i++) {
+    int index_s, it, mu;
+    double SU3_1[18];
+    double spinor1[24], spinor2[24];
+    double *xi_, *phi_, *U_;
+    complex phase_up[4], phase_dn[4];
+
+    index_s = g_eo2lexic[offset + i];
+
+    if(fermion_type == _TM_FERMION) {
+      for(mu=0; mu<4; mu++) {
+        phase_up[mu] = co_phase_up[mu];
+        phase_dn[mu] = co_phase_up[mu];
+      }
+    } else {
+      it = index_s / VOL3;
+      for(mu=0; mu<4; mu++) {
+        phase_up[mu].re = 1.; phase_up[mu].im = 0.;
+        phase_dn[mu].re = 1.; phase_dn[mu].im = 0.;
+      }
+      if(it==0   && g_proc_coords[0]==0)           phase_dn[0].re = -1.;
+      if(it==T-1 && g_proc_coords[0]==g_nproc_t-1) phase_up[0].re = -1.;
+    }
+
+    xi_ = xi + _GSI(index_s);
+
+    _fv_eq_zero(xi_);
+
+    for(mu=0; mu<4; mu++) {
+      /* negative mu-direction */
+      phi_ = phi + _GSI(g_idn[index_s][mu]);
+
+      _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+      _fv_pl_eq_fv(spinor1, phi_);
+
+      U_ = g_gauge_field + _GGI(g_idn[index_s][mu], mu);
+
+      _cm_eq_cm_ti_co(SU3_1, U_, &phase_dn[mu]);
+      _fv_eq_cm_dag_ti_fv(spinor2, SU3_1, spinor1);
+      _fv_pl_eq_fv(xi_, spinor2);
+
+      /* positive mu-direction */
+      phi_ = phi + _GSI(g_iup[index_s][mu]);
+
+      _fv_eq_gamma_ti_fv(spinor1, mu, phi_);
+      _fv_mi(spinor1);
+      _fv_pl_eq_fv(spinor1, phi_);
+
+      U_ = g_gauge_field + _GGI(index_s, mu);
+
+      _cm_eq_cm_ti_co(SU3_1, U_, &phase_up[mu]);
+      _fv_eq_cm_ti_fv(spinor2, SU3_1, spinor1);
+      _fv_pl_eq_fv(xi_, spinor2);
+    }
+
+    /* multiplication with -1/2 */
+    _fv_ti_eq_re(xi_, -0.5);
+  }
+}  /* end of Hopping_eo */
+
+/*********************************************************************
+ * xi_{ieo} = M_{ieo,ieo} phi_{ieo} = ( 1 / (2 kappa) + i mu gamma_5 ) phi_{ieo}
+ * - xi and phi can be the same field
+ *********************************************************************/
+void M_eo_diag(double *xi, double *phi, int ieo, double mutm) {
+  const unsigned int N = VOLUME / 2;
+  const unsigned int offset = ieo * N;
+  const double _1_2_kappa = 0.5 / g_kappa;
+  unsigned int i;
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < N; i++) {
+    double spinor1[24], spinor2[24];
+    unsigned int iix = _GSI( g_eo2lexic[offset + i] );
+
+    _fv_eq_gamma_ti_fv(spinor1, 5, phi+iix);
+    _fv_eq_fv_ti_im(spinor2, spinor1, mutm);
+    _fv_eq_fv_ti_re(spinor1, phi+iix, _1_2_kappa);
+    _fv_eq_fv_pl_fv(xi+iix, spinor1, spinor2);
+  }
+}  /* end of M_eo_diag */
+
+/*********************************************************************
+ * xi_{ieo} = M_{ieo,ieo}^{-1} phi_{ieo}
+ *          = ( 1 / (2 kappa) - i mu gamma_5 ) / ( 1 / (4 kappa^2) + mu^2 ) phi_{ieo}
+ * - xi and phi can be the same field
+ *********************************************************************/
+void M_eo_diag_inv(double *xi, double *phi, int ieo, double mutm) {
+  const unsigned int N = VOLUME / 2;
+  const unsigned int offset = ieo * N;
+  const double _1_2_kappa = 0.5 / g_kappa;
+  const double norm = 1. / ( _1_2_kappa * _1_2_kappa + mutm * mutm );
+  unsigned int i;
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < N; i++) {
+    double spinor1[24], spinor2[24];
+    unsigned int iix = _GSI( g_eo2lexic[offset + i] );
+
+    _fv_eq_gamma_ti_fv(spinor1, 5, phi+iix);
+    _fv_eq_fv_ti_im(spinor2, spinor1, -mutm*norm);
+    _fv_eq_fv_ti_re(spinor1, phi+iix, _1_2_kappa*norm);
+    _fv_eq_fv_pl_fv(xi+iix, spinor1, spinor2);
+  }
+}  /* end of M_eo_diag_inv */
+
+/*********************************************************************
+ * Schur complement on the odd sites
+ *   xi_o = ( M_oo - H_oe M_ee^{-1} H_eo ) phi_o
+ * - aux is a work field of size VOLUMEPLUSRAND; its even sites are
+ *   exchanged here, phi must have been exchanged by the calling process
+ * - xi, phi and aux must be different fields
+ *********************************************************************/
+void Q_eo_SchurComplement(double *xi, double *phi, double mutm, int fermion_type, double *aux) {
+  const unsigned int N = VOLUME / 2;
+  unsigned int i;
+
+  /* aux_e = M_ee^{-1} H_eo phi_o */
+  Hopping_eo(aux, phi, 0, fermion_type);
+  M_eo_diag_inv(aux, aux, 0, mutm);
+  xchange_field(aux);
+
+  /* xi_o = H_oe aux_e */
+  Hopping_eo(xi, aux, 1, fermion_type);
+
+  /* aux_o = M_oo phi_o */
+  M_eo_diag(aux, phi, 1, mutm);
+
+  /* xi_o = aux_o - xi_o */
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < N; i++) {
+    unsigned int iix = _GSI( g_eo2lexic[N + i] );
+    _fv_eq_fv_mi_fv(xi+iix, aux+iix, xi+iix);
+  }
+}  /* end of Q_eo_SchurComplement */
@@ -6,6 +6,9 @@
 /* Computes xi = Q phi, where Q is the light tm Dirac operator with twisted boundary conditions. */
 
 void Q_phi_tbc(double *xi, double *phi);
+void Q_phi_tbc_block(double **xi, double **phi, int nrhs);
+void Q_phi_tbc_overlap(double *xi, double *phi);
+void Q_Wilson_phi_overlap(double *xi, double *phi);
 void Hopping(double *xi, double *phi);
 void gamma5_BdagH4_gamma5 (double *xi, double *phi, double *work);
 void mul_one_pm_imu_inv (double *phi, double sign, int V);
@@ -28,12 +31,20 @@ void Q_Wilson_phi_tbc(double *xi, double *phi);
 void Q_Wilson_phi(double *xi, double *phi);
 void Q_g5_Wilson_phi(double *xi, double *phi);
 void Q_Wilson_phi_nobc(double *xi, double *phi);
+void Q_phi_tbc_flt(float *xi, float *phi, float *gauge);
+void Q_Wilson_phi_flt(float *xi, float *phi, float *gauge);
 #ifdef OPENMP
 void Q_Wilson_phi_threads(double *xi, double *phi);
 #endif
 
 void g5_phi(double *phi);
 
+// functions for even/odd preconditioning
+void Hopping_eo(double *xi, double *phi, int ieo, int fermion_type);
+void M_eo_diag(double *xi, double *phi, int ieo, double mutm);
+void M_eo_diag_inv(double *xi, double *phi, int ieo, double mutm);
+void Q_eo_SchurComplement(double *xi, double *phi, double mutm, int fermion_type, double *aux);
+
 // functions for DWF
 void Q_DW_Wilson_4d_phi(double *xi, double *phi);
 void Q_DW_Wilson_dag_4d_phi(double *xi, double *phi);
@@ -11,6 +11,9 @@
  * - tested HPE matrix calculation _fv_eq_hpem_ti_fv
  *   against the stepwise calculation
  * CHANGES:
+ * - init_trace_coeff: iterative enumeration of the loops,
+ *   Hopping_iter: partial products shared between consecutive
+ *   loops, thread safe
  *********************************************/
 
 #include <math.h>
@@ -372,138 +375,74 @@ void Hopping_rec(double *xi, double *phi, int xd, int xs, int l, int deg, int *s
 /****************************************************************************
  * void init_trace_coeff()
  *
+ * - loop_tab: all closed paths of deg hopping steps from x+mu back to x,
+ *   step 0,...,3 = +mu', 4,...,7 = -mu'; together with the link
+ *   x -> x+mu they form the loops of length deg+1
+ * - the paths are generated by an iterative depth first search which
+ *   leaves a branch as soon as it cannot return to x any more; the cost
+ *   is proportional to the number of paths, not to 8^deg
+ * - loop_tab is in lexicographic order, i.e. consecutive paths share
+ *   their longest common prefix; Hopping_iter relies on that
+ * - paths with tcf = tcb = 0 (back-tracking at g_mu = 0) are dropped
  ****************************************************************************/
 
-#define MAX_ORD 6
-
 void init_trace_coeff(double **tcf, double **tcb, int ***loop_tab, int deg, int *N) {
 
-  int l, l1, mu, steps[4], steps2[4], count, isign, sid, nloop, ix;
-  int *loop, Nloop_max, end_flag;
-  int **lpath, dist;
+  int l, l1, mu, steps[4], sid, nloop, nloop_max, dist;
+  int *loop=NULL, *tab=NULL, *tab_new=NULL;
   double spinor1[24], spinor2[24], *sp1, *sp2, *sp3;
   double mutilde = 2.*g_kappa*g_mu;
   double norminv = 1. / (1. + mutilde*mutilde);
   double sigma;
   double kappatodeg=1;
 
-  loop = (int*)malloc(deg*sizeof(int));
-  Nloop_max=8; for(l=2; l<=deg; l++) Nloop_max*=8;
-  if(g_cart_id==0) fprintf(stdout, "deg=%d, Nloop_max=%d\n", deg, Nloop_max);
-  lpath = (int**)malloc(Nloop_max*sizeof(int*));
   for(l=1; l<=deg; l++) kappatodeg *= -g_kappa; kappatodeg*=g_kappa;
-  fprintf(stdout, "kappatodeg = %25.16e\n", kappatodeg);
+  if(g_cart_id==0) fprintf(stdout, "# [init_trace_coeff] deg = %d, kappatodeg = %25.16e\n", deg, kappatodeg);
 
   /********************************************************
-   * (1) count the loops 
+   * (1) enumerate the paths
    ********************************************************/
+  nloop_max = 1024;
+  loop = (int*)malloc(deg*sizeof(int));
+  tab  = (int*)malloc(nloop_max*deg*sizeof(int));
+  if(loop==NULL || tab==NULL) {
+    fprintf(stderr, "[init_trace_coeff] Error, could not allocate loop table\n");
+    EXIT(1);
+  }
+
   nloop = 0;
-  for(l=0; l<deg; l++) loop[l]=0;
-  for(ix=0; ix<Nloop_max; ix++) {
-    steps[0]=0;  steps[1]=0;  steps[2]=0;  steps[3]=0;
-    steps[0]++;
-
-    for(l=0; l<deg; l++) {
-      if(loop[l]<4) { 
-        steps[loop[l]]++;
-      } else {
-        steps[loop[l]-4]--;
-      }
-      dist = abs(steps[0]) + abs(steps[1]) + abs(steps[2]) + abs(steps[3]);
-/*      fprintf(stdout, "ix=%5d; l=%1d; steps= %1d, %1d, %1d, %1d; loop= %1d, %1d, %1d; dist=%d\n", \
-        ix, l, steps[0], steps[1], steps[2], steps[3], loop[0], loop[1], loop[2], dist);
-*/
-      if(abs(steps[0]) + abs(steps[1]) + abs(steps[2]) + abs(steps[3]) < deg-l ) {
-        if(l==deg-1) {
-          nloop++;
- /*         fprintf(stdout, "found loop number %d\n", nloop); */
-          lpath[nloop-1] = (int*)malloc(deg*sizeof(int));
-          for(l1=0; l1<deg; l1++) lpath[nloop-1][l1] = loop[l1];
-        }
-      } else {
-/*        fprintf(stdout, "dist too large ...\n"); */
-/*
-        l1 = l;
-        while( l1>=0 && (loop[l1]+1)%8==0 ) l1--;
-        l=l1;
-        fprintf(stdout, "\tnew l = %d\n", l);
-        loop[l] = (loop[l]+1)%8;
-        for(l1=l+1; l1<deg; l1++) loop[l1]=0;
-        fprintf(stdout, "\tnew loop = %1d, %1d, %1d\n", loop[0], loop[1], loop[2]); 
-        l--;
-*/
-        break;
-      }
+  steps[0] = 1; steps[1] = 0; steps[2] = 0; steps[3] = 0;
+  l = 0;
+  loop[0] = -1;
+  while(l>=0) {
+    /* remove the current step at level l and go to the next one */
+    if(loop[l]>=0) {
+      if(loop[l]<4) steps[loop[l]]--; else steps[loop[l]-4]++;
     }
-/*
-    end_flag=1;
-    for(l=0; l<deg; l++) end_flag *= (loop[l]==7);
-    fprintf(stdout, "\tix=%d; end_flag=%d\n", ix, end_flag);
-    if(end_flag==1) break;
-*/
-    l1=deg-1;
-    while( l1>=0 && (loop[l1]=(loop[l1]+1)%8)==0 ) l1--;
-/*    fprintf(stdout, "\tnew loop = %1d, %1d, %1d\n", loop[0], loop[1], loop[2]); */
-  }  /* of ix */
-
-/*
-  if(g_cart_id==0) {
-    fprintf(stdout, "nloop = %d\n", nloop);
-    fprintf(stdout, "\nlpath table: \n");
-    for(l=0; l<nloop; l++) {
-      fprintf(stdout, "%3d: ", l);
-      for(l1=0; l1<deg-1; l1++) {
-        if(lpath[l][l1]<4) {
-          fprintf(stdout, "\t+%1d", lpath[l][l1]);
-        } else {
-          fprintf(stdout, "\t-%1d", lpath[l][l1]-4);
-        }
-      }
-      if(lpath[l][deg-1]<4) {
-        fprintf(stdout, "\t+%1d\n", lpath[l][deg-1]);
-      } else {
-        fprintf(stdout, "\t-%1d\n", lpath[l][deg-1]-4);
-      }
+    if(++loop[l]==8) { l--; continue; }
+    if(loop[l]<4) steps[loop[l]]++; else steps[loop[l]-4]--;
+
+    dist = abs(steps[0]) + abs(steps[1]) + abs(steps[2]) + abs(steps[3]);
+    if(dist >= deg-l) continue;
+
+    if(l<deg-1) {
+      loop[++l] = -1;
+      continue;
     }
-  } 
-*/
- 
-  /***************************************************
-   * copy lpath to loop_tab
-   ***************************************************/
-  *loop_tab    = (int**)malloc(nloop *       sizeof(int*));
-  (*loop_tab)[0] = (int* )malloc(nloop * deg * sizeof(int));
-  for(l=1; l<nloop; l++) (*loop_tab)[l] = (*loop_tab)[l-1] + deg;
-  for(l=0; l<nloop; l++) memcpy((void*)(*loop_tab)[l], (void*)lpath[l], deg*sizeof(int));
-  
-  /***************************************************
-   * print lpath to stdout
-   ***************************************************/
-  if(g_cart_id==0) {
-    fprintf(stdout, "nloop = %d\n", nloop);
-    fprintf(stdout, "\nloop_tab: \n");
-    for(l=0; l<nloop; l++) {
-      fprintf(stdout, "%3d: ", l);
-      for(l1=0; l1<deg-1; l1++) {
-        if( (*loop_tab)[l][l1]<4) {
-          fprintf(stdout, "\t+%1d", (*loop_tab)[l][l1]);
-        } else {
-          fprintf(stdout, "\t-%1d", (*loop_tab)[l][l1]-4);
-        }
-      }
-      if( (*loop_tab)[l][deg-1]<4) {
-        fprintf(stdout, "\t+%1d\n", (*loop_tab)[l][deg-1]);
-      } else {
-        fprintf(stdout, "\t-%1d\n", (*loop_tab)[l][deg-1]-4);
+
+    if(nloop==nloop_max) {
+      nloop_max *= 2;
+      tab_new = (int*)realloc(tab, nloop_max*deg*sizeof(int));
+      if(tab_new==NULL) {
+        fprintf(stderr, "[init_trace_coeff] Error, could not reallocate loop table for %d paths\n", nloop_max);
+        EXIT(1);
       }
+      tab = tab_new;
     }
-  } 
-
-  *N = nloop;
- 
+    memcpy(tab+nloop*deg, loop, deg*sizeof(int));
+    nloop++;
+  }
   free(loop);
-  for(l=0; l<nloop; l++) free(lpath[l]);
-  free(lpath);
 
   /********************************************************
    * (2) tcf/b 
@@ -511,9 +450,16 @@ void init_trace_coeff(double **tcf, double **tcb, int ***loop_tab, int deg, int
    *             i.e. +/-1 means 1 -/+ gamma_mu
    * - tcf/b have real and imaginary part   
    ********************************************************/
-  *tcf = (double*)malloc(2*nloop*sizeof(double));
-  *tcb = (double*)malloc(2*nloop*sizeof(double));
-  
+  *tcf = (double*)malloc((2*nloop+1)*sizeof(double));
+  *tcb = (double*)malloc((2*nloop+1)*sizeof(double));
+  if(*tcf==NULL || *tcb==NULL) {
+    fprintf(stderr, "[init_trace_coeff] Error, could not allocate trace coefficients\n");
+    EXIT(1);
+  }
+
+#ifdef OPENMP
+#pragma omp parallel for private(l1,mu,sigma,sid,spinor1,spinor2,sp1,sp2,sp3)
+#endif
   for(l=0; l<nloop; l++) {
     (*tcb)[2*l  ] = 0.; (*tcb)[2*l+1] = 0.;
     (*tcf)[2*l  ] = 0.; (*tcf)[2*l+1] = 0.;
@@ -523,8 +469,8 @@ void init_trace_coeff(double **tcf, double **tcb, int ***loop_tab, int deg, int
       sp2 = spinor1; sp1 = spinor2;
       for(l1=0; l1<deg; l1++) {
         sp3=sp1; sp1=sp2; sp2=sp3;
-        mu    = ((*loop_tab)[l][l1]) % 4;
-        sigma = - ( 2. * (int)(((*loop_tab)[l][l1]) / 4) - 1. );
+        mu    = tab[l*deg+l1] % 4;
+        sigma = - ( 2. * (int)(tab[l*deg+l1] / 4) - 1. );
         _fv_eq_hpem_ti_fv(sp2, sp1, mu, sigma, mutilde, norminv);
       }
       _fv_eq_hpem_ti_fv(sp1, sp2, 0, +1., mutilde, norminv);
@@ -536,8 +482,8 @@ void init_trace_coeff(double **tcf, double **tcb, int ***loop_tab, int deg, int
       sp2 = spinor1; sp1 = spinor2;
       for(l1=deg-1; l1>=0; l1--) {
         sp3=sp1; sp1=sp2; sp2=sp3;
-        mu    = ((*loop_tab)[l][l1]) % 4;
-        sigma =   ( 2. * (int)(((*loop_tab)[l][l1]) / 4) - 1. );
+        mu    = tab[l*deg+l1] % 4;
+        sigma =   ( 2. * (int)(tab[l*deg+l1] / 4) - 1. );
         _fv_eq_hpem_ti_fv(sp2, sp1, mu, sigma, mutilde, norminv);
       }
       _fv_eq_hpem_ti_fv(sp1, sp2, 0, -1., mutilde, norminv);
@@ -548,97 +494,123 @@ void init_trace_coeff(double **tcf, double **tcb, int ***loop_tab, int deg, int
     (*tcf)[2*l+1] *=  kappatodeg;
     (*tcb)[2*l  ] *= -kappatodeg;
     (*tcb)[2*l+1] *= -kappatodeg;
-    
   }
 
-  for(l=0; l<nloop; l++) fprintf(stdout, "%4d%25.16e%25.16e%25.16e%25.16e\n", l, 
-    (*tcf)[2*l], (*tcf)[2*l+1], (*tcb)[2*l], (*tcb)[2*l+1]);
+  /********************************************************
+   * (3) drop the paths with vanishing coefficients,
+   *     the order of the remaining ones is kept
+   ********************************************************/
+  l1 = 0;
+  for(l=0; l<nloop; l++) {
+    if( (*tcf)[2*l]==0. && (*tcf)[2*l+1]==0. && (*tcb)[2*l]==0. && (*tcb)[2*l+1]==0. ) continue;
+    if(l1<l) {
+      memcpy(tab+l1*deg, tab+l*deg, deg*sizeof(int));
+      (*tcf)[2*l1] = (*tcf)[2*l]; (*tcf)[2*l1+1] = (*tcf)[2*l+1];
+      (*tcb)[2*l1] = (*tcb)[2*l]; (*tcb)[2*l1+1] = (*tcb)[2*l+1];
+    }
+    l1++;
+  }
+  if(g_cart_id==0) fprintf(stdout, "# [init_trace_coeff] number of paths %d, with non-zero coefficients %d\n", nloop, l1);
+  nloop = l1;
+
+  *loop_tab      = (int**)malloc((nloop+1) * sizeof(int*));
+  (*loop_tab)[0] = (int* )malloc((nloop*deg+1) * sizeof(int));
+  if(*loop_tab==NULL || (*loop_tab)[0]==NULL) {
+    fprintf(stderr, "[init_trace_coeff] Error, could not allocate loop_tab\n");
+    EXIT(1);
+  }
+  for(l=1; l<nloop; l++) (*loop_tab)[l] = (*loop_tab)[l-1] + deg;
+  memcpy((*loop_tab)[0], tab, nloop*deg*sizeof(int));
+  free(tab);
+  *N = nloop;
+
+  /***************************************************
+   * print loop_tab and coefficients to stdout
+   ***************************************************/
+  if(g_cart_id==0 && g_verbose>2) {
+    fprintf(stdout, "\nloop_tab: \n");
+    for(l=0; l<nloop; l++) {
+      fprintf(stdout, "%3d: ", l);
+      for(l1=0; l1<deg; l1++) {
+        if( (*loop_tab)[l][l1]<4) {
+          fprintf(stdout, "\t+%1d", (*loop_tab)[l][l1]);
+        } else {
+          fprintf(stdout, "\t-%1d", (*loop_tab)[l][l1]-4);
+        }
+      }
+      fprintf(stdout, "\n");
+    }
+    for(l=0; l<nloop; l++) fprintf(stdout, "%4d%25.16e%25.16e%25.16e%25.16e\n", l, 
+      (*tcf)[2*l], (*tcf)[2*l+1], (*tcb)[2*l], (*tcb)[2*l+1]);
+  }
 
 }
 
 /****************************************************************************
  * void Hopping_iter()
  *
+ * - truf += sum_l tcf_l tr[ U_mu(xd) (path l, reversed) ]
+ *   trub += sum_l tcb_l tr[ U_mu(xd)^+ (path l) ]
+ * - the colour products along the path are kept per level; for path l
+ *   only the levels after the common prefix with path l-1 are
+ *   recomputed, which for loop_tab from init_trace_coeff reduces the
+ *   number of matrix products from deg to about 2.6 per path
+ * - the reversed path is the hermitean conjugate of the path,
+ *   so its trace is the complex conjugate of the backward one
+ * - no static data, can be called from several threads for different xd
  ****************************************************************************/
 
 void Hopping_iter(double *truf, double *trub, double *tcf, double *tcb, int xd, 
   int mu, int deg, int nloop, int **loop_tab) {
 
-  int l, l1, steps[4], mu1, isign, count, perm[4];
-  double U1_[18], U2_[18], *u1, *u2, *u3;
-  int sigma, xs, xnew, xold;
+  int l, l0, l1, i, mu1, perm[4];
+  int site[HPE_MAX_ORDER+1];
+  double U_[18*(HPE_MAX_ORDER+1)], *u1, *u2, *uc;
   complex w;
 
+  if(deg>HPE_MAX_ORDER) {
+    fprintf(stderr, "[Hopping_iter] Error, deg = %d > HPE_MAX_ORDER = %d\n", deg, HPE_MAX_ORDER);
+    return;
+  }
+
   for(l=0; l<4; l++) perm[l] = (l+mu)%4;
-  fprintf(stdout, "perm = %2d, %2d, %2d, %2d\n", perm[0], perm[1], perm[2], perm[3]);
-  
-  xs = g_iup[xd][mu];
-  fprintf(stdout, "xs = %d\n", xs);
+
+  uc = g_gauge_field + _GGI(xd, mu);
+  site[0] = g_iup[xd][mu];
+  _cm_eq_id(U_);
 
   for(l=0; l<nloop; l++) {
- 
-/*    fprintf(stdout, "\nbackward loops:\n"); */
-
-    _cm_eq_id(U1_);
-    u2=U1_; u1=U2_;
-    xnew=xs;
-/*  fprintf(stdout, "before: xnew = %5d\n", xnew); */
-    for(l1=0; l1<deg; l1++) {
-      u3=u1; u1=u2; u2=u3;
-      mu1   = perm[loop_tab[l][l1]%4];
-      sigma = -(2*(loop_tab[l][l1]/4) - 1);
-      if(sigma==+1) {
-        xold=xnew;
-        xnew = g_iup[xold][mu1];
-/*        fprintf(stdout, "l=%3d, l1=%3d, step=%2d, sigma=%2d; xnew = %5d; applying U_%1d(%4d)^+\n", l, l1, perm[loop_tab[l][l1]%4], sigma, xnew, mu1, xold);
-*/
-/*        _cm_eq_cm_ti_cm_dag(u2, g_gauge_field+_GGI(xold, mu1), u1); */
-        _cm_eq_cm_dag_ti_cm(u2, g_gauge_field+_GGI(xold, mu1), u1);
-      } else {
-        xold=xnew;
-        xnew = g_idn[xold][mu1];
-/*        fprintf(stdout, "l=%3d, l1=%3d, step=%2d, sigma=%2d; xnew = %5d, applying U_%1d(%4d)\n", l, l1, perm[loop_tab[l][l1]%4], sigma, xnew, mu1, xnew);
-*/
-        _cm_eq_cm_ti_cm(u2, g_gauge_field+_GGI(xnew, mu1), u1);
-      }
+
+    /* length of the common prefix with the previous path */
+    l0 = 0;
+    if(l>0) {
+      while(l0<deg-1 && loop_tab[l][l0]==loop_tab[l-1][l0]) l0++;
     }
-/*    _cm_eq_cm_ti_cm_dag(u1, g_gauge_field+_GGI(xd, mu), u2); */
-    _cm_eq_cm_dag_ti_cm(u1, g_gauge_field+_GGI(xd, mu), u2); 
-    _co_eq_tr_cm(&w, u1);
-/*    fprintf(stdout, "current w = %25.16e +i %25.16e\n", w.re, w.im); */
-    _co_pl_eq_co_ti_co((complex*)trub, (complex*)(tcb+2*l), &w);
 
-/*    fprintf(stdout, "\nforward loops:\n"); */
- 
-    _cm_eq_id(U1_);
-    u2=U1_; u1=U2_;
-    xnew=xd;
-/*    fprintf(stdout, "before: xnew = %5d\n", xnew); */
-    for(l1=deg-1; l1>=0; l1--) {
-      u3=u1; u1=u2; u2=u3;
-      mu1   = perm[loop_tab[l][l1]%4];
-      sigma = -(2*(loop_tab[l][l1]/4) - 1);
-      if(sigma==-1) {
-        xold=xnew;
-        xnew = g_iup[xold][mu1];
-/*        fprintf(stdout, "l=%3d, l1=%3d, step=%2d, sigma=%2d; xnew = %5d, applying U_%1d(%4d)^+\n", l, l1, perm[loop_tab[l][l1]%4], sigma, xnew, mu1, xold); */
-/*        _cm_eq_cm_ti_cm_dag(u2, g_gauge_field+_GGI(xold, mu1), u1); */
-        _cm_eq_cm_dag_ti_cm(u2, g_gauge_field+_GGI(xold, mu1), u1);
+    for(l1=l0; l1<deg; l1++) {
+      mu1 = perm[loop_tab[l][l1]%4];
+      u1  = U_ + 18*l1;
+      u2  = u1 + 18;
+      if(loop_tab[l][l1]<4) {
+        site[l1+1] = g_iup[site[l1]][mu1];
+        _cm_eq_cm_dag_ti_cm(u2, g_gauge_field+_GGI(site[l1], mu1), u1);
       } else {
-        xold=xnew;
-        xnew = g_idn[xold][mu1];
-/*        fprintf(stdout, "l=%3d, l1=%3d, step=%2d, sigma=%2d; xnew = %5d, applying U_%1d(%4d)\n", l, l1, perm[loop_tab[l][l1]%4], sigma, xnew, mu1, xnew); */
-        _cm_eq_cm_ti_cm(u2, g_gauge_field+_GGI(xnew, mu1), u1);
+        site[l1+1] = g_idn[site[l1]][mu1];
+        _cm_eq_cm_ti_cm(u2, g_gauge_field+_GGI(site[l1+1], mu1), u1);
       }
     }
-    _cm_eq_cm_ti_cm(u1, g_gauge_field+_GGI(xd, mu), u2);
-    _co_eq_tr_cm(&w, u1);
-    _co_pl_eq_co_ti_co((complex*)truf, (complex*)(tcf+2*l), &w);
 
+    /* w = tr[ U_mu(xd)^+ u2 ] */
+    u2 = U_ + 18*deg;
+    w.re = 0.; w.im = 0.;
+    for(i=0; i<18; i+=2) {
+      w.re += uc[i] * u2[i  ] + uc[i+1] * u2[i+1];
+      w.im += uc[i] * u2[i+1] - uc[i+1] * u2[i  ];
+    }
+    _co_pl_eq_co_ti_co((complex*)trub, (complex*)(tcb+2*l), &w);
+    _co_pl_eq_co_ti_co_conj((complex*)truf, (complex*)(tcf+2*l), &w);
   }
 
-  fprintf(stdout, "%6d%3d%25.16e%25.16e%25.16e%25.16e\n", xd, mu, truf[0], truf[1], trub[0], trub[1]);
-
 }
 
 /*********************************************
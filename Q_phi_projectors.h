@@ -0,0 +1,19 @@
+#ifndef _Q_PHI_PROJECTORS_H
+#define _Q_PHI_PROJECTORS_H
+
+/********************
+ * spin projection (1 + s gamma_mu) phi in the gamma basis of
+ * cvc_linalg.h:
+ *   h_a = phi_a + s proj_sign[mu][a] (i)^proj_imag[mu] phi_{proj_spin[mu][a]}, a = 0,1
+ * and reconstruction of the lower spin components
+ *   chi_{2+a} = s rec_sign[mu][a] (i)^proj_imag[mu] chi_{rec_spin[mu][a]}
+ *
+ * used by the hopping kernels in Q_phi_simd.c and Q_mobius_phi.c
+ ********************/
+static const int proj_spin[4][2] = { {2, 3}, {3, 2}, {3, 2}, {2, 3} };
+static const int proj_sign[4][2] = { {-1, -1}, {-1, -1}, {-1, 1}, {-1, 1} };
+static const int proj_imag[4]    = { 0, 1, 0, 1 };
+static const int rec_spin[4][2]  = { {0, 1}, {1, 0}, {1, 0}, {0, 1} };
+static const int rec_sign[4][2]  = { {-1, -1}, {1, 1}, {1, -1}, {1, -1} };
+
+#endif
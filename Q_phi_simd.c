@@ -0,0 +1,348 @@
+/********************
+ * Q_phi_simd.c
+ *
+ * PURPOSE:
+ * - tm Dirac operator with twisted boundary conditions
+ *   (as Q_phi_tbc) on site-blocked (AoSoA) fields, so
+ *   that the hopping term is vectorized across sites
+ * - AVX-512 (8 sites), AVX2 (4 sites) and scalar
+ *   instances of the same kernel (Q_phi_simd_kernel.h),
+ *   the instruction set is chosen at run time in
+ *   init_Q_phi_simd
+ * - the gauge field is copied to the AoSoA layout with
+ *   the boundary phases co_phase_up multiplied in;
+ *   init_Q_phi_simd must be called again whenever
+ *   g_gauge_field changes
+ * - neighbours of a block that form a complete block
+ *   themselves (all directions except z when
+ *   LZ % _AOSOA_BLOCK == 0) are read directly, all
+ *   others are gathered site by site
+ * - solvers keep their fields in the AoSoA layout and use
+ *   Q_phi_tbc_aosoa with xchange_field_aosoa; only the
+ *   boundary sites are converted for the exchange
+ ********************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#ifdef OPENMP
+#include <omp.h>
+#endif
+#if (defined __GNUC__) && (defined __x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "cvc_complex.h"
+#include "global.h"
+#include "cvc_linalg.h"
+#include "cvc_geometry.h"
+#include "cvc_utils.h"
+#include "Q_phi.h"
+#include "Q_phi_simd.h"
+#include "Q_phi_projectors.h"
+
+typedef void (*hopping_aosoa_kernel)(double*, double*, double*, int*, int, int, double, double, double);
+
+static hopping_aosoa_kernel kernel_aosoa = NULL;
+static double *gauge_aosoa = NULL;
+static double *phi_aosoa = NULL, *xi_aosoa = NULL;
+#ifdef MPI
+static double *xchange_aos = NULL;
+#endif
+static int *nb_block_aosoa = NULL;
+
+/********************
+ * scalar instance
+ ********************/
+#define _KERNEL_NAME hopping_aosoa_scalar
+#define _KERNEL_ATTR
+#define _NLANE 1
+#define _VT double
+#define _VLD(p) (*(p))
+#define _VST(p,v) (*(p) = (v))
+#define _VSET1(x) (x)
+#define _VADD(a,b) ((a)+(b))
+#define _VMUL(a,b) ((a)*(b))
+#define _VFMA(a,b,c) ((a)*(b)+(c))
+#define _VFNMA(a,b,c) ((c)-(a)*(b))
+#include "Q_phi_simd_kernel.h"
+#undef _KERNEL_NAME
+#undef _KERNEL_ATTR
+#undef _NLANE
+#undef _VT
+#undef _VLD
+#undef _VST
+#undef _VSET1
+#undef _VADD
+#undef _VMUL
+#undef _VFMA
+#undef _VFNMA
+
+#if (defined __GNUC__) && (defined __x86_64__)
+/********************
+ * AVX2 instance
+ ********************/
+#define _KERNEL_NAME hopping_aosoa_avx2
+#define _KERNEL_ATTR __attribute__((target("avx2,fma")))
+#define _NLANE 4
+#define _VT __m256d
+#define _VLD(p) _mm256_load_pd(p)
+#define _VST(p,v) _mm256_store_pd((p),(v))
+#define _VSET1(x) _mm256_set1_pd(x)
+#define _VADD(a,b) _mm256_add_pd((a),(b))
+#define _VMUL(a,b) _mm256_mul_pd((a),(b))
+#define _VFMA(a,b,c) _mm256_fmadd_pd((a),(b),(c))
+#define _VFNMA(a,b,c) _mm256_fnmadd_pd((a),(b),(c))
+#include "Q_phi_simd_kernel.h"
+#undef _KERNEL_NAME
+#undef _KERNEL_ATTR
+#undef _NLANE
+#undef _VT
+#undef _VLD
+#undef _VST
+#undef _VSET1
+#undef _VADD
+#undef _VMUL
+#undef _VFMA
+#undef _VFNMA
+
+/********************
+ * AVX-512 instance
+ ********************/
+#define _KERNEL_NAME hopping_aosoa_avx512
+#define _KERNEL_ATTR __attribute__((target("avx512f")))
+#define _NLANE 8
+#define _VT __m512d
+#define _VLD(p) _mm512_load_pd(p)
+#define _VST(p,v) _mm512_store_pd((p),(v))
+#define _VSET1(x) _mm512_set1_pd(x)
+#define _VADD(a,b) _mm512_add_pd((a),(b))
+#define _VMUL(a,b) _mm512_mul_pd((a),(b))
+#define _VFMA(a,b,c) _mm512_fmadd_pd((a),(b),(c))
+#define _VFNMA(a,b,c) _mm512_fnmadd_pd((a),(b),(c))
+#include "Q_phi_simd_kernel.h"
+#undef _KERNEL_NAME
+#undef _KERNEL_ATTR
+#undef _NLANE
+#undef _VT
+#undef _VLD
+#undef _VST
+#undef _VSET1
+#undef _VADD
+#undef _VMUL
+#undef _VFMA
+#undef _VFNMA
+#endif
+
+/********************
+ * AoSoA fields, 64 byte aligned, V rounded up
+ * to a multiple of _AOSOA_BLOCK
+ ********************/
+int alloc_spinor_field_aosoa(double **s, const int V) {
+  size_t bytes = 24 * (size_t)_AOSOA_VOLUME(V) * sizeof(double);
+  if(posix_memalign((void**)s, 64, bytes) != 0) {
+#ifdef MPI
+    MPI_Abort(MPI_COMM_WORLD, 10);
+    MPI_Finalize();
+#endif
+    exit(103);
+  }
+  memset(*s, 0, bytes);
+  return(0);
+}
+
+/* s (AoSoA) = t (AoS) for the first V sites */
+void spinor_field_aos_to_aosoa(double *s, double *t, const int V) {
+  int ix, k;
+#ifdef OPENMP
+#pragma omp parallel for private(ix,k) shared(s,t)
+#endif
+  for(ix=0; ix<V; ix++) {
+    for(k=0; k<24; k++) s[_GSI_AOSOA(ix) + k*_AOSOA_BLOCK] = t[_GSI(ix) + k];
+  }
+}
+
+/* s (AoS) = t (AoSoA) for the first V sites */
+void spinor_field_aosoa_to_aos(double *s, double *t, const int V) {
+  int ix, k;
+#ifdef OPENMP
+#pragma omp parallel for private(ix,k) shared(s,t)
+#endif
+  for(ix=0; ix<V; ix++) {
+    for(k=0; k<24; k++) s[_GSI(ix) + k] = t[_GSI_AOSOA(ix) + k*_AOSOA_BLOCK];
+  }
+}
+
+/* s (AoSoA) = t (AoS) for the first V sites */
+void gauge_field_aos_to_aosoa(double *s, double *t, const int V) {
+  int ix, mu, k;
+#ifdef OPENMP
+#pragma omp parallel for private(ix,mu,k) shared(s,t)
+#endif
+  for(ix=0; ix<V; ix++) {
+    for(mu=0; mu<4; mu++) {
+      for(k=0; k<18; k++) s[_GGI_AOSOA(ix,mu) + k*_AOSOA_BLOCK] = t[_GGI(ix,mu) + k];
+    }
+  }
+}
+
+/********************
+ * set up the AoSoA gauge field with boundary phases,
+ * the block neighbour table and the kernel
+ * - returns -1 if VOLUME is not a multiple of
+ *   _AOSOA_BLOCK, 0 otherwise
+ ********************/
+int init_Q_phi_simd(void) {
+
+  int ix, ib, l, mu, dir, iy, iy0, nblock, V;
+  double U_[18];
+  size_t bytes;
+
+  free_Q_phi_simd();
+  if(VOLUME % _AOSOA_BLOCK != 0) {
+    if(g_cart_id==0) fprintf(stderr, "[init_Q_phi_simd] Error, VOLUME is not a multiple of %d\n", _AOSOA_BLOCK);
+    return(-1);
+  }
+
+  V = _AOSOA_VOLUME(VOLUMEPLUSRAND);
+  bytes = 72 * (size_t)V * sizeof(double);
+  if(posix_memalign((void**)&gauge_aosoa, 64, bytes) != 0) {
+    fprintf(stderr, "[init_Q_phi_simd] Error, could not allocate gauge field\n");
+    return(-1);
+  }
+  memset(gauge_aosoa, 0, bytes);
+  for(ix=0; ix<VOLUMEPLUSRAND; ix++) {
+    for(mu=0; mu<4; mu++) {
+      _cm_eq_cm_ti_co(U_, g_gauge_field + _GGI(ix,mu), &co_phase_up[mu]);
+      for(l=0; l<18; l++) gauge_aosoa[_GGI_AOSOA(ix,mu) + l*_AOSOA_BLOCK] = U_[l];
+    }
+  }
+  alloc_spinor_field_aosoa(&phi_aosoa, VOLUMEPLUSRAND);
+  alloc_spinor_field_aosoa(&xi_aosoa, VOLUME);
+#ifdef MPI
+  alloc_spinor_field(&xchange_aos, VOLUMEPLUSRAND);
+#endif
+
+  /* neighbour block in direction (mu, dir) or -1 */
+  nblock = VOLUME / _AOSOA_BLOCK;
+  nb_block_aosoa = (int*)malloc(8*nblock*sizeof(int));
+  for(ib=0; ib<nblock; ib++) {
+    for(mu=0; mu<4; mu++) {
+    for(dir=0; dir<2; dir++) {
+      ix = _AOSOA_BLOCK*ib;
+      iy0 = dir==0 ? g_iup[ix][mu] : g_idn[ix][mu];
+      nb_block_aosoa[8*ib+2*mu+dir] = iy0 % _AOSOA_BLOCK == 0 ? iy0 / _AOSOA_BLOCK : -1;
+      for(l=1; l<_AOSOA_BLOCK; l++) {
+        iy = dir==0 ? g_iup[ix+l][mu] : g_idn[ix+l][mu];
+        if(iy != iy0 + l) nb_block_aosoa[8*ib+2*mu+dir] = -1;
+      }
+    }}
+  }
+
+  /* choose the kernel */
+  kernel_aosoa = hopping_aosoa_scalar;
+#if (defined __GNUC__) && (defined __x86_64__)
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx512f")) {
+    kernel_aosoa = hopping_aosoa_avx512;
+  } else if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    kernel_aosoa = hopping_aosoa_avx2;
+  }
+#endif
+  if(g_cart_id==0) {
+    fprintf(stdout, "# [init_Q_phi_simd] using %s hopping kernel\n",
+        kernel_aosoa == hopping_aosoa_scalar ? "scalar" :
+#if (defined __GNUC__) && (defined __x86_64__)
+        kernel_aosoa == hopping_aosoa_avx2 ? "AVX2" : "AVX-512"
+#else
+        "unknown"
+#endif
+        );
+  }
+  return(0);
+}
+
+void free_Q_phi_simd(void) {
+  if(gauge_aosoa != NULL) { free(gauge_aosoa); gauge_aosoa = NULL; }
+  if(phi_aosoa != NULL) { free(phi_aosoa); phi_aosoa = NULL; }
+  if(xi_aosoa != NULL) { free(xi_aosoa); xi_aosoa = NULL; }
+  if(nb_block_aosoa != NULL) { free(nb_block_aosoa); nb_block_aosoa = NULL; }
+#ifdef MPI
+  if(xchange_aos != NULL) { free(xchange_aos); xchange_aos = NULL; }
+#endif
+  kernel_aosoa = NULL;
+}
+
+/********************
+ * exchange of an AoSoA spinor field
+ * - the boundary sites are copied to an AoS field, which
+ *   is exchanged with xchange_field, the received halo
+ *   is copied back
+ * - needs init_Q_phi_simd
+ ********************/
+void xchange_field_aosoa(double *phi) {
+#ifdef MPI
+  int i, ix, k;
+
+#ifdef OPENMP
+#pragma omp parallel for private(i,ix,k)
+#endif
+  for(i=0; i<g_boundary_volume; i++) {
+    ix = g_boundary2lexic[i];
+    for(k=0; k<24; k++) xchange_aos[_GSI(ix) + k] = phi[_GSI_AOSOA(ix) + k*_AOSOA_BLOCK];
+  }
+
+  xchange_field(xchange_aos);
+
+#ifdef OPENMP
+#pragma omp parallel for private(ix,k)
+#endif
+  for(ix=VOLUME; ix<VOLUMEPLUSRAND; ix++) {
+    for(k=0; k<24; k++) phi[_GSI_AOSOA(ix) + k*_AOSOA_BLOCK] = xchange_aos[_GSI(ix) + k];
+  }
+#endif
+}
+
+/********************
+ * xi = Q phi as in Q_phi_tbc for AoSoA fields
+ * - the halo of phi must be filled
+ ********************/
+void Q_phi_tbc_aosoa(double *xi, double *phi) {
+  int nblock = VOLUME / _AOSOA_BLOCK;
+  double _1_2_kappa = 0.5 / g_kappa;
+#ifdef OPENMP
+  int ithread, nthreads, bstart, bend;
+#pragma omp parallel private(ithread, nthreads, bstart, bend)
+{
+  ithread  = omp_get_thread_num();
+  nthreads = omp_get_num_threads();
+  bstart = ( nblock * ithread ) / nthreads;
+  bend   = ( nblock * (ithread+1) ) / nthreads;
+  kernel_aosoa(xi, phi, gauge_aosoa, nb_block_aosoa, bstart, bend, -0.5, _1_2_kappa, g_mu);
+}
+#else
+  kernel_aosoa(xi, phi, gauge_aosoa, nb_block_aosoa, 0, nblock, -0.5, _1_2_kappa, g_mu);
+#endif
+}
+
+/********************
+ * drop-in replacement of Q_phi_tbc for AoS fields;
+ * falls back to Q_phi_tbc without init_Q_phi_simd
+ * - phi must be exchanged by the calling process
+ * - both fields are converted in every call; for
+ *   repeated application (solvers) use AoSoA fields
+ *   with Q_phi_tbc_aosoa directly
+ ********************/
+void Q_phi_tbc_simd(double *xi, double *phi) {
+  if(kernel_aosoa == NULL) {
+    Q_phi_tbc(xi, phi);
+    return;
+  }
+  spinor_field_aos_to_aosoa(phi_aosoa, phi, VOLUMEPLUSRAND);
+  Q_phi_tbc_aosoa(xi_aosoa, phi_aosoa);
+  spinor_field_aosoa_to_aos(xi, xi_aosoa, VOLUME);
+}
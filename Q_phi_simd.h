@@ -0,0 +1,28 @@
+#ifndef _Q_PHI_SIMD_H
+#define _Q_PHI_SIMD_H
+
+/********************
+ * site-blocked (AoSoA) layout: blocks of _AOSOA_BLOCK
+ * consecutive sites, inside a block the real
+ * components of a field are stored site-fastest,
+ * i.e. component k of site ix is at
+ *   _GSI_AOSOA(ix) + k*_AOSOA_BLOCK   (spinor, k < 24)
+ *   _GGI_AOSOA(ix,mu) + k*_AOSOA_BLOCK (gauge, k < 18)
+ ********************/
+#define _AOSOA_BLOCK 8
+#define _AOSOA_VOLUME(V) ( ( ((V) + _AOSOA_BLOCK - 1) / _AOSOA_BLOCK ) * _AOSOA_BLOCK )
+#define _GSI_AOSOA(ix) ( 24*_AOSOA_BLOCK*((ix)/_AOSOA_BLOCK) + (ix)%_AOSOA_BLOCK )
+#define _GGI_AOSOA(ix,mu) ( 72*_AOSOA_BLOCK*((ix)/_AOSOA_BLOCK) + 18*_AOSOA_BLOCK*(mu) + (ix)%_AOSOA_BLOCK )
+
+int alloc_spinor_field_aosoa(double **s, const int V);
+void spinor_field_aos_to_aosoa(double *s, double *t, const int V);
+void spinor_field_aosoa_to_aos(double *s, double *t, const int V);
+void gauge_field_aos_to_aosoa(double *s, double *t, const int V);
+
+int init_Q_phi_simd(void);
+void free_Q_phi_simd(void);
+void xchange_field_aosoa(double *phi);
+
+void Q_phi_tbc_aosoa(double *xi, double *phi);
+void Q_phi_tbc_simd(double *xi, double *phi);
+#endif
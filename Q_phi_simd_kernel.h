@@ -0,0 +1,147 @@
+/********************
+ * Q_phi_simd_kernel.h
+ *
+ * hopping kernel on AoSoA fields, included by Q_phi_simd.c
+ * once per instruction set with
+ *
+ *   _KERNEL_NAME, _KERNEL_ATTR, _NLANE, _VT,
+ *   _VLD(p), _VST(p,v), _VSET1(x), _VADD(a,b), _VMUL(a,b),
+ *   _VFMA(a,b,c) = a*b+c, _VFNMA(a,b,c) = c-a*b
+ *
+ * - _NLANE sites of a block at once, one per vector lane
+ * - spin projection: (1 -/+ gamma_mu) phi is
+ *   reconstructed from its upper two spin components,
+ *   only these are transported with U
+ * - xi = ca * hopping(phi) + cb * phi + i cmu gamma_5 phi
+ ********************/
+
+_KERNEL_ATTR static void _KERNEL_NAME(double *xi, double *phi, double *gauge, int *nb_block,
+    int block_start, int block_end, double ca, double cb, double cmu) {
+
+  int ib, il, l, k, c, i, j, mu, dir, ix, iy, nbb, stride_p, stride_u, s, hs;
+  double *p_, *u_;
+  double buf_phi[24*_NLANE] __attribute__((aligned(64)));
+  double buf_u[18*_NLANE] __attribute__((aligned(64)));
+  _VT acc[24], h[12], chi[12], f0, f1, ur, ui, va, vb, vc;
+
+#define _P(k) _VLD(p_ + (k)*stride_p)
+#define _U(k) _VLD(u_ + (k)*stride_u)
+
+  for(ib=block_start; ib<block_end; ib++) {
+  for(il=0; il<_AOSOA_BLOCK; il+=_NLANE) {
+
+    for(k=0; k<24; k++) acc[k] = _VSET1(0.);
+
+    for(mu=0; mu<4; mu++) {
+    for(dir=0; dir<2; dir++) {
+      /* dir = 0: (1 - gamma_mu) U_mu(x) phi(x+mu),
+       * dir = 1: (1 + gamma_mu) U_mu(x-mu)^+ phi(x-mu) */
+      s = 2*dir - 1;
+      nbb = nb_block[8*ib + 2*mu + dir];
+
+      if(nbb >= 0) {
+        p_ = phi + _GSI_AOSOA(_AOSOA_BLOCK*nbb) + il;
+        stride_p = _AOSOA_BLOCK;
+      } else {
+        for(l=0; l<_NLANE; l++) {
+          ix = _AOSOA_BLOCK*ib + il + l;
+          iy = dir==0 ? g_iup[ix][mu] : g_idn[ix][mu];
+          for(k=0; k<24; k++) buf_phi[k*_NLANE+l] = phi[_GSI_AOSOA(iy) + k*_AOSOA_BLOCK];
+          if(dir==1) {
+            for(k=0; k<18; k++) buf_u[k*_NLANE+l] = gauge[_GGI_AOSOA(iy,mu) + k*_AOSOA_BLOCK];
+          }
+        }
+        p_ = buf_phi;
+        stride_p = _NLANE;
+      }
+      if(dir==0) {
+        u_ = gauge + _GGI_AOSOA(_AOSOA_BLOCK*ib, mu) + il;
+        stride_u = _AOSOA_BLOCK;
+      } else if(nbb >= 0) {
+        u_ = gauge + _GGI_AOSOA(_AOSOA_BLOCK*nbb, mu) + il;
+        stride_u = _AOSOA_BLOCK;
+      } else {
+        u_ = buf_u;
+        stride_u = _NLANE;
+      }
+
+      /* half spinor h_a = phi_a + f_a phi_{q_a}, a = 0,1 */
+      f0 = _VSET1( (double)(s*proj_sign[mu][0]) );
+      f1 = _VSET1( (double)(s*proj_sign[mu][1]) );
+      for(c=0; c<3; c++) {
+        if(proj_imag[mu]) {
+          h[  2*c  ] = _VFNMA(f0, _P(6*proj_spin[mu][0]+2*c+1), _P(  2*c  ));
+          h[  2*c+1] = _VFMA (f0, _P(6*proj_spin[mu][0]+2*c  ), _P(  2*c+1));
+          h[6+2*c  ] = _VFNMA(f1, _P(6*proj_spin[mu][1]+2*c+1), _P(6+2*c  ));
+          h[6+2*c+1] = _VFMA (f1, _P(6*proj_spin[mu][1]+2*c  ), _P(6+2*c+1));
+        } else {
+          h[  2*c  ] = _VFMA (f0, _P(6*proj_spin[mu][0]+2*c  ), _P(  2*c  ));
+          h[  2*c+1] = _VFMA (f0, _P(6*proj_spin[mu][0]+2*c+1), _P(  2*c+1));
+          h[6+2*c  ] = _VFMA (f1, _P(6*proj_spin[mu][1]+2*c  ), _P(6+2*c  ));
+          h[6+2*c+1] = _VFMA (f1, _P(6*proj_spin[mu][1]+2*c+1), _P(6+2*c+1));
+        }
+      }
+
+      /* chi = U h (dir = 0) or chi = U^+ h (dir = 1) */
+      for(k=0; k<12; k++) chi[k] = _VSET1(0.);
+      for(i=0; i<3; i++) {
+      for(j=0; j<3; j++) {
+        ur = _U(2*(3*i+j)  );
+        ui = _U(2*(3*i+j)+1);
+        for(hs=0; hs<2; hs++) {
+          if(dir==0) {
+            /* chi_i += U_ij h_j */
+            chi[6*hs+2*i  ] = _VFMA (ur, h[6*hs+2*j  ], chi[6*hs+2*i  ]);
+            chi[6*hs+2*i  ] = _VFNMA(ui, h[6*hs+2*j+1], chi[6*hs+2*i  ]);
+            chi[6*hs+2*i+1] = _VFMA (ur, h[6*hs+2*j+1], chi[6*hs+2*i+1]);
+            chi[6*hs+2*i+1] = _VFMA (ui, h[6*hs+2*j  ], chi[6*hs+2*i+1]);
+          } else {
+            /* chi_j += conj(U_ij) h_i */
+            chi[6*hs+2*j  ] = _VFMA (ur, h[6*hs+2*i  ], chi[6*hs+2*j  ]);
+            chi[6*hs+2*j  ] = _VFMA (ui, h[6*hs+2*i+1], chi[6*hs+2*j  ]);
+            chi[6*hs+2*j+1] = _VFMA (ur, h[6*hs+2*i+1], chi[6*hs+2*j+1]);
+            chi[6*hs+2*j+1] = _VFNMA(ui, h[6*hs+2*i  ], chi[6*hs+2*j+1]);
+          }
+        }
+      }}
+
+      /* reconstruct: spin 0,1 = chi_0,1; spin 2,3 = g_a chi_{r_a} */
+      f0 = _VSET1( (double)(s*rec_sign[mu][0]) );
+      f1 = _VSET1( (double)(s*rec_sign[mu][1]) );
+      for(k=0; k<12; k++) acc[k] = _VADD(acc[k], chi[k]);
+      for(c=0; c<3; c++) {
+        if(proj_imag[mu]) {
+          acc[12+2*c  ] = _VFNMA(f0, chi[6*rec_spin[mu][0]+2*c+1], acc[12+2*c  ]);
+          acc[12+2*c+1] = _VFMA (f0, chi[6*rec_spin[mu][0]+2*c  ], acc[12+2*c+1]);
+          acc[18+2*c  ] = _VFNMA(f1, chi[6*rec_spin[mu][1]+2*c+1], acc[18+2*c  ]);
+          acc[18+2*c+1] = _VFMA (f1, chi[6*rec_spin[mu][1]+2*c  ], acc[18+2*c+1]);
+        } else {
+          acc[12+2*c  ] = _VFMA (f0, chi[6*rec_spin[mu][0]+2*c  ], acc[12+2*c  ]);
+          acc[12+2*c+1] = _VFMA (f0, chi[6*rec_spin[mu][0]+2*c+1], acc[12+2*c+1]);
+          acc[18+2*c  ] = _VFMA (f1, chi[6*rec_spin[mu][1]+2*c  ], acc[18+2*c  ]);
+          acc[18+2*c+1] = _VFMA (f1, chi[6*rec_spin[mu][1]+2*c+1], acc[18+2*c+1]);
+        }
+      }
+    }}  /* of mu, dir */
+
+    /* xi = ca acc + cb phi + i cmu gamma_5 phi */
+    p_ = phi + _GSI_AOSOA(_AOSOA_BLOCK*ib) + il;
+    stride_p = _AOSOA_BLOCK;
+    va = _VSET1(ca);
+    vb = _VSET1(cb);
+    for(k=0; k<24; k+=2) {
+      vc = _VSET1( k<12 ? cmu : -cmu );
+      ur = _VMUL(va, acc[k  ]);
+      ui = _VMUL(va, acc[k+1]);
+      ur = _VFMA (vb, _P(k  ), ur);
+      ui = _VFMA (vb, _P(k+1), ui);
+      ur = _VFNMA(vc, _P(k+1), ur);
+      ui = _VFMA (vc, _P(k  ), ui);
+      _VST(xi + _GSI_AOSOA(_AOSOA_BLOCK*ib) + il + (k  )*_AOSOA_BLOCK, ur);
+      _VST(xi + _GSI_AOSOA(_AOSOA_BLOCK*ib) + il + (k+1)*_AOSOA_BLOCK, ui);
+    }
+  }}  /* of ib, il */
+
+#undef _P
+#undef _U
+}
@@ -339,6 +339,9 @@ int main(int argc, char **argv) {
   ratime = (double)clock() / CLOCKS_PER_SEC;
 #endif
   init_trace_coeff(&tcf, &tcb, &loop_tab, 5, &nloop);
+#ifdef OPENMP
+#pragma omp parallel for private(mu)
+#endif
   for(ix=0; ix<VOLUME; ix++) {
     for(mu=0; mu<4; mu++) {
 /*
@@ -33,6 +33,7 @@
 #include "io.h"
 #include "propagator_io.h"
 #include "contractions_io.h"
+#include "spinor_prefetch.h"
 #include "Q_phi.h"
 #include "read_input_parser.h"
 
@@ -42,9 +43,30 @@ void usage() {
   fprintf(stdout, "Options: -v verbose\n");
   fprintf(stdout, "         -g apply a random gauge transformation\n");
   fprintf(stdout, "         -f input filename [default cvc.input]\n");
+  fprintf(stdout, "         -p number of propagator sets to read ahead [default 1, 0 = no prefetch]\n");
   EXIT(0);
 }
 
+/***********************************************************
+ * file name and record position of propagator ia
+ * with source index nu (4 = no shift), up = 1 / -1 for
+ * up- / dn-type, as read in the loops below
+ ***********************************************************/
+static int propagator_filename(char *filename, int nu, int ia, int up, int mms, int mass_id,
+    int up_dn_onefile, int use_shifted_spinor) {
+  if(mms) {
+    sprintf(filename, "%s.%.4d.%.2d.%.2d.cgmms.%.2d.inverted", filename_prefix, Nconf, nu, ia, mass_id);
+    return(0);
+  }
+  if(use_shifted_spinor) nu = 4;
+  if(up_dn_onefile) {
+    get_filename(filename, nu, ia, 1);
+    return(up == 1 ? 0 : 1);
+  }
+  get_filename(filename, nu, ia, up);
+  return(0);
+}
+
 
 int main(int argc, char **argv) {
   
@@ -81,6 +103,12 @@ int main(int argc, char **argv) {
   double Usourcebuff[72], *Usource[4];
   FILE *ofs;
   int use_shifted_spinor = 0, shift_vector[4];
+  int prefetch_nbuf = 1, prefetch_position[120];
+  char *prefetch_filename[120];
+  spinor_prefetch prefetch;
+#if (defined MPI) && (defined HAVE_PTHREAD)
+  int mpi_thread_provided;
+#endif
 
   fftw_complex *in=(fftw_complex*)NULL;
 
@@ -91,11 +119,14 @@ int main(int argc, char **argv) {
   fftwnd_plan plan_p;
 #endif
 
-#ifdef MPI
+#if (defined MPI) && (defined HAVE_PTHREAD)
+  /* the prefetch I/O thread makes no MPI calls */
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &mpi_thread_provided);
+#elif (defined MPI)
   MPI_Init(&argc, &argv);
 #endif
 
-  while ((c = getopt(argc, argv, "cuwWah?vgf:t:m:o:")) != -1) {
+  while ((c = getopt(argc, argv, "cuwWah?vgf:t:m:o:p:")) != -1) {
     switch (c) {
     case 'v':
       verbose = 1;
@@ -141,6 +172,10 @@ int main(int argc, char **argv) {
       use_shifted_spinor = 1;
       fprintf(stdout, "# [avc_exact2] will use shifted free spinor fields\n");
       break;
+    case 'p':
+      prefetch_nbuf = atoi(optarg);
+      fprintf(stdout, "# [avc_exact2] will read ahead %d propagator set(s)\n", prefetch_nbuf);
+      break;
     case 'h':
     case '?':
     default:
@@ -176,6 +211,12 @@ int main(int argc, char **argv) {
 
   /* initialize MPI parameters */
   mpi_init(argc, argv);
+#if (defined MPI) && (defined HAVE_PTHREAD)
+  if(mpi_thread_provided < MPI_THREAD_FUNNELED) {
+    if(g_cart_id==0) fprintf(stdout, "# [avc_exact2] MPI provides thread level %d only, no prefetch\n", mpi_thread_provided);
+    prefetch_nbuf = 0;
+  }
+#endif
 #ifdef MPI
   if((status = (int*)calloc(g_nproc, sizeof(int))) == (int*)NULL) {
     EXIT(7);
@@ -378,6 +419,26 @@ int main(int argc, char **argv) {
   }
 
 
+  /**********************************************************
+   * queue all propagator reads for the prefetch, in the
+   * order of the loops below: up-type from source_location,
+   * dn-type for nu=0,...,3, dn-type from source_location,
+   * up-type for nu=0,...,3
+   **********************************************************/
+  for(i=0; i<120; i++) {
+    j  = i / 12;
+    ia = i % 12;
+    if((prefetch_filename[i] = (char*)malloc(200*sizeof(char))) == NULL) EXIT(5);
+    if(j == 0)      prefetch_position[i] = propagator_filename(prefetch_filename[i], 4,   ia,  1, mms, mass_id, up_dn_onefile, use_shifted_spinor);
+    else if(j < 5)  prefetch_position[i] = propagator_filename(prefetch_filename[i], j-1, ia, -1, mms, mass_id, up_dn_onefile, use_shifted_spinor);
+    else if(j == 5) prefetch_position[i] = propagator_filename(prefetch_filename[i], 4,   ia, -1, mms, mass_id, up_dn_onefile, use_shifted_spinor);
+    else            prefetch_position[i] = propagator_filename(prefetch_filename[i], j-6, ia,  1, mms, mass_id, up_dn_onefile, use_shifted_spinor);
+  }
+  if(init_spinor_prefetch(&prefetch, prefetch_nbuf, 10, 12, prefetch_filename, prefetch_position) != 0) {
+    EXIT_WITH_MSG(6, "[avc_exact2] Error from init_spinor_prefetch\n");
+  }
+  for(i=0; i<120; i++) free(prefetch_filename[i]);
+
   /**********************************************************
    * read 12 up-type propagators with source source_location
    * - can get contributions 1 and 3 from that
@@ -386,15 +447,15 @@ int main(int argc, char **argv) {
     if(!mms) {
       if(!up_dn_onefile) {
         get_filename(filename, 4, ia, 1);
-        exitstatus = read_lime_spinor(g_spinor_field[ia], filename, 0);
+        exitstatus = spinor_prefetch_read(&prefetch, g_spinor_field[ia], filename, 0);
       } else {
         get_filename(filename, 4, ia, 1);
-        exitstatus = read_lime_spinor(g_spinor_field[ia], filename, 0);
+        exitstatus = spinor_prefetch_read(&prefetch, g_spinor_field[ia], filename, 0);
       }
       xchange_field(g_spinor_field[ia]);
     } else {
       sprintf(filename, "%s.%.4d.04.%.2d.cgmms.%.2d.inverted", filename_prefix, Nconf, ia, mass_id);
-      exitstatus = read_lime_spinor(work, filename, 0);
+      exitstatus = spinor_prefetch_read(&prefetch, work, filename, 0);
       xchange_field(work);
       Qf5(g_spinor_field[ia], work, -g_mu);
       xchange_field(g_spinor_field[ia]);
@@ -422,26 +483,26 @@ int main(int argc, char **argv) {
         if(!up_dn_onefile) {
           if(!use_shifted_spinor) {
             get_filename(filename, nu, ia, -1);
-            exitstatus = read_lime_spinor(g_spinor_field[12+ia], filename, 0);
+            exitstatus = spinor_prefetch_read(&prefetch, g_spinor_field[12+ia], filename, 0);
           } else {
             get_filename(filename, 4, ia, -1);
-            exitstatus = read_lime_spinor(work, filename, 0);
+            exitstatus = spinor_prefetch_read(&prefetch, work, filename, 0);
             shift_spinor_field(g_spinor_field[12+ia], work, shift_vector);
           }
         } else {
           if(!use_shifted_spinor) {
             get_filename(filename, nu, ia, 1);
-            exitstatus = read_lime_spinor(g_spinor_field[12+ia], filename, 1);
+            exitstatus = spinor_prefetch_read(&prefetch, g_spinor_field[12+ia], filename, 1);
           } else {
             get_filename(filename, 4, ia, 1);
-            exitstatus = read_lime_spinor(work, filename, 1);
+            exitstatus = spinor_prefetch_read(&prefetch, work, filename, 1);
             shift_spinor_field(g_spinor_field[12+ia], work, shift_vector);
           }
         }
         xchange_field(g_spinor_field[12+ia]);
       } else {
         sprintf(filename, "%s.%.4d.%.2d.%.2d.cgmms.%.2d.inverted", filename_prefix, Nconf, nu, ia, mass_id);
-        exitstatus = read_lime_spinor(work, filename, 0);
+        exitstatus = spinor_prefetch_read(&prefetch, work, filename, 0);
         xchange_field(work);
         Qf5(g_spinor_field[12+ia], work, g_mu);
         xchange_field(g_spinor_field[12+ia]);
@@ -595,15 +656,15 @@ int main(int argc, char **argv) {
     if(!mms) {
       if(!up_dn_onefile) {
         get_filename(filename, 4, ia, -1);
-        exitstatus = read_lime_spinor(g_spinor_field[12+ia], filename, 0);
+        exitstatus = spinor_prefetch_read(&prefetch, g_spinor_field[12+ia], filename, 0);
       } else {
         get_filename(filename, 4, ia, 1);
-        exitstatus = read_lime_spinor(g_spinor_field[12+ia], filename, 1);
+        exitstatus = spinor_prefetch_read(&prefetch, g_spinor_field[12+ia], filename, 1);
       }
       xchange_field(g_spinor_field[12+ia]);
     } else {
       sprintf(filename, "%s.%.4d.04.%.2d.cgmms.%.2d.inverted", filename_prefix, Nconf, ia, mass_id);
-      exitstatus = read_lime_spinor(work, filename, 0);
+      exitstatus = spinor_prefetch_read(&prefetch, work, filename, 0);
       xchange_field(work);
       Qf5(g_spinor_field[12+ia], work, g_mu);
       xchange_field(g_spinor_field[12+ia]);
@@ -629,26 +690,26 @@ int main(int argc, char **argv) {
       if(!up_dn_onefile) {
         if(!use_shifted_spinor) {
           get_filename(filename, nu, ia, 1);
-          exitstatus = read_lime_spinor(g_spinor_field[ia], filename, 0);
+          exitstatus = spinor_prefetch_read(&prefetch, g_spinor_field[ia], filename, 0);
         } else {
           get_filename(filename, 4, ia, 1);
-          exitstatus = read_lime_spinor(work, filename, 0);
+          exitstatus = spinor_prefetch_read(&prefetch, work, filename, 0);
           shift_spinor_field(g_spinor_field[ia], work, shift_vector);
         }
       } else {
         if(!use_shifted_spinor) {
           get_filename(filename, nu, ia, 1);
-          exitstatus = read_lime_spinor(g_spinor_field[ia], filename, 0);
+          exitstatus = spinor_prefetch_read(&prefetch, g_spinor_field[ia], filename, 0);
         } else {
           get_filename(filename, 4, ia, 1);
-          exitstatus = read_lime_spinor(work, filename, 0);
+          exitstatus = spinor_prefetch_read(&prefetch, work, filename, 0);
           shift_spinor_field(g_spinor_field[ia], work, shift_vector);
         }
       }
         xchange_field(g_spinor_field[ia]);
       } else {
         sprintf(filename, "%s.%.4d.%.2d.%.2d.cgmms.%.2d.inverted", filename_prefix, Nconf, nu, ia, mass_id);
-        exitstatus = read_lime_spinor(work, filename, 0);
+        exitstatus = spinor_prefetch_read(&prefetch, work, filename, 0);
         xchange_field(work);
         Qf5(g_spinor_field[ia], work, -g_mu);
         xchange_field(g_spinor_field[ia]);
@@ -785,6 +846,8 @@ int main(int argc, char **argv) {
 
 
 
+  fini_spinor_prefetch(&prefetch);
+
   // print contact term
   if(g_cart_id==0) {
     fprintf(stdout, "\n# [avc_exact2] contact term\n");
@@ -0,0 +1,302 @@
+/****************************************************
+ * check_Q_phi_simd.c
+ *
+ * PURPOSE:
+ * - check the vectorized tm operator on AoSoA fields
+ *   (Q_phi_simd.c) against Q_phi_tbc
+ * - random source; compares the drop-in Q_phi_tbc_simd,
+ *   Q_phi_tbc_aosoa with xchange_field_aosoa and the
+ *   true residuum of the AoSoA BiCGStab invert_Qtm_simd
+ * - gauge field from file, "identity" or "random"
+ *   (gaugefilename_prefix)
+ * TODO:
+ * DONE:
+ * CHANGES:
+ ****************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#include <getopt.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+#define MAIN_PROGRAM
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "cvc_complex.h"
+#include "cvc_linalg.h"
+#include "global.h"
+#include "cvc_geometry.h"
+#include "cvc_utils.h"
+#include "mpi_init.h"
+#include "io.h"
+#include "propagator_io.h"
+#include "Q_phi.h"
+#include "Q_phi_simd.h"
+#include "read_input_parser.h"
+#include "invert_Qtm.h"
+#include "gauge_io.h"
+#include "ranlxd.h"
+#ifdef __cplusplus
+}
+#endif
+
+void usage() {
+  fprintf(stdout, "Code to check the SIMD tm operator against Q_phi_tbc\n");
+  fprintf(stdout, "Usage:    [options]\n");
+  fprintf(stdout, "Options: -v verbose\n");
+  fprintf(stdout, "         -f input filename [default cvc.input]\n");
+  fprintf(stdout, "         -t number of threads [default 1]\n");
+#ifdef MPI
+  MPI_Abort(MPI_COMM_WORLD, 1);
+  MPI_Finalize();
+#endif
+  exit(0);
+}
+
+/***********************************************
+ * relative squared difference of g_spinor_field[2]
+ * to the reference in g_spinor_field[1]
+ ***********************************************/
+static double relative_difference(void) {
+  unsigned int ix;
+  double norm, norm2;
+
+  spinor_scalar_product_re(&norm2, g_spinor_field[1], g_spinor_field[1], VOLUME);
+  for(ix=0;ix<VOLUME;ix++) {
+    _fv_mi_eq_fv(g_spinor_field[2]+_GSI(ix), g_spinor_field[1]+_GSI(ix));
+  }
+  spinor_scalar_product_re(&norm, g_spinor_field[2], g_spinor_field[2], VOLUME);
+  return(norm/norm2);
+}
+
+int main(int argc, char **argv) {
+
+  int c, i, mu, status=0;
+  int filename_set = 0;
+  int ix, niter;
+  int num_threads = 1;
+  int exit_status = 0;
+  char filename[200];
+  double ratime, retime;
+  double plaq_m=0., norm, norm_src, diff_simd, diff_aosoa;
+  double *phi_aosoa=NULL, *xi_aosoa=NULL;
+  /* squared relative difference allowed for rounding */
+  const double eps = 1.e-24;
+
+#ifdef MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  while ((c = getopt(argc, argv, "h?vf:t:")) != -1) {
+    switch (c) {
+    case 'v':
+      g_verbose = 1;
+      break;
+    case 't':
+      num_threads = atoi(optarg);
+      fprintf(stdout, "\n# [check_Q_phi_simd] will use %d threads in spacetime loops\n", num_threads);
+      break;
+    case 'f':
+      strcpy(filename, optarg);
+      filename_set=1;
+      break;
+    case 'h':
+    case '?':
+    default:
+      usage();
+      break;
+    }
+  }
+
+  // get the time stamp
+  g_the_time = time(NULL);
+
+  /*********************************
+   * set number of openmp threads
+   *********************************/
+#ifdef OPENMP
+  omp_set_num_threads(num_threads);
+#endif
+
+  /**************************************
+   * set the default values, read input
+   **************************************/
+  if(filename_set==0) strcpy(filename, "cvc.input");
+  if(g_proc_id==0) fprintf(stdout, "# Reading input from file %s\n", filename);
+  read_input_parser(filename);
+
+  /* some checks on the input data */
+  if((T_global == 0) || (LX==0) || (LY==0) || (LZ==0)) {
+    if(g_proc_id==0) fprintf(stderr, "[check_Q_phi_simd] Error, T and L's must be set\n");
+    usage();
+  }
+  if(g_kappa == 0.) {
+    if(g_proc_id==0) fprintf(stderr, "[check_Q_phi_simd] Error, kappa should be > 0.\n");
+    usage();
+  }
+
+  // initialize MPI parameters
+  mpi_init(argc, argv);
+
+#ifdef MPI
+  if(T==0) {
+    fprintf(stderr, "[%2d] local T is zero; exit\n", g_cart_id);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(2);
+  }
+#endif
+
+  if(init_geometry() != 0) {
+    fprintf(stderr, "ERROR from init_geometry\n");
+#ifdef MPI
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+#endif
+    exit(1);
+  }
+
+  geometry();
+
+  rlxd_init(2, g_seed + g_cart_id);
+
+  /**************************************
+   * prepare the gauge field
+   **************************************/
+  alloc_gauge_field(&g_gauge_field, VOLUMEPLUSRAND);
+  if(strcmp( gaugefilename_prefix, "identity")==0 ) {
+    if(g_cart_id==0) fprintf(stdout, "# [check_Q_phi_simd] Setting up unit gauge field\n");
+    for(ix=0;ix<VOLUME; ix++) {
+      for(mu=0;mu<4;mu++) {
+        _cm_eq_id(g_gauge_field+_GGI(ix,mu));
+      }
+    }
+  } else if(strcmp( gaugefilename_prefix, "random")==0 ) {
+    if(g_cart_id==0) fprintf(stdout, "# [check_Q_phi_simd] Setting up random gauge field\n");
+    random_gauge_field(g_gauge_field, 1.);
+  } else {
+    sprintf(filename, "%s.%.4d", gaugefilename_prefix, Nconf);
+    if(g_cart_id==0) fprintf(stdout, "# Reading gauge field from file %s\n", filename);
+    status = read_lime_gauge_field_doubleprec(filename);
+    if(status != 0) {
+      fprintf(stderr, "[check_Q_phi_simd] Error, could not read gauge field");
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 12);
+      MPI_Finalize();
+#endif
+      exit(12);
+    }
+  }
+#ifdef MPI
+  xchange_gauge();
+#endif
+
+  /* measure the plaquette */
+  plaquette(&plaq_m);
+  if(g_cart_id==0) fprintf(stdout, "# Measured plaquette value: %25.16e\n", plaq_m);
+
+  /* allocate memory for the spinor fields:
+   * source, reference, SIMD result, solution and 1 work field */
+  no_fields = 5;
+  g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
+  for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOLUMEPLUSRAND);
+
+  /***********************************************
+   * random source, reference Q_phi_tbc
+   ***********************************************/
+  rangauss(g_spinor_field[0], 24*VOLUME);
+  xchange_field(g_spinor_field[0]);
+  Q_phi_tbc(g_spinor_field[1], g_spinor_field[0]);
+
+  if(init_Q_phi_simd() != 0) {
+    fprintf(stderr, "[check_Q_phi_simd] Error from init_Q_phi_simd\n");
+#ifdef MPI
+    MPI_Abort(MPI_COMM_WORLD, 13);
+    MPI_Finalize();
+#endif
+    exit(13);
+  }
+
+  /***********************************************
+   * drop-in version on AoS fields
+   ***********************************************/
+  Q_phi_tbc_simd(g_spinor_field[2], g_spinor_field[0]);
+  diff_simd = relative_difference();
+
+  /***********************************************
+   * AoSoA fields, halo from xchange_field_aosoa
+   ***********************************************/
+  alloc_spinor_field_aosoa(&phi_aosoa, VOLUMEPLUSRAND);
+  alloc_spinor_field_aosoa(&xi_aosoa, VOLUME);
+  spinor_field_aos_to_aosoa(phi_aosoa, g_spinor_field[0], VOLUME);
+  xchange_field_aosoa(phi_aosoa);
+  Q_phi_tbc_aosoa(xi_aosoa, phi_aosoa);
+  spinor_field_aosoa_to_aos(g_spinor_field[2], xi_aosoa, VOLUME);
+  diff_aosoa = relative_difference();
+  free(phi_aosoa);
+  free(xi_aosoa);
+  free_Q_phi_simd();
+
+  if(g_cart_id==0) {
+    fprintf(stdout, "\n# [check_Q_phi_simd] Q_phi_tbc_simd  relative difference squared = %e\n", diff_simd);
+    fprintf(stdout, "# [check_Q_phi_simd] Q_phi_tbc_aosoa relative difference squared = %e\n", diff_aosoa);
+  }
+  if(diff_simd > eps || diff_aosoa > eps) {
+    if(g_cart_id==0) fprintf(stderr, "[check_Q_phi_simd] Error, SIMD operator differs from Q_phi_tbc\n");
+    exit_status = 1;
+  }
+
+  /***********************************************
+   * AoSoA BiCGStab, true residuum with Q_phi_tbc
+   ***********************************************/
+  for(ix=0;ix<VOLUMEPLUSRAND;ix++) { _fv_eq_zero( g_spinor_field[3]+_GSI(ix) ); }
+  ratime = (double)clock() / CLOCKS_PER_SEC;
+  niter = invert_Qtm_simd(g_spinor_field[3], g_spinor_field[0], 4);
+  retime = (double)clock() / CLOCKS_PER_SEC;
+
+  Q_phi_tbc(g_spinor_field[4], g_spinor_field[3]);
+  for(ix=0;ix<VOLUME;ix++) {
+    _fv_mi_eq_fv(g_spinor_field[4]+_GSI(ix), g_spinor_field[0]+_GSI(ix));
+  }
+  spinor_scalar_product_re(&norm, g_spinor_field[4], g_spinor_field[4], VOLUME);
+  spinor_scalar_product_re(&norm_src, g_spinor_field[0], g_spinor_field[0], VOLUME);
+  if(g_cart_id==0) {
+    fprintf(stdout, "\n# [check_Q_phi_simd] invert_Qtm_simd: niter = %d, time = %e seconds, true relative residuum squared = %e\n\n",
+        niter, retime-ratime, norm/norm_src);
+  }
+  if(niter < 0 || norm/norm_src > 10.*solver_precision) {
+    if(g_cart_id==0) fprintf(stderr, "[check_Q_phi_simd] Error, residuum check of invert_Qtm_simd failed\n");
+    exit_status = 1;
+  }
+
+  /***********************************************
+   * free the allocated memory, finalize
+   ***********************************************/
+
+  free(g_gauge_field);
+  for(i=0; i<no_fields; i++) free(g_spinor_field[i]);
+  free(g_spinor_field);
+  free_geometry();
+
+#ifdef MPI
+  MPI_Finalize();
+#endif
+
+  if(g_cart_id==0) {
+    g_the_time = time(NULL);
+    fprintf(stdout, "\n# [check_Q_phi_simd] %s# [check_Q_phi_simd] end of run\n", ctime(&g_the_time));
+    fprintf(stderr, "\n# [check_Q_phi_simd] %s# [check_Q_phi_simd] end of run\n", ctime(&g_the_time));
+  }
+
+  return(exit_status);
+}
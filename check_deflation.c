@@ -0,0 +1,299 @@
+/****************************************************
+ * check_deflation.c
+ *
+ * PURPOSE:
+ * - round trip of the eigenvector cache of deflation.c
+ * - init_deflation computes the eigenspace of the tm
+ *   operator and writes <deflation_filename_prefix>.<Nconf>
+ *   (with propagator_codec, if set); every eigenvector is
+ *   read back with read_lime_spinor and compared
+ * - a second init_deflation must take the eigenspace
+ *   from the cache; the recomputed Rayleigh quotients
+ *   are compared with the eigenvalues of the first call
+ * - gauge field from file, "identity" or "random"
+ *   (gaugefilename_prefix)
+ * TODO:
+ * DONE:
+ * CHANGES:
+ ****************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#include <getopt.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+#define MAIN_PROGRAM
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "cvc_complex.h"
+#include "cvc_linalg.h"
+#include "global.h"
+#include "cvc_geometry.h"
+#include "cvc_utils.h"
+#include "mpi_init.h"
+#include "io.h"
+#include "propagator_io.h"
+#include "spinor_codec.h"
+#include "Q_phi.h"
+#include "read_input_parser.h"
+#include "invert_Qtm.h"
+#include "deflation.h"
+#include "gauge_io.h"
+#include "ranlxd.h"
+#ifdef __cplusplus
+}
+#endif
+
+void usage() {
+  fprintf(stdout, "Code to check the write / read round trip of the deflation eigenvector cache\n");
+  fprintf(stdout, "Usage:    [options]\n");
+  fprintf(stdout, "Options: -v verbose\n");
+  fprintf(stdout, "         -f input filename [default cvc.input]\n");
+  fprintf(stdout, "         -t number of threads [default 1]\n");
+#ifdef MPI
+  MPI_Abort(MPI_COMM_WORLD, 1);
+  MPI_Finalize();
+#endif
+  exit(0);
+}
+
+int main(int argc, char **argv) {
+
+  int c, i, mu, status=0;
+  int filename_set = 0;
+  int ix, nev, nev_read;
+  int num_threads = 1;
+  int exit_status = 0;
+  char filename[200];
+  double plaq_m=0., norm, diff_max=0., lambda_diff_max=0.;
+  double **v=NULL, *lambda=NULL, *lambda_ref=NULL;
+  /* squared relative difference allowed for the codec */
+  double eps;
+
+#ifdef MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  while ((c = getopt(argc, argv, "h?vf:t:")) != -1) {
+    switch (c) {
+    case 'v':
+      g_verbose = 1;
+      break;
+    case 't':
+      num_threads = atoi(optarg);
+      fprintf(stdout, "\n# [check_deflation] will use %d threads in spacetime loops\n", num_threads);
+      break;
+    case 'f':
+      strcpy(filename, optarg);
+      filename_set=1;
+      break;
+    case 'h':
+    case '?':
+    default:
+      usage();
+      break;
+    }
+  }
+
+  // get the time stamp
+  g_the_time = time(NULL);
+
+  /*********************************
+   * set number of openmp threads
+   *********************************/
+#ifdef OPENMP
+  omp_set_num_threads(num_threads);
+#endif
+
+  /**************************************
+   * set the default values, read input
+   **************************************/
+  if(filename_set==0) strcpy(filename, "cvc.input");
+  if(g_proc_id==0) fprintf(stdout, "# Reading input from file %s\n", filename);
+  read_input_parser(filename);
+
+  /* some checks on the input data */
+  if((T_global == 0) || (LX==0) || (LY==0) || (LZ==0)) {
+    if(g_proc_id==0) fprintf(stderr, "[check_deflation] Error, T and L's must be set\n");
+    usage();
+  }
+  if(g_kappa == 0.) {
+    if(g_proc_id==0) fprintf(stderr, "[check_deflation] Error, kappa should be > 0.\n");
+    usage();
+  }
+  if(g_deflation_nev <= 0 || strcmp(g_deflation_filename_prefix, "none") == 0) {
+    if(g_proc_id==0) fprintf(stderr, "[check_deflation] Error, deflation_nev and deflation_filename_prefix must be set\n");
+    usage();
+  }
+
+  // initialize MPI parameters
+  mpi_init(argc, argv);
+
+#ifdef MPI
+  if(T==0) {
+    fprintf(stderr, "[%2d] local T is zero; exit\n", g_cart_id);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(2);
+  }
+#endif
+
+  if(init_geometry() != 0) {
+    fprintf(stderr, "ERROR from init_geometry\n");
+#ifdef MPI
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+#endif
+    exit(1);
+  }
+
+  geometry();
+
+  rlxd_init(2, g_seed + g_cart_id);
+
+  /**************************************
+   * prepare the gauge field
+   **************************************/
+  alloc_gauge_field(&g_gauge_field, VOLUMEPLUSRAND);
+  if(strcmp( gaugefilename_prefix, "identity")==0 ) {
+    if(g_cart_id==0) fprintf(stdout, "# [check_deflation] Setting up unit gauge field\n");
+    for(ix=0;ix<VOLUME; ix++) {
+      for(mu=0;mu<4;mu++) {
+        _cm_eq_id(g_gauge_field+_GGI(ix,mu));
+      }
+    }
+  } else if(strcmp( gaugefilename_prefix, "random")==0 ) {
+    if(g_cart_id==0) fprintf(stdout, "# [check_deflation] Setting up random gauge field\n");
+    random_gauge_field(g_gauge_field, 1.);
+  } else {
+    sprintf(filename, "%s.%.4d", gaugefilename_prefix, Nconf);
+    if(g_cart_id==0) fprintf(stdout, "# Reading gauge field from file %s\n", filename);
+    status = read_lime_gauge_field_doubleprec(filename);
+    if(status != 0) {
+      fprintf(stderr, "[check_deflation] Error, could not read gauge field");
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 12);
+      MPI_Finalize();
+#endif
+      exit(12);
+    }
+  }
+#ifdef MPI
+  xchange_gauge();
+#endif
+
+  /* measure the plaquette */
+  plaquette(&plaq_m);
+  if(g_cart_id==0) fprintf(stdout, "# Measured plaquette value: %25.16e\n", plaq_m);
+
+  /* allocate memory for the spinor fields:
+   * 2 work fields for init_deflation and 1 for reading */
+  no_fields = 3;
+  g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
+  for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOLUMEPLUSRAND);
+
+  if(g_propagator_codec == _SPINOR_CODEC_HALF16)         eps = 1.e-8;
+  else if(g_propagator_codec == _SPINOR_CODEC_SHUFFLE32) eps = 1.e-12;
+  else                                                  eps = 1.e-24;
+
+  /***********************************************
+   * compute and write the eigenspace
+   ***********************************************/
+  sprintf(filename, "%s.%.4d", g_deflation_filename_prefix, Nconf);
+  if(g_cart_id==0) remove(filename);
+#ifdef MPI
+  MPI_Barrier(g_cart_grid);
+#endif
+  nev = init_deflation(_TM_FERMION, 0);
+  if(nev <= 0) {
+    fprintf(stderr, "[check_deflation] Error from init_deflation, status was %d\n", nev);
+#ifdef MPI
+    MPI_Abort(MPI_COMM_WORLD, 13);
+    MPI_Finalize();
+#endif
+    exit(13);
+  }
+  get_deflation_eigenspace(&v, &lambda);
+  lambda_ref = (double*)malloc(nev*sizeof(double));
+  memcpy(lambda_ref, lambda, nev*sizeof(double));
+
+  /***********************************************
+   * read back every eigenvector, record i must
+   * be eigenvector i
+   ***********************************************/
+  for(i=0; i<nev; i++) {
+    status = read_lime_spinor(g_spinor_field[2], filename, i);
+    if(status != 0) {
+      if(g_cart_id==0) fprintf(stderr, "[check_deflation] Error, could not read eigenvector %d from file %s\n", i, filename);
+      exit_status = 1;
+      continue;
+    }
+    for(ix=0;ix<VOLUME;ix++) {
+      _fv_mi_eq_fv(g_spinor_field[2]+_GSI(ix), v[i]+_GSI(ix));
+    }
+    spinor_scalar_product_re(&norm, g_spinor_field[2], g_spinor_field[2], VOLUME);
+    if(g_cart_id==0) fprintf(stdout, "# [check_deflation] eigenvector %3d relative difference squared = %e\n", i, norm);
+    if(norm > diff_max) diff_max = norm;
+    /* also catches nan */
+    if(!(norm <= eps)) exit_status = 1;
+  }
+
+  /***********************************************
+   * the second call takes the eigenspace from
+   * the cache
+   ***********************************************/
+  nev_read = init_deflation(_TM_FERMION, 0);
+  get_deflation_eigenspace(&v, &lambda);
+  if(nev_read != nev) {
+    if(g_cart_id==0) fprintf(stderr, "[check_deflation] Error, %d eigenvectors from the cache, %d computed\n", nev_read, nev);
+    exit_status = 1;
+  } else {
+    for(i=0; i<nev; i++) {
+      norm = fabs(lambda[i] - lambda_ref[i]) / fabs(lambda_ref[i]);
+      if(norm > lambda_diff_max) lambda_diff_max = norm;
+    }
+  }
+
+  if(g_cart_id==0) {
+    fprintf(stdout, "\n# [check_deflation] codec %d, %d eigenvectors\n", g_propagator_codec, nev);
+    fprintf(stdout, "# [check_deflation] maximal relative difference squared of the eigenvectors = %e\n", diff_max);
+    fprintf(stdout, "# [check_deflation] maximal relative difference of the eigenvalues       = %e\n\n", lambda_diff_max);
+  }
+  if(diff_max > eps || lambda_diff_max > sqrt(eps)) {
+    if(g_cart_id==0) fprintf(stderr, "[check_deflation] Error, eigenvector cache round trip failed\n");
+    exit_status = 1;
+  }
+
+  /***********************************************
+   * free the allocated memory, finalize
+   ***********************************************/
+
+  free_deflation();
+  free(lambda_ref);
+  free(g_gauge_field);
+  for(i=0; i<no_fields; i++) free(g_spinor_field[i]);
+  free(g_spinor_field);
+  free_geometry();
+
+#ifdef MPI
+  MPI_Finalize();
+#endif
+
+  if(g_cart_id==0) {
+    g_the_time = time(NULL);
+    fprintf(stdout, "\n# [check_deflation] %s# [check_deflation] end of run\n", ctime(&g_the_time));
+    fprintf(stderr, "\n# [check_deflation] %s# [check_deflation] end of run\n", ctime(&g_the_time));
+  }
+
+  return(exit_status);
+}
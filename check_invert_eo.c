@@ -0,0 +1,342 @@
+/****************************************************
+ * check_invert_eo.c
+ *
+ * PURPOSE:
+ * - check the even/odd preconditioned solvers invert_Qtm_eo and
+ *   invert_Q_Wilson_eo against the full lattice BiCGStab
+ *   invert_Qtm and invert_Q_Wilson
+ * - point source at g_source_location with spin-color index
+ *   given on the command line
+ * - compare the true residua and the difference of the solutions
+ * TODO:
+ * DONE:
+ * CHANGES:
+ ****************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#include <getopt.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+#define MAIN_PROGRAM
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "cvc_complex.h"
+#include "cvc_linalg.h"
+#include "global.h"
+#include "cvc_geometry.h"
+#include "cvc_utils.h"
+#include "mpi_init.h"
+#include "io.h"
+#include "propagator_io.h"
+#include "Q_phi.h"
+#include "read_input_parser.h"
+#include "invert_Qtm.h"
+#include "gauge_io.h"
+#ifdef __cplusplus
+}
+#endif
+
+void usage() {
+  fprintf(stdout, "Code to compare even/odd preconditioned and full lattice inversion\n");
+  fprintf(stdout, "Usage:    [options]\n");
+  fprintf(stdout, "Options: -v verbose\n");
+  fprintf(stdout, "         -f input filename [default cvc.input]\n");
+  fprintf(stdout, "         -s spin-color index of the point source [default 0]\n");
+  fprintf(stdout, "         -t number of threads [default 1]\n");
+#ifdef MPI
+  MPI_Abort(MPI_COMM_WORLD, 1);
+  MPI_Finalize();
+#endif
+  exit(0);
+}
+
+/***********************************************
+ * true relative squared residuum of the solution
+ * in g_spinor_field[1] for the source
+ * in g_spinor_field[0]; uses g_spinor_field[2]
+ ***********************************************/
+static double true_residuum(int fermion_type) {
+  unsigned int ix;
+  double norm, norm2;
+
+  xchange_field(g_spinor_field[1]);
+  if(fermion_type == _TM_FERMION) {
+    Q_phi_tbc(g_spinor_field[2], g_spinor_field[1]);
+  } else {
+    Q_Wilson_phi(g_spinor_field[2], g_spinor_field[1]);
+  }
+  for(ix=0;ix<VOLUME;ix++) {
+    _fv_mi_eq_fv(g_spinor_field[2]+_GSI(ix), g_spinor_field[0]+_GSI(ix));
+  }
+  spinor_scalar_product_re(&norm,  g_spinor_field[2], g_spinor_field[2], VOLUME);
+  spinor_scalar_product_re(&norm2, g_spinor_field[0], g_spinor_field[0], VOLUME);
+  return(norm/norm2);
+}
+
+int main(int argc, char **argv) {
+
+  int c, i, mu, status;
+  int filename_set = 0;
+  int ix, ifermion;
+  int sl0, sl1, sl2, sl3, have_source_flag=0;
+  int source_proc_id;
+#ifdef MPI
+  int source_proc_coords[4];
+#endif
+  int num_threads = 1;
+  int niter_full, niter_eo;
+  int exit_status = 0;
+  char filename[200];
+  double ratime, retime, time_full, time_eo;
+  double plaq_r=0., plaq_m=0., norm, norm_src, res_full, res_eo;
+  int spin_color_index = 0;
+  const int fermion_type_list[2] = {_TM_FERMION, _WILSON_FERMION};
+  const char fermion_name_list[2][8] = {"tm", "Wilson"};
+
+#ifdef MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  while ((c = getopt(argc, argv, "h?vf:t:s:")) != -1) {
+    switch (c) {
+    case 'v':
+      g_verbose = 1;
+      break;
+    case 't':
+      num_threads = atoi(optarg);
+      fprintf(stdout, "\n# [check_invert_eo] will use %d threads in spacetime loops\n", num_threads);
+      break;
+    case 'f':
+      strcpy(filename, optarg);
+      filename_set=1;
+      break;
+    case 's':
+      spin_color_index = atoi(optarg);
+      fprintf(stdout, "# [check_invert_eo] will use spin-color index %d\n", spin_color_index);
+      break;
+    case 'h':
+    case '?':
+    default:
+      usage();
+      break;
+    }
+  }
+
+  // get the time stamp
+  g_the_time = time(NULL);
+
+  /*********************************
+   * set number of openmp threads
+   *********************************/
+#ifdef OPENMP
+  omp_set_num_threads(num_threads);
+#endif
+
+  /**************************************
+   * set the default values, read input
+   **************************************/
+  if(filename_set==0) strcpy(filename, "cvc.input");
+  if(g_proc_id==0) fprintf(stdout, "# Reading input from file %s\n", filename);
+  read_input_parser(filename);
+
+  /* some checks on the input data */
+  if((T_global == 0) || (LX==0) || (LY==0) || (LZ==0)) {
+    if(g_proc_id==0) fprintf(stderr, "[check_invert_eo] Error, T and L's must be set\n");
+    usage();
+  }
+  if(g_kappa == 0.) {
+    if(g_proc_id==0) fprintf(stderr, "[check_invert_eo] Error, kappa should be > 0.\n");
+    usage();
+  }
+  if(spin_color_index < 0 || spin_color_index > 11) {
+    if(g_proc_id==0) fprintf(stderr, "[check_invert_eo] Error, spin-color index must be in 0,...,11\n");
+    usage();
+  }
+
+  // initialize MPI parameters
+  mpi_init(argc, argv);
+
+#ifdef MPI
+  if(T==0) {
+    fprintf(stderr, "[%2d] local T is zero; exit\n", g_cart_id);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(2);
+  }
+#endif
+
+  if(init_geometry() != 0) {
+    fprintf(stderr, "ERROR from init_geometry\n");
+#ifdef MPI
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+#endif
+    exit(1);
+  }
+
+  geometry();
+
+  /**************************************
+   * prepare the gauge field
+   **************************************/
+  alloc_gauge_field(&g_gauge_field, VOLUMEPLUSRAND);
+  if(strcmp( gaugefilename_prefix, "identity")==0 ) {
+    if(g_cart_id==0) fprintf(stdout, "# [check_invert_eo] Setting up unit gauge field\n");
+    for(ix=0;ix<VOLUME; ix++) {
+      for(mu=0;mu<4;mu++) {
+        _cm_eq_id(g_gauge_field+_GGI(ix,mu));
+      }
+    }
+  } else {
+    if(g_gauge_file_format == 0) {
+      // ILDG
+      sprintf(filename, "%s.%.4d", gaugefilename_prefix, Nconf);
+      if(g_cart_id==0) fprintf(stdout, "# Reading gauge field from file %s\n", filename);
+      status = read_lime_gauge_field_doubleprec(filename);
+    } else if(g_gauge_file_format == 1) {
+      // NERSC
+      sprintf(filename, "%s.%.5d", gaugefilename_prefix, Nconf);
+      if(g_cart_id==0) fprintf(stdout, "# Reading gauge field from file %s\n", filename);
+      status = read_nersc_gauge_field(g_gauge_field, filename, &plaq_r);
+    }
+    if(status != 0) {
+      fprintf(stderr, "[check_invert_eo] Error, could not read gauge field");
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 12);
+      MPI_Finalize();
+#endif
+      exit(12);
+    }
+  }
+#ifdef MPI
+  xchange_gauge();
+#endif
+
+  /* measure the plaquette */
+  plaquette(&plaq_m);
+  if(g_cart_id==0) fprintf(stdout, "# Measured plaquette value: %25.16e\n", plaq_m);
+  if(g_cart_id==0) fprintf(stdout, "# Read plaquette value    : %25.16e\n", plaq_r);
+
+  /* allocate memory for the spinor fields:
+   * source, solution, full lattice solution and 7 work fields */
+  no_fields = 10;
+  g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
+  for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOLUMEPLUSRAND);
+
+  /* the source locaton */
+  sl0 =   g_source_location                              / (LX_global*LY_global*LZ);
+  sl1 = ( g_source_location % (LX_global*LY_global*LZ) ) / (          LY_global*LZ);
+  sl2 = ( g_source_location % (          LY_global*LZ) ) / (                    LZ);
+  sl3 =   g_source_location %                      LZ;
+  if(g_cart_id==0) fprintf(stdout, "# [check_invert_eo] global sl = (%d, %d, %d, %d)\n", sl0, sl1, sl2, sl3);
+#ifdef MPI
+  source_proc_coords[0] = sl0 / T;
+  source_proc_coords[1] = sl1 / LX;
+  source_proc_coords[2] = sl2 / LY;
+  source_proc_coords[3] = sl3 / LZ;
+  MPI_Cart_rank(g_cart_grid, source_proc_coords, &source_proc_id);
+#else
+  source_proc_id = 0;
+#endif
+  have_source_flag = source_proc_id == g_cart_id;
+
+  /***********************************************
+   * prepare the point souce
+   ***********************************************/
+  for(ix=0;ix<VOLUMEPLUSRAND;ix++) { _fv_eq_zero( g_spinor_field[0]+_GSI(ix) ); }
+  if(have_source_flag) {
+    ix = g_ipt[sl0%T][sl1%LX][sl2%LY][sl3%LZ];
+    fprintf(stdout, "# [check_invert_eo] process %d has the source at %d\n", g_cart_id, ix);
+    g_spinor_field[0][_GSI(ix) + 2*spin_color_index] = 1.;
+  }
+  xchange_field(g_spinor_field[0]);
+
+  for(ifermion=0; ifermion<2; ifermion++) {
+
+    /***********************************************
+     * full lattice BiCGStab
+     ***********************************************/
+    for(ix=0;ix<VOLUMEPLUSRAND;ix++) { _fv_eq_zero( g_spinor_field[1]+_GSI(ix) ); }
+    ratime = (double)clock() / CLOCKS_PER_SEC;
+    if(fermion_type_list[ifermion] == _TM_FERMION) {
+      niter_full = invert_Qtm(g_spinor_field[1], g_spinor_field[0], 3);
+    } else {
+      niter_full = invert_Q_Wilson(g_spinor_field[1], g_spinor_field[0], 3);
+    }
+    retime = (double)clock() / CLOCKS_PER_SEC;
+    time_full = retime - ratime;
+    res_full = true_residuum(fermion_type_list[ifermion]);
+    memcpy(g_spinor_field[9], g_spinor_field[1], 24*VOLUME*sizeof(double));
+
+    /***********************************************
+     * even/odd preconditioned BiCGStab
+     ***********************************************/
+    for(ix=0;ix<VOLUMEPLUSRAND;ix++) { _fv_eq_zero( g_spinor_field[1]+_GSI(ix) ); }
+    ratime = (double)clock() / CLOCKS_PER_SEC;
+    if(fermion_type_list[ifermion] == _TM_FERMION) {
+      niter_eo = invert_Qtm_eo(g_spinor_field[1], g_spinor_field[0], 2);
+    } else {
+      niter_eo = invert_Q_Wilson_eo(g_spinor_field[1], g_spinor_field[0], 2);
+    }
+    retime = (double)clock() / CLOCKS_PER_SEC;
+    time_eo = retime - ratime;
+    res_eo = true_residuum(fermion_type_list[ifermion]);
+
+    /***********************************************
+     * compare
+     ***********************************************/
+    for(ix=0;ix<VOLUME;ix++) {
+      _fv_mi_eq_fv(g_spinor_field[9]+_GSI(ix), g_spinor_field[1]+_GSI(ix));
+    }
+    spinor_scalar_product_re(&norm, g_spinor_field[9], g_spinor_field[9], VOLUME);
+    spinor_scalar_product_re(&norm_src, g_spinor_field[1], g_spinor_field[1], VOLUME);
+
+    if(g_cart_id==0) {
+      fprintf(stdout, "\n# [check_invert_eo] %s full lattice: niter = %d, time = %e seconds, true relative residuum squared = %e\n",
+          fermion_name_list[ifermion], niter_full, time_full, res_full);
+      fprintf(stdout, "# [check_invert_eo] %s even/odd    : niter = %d, time = %e seconds, true relative residuum squared = %e\n",
+          fermion_name_list[ifermion], niter_eo, time_eo, res_eo);
+      fprintf(stdout, "# [check_invert_eo] %s relative difference of solutions squared = %e\n\n",
+          fermion_name_list[ifermion], norm/norm_src);
+    }
+
+    /* the even/odd solution must solve the full system to the requested precision */
+    if(niter_full < 0 || niter_eo < 0 || res_eo > 10.*solver_precision) {
+      if(g_cart_id==0) fprintf(stderr, "[check_invert_eo] Error, %s even/odd residuum check failed\n", fermion_name_list[ifermion]);
+      exit_status = 1;
+    }
+  }
+
+  /***********************************************
+   * free the allocated memory, finalize
+   ***********************************************/
+
+  free(g_gauge_field);
+  for(i=0; i<no_fields; i++) free(g_spinor_field[i]);
+  free(g_spinor_field);
+  free_geometry();
+
+#ifdef MPI
+  MPI_Finalize();
+#endif
+
+  if(g_cart_id==0) {
+    g_the_time = time(NULL);
+    fprintf(stdout, "\n# [check_invert_eo] %s# [check_invert_eo] end of run\n", ctime(&g_the_time));
+    fprintf(stderr, "\n# [check_invert_eo] %s# [check_invert_eo] end of run\n", ctime(&g_the_time));
+  }
+
+  return(exit_status);
+
+}
@@ -0,0 +1,314 @@
+/********************
+ * contract_twopoint_batch.c
+ *
+ * batched versions of contract_twopoint, contract_twopoint_xdep
+ * and contract_twopoint_snk_momentum: all gamma structures
+ * (idsource[ig], idsink[ig]), ig < ngamma, from one pass over
+ * the propagators
+ *
+ * - per site the 12x12 propagator product, as spin-colour traces
+ *     P[nu][mu][a][b] = sum_{c,col} chi[nu*n_c+c]_{a,col}^* phi[mu*n_c+c]_{b,col},
+ *   is built once; with gamma_5 gamma_sink and the source gamma
+ *   from the gamma_permutation / gamma_sign tables every structure
+ *   is a sum of 16 entries of P
+ * - same conventions (gamma_5 at the source, factor -i for imaginary
+ *   source gamma, phase sign and source location) as the single
+ *   structure versions in cvc_utils.c
+ * - the momentum projection is done by momentum_projection
+ *   (momentum_phase.c)
+ ********************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+#include "cvc_complex.h"
+#include "cvc_linalg.h"
+#include "global.h"
+#include "momentum_phase.h"
+#include "contract_twopoint_batch.h"
+
+/********************
+ * structure ig is
+ *   w_ig = sum_{k<16} coef[32*ig+2*k] P[pidx[16*ig+k]]
+ * with P as double[512]
+ ********************/
+typedef struct {
+  int ngamma;
+  int *pidx;
+  double *coef;
+} twopoint_gamma_batch;
+
+static int init_twopoint_gamma_batch(twopoint_gamma_batch *g, int ngamma, int *idsource, int *idsink) {
+  int ig, mu, a, b, k, psource, isimag;
+  double ssource, re, im;
+  double sp1[24], sp2[24], sp3[24];
+
+  g->ngamma = ngamma;
+  g->pidx = (int*)malloc(16*ngamma*sizeof(int));
+  g->coef = (double*)malloc(32*ngamma*sizeof(double));
+  if(g->pidx == NULL || g->coef == NULL) {
+    fprintf(stderr, "[init_twopoint_gamma_batch] Error, could not allocate memory\n");
+    free(g->pidx);
+    free(g->coef);
+    return(1);
+  }
+
+  for(ig=0; ig<ngamma; ig++) {
+    isimag = gamma_permutation[idsource[ig]][0] % 2;
+    for(b=0; b<4; b++) {
+      /* column b of gamma_5 gamma_sink has one non-zero entry in row a */
+      _fv_eq_zero(sp1);
+      sp1[6*b] = 1.;
+      _fv_eq_gamma_ti_fv(sp2, idsink[ig], sp1);
+      _fv_eq_gamma_ti_fv(sp3, 5, sp2);
+      for(a=0; a<4 && sp3[6*a] == 0. && sp3[6*a+1] == 0.; a++);
+      /* factor -i for imaginary source gamma */
+      re = isimag ?  sp3[6*a+1] : sp3[6*a  ];
+      im = isimag ? -sp3[6*a  ] : sp3[6*a+1];
+      for(mu=0; mu<4; mu++) {
+        psource = gamma_permutation[idsource[ig]][6*mu] / 6;
+        ssource = gamma_sign[idsource[ig]][6*mu] * gamma_sign[5][gamma_permutation[idsource[ig]][6*mu]];
+        k = 16*ig + 4*mu + b;
+        g->pidx[k] = 32*(4*psource+mu) + 2*(4*a+b);
+        g->coef[2*k  ] = ssource * re;
+        g->coef[2*k+1] = ssource * im;
+      }
+    }
+  }
+  return(0);
+}
+
+static void fini_twopoint_gamma_batch(twopoint_gamma_batch *g) {
+  free(g->pidx);
+  free(g->coef);
+}
+
+/********************
+ * w[2*ig] for all structures at site ix
+ ********************/
+static void twopoint_site_batch(double *w, twopoint_gamma_batch *g, double **chi, double **phi, int n_c, unsigned int ix) {
+  int nu, mu, c, a, b, col, k;
+  double P[512], *pp, *pc, *pa, *cf;
+  int *pi;
+
+  for(nu=0; nu<4; nu++) {
+  for(mu=0; mu<4; mu++) {
+    pp = P + 32*(4*nu+mu);
+    memset(pp, 0, 32*sizeof(double));
+    for(c=0; c<n_c; c++) {
+      pc = chi[nu*n_c+c] + _GSI(ix);
+      pa = phi[mu*n_c+c] + _GSI(ix);
+      for(a=0; a<4; a++) {
+      for(b=0; b<4; b++) {
+        for(col=0; col<3; col++) {
+          pp[2*(4*a+b)  ] += pc[6*a+2*col] * pa[6*b+2*col  ] + pc[6*a+2*col+1] * pa[6*b+2*col+1];
+          pp[2*(4*a+b)+1] += pc[6*a+2*col] * pa[6*b+2*col+1] - pc[6*a+2*col+1] * pa[6*b+2*col  ];
+        }
+      }}
+    }
+  }}
+
+  for(k=0; k<g->ngamma; k++) {
+    pi = g->pidx + 16*k;
+    cf = g->coef + 32*k;
+    w[2*k] = 0.; w[2*k+1] = 0.;
+    for(a=0; a<16; a++) {
+      w[2*k  ] += cf[2*a] * P[pi[a]  ] - cf[2*a+1] * P[pi[a]+1];
+      w[2*k+1] += cf[2*a] * P[pi[a]+1] + cf[2*a+1] * P[pi[a]  ];
+    }
+  }
+}
+
+/********************
+ * contr[2*(ig*T + t)] += sum_x w_ig(t, x)
+ ********************/
+int contract_twopoint_batch(double *contr, int ngamma, int *idsource, int *idsink, double **chi, double **phi, int n_c) {
+
+  int x0;
+  unsigned int VOL3 = LX*LY*LZ;
+  twopoint_gamma_batch g;
+
+  if(ngamma <= 0) return(0);
+  if(init_twopoint_gamma_batch(&g, ngamma, idsource, idsink) != 0) return(1);
+
+  for(x0=0; x0<T; x0++) {
+#ifdef OPENMP
+#pragma omp parallel
+{
+#endif
+    unsigned int ix;
+    int ig;
+    double *w   = (double*)malloc(2*ngamma*sizeof(double));
+    double *sum = (double*)calloc(2*ngamma, sizeof(double));
+#ifdef OPENMP
+#pragma omp for
+#endif
+    for(ix=0; ix<VOL3; ix++) {
+      twopoint_site_batch(w, &g, chi, phi, n_c, x0*VOL3+ix);
+      for(ig=0; ig<2*ngamma; ig++) sum[ig] += w[ig];
+    }
+#ifdef OPENMP
+#pragma omp critical
+#endif
+    for(ig=0; ig<ngamma; ig++) {
+      contr[2*(ig*T+x0)  ] += sum[2*ig  ];
+      contr[2*(ig*T+x0)+1] += sum[2*ig+1];
+    }
+    free(w);
+    free(sum);
+#ifdef OPENMP
+}  /* end of parallel region */
+#endif
+  }
+  fini_twopoint_gamma_batch(&g);
+  return(0);
+}
+
+/********************
+ * position space, double precision:
+ *   contr[2*(ix*stride + idout[ig])] += factor[ig] * w_ig(ix)
+ * for ix < VOLUME; several structures may share one output
+ * (idout = NULL, factor = NULL for idout[ig] = ig, factor[ig] = 1)
+ ********************/
+int contract_twopoint_xdep_batch(double *contr, int ngamma, int *idsource, int *idsink, int *idout, double *factor,
+    double **chi, double **phi, int n_c, int stride) {
+
+  twopoint_gamma_batch g;
+
+  if(ngamma <= 0) return(0);
+  if(init_twopoint_gamma_batch(&g, ngamma, idsource, idsink) != 0) return(1);
+
+#ifdef OPENMP
+#pragma omp parallel
+{
+#endif
+  unsigned int ix;
+  int ig, iout;
+  double f;
+  double *w = (double*)malloc(2*ngamma*sizeof(double));
+#ifdef OPENMP
+#pragma omp for
+#endif
+  for(ix=0; ix<VOLUME; ix++) {
+    twopoint_site_batch(w, &g, chi, phi, n_c, ix);
+    for(ig=0; ig<ngamma; ig++) {
+      iout = idout  == NULL ? ig : idout[ig];
+      f    = factor == NULL ? 1. : factor[ig];
+      contr[2*(ix*stride+iout)  ] += f * w[2*ig  ];
+      contr[2*(ix*stride+iout)+1] += f * w[2*ig+1];
+    }
+  }
+  free(w);
+#ifdef OPENMP
+}  /* end of parallel region */
+#endif
+  fini_twopoint_gamma_batch(&g);
+  return(0);
+}
+
+/********************
+ * sink momenta snk_mom[3*ip], ip < nmom:
+ *   contr[2*((ig*nmom + ip)*T + t)] +=
+ *     sum_x exp(i p (x - x_src)) w_ig(t, x)
+ * summed over the spatial process grid
+ ********************/
+int contract_twopoint_snk_momentum_batch(double *contr, int ngamma, int *idsource, int *idsink,
+    double **chi, double **phi, int n_c, int nmom, int *snk_mom) {
+
+  int ig, ip, t;
+  int sx0=0, sx1=0, sx2=0, sx3=0, sx[3], iix;
+  unsigned int VOL3 = LX*LY*LZ;
+  double *S=NULL, *C=NULL;
+  twopoint_gamma_batch g;
+  momentum_phase ph;
+
+  if(ngamma <= 0 || nmom <= 0) return(0);
+
+  S = (double*)malloc(2*ngamma*T*VOL3*sizeof(double));
+  C = (double*)calloc(2*ngamma*T*nmom, sizeof(double));
+  if(S == NULL || C == NULL) {
+    fprintf(stderr, "[contract_twopoint_snk_momentum_batch] Error, could not allocate memory\n");
+    free(S);
+    free(C);
+    return(1);
+  }
+  if(init_twopoint_gamma_batch(&g, ngamma, idsource, idsink) != 0) {
+    free(S);
+    free(C);
+    return(1);
+  }
+
+  if(g_source_type==0) { // point source
+    iix = g_source_location;
+    sx0 = iix / (LX*LY*LZ);
+    iix -= sx0 * LX*LY*LZ;
+    sx1 = iix / (LY*LZ);
+    iix -= sx1 * LY*LZ;
+    sx2 = iix / (LZ);
+    sx3 = iix - sx2 * LZ;
+  }
+
+  /********************
+   * site correlators S[2*((ig*T+t)*VOL3 + x)]
+   ********************/
+#ifdef OPENMP
+#pragma omp parallel private(ig)
+{
+#endif
+  double *w = (double*)malloc(2*ngamma*sizeof(double));
+  unsigned int ix;
+#ifdef OPENMP
+#pragma omp for
+#endif
+  for(ix=0; ix<T*VOL3; ix++) {
+    twopoint_site_batch(w, &g, chi, phi, n_c, ix);
+    for(ig=0; ig<ngamma; ig++) {
+      S[2*((ig*T+ix/VOL3)*VOL3+ix%VOL3)  ] = w[2*ig  ];
+      S[2*((ig*T+ix/VOL3)*VOL3+ix%VOL3)+1] = w[2*ig+1];
+    }
+  }
+  free(w);
+#ifdef OPENMP
+}  /* end of parallel region */
+#endif
+  fini_twopoint_gamma_batch(&g);
+
+  /********************
+   * momentum projection,
+   * C[2*(ip*ngamma*T + ig*T+t)] = sum_x phase[ip][x] S[ig,t][x]
+   ********************/
+  sx[0] = sx1; sx[1] = sx2; sx[2] = sx3;
+  if(init_momentum_phase(&ph, nmom, snk_mom, sx) != 0) {
+    fprintf(stderr, "[contract_twopoint_snk_momentum_batch] Error from init_momentum_phase\n");
+    free(S);
+    free(C);
+    return(2);
+  }
+  if(momentum_projection(C, &ph, S, ngamma*T) != 0) {
+    fprintf(stderr, "[contract_twopoint_snk_momentum_batch] Error from momentum_projection\n");
+    fini_momentum_phase(&ph);
+    free(S);
+    free(C);
+    return(2);
+  }
+  fini_momentum_phase(&ph);
+
+  for(ig=0; ig<ngamma; ig++) {
+    for(ip=0; ip<nmom; ip++) {
+      for(t=0; t<T; t++) {
+        contr[2*((ig*nmom+ip)*T+t)  ] += C[2*(ip*ngamma*T+ig*T+t)  ];
+        contr[2*((ig*nmom+ip)*T+t)+1] += C[2*(ip*ngamma*T+ig*T+t)+1];
+      }
+    }
+  }
+
+  free(S);
+  free(C);
+  return(0);
+}
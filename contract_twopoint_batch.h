@@ -0,0 +1,17 @@
+/********************
+ * contract_twopoint_batch.h
+ *
+ * meson 2-point functions for a list of gamma structures
+ * (and a list of sink momenta) in one pass over the
+ * propagators (one-end trick and point sources)
+ ********************/
+#ifndef _CONTRACT_TWOPOINT_BATCH_H
+#define _CONTRACT_TWOPOINT_BATCH_H
+
+int contract_twopoint_batch(double *contr, int ngamma, int *idsource, int *idsink, double **chi, double **phi, int n_c);
+int contract_twopoint_xdep_batch(double *contr, int ngamma, int *idsource, int *idsink, int *idout, double *factor,
+    double **chi, double **phi, int n_c, int stride);
+int contract_twopoint_snk_momentum_batch(double *contr, int ngamma, int *idsource, int *idsink,
+    double **chi, double **phi, int n_c, int nmom, int *snk_mom);
+
+#endif
@@ -4,6 +4,8 @@
  * PURPOSE
  * - functions for i/o of contractions, derived from propagator_io
  * - uses lime and the DML checksum
+ * - with MPI the binary data are read and written
+ *   collectively with MPI-IO (io_mpiio.c)
  * TODO:
  * CHANGES:
  *
@@ -35,6 +37,7 @@
 #include "propagator_io.h"
 #include "contractions_io.h"
 #include "cvc_utils.h"
+#include "io_mpiio.h"
 
 /* write an N-comp. contraction to file */
 
@@ -42,6 +45,16 @@
  * write_binary_contraction_data
  ****************************************************/
 #ifndef HAVE_LIBLEMON
+#ifdef PARALLELTXYZ
+int write_binary_contraction_data(double * const s, LimeWriter * limewriter,
+                                      const int prec, const int N, DML_Checksum * ans) {
+  DML_checksum_init(ans);
+  if(g_cart_id == 0) {
+    fprintf(stderr, "\n[write_binary_contraction_data] Error: no version implemented for PARALLELTXYZ\n");
+  }
+  return(-1);
+}
+#else
 int write_binary_contraction_data(double * const s, LimeWriter * limewriter,
                                       const int prec, const int N, DML_Checksum * ans) {
 
@@ -323,6 +336,7 @@ int write_binary_contraction_data(double * const s, LimeWriter * limewriter,
    
   return(0);
 }
+#endif  // of ifdef PARALLELTXYZ
 #else  // HAVE_LIBLEMON
 int write_binary_contraction_data(double * const s, LemonWriter * writer, const int prec, const int N, DML_Checksum * ans) {
 
@@ -490,6 +504,106 @@ int read_binary_contraction_data(double * const s, LimeReader * limereader,
   return(0);
 }
 
+#ifdef MPI
+/************************************************************
+ * read_binary_contraction_data_mpiio
+ *
+ * collective read of the local sub-lattice from the record
+ * data at offset; file order t,x,y,z with N complex numbers
+ * per site
+ ************************************************************/
+static int read_binary_contraction_data_mpiio(double * const s, char * filename, MPI_Offset offset,
+    const int prec, const int N, DML_Checksum *ans) {
+
+  int t, x, y, z, mu;
+  unsigned int iy, ix;
+  size_t bytes = 2*N*(prec == 32 ? sizeof(float) : sizeof(double));
+  char *buffer = NULL, *site;
+  DML_SiteRank rank;
+  int words_bigendian = big_endian();
+
+  DML_checksum_init(ans);
+  if( (buffer = (char*)malloc(VOLUME*bytes)) == NULL ) {
+    fprintf(stderr, "[read_binary_contraction_data_mpiio] Error, could not allocate buffer\n");
+    return(-1);
+  }
+  if(mpiio_read_lattice(buffer, filename, offset, _MPIIO_TXYZ, bytes) != 0) {
+    free(buffer);
+    return(-1);
+  }
+
+  for(iy = 0; iy < VOLUME; iy++) {
+    t = iy / (LX*LY*LZ);
+    x = (iy % (LX*LY*LZ)) / (LY*LZ);
+    y = (iy % (LY*LZ)) / LZ;
+    z = iy % LZ;
+    ix = g_ipt[t][x][y][z];
+    site = buffer + iy * bytes;
+    rank = (DML_SiteRank) ((((Tstart+t)*LX_global + LXstart + x)*LY_global + LYstart + y)*(DML_SiteRank)LZ_global + LZstart + z);
+    DML_checksum_accum(ans, rank, site, bytes);
+    for(mu=0; mu<N; mu++) {
+      if(!words_bigendian) {
+        if(prec == 32) byte_swap_assign_single2double(s + _GWI(mu,ix,VOLUME), (float*)site + 2*mu, 2);
+        else           byte_swap_assign(s + _GWI(mu,ix,VOLUME), (double*)site + 2*mu, 2);
+      } else {
+        if(prec == 32) single2double(s + _GWI(mu,ix,VOLUME), (float*)site + 2*mu, 2);
+        else           memcpy(s + _GWI(mu,ix,VOLUME), (double*)site + 2*mu, 2*sizeof(double));
+      }
+    }
+  }
+  free(buffer);
+
+  DML_checksum_combine(ans);
+  if(g_cart_id == 0) printf("\n# [read_binary_contraction_data_mpiio] The final checksum is %#x %#x\n", (*ans).suma, (*ans).sumb);
+  return(0);
+}
+
+/************************************************************
+ * write_binary_contraction_data_mpiio
+ ************************************************************/
+static int write_binary_contraction_data_mpiio(double * const s, char * filename, MPI_Offset offset,
+    const int prec, const int N, DML_Checksum *ans) {
+
+  int t, x, y, z, mu, status;
+  unsigned int iy, ix;
+  size_t bytes = 2*N*(prec == 32 ? sizeof(float) : sizeof(double));
+  char *buffer = NULL, *site;
+  DML_SiteRank rank;
+  int words_bigendian = big_endian();
+
+  DML_checksum_init(ans);
+  if( (buffer = (char*)malloc(VOLUME*bytes)) == NULL ) {
+    fprintf(stderr, "[write_binary_contraction_data_mpiio] Error, could not allocate buffer\n");
+    return(-1);
+  }
+
+  for(iy = 0; iy < VOLUME; iy++) {
+    t = iy / (LX*LY*LZ);
+    x = (iy % (LX*LY*LZ)) / (LY*LZ);
+    y = (iy % (LY*LZ)) / LZ;
+    z = iy % LZ;
+    ix = g_ipt[t][x][y][z];
+    site = buffer + iy * bytes;
+    for(mu=0; mu<N; mu++) {
+      if(!words_bigendian) {
+        if(prec == 32) byte_swap_assign_double2single((float*)site + 2*mu, s + _GWI(mu,ix,VOLUME), 2);
+        else           byte_swap_assign((double*)site + 2*mu, s + _GWI(mu,ix,VOLUME), 2);
+      } else {
+        if(prec == 32) double2single((float*)site + 2*mu, s + _GWI(mu,ix,VOLUME), 2);
+        else           memcpy((double*)site + 2*mu, s + _GWI(mu,ix,VOLUME), 2*sizeof(double));
+      }
+    }
+    rank = (DML_SiteRank) ((((Tstart+t)*LX_global + LXstart + x)*LY_global + LYstart + y)*(DML_SiteRank)LZ_global + LZstart + z);
+    DML_checksum_accum(ans, rank, site, bytes);
+  }
+
+  status = mpiio_write_lattice(buffer, filename, offset, _MPIIO_TXYZ, bytes);
+  free(buffer);
+  DML_checksum_combine(ans);
+  return(status == 0 ? 0 : -1);
+}
+#endif  /* of ifdef MPI */
+
 /**************************************************************
  * write_contraction_format
  **************************************************************/
@@ -560,6 +674,9 @@ int write_lime_contraction(double * const s, char * filename, const int prec, co
   int ME_flag=0, MB_flag=0;
   n_uint64_t bytes;
   DML_Checksum checksum;
+#ifdef MPI
+  MPI_Offset offset;
+#endif
 
   write_contraction_format(filename, prec, N, type, gid, sid);
 
@@ -599,6 +716,22 @@ int write_lime_contraction(double * const s, char * filename, const int prec, co
     limeDestroyHeader( limeheader );
   }
   
+#ifdef MPI
+  /* header by process 0, data collectively behind it */
+  if(g_cart_id==0) {
+    offset = (MPI_Offset)ftello(ofs);
+    limeDestroyWriter( limewriter );
+    fflush(ofs);
+    fclose(ofs);
+  }
+  MPI_Bcast(&offset, 1, MPI_OFFSET, 0, g_cart_grid);
+  status = write_binary_contraction_data_mpiio(s, filename, offset, prec, N, &checksum);
+  if(status != 0) {
+    fprintf(stderr, "Error while writing to file %s \n", filename);
+    return(status);
+  }
+  if(g_cart_id==0) printf("# Final check sum is (%#x  %#x)\n", checksum.suma, checksum.sumb);
+#else
   status = write_binary_contraction_data(s, limewriter, prec, N, &checksum);
   if(g_cart_id==0) {
     printf("# Final check sum is (%#lx  %#lx)\n", checksum.suma, checksum.sumb);
@@ -609,6 +742,7 @@ int write_lime_contraction(double * const s, char * filename, const int prec, co
     fflush(ofs);
     fclose(ofs);
   }
+#endif
   write_checksum(filename, &checksum);
   return(0);
 }
@@ -688,6 +822,54 @@ int write_lime_contraction(double * const s, char * filename, const int prec, co
  * read_lime_contraction
  ***********************************************************/
 
+#ifdef MPI
+int read_lime_contraction(double * const s, char * filename, const int N, const int position) {
+  int status=0, prec = 32;
+  MPI_Offset offset;
+  n_uint64_t bytes, vol = (n_uint64_t)LX_global*LY_global*LZ_global*T_global;
+  DML_Checksum checksum;
+
+  status = mpiio_lime_record(filename, "scidac-binary-data", position, &offset, &bytes);
+  if(status == 1) {
+    return(106);
+  } else if(status == 2) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "no scidac-binary-data record found in file %s\n",filename);
+      fprintf(stderr, "try to read in non-lime format\n");
+    }
+    return(read_contraction(s, NULL, filename, N));
+  } else if(status != 0) {
+    return(-1);
+  }
+  if(bytes == vol*2*N*sizeof(double)) prec = 64;
+  else if(bytes == vol*2*N*sizeof(float)) prec = 32;
+  else {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "wrong length in contraction: bytes = %llu, not %llu. Aborting read!\n", (unsigned long long)bytes, (unsigned long long)(vol*2*N*sizeof(float)));
+    }
+    return(-1);
+  }
+  if(g_proc_id == 0) {
+    printf("# %d Bit precision read\n", prec);
+  }
+
+  status = read_binary_contraction_data_mpiio(s, filename, offset, prec, N, &checksum);
+
+  if(g_proc_id == 0) {
+    printf("# checksum for contractions in file %s position %d is %#x %#x\n",
+           filename, position, checksum.suma, checksum.sumb);
+  }
+
+  if(status < 0) {
+    fprintf(stderr, "MPI-IO read error occured with status = %d while reading file %s!\n Aborting...\n",
+            status, filename);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(500);
+  }
+  return(0);
+}
+#else
 int read_lime_contraction(double * const s, char * filename, const int N, const int position) {
   FILE *ifs=(FILE*)NULL;
   int status=0, getpos=-1;
@@ -766,6 +948,7 @@ int read_lime_contraction(double * const s, char * filename, const int N, const
   fclose(ifs);
   return(0);
 }
+#endif
 
 
 
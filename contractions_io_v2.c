@@ -42,6 +42,16 @@
  * write_binary_contraction_data
  ****************************************************/
 #ifndef HAVE_LIBLEMON
+#ifdef PARALLELTXYZ
+int write_binary_contraction_data_v2(double * const s, LimeWriter * limewriter,
+                                      const int prec, const int N, DML_Checksum * ans) {
+  DML_checksum_init(ans);
+  if(g_cart_id == 0) {
+    fprintf(stderr, "\n[write_binary_contraction_data] Error: no version implemented for PARALLELTXYZ\n");
+  }
+  return(-1);
+}
+#else
 int write_binary_contraction_data_v2(double * const s, LimeWriter * limewriter,
                                       const int prec, const int N, DML_Checksum * ans) {
 
@@ -323,6 +333,7 @@ int write_binary_contraction_data_v2(double * const s, LimeWriter * limewriter,
    
   return(0);
 }
+#endif  // of ifdef PARALLELTXYZ
 #else  // HAVE_LIBLEMON
 int write_binary_contraction_data_v2(double * const s, LemonWriter * writer, const int prec, const int N, DML_Checksum * ans) {
 
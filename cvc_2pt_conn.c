@@ -7,7 +7,8 @@
  * - major change: source momentum must be negative of sink momentum ( i.e. correlation of the form
  *   <G(x) G(y)^\dagger> exp(i \vec{k} (\vec{x} - \vec{y}) )
  * - propagators are assumed to have been generated with correctly chosen source momenta
- * - multiplication with momentum factor exp( i \vec{k} ( \vec{x}-\vec{x_src} ) ) in contract_twopoint_snk_momentum
+ * - multiplication with momentum factor exp( i \vec{k} ( \vec{x}-\vec{x_src} ) ) in contract_twopoint_snk_momentum_batch,
+ *   all 40 gamma structures of one smearing combination in one call
  * TODO:
  * - test with smearing
  * - tests with point sources (n_c = 3)
@@ -49,6 +50,7 @@
 #include "read_input_parser.h"
 #include "smearing_techniques.h"
 #include "make_q_orbits.h"
+#include "contract_twopoint_batch.h"
 
 void usage() {
   fprintf(stdout, "Code to perform contractions for connected contributions\n");
@@ -124,6 +126,7 @@ int main(int argc, char **argv) {
   int snk_momentum_runs = 1, snk_momentum_id=0, snk_momentum[3], src_momentum[3], imom;
   int shift_vector[5][4] =  {{0,0,0,0}, {1,0,0,0}, {0,1,0,0}, {0,0,1,0}, {0,0,0,1}};
   size_t nconn_length=0, cconn_length=0;
+  double *Cbatch=NULL, *nCbatch=NULL;
 
   /**************************************************************************************************
    * charged stuff
@@ -372,6 +375,14 @@ int main(int argc, char **argv) {
     fprintf(stderr, "Error, could not allocate mem for Ctmp\n");
     EXIT(4);
   }
+
+  /* all 40 gamma structures of one smearing combination at once */
+  Cbatch  = (double*)malloc(2*40*T*sizeof(double));
+  nCbatch = (double*)malloc(2*40*T*sizeof(double));
+  if( Cbatch == NULL || nCbatch == NULL ) {
+    fprintf(stderr, "Error, could not allocate mem for Cbatch\n");
+    EXIT(4);
+  }
   
 
   if( N_Jacobi>0) {
@@ -755,12 +766,14 @@ int main(int argc, char **argv) {
             /************************************************************
              * the charged contractions
              ************************************************************/
+            memset(Cbatch, 0, 2*40*T*sizeof(double));
+            contract_twopoint_snk_momentum_batch(Cbatch, 40, gindex1, gindex2, chi, psi, n_c, 1, snk_momentum);
             sl = 2*ll*T*K;
             itype = 1; 
             // pion sector
             for(idx=0; idx<9; idx++)
             {
-              contract_twopoint_snk_momentum(&cconn[sl], gindex1[idx], gindex2[idx], chi, psi, n_c, snk_momentum);
+              for(x0=0; x0<2*T; x0++) cconn[sl+x0] += Cbatch[2*T*idx+x0];
               //for(x0=0; x0<T; x0++) fprintf(stdout, "pion: %3d%25.16e%25.16e\n", x0, 
               //    cconn[sl+2*x0]/(double)VOL3/2./g_kappa/g_kappa, cconn[sl+2*x0+1]/(double)VOL3/2./g_kappa/g_kappa);
               sl += (2*T);        
@@ -770,8 +783,7 @@ int main(int argc, char **argv) {
             // rho sector
             for(idx = 9; idx < 36; idx+=3) {
               for(i = 0; i < 3; i++) {
-                for(x0=0; x0<2*T; x0++) Ctmp[x0] = 0.;
-                contract_twopoint_snk_momentum(Ctmp, gindex1[idx+i], gindex2[idx+i], chi, psi, n_c, snk_momentum);
+                memcpy(Ctmp, Cbatch+2*T*(idx+i), 2*T*sizeof(double));
                 for(x0=0; x0<T; x0++) {
                   cconn[sl+2*x0  ] += (conf_gamma_sign[(idx-9)/3]*vsign[idx-9+i]*Ctmp[2*x0  ]);
                   cconn[sl+2*x0+1] += (conf_gamma_sign[(idx-9)/3]*vsign[idx-9+i]*Ctmp[2*x0+1]);
@@ -788,15 +800,14 @@ int main(int argc, char **argv) {
             }
       
             // the a0
-            contract_twopoint_snk_momentum(&cconn[sl], gindex1[36], gindex2[36], chi, psi, n_c, snk_momentum);
+            for(x0=0; x0<2*T; x0++) cconn[sl+x0] += Cbatch[2*T*36+x0];
             sl += (2*T);
             itype++;
       
             // the b1
             for(i=0; i<3; i++) {
-              for(x0=0; x0<2*T; x0++) Ctmp[x0] = 0.;
               idx = 37;
-              contract_twopoint_snk_momentum(Ctmp, gindex1[idx+i], gindex2[idx+i], chi, psi, n_c, snk_momentum);
+              memcpy(Ctmp, Cbatch+2*T*(idx+i), 2*T*sizeof(double));
               for(x0=0; x0<T; x0++) { 
                 cconn[sl+2*x0  ] += (vsign[idx-9+i]*Ctmp[2*x0  ]);
                 cconn[sl+2*x0+1] += (vsign[idx-9+i]*Ctmp[2*x0+1]);
@@ -807,11 +818,13 @@ int main(int argc, char **argv) {
              * the neutral contractions
              ************************************************************/
             if(fermion_type == 0) {
+              memset(nCbatch, 0, 2*40*T*sizeof(double));
+              contract_twopoint_snk_momentum_batch(nCbatch, 40, ngindex1, ngindex2, chi2, psi2, n_c, 1, snk_momentum);
               sl = 2*ll*nK*T;
               itype = 1;
               // pion sector first
               for(idx=0; idx<9; idx++) {
-                contract_twopoint_snk_momentum(&nconn[sl], ngindex1[idx], ngindex2[idx], chi2, psi2, n_c, snk_momentum);
+                for(x0=0; x0<2*T; x0++) nconn[sl+x0] += nCbatch[2*T*idx+x0];
                 sl += (2*T);
                 itype++;
               }
@@ -819,8 +832,7 @@ int main(int argc, char **argv) {
               // the neutral rho
               for(idx=9; idx<36; idx+=3) {
                 for(i=0; i<3; i++) {
-                  for(x0=0; x0<2*T; x0++) Ctmp[x0] = 0.;
-                  contract_twopoint_snk_momentum(Ctmp, ngindex1[idx+i], ngindex2[idx+i], chi2, psi2, n_c, snk_momentum);
+                  memcpy(Ctmp, nCbatch+2*T*(idx+i), 2*T*sizeof(double));
                   for(x0=0; x0<T; x0++) {
                     nconn[sl+2*x0  ] += (nvsign[idx-9+i]*Ctmp[2*x0  ]);
                     nconn[sl+2*x0+1] += (nvsign[idx-9+i]*Ctmp[2*x0+1]);
@@ -831,15 +843,14 @@ int main(int argc, char **argv) {
               }
         
               // the X (JPC=0+- with no experimental candidate known)
-              contract_twopoint_snk_momentum(&nconn[sl], ngindex1[36], ngindex2[36], chi2, psi2, n_c, snk_momentum);
+              for(x0=0; x0<2*T; x0++) nconn[sl+x0] += nCbatch[2*T*36+x0];
               sl += (2*T);
               itype++;
         
               // the a1/f1
               for(i = 0; i < 3; i++) {
-                for(x0=0; x0<2*T; x0++) Ctmp[x0] = 0.;
                 idx = 37;
-                contract_twopoint_snk_momentum(Ctmp, ngindex1[idx+i], ngindex2[idx+i], chi2, psi2, n_c, snk_momentum);
+                memcpy(Ctmp, nCbatch+2*T*(idx+i), 2*T*sizeof(double));
                 for(x0=0; x0<T; x0++) {
                   nconn[sl+2*x0  ] += (nvsign[idx-9+i]*Ctmp[2*x0  ]);
                   nconn[sl+2*x0+1] += (nvsign[idx-9+i]*Ctmp[2*x0+1]);
@@ -976,6 +987,8 @@ int main(int argc, char **argv) {
   free(cconn);
   free(nconn);
   free(Ctmp);
+  free(Cbatch);
+  free(nCbatch);
   free(gauge_field_f);
 
   finalize_q_orbits(&qlatt_id, &qlatt_count, &qlatt_list, &qlatt_rep);
@@ -46,6 +46,7 @@ void usage() {
   fprintf(stdout, "         -l Nlong for fuzzing [default -1, no fuzzing]\n");
   fprintf(stdout, "         -a no of steps for APE smearing [default -1, no smearing]\n");
   fprintf(stdout, "         -k alpha for APE smearing [default 0.]\n");
+  fprintf(stdout, "         -b number of timeslices read and contracted at once [default 1]\n");
   EXIT(0);
 }
 
@@ -103,6 +104,7 @@ int main(int argc, char **argv) {
   int c, i, j, ll, sl, status;
   int filename_set = 0;
   int timeslice=-1, mms1=-1;
+  int nt_block=1, nt_read=1, *tlist=NULL;
   int l_LX_at, l_LXstart_at;
   int x0, x1, x2, ix, idx;
   unsigned int VOL3, icol;
@@ -199,7 +201,7 @@ int main(int argc, char **argv) {
 
   MPI_Init(&argc, &argv);
 
-  while ((c = getopt(argc, argv, "soh?vguf:p:F:P:")) != -1) {
+  while ((c = getopt(argc, argv, "soh?vguf:p:F:P:b:")) != -1) {
     switch (c) {
     case 'v':
       verbose = 1;
@@ -239,6 +241,10 @@ int main(int argc, char **argv) {
       sprintf(pre_string, "pre%.2d", atoi(optarg));
       fprintf(stdout, "# [cvc_2pt_conn] will use precision string \"%s\"\n", pre_string);
       break;
+    case 'b':
+      nt_block = atoi(optarg);
+      fprintf(stdout, "# [cvc_2pt_conn] will read and contract %d timeslices at once\n", nt_block);
+      break;
     case 'h':
     case '?':
     default:
@@ -483,13 +489,21 @@ int main(int argc, char **argv) {
   fprintf(stdout, "# [cvc_2pt_conn] total number of fields = %d\n", no_fields);
   g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
 
+  // blocks of nt_block timeslices
+  if(nt_block < 1) nt_block = 1;
+  if(nt_block > T) nt_block = T;
+  if( (tlist = (int*)malloc(nt_block*sizeof(int))) == NULL ) {
+    fprintf(stderr, "[cvc_2pt_conn] proc%.4d Error, could not allocate tlist\n", proc_id);
+    EXIT(118);
+  }
+
   if(!use_mms) {
     for(i=0; i<no_fields; i++) {
-      alloc_spinor_field(&g_spinor_field[i], VOL3);
+      alloc_spinor_field(&g_spinor_field[i], nt_block*VOL3);
     }
   } else {
     for(i=0; i<no_fields-2; i++) {
-      alloc_spinor_field(&g_spinor_field[i], VOL3);
+      alloc_spinor_field(&g_spinor_field[i], nt_block*VOL3);
     }
     alloc_spinor_field(&g_spinor_field[no_fields-2], VOLUMEPLUSRAND);
     alloc_spinor_field(&g_spinor_field[no_fields-1], VOLUMEPLUSRAND);
@@ -598,7 +612,14 @@ int main(int argc, char **argv) {
         for(ix=0; ix<8*K*T_global; ix++) cconn[ix] = 0.;
         for(ix=0; ix<8*K*T_global; ix++) nconn[ix] = 0.;
     
-        for(timeslice=0; timeslice<T; timeslice++) {
+        if(!use_mms) {
+          for(i=0; i<no_fields; i++) DML_checksum_init(spinor_checksum+i);
+        }
+
+        for(timeslice=0; timeslice<T; timeslice+=nt_block) {
+          // the timeslices timeslice,...,timeslice+nt_read-1 of the propagators
+          nt_read = T - timeslice < nt_block ? T - timeslice : nt_block;
+          for(x0=0; x0<nt_read; x0++) tlist[x0] = timeslice + x0;
 
         /*************************************
          * begin loop on LL, LS, SL, SS
@@ -621,33 +642,33 @@ int main(int argc, char **argv) {
                   Q_phi_tbc(work2, work);
                   g_mu = -g_mu;
                   g5_phi(work2);
-                  memcpy(g_spinor_field[i], work2 + _GSI(g_ipt[timeslice][0][0][0]), 24*VOL3*sizeof(double));
+                  memcpy(g_spinor_field[i], work2 + _GSI(g_ipt[timeslice][0][0][0]), 24*nt_read*VOL3*sizeof(double));
 
                   // g_spinor_field[i+n_s*n_c] <- g5 D_- work
                   if(fermion_type == 0) {
                     // Qf5(g_spinor_field[i+n_s*n_c], work, g_mu);
                     Q_phi_tbc(work2, work);
                     g5_phi(work2);
-                    memcpy(g_spinor_field[i+n_s*n_c], work2 + _GSI(g_ipt[timeslice][0][0][0]), 24*VOL3*sizeof(double));
+                    memcpy(g_spinor_field[i+n_s*n_c], work2 + _GSI(g_ipt[timeslice][0][0][0]), 24*nt_read*VOL3*sizeof(double));
                   }
                 } else {
                   get_propagator_filename(filename, filename_prefix, source_coords, i, src_momentum_zero, Nconf, +1);
                   check_error( \
-                    read_lime_spinor_timeslice(g_spinor_field[i], timeslice, filename, g_propagator_position, spinor_checksum+i), \
-                    "read_lime_spinor_timeslice", NULL, 15);
+                    read_lime_spinor_trange(g_spinor_field[i], filename, g_propagator_position, nt_read, tlist, spinor_checksum+i), \
+                    "read_lime_spinor_trange", NULL, 15);
                   if(g_sink_momentum_set) {
                     get_propagator_filename(filename, filename_prefix, source_coords, i, src_momentum, Nconf, +1);
                     check_error( \
-                      read_lime_spinor_timeslice(g_spinor_field[i+n_s*n_c], timeslice, filename, g_propagator_position, \
+                      read_lime_spinor_trange(g_spinor_field[i+n_s*n_c], filename, g_propagator_position, nt_read, tlist, \
                         spinor_checksum+i+n_s*n_c), \
-                      "read_lime_spinor_timeslice", NULL, 15);
+                      "read_lime_spinor_trange", NULL, 15);
                   }
                   if(fermion_type == 0) { // read down propagators
                     get_propagator_filename(filename, filename_prefix2, source_coords, i, src_momentum, Nconf, -1);
                     check_error( \
-                      read_lime_spinor_timeslice(g_spinor_field[i+n_s*n_c*(1+g_sink_momentum_set)], timeslice, filename, \
-                        g_propagator_position, spinor_checksum+i+n_s*n_c*(1+g_sink_momentum_set)), \
-                      "read_lime_spinor_timeslice", NULL, 16);
+                      read_lime_spinor_trange(g_spinor_field[i+n_s*n_c*(1+g_sink_momentum_set)], filename, \
+                        g_propagator_position, nt_read, tlist, spinor_checksum+i+n_s*n_c*(1+g_sink_momentum_set)), \
+                      "read_lime_spinor_trange", NULL, 16);
                     // check_error(read_lime_spinor(g_spinor_field[i+n_s*n_c*(1+g_sink_momentum_set)], filename, 1), "read_lime_spinor", NULL, 16);
                   }
                 }  // of if use_mms
@@ -831,7 +852,7 @@ int main(int argc, char **argv) {
             // pion sector
             for(idx=0; idx<9; idx++)
             {
-              contract_twopoint_snk_momentum_trange(&cconn[sl], gindex1[idx], gindex2[idx], chi, psi, n_c, snk_momentum, 0, 0);
+              contract_twopoint_snk_momentum_trange(&cconn[sl], gindex1[idx], gindex2[idx], chi, psi, n_c, snk_momentum, 0, nt_read-1);
               //for(x0=0; x0<T; x0++) fprintf(stdout, "pion: %3d%25.16e%25.16e\n", x0, 
               //    cconn[sl+2*x0]/(double)VOL3/2./g_kappa/g_kappa, cconn[sl+2*x0+1]/(double)VOL3/2./g_kappa/g_kappa);
               sl += (2*T);
@@ -842,7 +863,7 @@ int main(int argc, char **argv) {
             for(idx = 9; idx < 36; idx+=3) {
               for(i = 0; i < 3; i++) {
                 for(x0=0; x0<2*T; x0++) Ctmp[x0] = 0.;
-                contract_twopoint_snk_momentum_trange(Ctmp, gindex1[idx+i], gindex2[idx+i], chi, psi, n_c, snk_momentum, 0, 0);
+                contract_twopoint_snk_momentum_trange(Ctmp, gindex1[idx+i], gindex2[idx+i], chi, psi, n_c, snk_momentum, 0, nt_read-1);
                 for(x0=0; x0<T; x0++) {
                   cconn[sl+2*x0  ] += (conf_gamma_sign[(idx-9)/3]*vsign[idx-9+i]*Ctmp[2*x0  ]);
                   cconn[sl+2*x0+1] += (conf_gamma_sign[(idx-9)/3]*vsign[idx-9+i]*Ctmp[2*x0+1]);
@@ -859,7 +880,7 @@ int main(int argc, char **argv) {
             }
       
             // the a0
-            contract_twopoint_snk_momentum_trange(&cconn[sl], gindex1[36], gindex2[36], chi, psi, n_c, snk_momentum, 0, 0);
+            contract_twopoint_snk_momentum_trange(&cconn[sl], gindex1[36], gindex2[36], chi, psi, n_c, snk_momentum, 0, nt_read-1);
             sl += (2*T);
             itype++;
       
@@ -867,7 +888,7 @@ int main(int argc, char **argv) {
             for(i=0; i<3; i++) {
               for(x0=0; x0<2*T; x0++) Ctmp[x0] = 0.;
               idx = 37;
-              contract_twopoint_snk_momentum_trange(Ctmp, gindex1[idx+i], gindex2[idx+i], chi, psi, n_c, snk_momentum, 0, 0);
+              contract_twopoint_snk_momentum_trange(Ctmp, gindex1[idx+i], gindex2[idx+i], chi, psi, n_c, snk_momentum, 0, nt_read-1);
               for(x0=0; x0<T; x0++) { 
                 cconn[sl+2*x0  ] += (vsign[idx-9+i]*Ctmp[2*x0  ]);
                 cconn[sl+2*x0+1] += (vsign[idx-9+i]*Ctmp[2*x0+1]);
@@ -886,7 +907,7 @@ int main(int argc, char **argv) {
 
               // pion sector first
               for(idx=0; idx<9; idx++) {
-                contract_twopoint_snk_momentum_trange(&nconn[sl], ngindex1[idx], ngindex2[idx], chi2, psi2, n_c, snk_momentum, 0, 0);
+                contract_twopoint_snk_momentum_trange(&nconn[sl], ngindex1[idx], ngindex2[idx], chi2, psi2, n_c, snk_momentum, 0, nt_read-1);
                 sl += (2*T);
                 itype++;
               }
@@ -895,7 +916,7 @@ int main(int argc, char **argv) {
               for(idx=9; idx<36; idx+=3) {
                 for(i=0; i<3; i++) {
                   for(x0=0; x0<2*T; x0++) Ctmp[x0] = 0.;
-                  contract_twopoint_snk_momentum_trange(Ctmp, ngindex1[idx+i], ngindex2[idx+i], chi2, psi2, n_c, snk_momentum, 0, 0);
+                  contract_twopoint_snk_momentum_trange(Ctmp, ngindex1[idx+i], ngindex2[idx+i], chi2, psi2, n_c, snk_momentum, 0, nt_read-1);
                   for(x0=0; x0<T; x0++) {
                     nconn[sl+2*x0  ] += (nvsign[idx-9+i]*Ctmp[2*x0  ]);
                     nconn[sl+2*x0+1] += (nvsign[idx-9+i]*Ctmp[2*x0+1]);
@@ -906,7 +927,7 @@ int main(int argc, char **argv) {
               }
         
               // the X (JPC=0+- with no experimental candidate known)
-              contract_twopoint_snk_momentum_trange(&nconn[sl], ngindex1[36], ngindex2[36], chi2, psi2, n_c, snk_momentum, 0, 0);
+              contract_twopoint_snk_momentum_trange(&nconn[sl], ngindex1[36], ngindex2[36], chi2, psi2, n_c, snk_momentum, 0, nt_read-1);
               sl += (2*T);
               itype++;
         
@@ -914,7 +935,7 @@ int main(int argc, char **argv) {
               for(i = 0; i < 3; i++) {
                 for(x0=0; x0<2*T; x0++) Ctmp[x0] = 0.;
                 idx = 37;
-                contract_twopoint_snk_momentum_trange(Ctmp, ngindex1[idx+i], ngindex2[idx+i], chi2, psi2, n_c, snk_momentum, 0, 0);
+                contract_twopoint_snk_momentum_trange(Ctmp, ngindex1[idx+i], ngindex2[idx+i], chi2, psi2, n_c, snk_momentum, 0, nt_read-1);
                 for(x0=0; x0<T; x0++) {
                   nconn[sl+2*x0  ] += (nvsign[idx-9+i]*Ctmp[2*x0  ]);
                   nconn[sl+2*x0+1] += (nvsign[idx-9+i]*Ctmp[2*x0+1]);
@@ -926,6 +947,12 @@ int main(int argc, char **argv) {
           }    // of j=0,...,3
 
         }      // of loop on timeslice
+
+        if(!use_mms) {
+          for(i=0; i<((fermion_type==0)+g_sink_momentum_set+1)*n_s*n_c; i++) {
+            fprintf(stdout, "# [cvc_2pt_conn] checksum for propagator no. %2d is %#x %#x\n", i, spinor_checksum[i].suma, spinor_checksum[i].sumb);
+          }
+        }
       
         // write to file
         if(g_source_type == 0) {
@@ -1051,6 +1078,7 @@ int main(int argc, char **argv) {
   free(Ctmp);
   if(gauge_field_f != NULL) free(gauge_field_f);
   if(spinor_checksum != NULL) free(spinor_checksum);
+  if(tlist != NULL) free(tlist);
 
   finalize_q_orbits(&qlatt_id, &qlatt_count, &qlatt_list, &qlatt_rep);
   if(qlatt_map != NULL) {
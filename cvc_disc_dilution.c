@@ -0,0 +1,320 @@
+/****************************************************
+ * cvc_disc_dilution.c
+ *
+ * PURPOSE:
+ * - quark-disconnected loops (conserved vector current
+ *   and the 16 local bilinears) from diluted stochastic
+ *   sources, generated, inverted and contracted in memory
+ *   with the dilution engine (dilution.c)
+ * - samples g_sourceid, ..., g_sourceid2 in steps of
+ *   g_sourceid_step; noise from the counter-based rng,
+ *   so no source or propagator files are read or written
+ * - with hierarchical probing (-p) the estimate is built up
+ *   level by level, levels 0, ..., degree, reusing the solves
+ *   of the lower levels; one result per level
+ * - results are saved every Nsave samples
+ * TODO:
+ * DONE:
+ * CHANGES:
+ ****************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#include <getopt.h>
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+#define MAIN_PROGRAM
+
+#include "cvc_complex.h"
+#include "cvc_linalg.h"
+#include "global.h"
+#include "cvc_geometry.h"
+#include "cvc_utils.h"
+#include "mpi_init.h"
+#include "io.h"
+#include "propagator_io.h"
+#include "contractions_io.h"
+#include "Q_phi.h"
+#include "read_input_parser.h"
+#include "invert_Qtm.h"
+#include "gauge_io.h"
+#include "dilution.h"
+
+void usage() {
+  fprintf(stdout, "Code to calculate stochastic disconnected loops with in-memory dilution\n");
+  fprintf(stdout, "Usage:    [options]\n");
+  fprintf(stdout, "Options: -v verbose\n");
+  fprintf(stdout, "         -f input filename [default cvc.input]\n");
+  fprintf(stdout, "         -T time dilution\n");
+  fprintf(stdout, "         -S spin dilution\n");
+  fprintf(stdout, "         -C colour dilution\n");
+  fprintf(stdout, "         -d degree of the space dilution (1 = even/odd) [default 0]\n");
+  fprintf(stdout, "         -p degree of the hierarchical probing [default 0]\n");
+  fprintf(stdout, "         -e use the even/odd preconditioned solver\n");
+  fprintf(stdout, "         -t number of threads [default 1]\n");
+#ifdef MPI
+  MPI_Abort(MPI_COMM_WORLD, 1);
+  MPI_Finalize();
+#endif
+  exit(0);
+}
+
+/* contraction callback for the dilution engine: both loops at once */
+typedef struct {
+  double *disc;
+  double *loop;
+} disc_loops;
+
+static int contract_disc_loops(double *eta, double *phi, void *data) {
+  disc_loops *d = (disc_loops*)data;
+  dilution_contract_cvc(eta, phi, d->disc);
+  dilution_contract_local(eta, phi, d->loop);
+  return(0);
+}
+
+int main(int argc, char **argv) {
+
+  int c, i, status;
+  int filename_set = 0;
+  int ix, sid, count = 0;
+  int flags = 0, space_degree = 0, use_eo = 0;
+  int probing_degree = 0, level, nvec, nvec_prev, ninner;
+#ifdef OPENMP
+  int num_threads = 1;
+#endif
+  char filename[200], contype[200];
+  double ratime, retime;
+  double plaq, fnorm;
+  double *work = NULL;
+  double **disc_level = NULL, **loop_level = NULL;
+  dilution_scheme dil;
+  disc_loops loops;
+
+#ifdef MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  while ((c = getopt(argc, argv, "h?vTSCed:p:f:t:")) != -1) {
+    switch (c) {
+    case 'v':
+      g_verbose = 1;
+      break;
+    case 'T':
+      flags |= _DILUTION_TIME;
+      break;
+    case 'S':
+      flags |= _DILUTION_SPIN;
+      break;
+    case 'C':
+      flags |= _DILUTION_COLOR;
+      break;
+    case 'd':
+      space_degree = atoi(optarg);
+      break;
+    case 'p':
+      probing_degree = atoi(optarg);
+      break;
+    case 'e':
+      use_eo = 1;
+      break;
+    case 't':
+#ifdef OPENMP
+      num_threads = atoi(optarg);
+#endif
+      break;
+    case 'f':
+      strcpy(filename, optarg);
+      filename_set=1;
+      break;
+    case 'h':
+    case '?':
+    default:
+      usage();
+      break;
+    }
+  }
+
+  g_the_time = time(NULL);
+
+#ifdef OPENMP
+  omp_set_num_threads(num_threads);
+#endif
+
+  /**************************************
+   * set the default values, read input
+   **************************************/
+  if(filename_set==0) strcpy(filename, "cvc.input");
+  if(g_proc_id==0) fprintf(stdout, "# Reading input from file %s\n", filename);
+  read_input_parser(filename);
+
+  if((T_global == 0) || (LX==0) || (LY==0) || (LZ==0)) {
+    if(g_proc_id==0) fprintf(stderr, "[cvc_disc_dilution] Error, T and L's must be set\n");
+    usage();
+  }
+  if(g_kappa == 0.) {
+    if(g_proc_id==0) fprintf(stderr, "[cvc_disc_dilution] Error, kappa should be > 0.\n");
+    usage();
+  }
+
+  mpi_init(argc, argv);
+
+  if(init_geometry() != 0) {
+    fprintf(stderr, "[cvc_disc_dilution] Error from init_geometry\n");
+    EXIT(1);
+  }
+  geometry();
+
+  /**************************************
+   * read the gauge field
+   **************************************/
+  alloc_gauge_field(&g_gauge_field, VOLUMEPLUSRAND);
+  sprintf(filename, "%s.%.4d", gaugefilename_prefix, Nconf);
+  if(g_cart_id==0) fprintf(stdout, "# [cvc_disc_dilution] reading gauge field from file %s\n", filename);
+  read_lime_gauge_field_doubleprec(filename);
+#ifdef MPI
+  xchange_gauge();
+#endif
+  plaquette(&plaq);
+  if(g_cart_id==0) fprintf(stdout, "# [cvc_disc_dilution] measured plaquette value: %25.16e\n", plaq);
+
+  /**************************************
+   * noise, diluted source, solution
+   * and 7 solver work fields
+   **************************************/
+  no_fields = 10;
+  g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
+  for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOLUMEPLUSRAND);
+
+  /**************************************
+   * loops of the current sample and
+   * accumulated loops per probing level
+   **************************************/
+  loops.disc = (double*)calloc( 8*VOLUME, sizeof(double));
+  loops.loop = (double*)calloc(32*VOLUME, sizeof(double));
+  work       = (double*)calloc(32*VOLUME, sizeof(double));
+  disc_level = (double**)calloc(probing_degree+1, sizeof(double*));
+  loop_level = (double**)calloc(probing_degree+1, sizeof(double*));
+  if(loops.disc == NULL || loops.loop == NULL || work == NULL || disc_level == NULL || loop_level == NULL) {
+    fprintf(stderr, "[cvc_disc_dilution] Error, could not allocate memory for the loops\n");
+    EXIT(3);
+  }
+  for(level=0; level<=probing_degree; level++) {
+    disc_level[level] = (double*)calloc( 8*VOLUME, sizeof(double));
+    loop_level[level] = (double*)calloc(32*VOLUME, sizeof(double));
+    if(disc_level[level] == NULL || loop_level[level] == NULL) {
+      fprintf(stderr, "[cvc_disc_dilution] Error, could not allocate memory for the loops\n");
+      EXIT(3);
+    }
+  }
+
+  if(init_dilution_scheme(&dil, flags, space_degree) != 0) {
+    fprintf(stderr, "[cvc_disc_dilution] Error from init_dilution_scheme\n");
+    EXIT(4);
+  }
+  ninner = dil.npart;
+  if(probing_degree > 0) {
+    if(init_dilution_probing(&dil, probing_degree) != 0) {
+      fprintf(stderr, "[cvc_disc_dilution] Error from init_dilution_probing\n");
+      EXIT(4);
+    }
+  }
+
+  /***********************************************
+   * loop on samples
+   ***********************************************/
+  for(sid=g_sourceid; sid<=g_sourceid2; sid+=g_sourceid_step) {
+
+#ifdef MPI
+    ratime = MPI_Wtime();
+#else
+    ratime = (double)clock() / CLOCKS_PER_SEC;
+#endif
+    memset(loops.disc, 0,  8*VOLUME*sizeof(double));
+    memset(loops.loop, 0, 32*VOLUME*sizeof(double));
+
+    /* probing level by level, only the new vectors are solved */
+    nvec_prev = 0;
+    for(level=0; level<=probing_degree; level++) {
+      nvec = hierarchical_probing_ncolour(level);
+      status = dilution_run_partitions(&dil, sid, nvec_prev*ninner, nvec*ninner, use_eo ? invert_Qtm_eo : invert_Qtm, 3,
+          contract_disc_loops, &loops, g_spinor_field[0], g_spinor_field[1], g_spinor_field[2]);
+      if(status != 0) {
+        fprintf(stderr, "[cvc_disc_dilution] Error from dilution_run_partitions, status was %d\n", status);
+        EXIT(5);
+      }
+      for(ix=0; ix< 8*VOLUME; ix++) disc_level[level][ix] += loops.disc[ix] / (double)nvec;
+      for(ix=0; ix<32*VOLUME; ix++) loop_level[level][ix] += loops.loop[ix] / (double)nvec;
+      nvec_prev = nvec;
+    }
+    count++;
+#ifdef MPI
+    retime = MPI_Wtime();
+#else
+    retime = (double)clock() / CLOCKS_PER_SEC;
+#endif
+    if(g_cart_id==0) fprintf(stdout, "# [cvc_disc_dilution] time for sample %d with %d partitions: %e seconds\n", sid, dil.npart, retime-ratime);
+
+    /***************************************************
+     * save results for count = multiple of Nsave
+     ***************************************************/
+    if(count%Nsave == 0 || sid+g_sourceid_step > g_sourceid2) {
+      fnorm = 1. / ( (double)count * g_prop_normsqr );
+      if(g_cart_id==0) fprintf(stdout, "# [cvc_disc_dilution] save results for count = %d with fnorm = %e\n", count, fnorm);
+
+      for(level=0; level<=probing_degree; level++) {
+        for(ix=0; ix<8*VOLUME; ix++) work[ix] = disc_level[level][ix] * fnorm;
+        if(probing_degree > 0) {
+          sprintf(filename, "outcvc_X.%.4d.%.4d.hp%d", Nconf, count, level);
+        } else {
+          sprintf(filename, "outcvc_X.%.4d.%.4d", Nconf, count);
+        }
+        sprintf(contype, "cvc-disc-dilution-X");
+        write_lime_contraction(work, filename, 64, 4, contype, Nconf, count);
+
+        for(ix=0; ix<32*VOLUME; ix++) work[ix] = loop_level[level][ix] * fnorm;
+        if(probing_degree > 0) {
+          sprintf(filename, "outloop_X.%.4d.%.4d.hp%d", Nconf, count, level);
+        } else {
+          sprintf(filename, "outloop_X.%.4d.%.4d", Nconf, count);
+        }
+        sprintf(contype, "local-disc-dilution-X");
+        write_lime_contraction(work, filename, 64, 16, contype, Nconf, count);
+      }
+    }
+  }  /* of loop on sid */
+
+  /***********************************************
+   * free the allocated memory, finalize
+   ***********************************************/
+  fini_dilution_scheme(&dil);
+  free(work);
+  free(loops.disc);
+  free(loops.loop);
+  for(level=0; level<=probing_degree; level++) {
+    free(disc_level[level]);
+    free(loop_level[level]);
+  }
+  free(disc_level);
+  free(loop_level);
+  free(g_gauge_field);
+  for(i=0; i<no_fields; i++) free(g_spinor_field[i]);
+  free(g_spinor_field);
+  free_geometry();
+
+  if(g_cart_id==0) {
+    g_the_time = time(NULL);
+    fprintf(stdout, "# [cvc_disc_dilution] %s# [cvc_disc_dilution] end of run\n", ctime(&g_the_time));
+  }
+#ifdef MPI
+  MPI_Finalize();
+#endif
+  return(0);
+}
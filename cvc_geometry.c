@@ -30,7 +30,7 @@ unsigned long int get_index(const int t, const int x, const int y, const int z)
   if(t==-1) {
     ix = VOLUME +   LX*LY*LZ + (xx*LY+yy)*LZ+zz;
   }
-#  if defined PARALLELTX || defined PARALLELTXY
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
   if(x==LX) {
     ix = VOLUME + 2*LX*LY*LZ +           (tt*LY+yy)*LZ+zz;
   }
@@ -38,7 +38,7 @@ unsigned long int get_index(const int t, const int x, const int y, const int z)
     ix = VOLUME + 2*LX*LY*LZ + T*LY*LZ + (tt*LY+yy)*LZ+zz;
   }
 #  endif
-#  if defined PARALLELTXY
+#  if defined PARALLELTXY || defined PARALLELTXYZ
   if(y==LY) {
     ix = VOLUME + 2*(LX*LY*LZ + T*LY*LZ) + (tt*LX+xx)*LZ+zz;
   }
@@ -46,8 +46,16 @@ unsigned long int get_index(const int t, const int x, const int y, const int z)
     ix = VOLUME + 2*(LX*LY*LZ + T*LY*LZ) + T*LX*LZ + (tt*LX+xx)*LZ+zz;
   }
 #  endif
+#  if defined PARALLELTXYZ
+  if(z==LZ) {
+    ix = VOLUME + 2*(LX*LY*LZ + T*LY*LZ + T*LX*LZ) +           (tt*LX+xx)*LY+yy;
+  }
+  if(z==-1) {
+    ix = VOLUME + 2*(LX*LY*LZ + T*LY*LZ + T*LX*LZ) + T*LX*LY + (tt*LX+xx)*LY+yy;
+  }
+#  endif
 
-#  if defined PARALLELTX || defined PARALLELTXY
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
 
   /* x-t-edges */
   if(x==LX) {
@@ -66,7 +74,7 @@ unsigned long int get_index(const int t, const int x, const int y, const int z)
       ix = VOLUME + RAND + 3*LY*LZ + yy*LZ+zz;
     }
   }
-#  if defined PARALLELTXY
+#  if defined PARALLELTXY || defined PARALLELTXYZ
   /* y-t-edges */
   if(t==T) {
     if(y==LY) {
@@ -102,8 +110,63 @@ unsigned long int get_index(const int t, const int x, const int y, const int z)
       ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ) + 3*T*LZ + tt*LZ+zz;
     }
   }
-#  endif  /* of if defined PARALLELTXY */
-#  endif  /* of if defined PARALLELTX || defined PARALLELTXY */
+#  endif  /* of if defined PARALLELTXY || defined PARALLELTXYZ */
+#  if defined PARALLELTXYZ
+  /* z-t-edges */
+  if(t==T) {
+    if(z==LZ) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ)           + xx*LY+yy;
+    }
+    if(z==-1) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ) +   LX*LY + xx*LY+yy;
+    }
+  }
+  if(t==-1) {
+    if(z==LZ) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ) + 2*LX*LY + xx*LY+yy;
+    }
+    if(z==-1) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ) + 3*LX*LY + xx*LY+yy;
+    }
+  }
+
+  /* z-x-edges */
+  if(x==LX) {
+    if(z==LZ) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY)          + tt*LY+yy;
+    }
+    if(z==-1) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY) +   T*LY + tt*LY+yy;
+    }
+  }
+  if(x==-1) {
+    if(z==LZ) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY) + 2*T*LY + tt*LY+yy;
+    }
+    if(z==-1) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY) + 3*T*LY + tt*LY+yy;
+    }
+  }
+
+  /* z-y-edges */
+  if(y==LY) {
+    if(z==LZ) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY + T*LY)          + tt*LX+xx;
+    }
+    if(z==-1) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY + T*LY) +   T*LX + tt*LX+xx;
+    }
+  }
+  if(y==-1) {
+    if(z==LZ) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY + T*LY) + 2*T*LX + tt*LX+xx;
+    }
+    if(z==-1) {
+      ix = VOLUME + RAND + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY + T*LY) + 3*T*LX + tt*LX+xx;
+    }
+  }
+#  endif  /* of if defined PARALLELTXYZ */
+#  endif  /* of if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ */
 #endif
   return(ix);
 }
@@ -111,7 +174,7 @@ unsigned long int get_index(const int t, const int x, const int y, const int z)
 void geometry() {
 
   int x0, x1, x2, x3;
-  int y0, y1, y2, y3, ix;
+  int y0, y1, y2, y3, ix, mu;
   int isboundary;
   int i_even, i_odd;
   int itzyx;
@@ -119,39 +182,48 @@ void geometry() {
 #ifdef MPI
   int start_valuet = 1;
 
-#  if defined PARALLELTX || defined PARALLELTXY
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
   int start_valuex = 1;
 #  else
   int start_valuex = 0;
 #  endif
 
-#  if defined PARALLELTXY
+#  if defined PARALLELTXY || defined PARALLELTXYZ
   int start_valuey = 1;
 #  else
   int start_valuey = 0;
 #  endif
 
+#  if defined PARALLELTXYZ
+  int start_valuez = 1;
+#  else
+  int start_valuez = 0;
+#  endif
+
 #else
   int start_valuet = 0;
   int start_valuex = 0;
   int start_valuey = 0;
+  int start_valuez = 0;
 #endif
 
   for(x0=-start_valuet; x0<T +start_valuet; x0++) {
   for(x1=-start_valuex; x1<LX+start_valuex; x1++) {
   for(x2=-start_valuey; x2<LY+start_valuey; x2++) {
 
-  for(x3=0; x3<LZ; x3++) {
+  for(x3=-start_valuez; x3<LZ+start_valuez; x3++) {
 
     isboundary = 0;
     if(x0==-1 || x0== T) isboundary++;
     if(x1==-1 || x1==LX) isboundary++;
     if(x2==-1 || x2==LY) isboundary++;
+    if(x3==-1 || x3==LZ) isboundary++;
 
     y0=x0; y1=x1; y2=x2; y3=x3;
     if(x0==-1) y0=T +1;
     if(x1==-1) y1=LX+1;
     if(x2==-1) y2=LY+1;
+    if(x3==-1) y3=LZ+1;
 
     if(isboundary > 2) {
       g_ipt[y0][y1][y2][y3] = -1;
@@ -219,6 +291,22 @@ void geometry() {
     itzyx++;
   }}}}
 
+  // sites with all neighbours inside the local lattice and sites
+  // with at least one neighbour in the boundary
+  g_interior_volume = 0;
+  g_boundary_volume = 0;
+  for(ix=0; ix<VOLUME; ix++) {
+    isboundary = 0;
+    for(mu=0; mu<4; mu++) {
+      isboundary += ( g_iup[ix][mu] >= VOLUME ) || ( g_idn[ix][mu] >= VOLUME );
+    }
+    if(isboundary) {
+      g_boundary2lexic[g_boundary_volume++] = ix;
+    } else {
+      g_interior2lexic[g_interior_volume++] = ix;
+    }
+  }
+
 
 
 /*
@@ -272,7 +360,7 @@ void geometry() {
 int init_geometry(void) {
 
   int ix = 0, V;
-  int dx = 0, dy = 0;
+  int dx = 0, dy = 0, dz = 0;
 
   VOLUME         = T*LX*LY*LZ;
   VOLUMEPLUSRAND = VOLUME;
@@ -283,20 +371,27 @@ int init_geometry(void) {
   RAND           += 2*LX*LY*LZ;
   VOLUMEPLUSRAND += 2*LX*LY*LZ;
 
-#if defined PARALLELTX || defined PARALLELTXY
+#if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
   RAND           += 2*T*LY*LZ;
   EDGES          +=             4*LY*LZ;
   VOLUMEPLUSRAND += 2*T*LY*LZ + 4*LY*LZ;
   dx = 2;
 #endif
 
-#if defined PARALLELTXY
+#if defined PARALLELTXY || defined PARALLELTXYZ
   RAND           += 2*T*LX*LZ;
   EDGES          +=             4*LX*LZ + 4*T*LZ;
   VOLUMEPLUSRAND += 2*T*LX*LZ + 4*LX*LZ + 4*T*LZ;
   dy = 2;
 #endif
 
+#if defined PARALLELTXYZ
+  RAND           += 2*T*LX*LY;
+  EDGES          +=             4*LX*LY + 4*T*LY + 4*T*LX;
+  VOLUMEPLUSRAND += 2*T*LX*LY + 4*LX*LY + 4*T*LY + 4*T*LX;
+  dz = 2;
+#endif
+
 #endif  /* of ifdef MPI */
 
   if(g_cart_id==0) {
@@ -330,7 +425,7 @@ int init_geometry(void) {
   ipt_ =  (int**)calloc((T+2)*(LX+dx)*(LY+dy), sizeof(int*));
   if((void*)ipt_ == NULL) return(7);
 
-  ipt =   (int*)calloc((T+2)*(LX+dx)*(LY+dy)*LZ, sizeof(int));
+  ipt =   (int*)calloc((T+2)*(LX+dx)*(LY+dy)*(LZ+dz), sizeof(int));
   if((void*)ipt == NULL) return(8);
 
  
@@ -344,7 +439,7 @@ int init_geometry(void) {
   ipt_[0]  = ipt;
   ipt__[0] = ipt_;
   g_ipt[0] = ipt__;
-  for(ix=1; ix<(T+2)*(LX+dx)*(LY+dy); ix++) ipt_[ix]  = ipt_[ix-1]  + LZ;
+  for(ix=1; ix<(T+2)*(LX+dx)*(LY+dy); ix++) ipt_[ix]  = ipt_[ix-1]  + (LZ+dz);
 
   for(ix=1; ix<(T+2)*(LX+dx);         ix++) ipt__[ix] = ipt__[ix-1] + (LY+dy);
 
@@ -369,6 +464,12 @@ int init_geometry(void) {
   g_isevent = (int*)calloc(V, sizeof(int));
   if(g_isevent == NULL) return(12);
 
+  g_interior2lexic = (int*)calloc(VOLUME, sizeof(int));
+  if(g_interior2lexic == NULL) return(13);
+
+  g_boundary2lexic = (int*)calloc(VOLUME, sizeof(int));
+  if(g_boundary2lexic == NULL) return(13);
+
 
   /* initialize the boundary condition */
   co_phase_up[0].re = cos(BCangle[0]*M_PI / (double)T_global);
@@ -377,8 +478,8 @@ int init_geometry(void) {
   co_phase_up[1].im = sin(BCangle[1]*M_PI / (double)(LX*g_nproc_x));
   co_phase_up[2].re = cos(BCangle[2]*M_PI / (double)(LY*g_nproc_y));
   co_phase_up[2].im = sin(BCangle[2]*M_PI / (double)(LY*g_nproc_y));
-  co_phase_up[3].re = cos(BCangle[3]*M_PI / (double)LZ);
-  co_phase_up[3].im = sin(BCangle[3]*M_PI / (double)LZ);
+  co_phase_up[3].re = cos(BCangle[3]*M_PI / (double)(LZ*g_nproc_z));
+  co_phase_up[3].im = sin(BCangle[3]*M_PI / (double)(LZ*g_nproc_z));
 
   /* initialize the gamma matrices */
   init_gamma();
@@ -402,6 +503,8 @@ void free_geometry() {
   free(g_eot2lexic);
   free(g_iseven);
   free(g_isevent);
+  free(g_interior2lexic);
+  free(g_boundary2lexic);
 }
 
 
@@ -515,7 +618,7 @@ int init_multigrid_decompositon(int degree, int**lexic2sub, int***sub2lexic, int
   }}}}
 
   // TEST
-
+  if(g_verbose > 2) {
   sprintf(filename, "geom.%.2d.%.2d", g_nproc, g_cart_id);
   ofs = fopen(filename, "w");
 
@@ -536,6 +639,7 @@ int init_multigrid_decompositon(int degree, int**lexic2sub, int***sub2lexic, int
     }
   }
   fclose(ofs);
+  }  /* of if g_verbose > 2 */
 
   if(eocounter[0] != NULL) free(eocounter[0]);
   if(eocounter[1] != NULL) free(eocounter[1]);
@@ -31,7 +31,7 @@ unsigned long int get_index_5d(const int s, const int t, const int x, const int
   if(t==-1) {
     ix = V5 + ss*RAND + LX*LY*LZ + (xx*LY+yy)*LZ+zz;
   }
-#  if defined PARALLELTX || defined PARALLELTXY
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
   if(x==LX) {
     ix = V5 + ss*RAND + 2*LX*LY*LZ +           (tt*LY+yy)*LZ+zz;
   }
@@ -39,7 +39,7 @@ unsigned long int get_index_5d(const int s, const int t, const int x, const int
     ix = V5 + ss*RAND + 2*LX*LY*LZ + T*LY*LZ + (tt*LY+yy)*LZ+zz;
   }
 #  endif
-#  if defined PARALLELTXY
+#  if defined PARALLELTXY || defined PARALLELTXYZ
   if(y==LY) {
     ix = V5 + ss*RAND + 2*(LX*LY*LZ + T*LY*LZ) + (tt*LX+xx)*LZ+zz;
   }
@@ -47,8 +47,16 @@ unsigned long int get_index_5d(const int s, const int t, const int x, const int
     ix = V5 + ss*RAND + 2*(LX*LY*LZ + T*LY*LZ) + T*LX*LZ + (tt*LX+xx)*LZ+zz;
   }
 #  endif
+#  if defined PARALLELTXYZ
+  if(z==LZ) {
+    ix = V5 + ss*RAND + 2*(LX*LY*LZ + T*LY*LZ + T*LX*LZ) +           (tt*LX+xx)*LY+yy;
+  }
+  if(z==-1) {
+    ix = V5 + ss*RAND + 2*(LX*LY*LZ + T*LY*LZ + T*LX*LZ) + T*LX*LY + (tt*LX+xx)*LY+yy;
+  }
+#  endif
 
-#  if defined PARALLELTX || defined PARALLELTXY
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
 
   // x-t-edges
   if(x==LX) {
@@ -67,7 +75,7 @@ unsigned long int get_index_5d(const int s, const int t, const int x, const int
       ix = V5 + L5*RAND + ss*EDGES + 3*LY*LZ + yy*LZ+zz;
     }
   }
-#  if defined PARALLELTXY
+#  if defined PARALLELTXY || defined PARALLELTXYZ
   // y-t-edges
   if(t==T) {
     if(y==LY) {
@@ -103,8 +111,63 @@ unsigned long int get_index_5d(const int s, const int t, const int x, const int
       ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ) + 3*T*LZ + tt*LZ+zz;
     }
   }
-#  endif  /* of if defined PARALLELTXY */
-#  endif  /* of if defined PARALLELTX || defined PARALLELTXY */
+#  endif  /* of if defined PARALLELTXY || defined PARALLELTXYZ */
+#  if defined PARALLELTXYZ
+  // z-t-edges
+  if(t==T) {
+    if(z==LZ) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ)           + xx*LY+yy;
+    }
+    if(z==-1) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ) +   LX*LY + xx*LY+yy;
+    }
+  }
+  if(t==-1) {
+    if(z==LZ) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ) + 2*LX*LY + xx*LY+yy;
+    }
+    if(z==-1) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ) + 3*LX*LY + xx*LY+yy;
+    }
+  }
+
+  // z-x-edges
+  if(x==LX) {
+    if(z==LZ) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY)          + tt*LY+yy;
+    }
+    if(z==-1) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY) +   T*LY + tt*LY+yy;
+    }
+  }
+  if(x==-1) {
+    if(z==LZ) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY) + 2*T*LY + tt*LY+yy;
+    }
+    if(z==-1) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY) + 3*T*LY + tt*LY+yy;
+    }
+  }
+
+  // z-y-edges
+  if(y==LY) {
+    if(z==LZ) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY + T*LY)          + tt*LX+xx;
+    }
+    if(z==-1) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY + T*LY) +   T*LX + tt*LX+xx;
+    }
+  }
+  if(y==-1) {
+    if(z==LZ) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY + T*LY) + 2*T*LX + tt*LX+xx;
+    }
+    if(z==-1) {
+      ix = V5 + L5*RAND + ss*EDGES + 4*(LY*LZ + LX*LZ + T*LZ + LX*LY + T*LY) + 3*T*LX + tt*LX+xx;
+    }
+  }
+#  endif  /* of if defined PARALLELTXYZ */
+#  endif  /* of if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ */
 #endif
   return(ix);
 }
@@ -123,22 +186,29 @@ void geometry_5d() {
 #ifdef MPI
   int start_valuet = 1;
 
-#  if defined PARALLELTX || defined PARALLELTXY
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
   int start_valuex = 1;
 #  else
   int start_valuex = 0;
 #  endif
 
-#  if defined PARALLELTXY
+#  if defined PARALLELTXY || defined PARALLELTXYZ
   int start_valuey = 1;
 #  else
   int start_valuey = 0;
 #  endif
 
+#  if defined PARALLELTXYZ
+  int start_valuez = 1;
+#  else
+  int start_valuez = 0;
+#  endif
+
 #else
   int start_valuet = 0;
   int start_valuex = 0;
   int start_valuey = 0;
+  int start_valuez = 0;
 #endif
 
   for(is=0;is<L5;is++) {
@@ -146,17 +216,19 @@ void geometry_5d() {
   for(x1=-start_valuex; x1<LX+start_valuex; x1++) {
   for(x2=-start_valuey; x2<LY+start_valuey; x2++) {
 
-  for(x3=0; x3<LZ; x3++) {
+  for(x3=-start_valuez; x3<LZ+start_valuez; x3++) {
 
     isboundary = 0;
     if(x0==-1 || x0== T) isboundary++;
     if(x1==-1 || x1==LX) isboundary++;
     if(x2==-1 || x2==LY) isboundary++;
+    if(x3==-1 || x3==LZ) isboundary++;
 
     y0=x0; y1=x1; y2=x2; y3=x3;
     if(x0==-1) y0=T +1;
     if(x1==-1) y1=LX+1;
     if(x2==-1) y2=LY+1;
+    if(x3==-1) y3=LZ+1;
 
     if(isboundary > 2) {
       g_ipt_5d[is][y0][y1][y2][y3] = -1;
@@ -281,7 +353,7 @@ int init_geometry_5d(void) {
 
   int ix = 0;
   unsigned int V, V5;
-  int dx = 0, dy = 0;
+  int dx = 0, dy = 0, dz = 0;
 
   VOLUME         = T*LX*LY*LZ;
   VOLUMEPLUSRAND = VOLUME;
@@ -292,20 +364,27 @@ int init_geometry_5d(void) {
   RAND           += 2*LX*LY*LZ;
   VOLUMEPLUSRAND += 2*LX*LY*LZ;
 
-#if defined PARALLELTX || defined PARALLELTXY
+#if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
   RAND           += 2*T*LY*LZ;
   EDGES          +=             4*LY*LZ;
   VOLUMEPLUSRAND += 2*T*LY*LZ + 4*LY*LZ;
   dx = 2;
 #endif
 
-#if defined PARALLELTXY
+#if defined PARALLELTXY || defined PARALLELTXYZ
   RAND           += 2*T*LX*LZ;
   EDGES          +=             4*LX*LZ + 4*T*LZ;
   VOLUMEPLUSRAND += 2*T*LX*LZ + 4*LX*LZ + 4*T*LZ;
   dy = 2;
 #endif
 
+#if defined PARALLELTXYZ
+  RAND           += 2*T*LX*LY;
+  EDGES          +=             4*LX*LY + 4*T*LY + 4*T*LX;
+  VOLUMEPLUSRAND += 2*T*LX*LY + 4*LX*LY + 4*T*LY + 4*T*LX;
+  dz = 2;
+#endif
+
 #endif  /* of ifdef MPI */
 
   if(g_cart_id==0) fprintf(stdout, "# VOLUME = %d\n# RAND   = %d\n# EDGES  = %d\n# VOLUMEPLUSRAND = %d\n",
@@ -338,7 +417,7 @@ int init_geometry_5d(void) {
   ipt_5d_   =  (int**)calloc(L5*(T+2)*(LX+dx)*(LY+dy), sizeof(int*));
   if((void*)ipt_5d_ == NULL) return(7);
 
-  ipt_5d    =  (int*)calloc(L5*(T+2)*(LX+dx)*(LY+dy)*LZ, sizeof(int));
+  ipt_5d    =  (int*)calloc(L5*(T+2)*(LX+dx)*(LY+dy)*(LZ+dz), sizeof(int));
   if((void*)ipt_5d == NULL) return(8);
 
  
@@ -353,7 +432,7 @@ int init_geometry_5d(void) {
   ipt_5d__[0]  = ipt_5d_;
   ipt_5d___[0] = ipt_5d__;
   g_ipt_5d[0]  = ipt_5d___;
-  for(ix=1; ix<L5*(T+2)*(LX+dx)*(LY+dy); ix++) ipt_5d_[ix]     = ipt_5d_[ix-1]     + LZ;
+  for(ix=1; ix<L5*(T+2)*(LX+dx)*(LY+dy); ix++) ipt_5d_[ix]     = ipt_5d_[ix-1]     + (LZ+dz);
 
   for(ix=1; ix<L5*(T+2)*(LX+dx);         ix++) ipt_5d__[ix]    = ipt_5d__[ix-1]    + (LY+dy);
 
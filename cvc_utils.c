@@ -20,6 +20,7 @@
 #include "get_index.h"
 #include "read_input_parser.h"
 #include "cvc_utils.h"
+#include "momentum_phase.h"
 #include "ranlxd.h"
 
 void EV_Hermitian_3x3_Matrix(double *M, double *lambda);
@@ -180,7 +181,7 @@ void xchange_gauge() {
   MPI_Irecv(&g_gauge_field[72*(T+1)*LX*LY*LZ], 1, gauge_time_slice_cont, g_nb_t_dn, 84, g_cart_grid, &request[cntr]);
   cntr++;
 
-#if (defined PARALLELTX) || (defined PARALLELTXY)
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
   MPI_Isend(&g_gauge_field[0],                              1, gauge_x_slice_vector, g_nb_x_dn, 85, g_cart_grid, &request[cntr]);
   cntr++;
   MPI_Irecv(&g_gauge_field[72*(VOLUME+2*LX*LY*LZ)],         1, gauge_x_slice_cont,   g_nb_x_up, 85, g_cart_grid, &request[cntr]);
@@ -206,7 +207,7 @@ void xchange_gauge() {
   cntr++;
 #endif
 
-#if defined PARALLELTXY
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
   MPI_Isend(&g_gauge_field[0], 1, gauge_y_slice_vector, g_nb_y_dn, 89, g_cart_grid, &request[cntr]);
   cntr++;
   MPI_Irecv(&g_gauge_field[72*(VOLUME+2*LX*LY*LZ+2*T*LY*LZ)], 1, gauge_y_slice_cont, g_nb_y_up, 89, g_cart_grid, &request[cntr]);
@@ -242,6 +243,52 @@ void xchange_gauge() {
   cntr++;
 #endif
 
+#if defined PARALLELTXYZ
+  MPI_Isend(&g_gauge_field[0], 1, gauge_z_slice_vector, g_nb_z_dn, 95, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&g_gauge_field[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))], 1, gauge_z_slice_cont, g_nb_z_up, 95, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&g_gauge_field[72*(LZ-1)], 1, gauge_z_slice_vector, g_nb_z_up, 96, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&g_gauge_field[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY)], 1, gauge_z_slice_cont, g_nb_z_dn, 96, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Waitall(cntr, request, status);
+
+  cntr = 0;
+
+  MPI_Isend(&g_gauge_field[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))], 1, gauge_zt_edge_vector, g_nb_t_dn, 97, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&g_gauge_field[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ))], 1, gauge_zt_edge_cont, g_nb_t_up, 97, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&g_gauge_field[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+(T-1)*LX*LY)], 1, gauge_zt_edge_vector, g_nb_t_up, 98, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&g_gauge_field[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ)+2*LX*LY)], 1, gauge_zt_edge_cont, g_nb_t_dn, 98, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&g_gauge_field[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))], 1, gauge_zx_edge_vector, g_nb_x_dn, 99, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&g_gauge_field[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY))], 1, gauge_zx_edge_cont, g_nb_x_up, 99, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&g_gauge_field[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+(LX-1)*LY)], 1, gauge_zx_edge_vector, g_nb_x_up, 100, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&g_gauge_field[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY)+2*T*LY)], 1, gauge_zx_edge_cont, g_nb_x_dn, 100, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&g_gauge_field[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))], 1, gauge_zy_edge_vector, g_nb_y_dn, 101, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&g_gauge_field[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY+T*LY))], 1, gauge_zy_edge_cont, g_nb_y_up, 101, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&g_gauge_field[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+(LY-1))], 1, gauge_zy_edge_vector, g_nb_y_up, 102, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&g_gauge_field[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY+T*LY)+2*T*LX)], 1, gauge_zy_edge_cont, g_nb_y_dn, 102, g_cart_grid, &request[cntr]);
+  cntr++;
+#endif
+
   MPI_Waitall(cntr, request, status);
 /*
   int i;
@@ -272,7 +319,7 @@ void xchange_gauge_field(double *gfield) {
   MPI_Irecv(&gfield[72*(T+1)*LX*LY*LZ], 1, gauge_time_slice_cont, g_nb_t_dn, 84, g_cart_grid, &request[cntr]);
   cntr++;
 
-#if (defined PARALLELTX) || (defined PARALLELTXY)
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
   MPI_Isend(&gfield[0],                              1, gauge_x_slice_vector, g_nb_x_dn, 85, g_cart_grid, &request[cntr]);
   cntr++;
   MPI_Irecv(&gfield[72*(VOLUME+2*LX*LY*LZ)],         1, gauge_x_slice_cont,   g_nb_x_up, 85, g_cart_grid, &request[cntr]);
@@ -298,7 +345,7 @@ void xchange_gauge_field(double *gfield) {
   cntr++;
 #endif
 
-#if defined PARALLELTXY
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
   MPI_Isend(&gfield[0], 1, gauge_y_slice_vector, g_nb_y_dn, 89, g_cart_grid, &request[cntr]);
   cntr++;
   MPI_Irecv(&gfield[72*(VOLUME+2*LX*LY*LZ+2*T*LY*LZ)], 1, gauge_y_slice_cont, g_nb_y_up, 89, g_cart_grid, &request[cntr]);
@@ -334,6 +381,52 @@ void xchange_gauge_field(double *gfield) {
   cntr++;
 #endif
 
+#if defined PARALLELTXYZ
+  MPI_Isend(&gfield[0], 1, gauge_z_slice_vector, g_nb_z_dn, 95, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))], 1, gauge_z_slice_cont, g_nb_z_up, 95, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(LZ-1)], 1, gauge_z_slice_vector, g_nb_z_up, 96, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY)], 1, gauge_z_slice_cont, g_nb_z_dn, 96, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Waitall(cntr, request, status);
+
+  cntr = 0;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))], 1, gauge_zt_edge_vector, g_nb_t_dn, 97, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ))], 1, gauge_zt_edge_cont, g_nb_t_up, 97, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+(T-1)*LX*LY)], 1, gauge_zt_edge_vector, g_nb_t_up, 98, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ)+2*LX*LY)], 1, gauge_zt_edge_cont, g_nb_t_dn, 98, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))], 1, gauge_zx_edge_vector, g_nb_x_dn, 99, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY))], 1, gauge_zx_edge_cont, g_nb_x_up, 99, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+(LX-1)*LY)], 1, gauge_zx_edge_vector, g_nb_x_up, 100, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY)+2*T*LY)], 1, gauge_zx_edge_cont, g_nb_x_dn, 100, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))], 1, gauge_zy_edge_vector, g_nb_y_dn, 101, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY+T*LY))], 1, gauge_zy_edge_cont, g_nb_y_up, 101, g_cart_grid, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+(LY-1))], 1, gauge_zy_edge_vector, g_nb_y_up, 102, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY+T*LY)+2*T*LX)], 1, gauge_zy_edge_cont, g_nb_y_dn, 102, g_cart_grid, &request[cntr]);
+  cntr++;
+#endif
+
   MPI_Waitall(cntr, request, status);
 #endif
 }
@@ -342,11 +435,11 @@ void xchange_gauge_field(double *gfield) {
  * exchange any gauge field defined on a timeslice communicator
  **************************************************************/
 void xchange_gauge_field_timeslice(double *gfield) {
-#if (defined MPI) && ( (defined PARALLELTX) || (defined PARALLELTXY) )
+#if (defined MPI) && ( (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ) )
 
   int cntr=0;
-  MPI_Request request[12];
-  MPI_Status status[12];
+  MPI_Request request[16];
+  MPI_Status status[16];
 
   MPI_Isend(&gfield[0],                              1, gauge_x_slice_vector, g_ts_nb_x_dn, 83, g_ts_comm, &request[cntr]);
   cntr++;
@@ -358,7 +451,7 @@ void xchange_gauge_field_timeslice(double *gfield) {
   MPI_Irecv(&gfield[72*(VOLUME+2*LX*LY*LZ+T*LY*LZ)], 1, gauge_x_slice_cont,   g_ts_nb_x_dn, 84, g_ts_comm, &request[cntr]);
   cntr++;
 
-#ifdef PARALLELTXY
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
   MPI_Isend(&gfield[0],                                        1, gauge_y_slice_vector, g_ts_nb_y_dn, 85, g_ts_comm, &request[cntr]);
   cntr++;
   MPI_Irecv(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ))],         1, gauge_y_slice_cont,   g_ts_nb_y_up, 85, g_ts_comm, &request[cntr]);
@@ -383,6 +476,41 @@ void xchange_gauge_field_timeslice(double *gfield) {
   cntr++;
 #endif
 
+#if defined PARALLELTXYZ
+  MPI_Isend(&gfield[0],                                                 1, gauge_z_slice_vector, g_ts_nb_z_dn, 87, g_ts_comm, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))],         1, gauge_z_slice_cont,   g_ts_nb_z_up, 87, g_ts_comm, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(LZ-1)],                                         1, gauge_z_slice_vector, g_ts_nb_z_up, 88, g_ts_comm, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY)], 1, gauge_z_slice_cont,   g_ts_nb_z_dn, 88, g_ts_comm, &request[cntr]);
+  cntr++;
+
+  MPI_Waitall(cntr, request, status);
+  cntr = 0;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))],           1, gauge_zx_edge_vector, g_ts_nb_x_dn, 99, g_ts_comm, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY))],        1, gauge_zx_edge_cont,   g_ts_nb_x_up, 99, g_ts_comm, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+(LX-1)*LY)], 1, gauge_zx_edge_vector, g_ts_nb_x_up, 100, g_ts_comm, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY)+2*T*LY)], 1, gauge_zx_edge_cont,   g_ts_nb_x_dn, 100, g_ts_comm, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))],                1, gauge_zy_edge_vector, g_ts_nb_y_dn, 101, g_ts_comm, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY+T*LY))],        1, gauge_zy_edge_cont,   g_ts_nb_y_up, 101, g_ts_comm, &request[cntr]);
+  cntr++;
+
+  MPI_Isend(&gfield[72*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+(LY-1))],         1, gauge_zy_edge_vector, g_ts_nb_y_up, 102, g_ts_comm, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&gfield[72*(VOLUME+RAND+4*(LY*LZ+LX*LZ+T*LZ+LX*LY+T*LY)+2*T*LX)], 1, gauge_zy_edge_cont,   g_ts_nb_y_dn, 102, g_ts_comm, &request[cntr]);
+  cntr++;
+#endif
+
   MPI_Waitall(cntr, request, status);
 
 #endif
@@ -420,7 +548,7 @@ void xchange_field_5d(double *phi) {
     cntr++;
     id++;
 
-#if (defined PARALLELTX) || (defined PARALLELTXY)
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
     send_offset = 24*is*VOLUME;
     recv_offset = 24*(V5 + is*RAND + 2*LX*LY*LZ);
     MPI_Isend(&phi[send_offset], 1, spinor_x_slice_vector, g_nb_x_dn, id, g_cart_grid, &request[cntr]);
@@ -438,7 +566,7 @@ void xchange_field_5d(double *phi) {
     id++;
 #endif
 
-#if defined PARALLELTXY
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
     send_offset = 24*is*VOLUME;
     recv_offset = 24*(V5 + is*RAND + 2*(LX*LY*LZ+T*LY*LZ) );
     MPI_Isend(&phi[send_offset], 1, spinor_y_slice_vector, g_nb_y_dn, id, g_cart_grid, &request[cntr]);
@@ -455,6 +583,24 @@ void xchange_field_5d(double *phi) {
     cntr++;
     id++;
 #endif
+
+#if defined PARALLELTXYZ
+    send_offset = 24*is*VOLUME;
+    recv_offset = 24*(V5 + is*RAND + 2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ) );
+    MPI_Isend(&phi[send_offset], 1, spinor_z_slice_vector, g_nb_z_dn, id, g_cart_grid, &request[cntr]);
+    cntr++;
+    MPI_Irecv(&phi[recv_offset], 1, spinor_z_slice_cont,   g_nb_z_up, id, g_cart_grid, &request[cntr]);
+    cntr++;
+    id++;
+
+    send_offset = 24*(is*VOLUME + (LZ-1) );
+    recv_offset = 24*(V5 + is*RAND + 2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY );
+    MPI_Isend(&phi[send_offset], 1, spinor_z_slice_vector, g_nb_z_up, id, g_cart_grid, &request[cntr]);
+    cntr++;
+    MPI_Irecv(&phi[recv_offset], 1, spinor_z_slice_cont,   g_nb_z_dn, id, g_cart_grid, &request[cntr]);
+    cntr++;
+    id++;
+#endif
   }
   MPI_Waitall(cntr, request, status);
 #endif
@@ -462,13 +608,26 @@ void xchange_field_5d(double *phi) {
 
 /*****************************************************
  * exchange a spinor field
+ *
+ * split-phase exchange of a spinor field
+ * - xchange_field_start posts the sends and receives,
+ *   xchange_field_wait completes them
+ * - only one exchange can be in progress at a time
  *****************************************************/
-void xchange_field(double *phi) {
+#ifdef MPI
+static MPI_Request xchange_field_request[120];
+static int xchange_field_nreq = 0;
+#endif
+
+void xchange_field_start(double *phi) {
 #ifdef MPI
   int cntr=0;
+  MPI_Request *request = xchange_field_request;
 
-  MPI_Request request[120];
-  MPI_Status status[120];
+  if(xchange_field_nreq > 0) {
+    fprintf(stderr, "[xchange_field_start] Error, exchange already in progress\n");
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
 
   MPI_Isend(&phi[0],                 1, spinor_time_slice_cont, g_nb_t_dn, 83, g_cart_grid, &request[cntr]);
   cntr++;
@@ -479,7 +638,7 @@ void xchange_field(double *phi) {
   cntr++;
   MPI_Irecv(&phi[24*(T+1)*LX*LY*LZ], 1, spinor_time_slice_cont, g_nb_t_dn, 84, g_cart_grid, &request[cntr]);
   cntr++;
-#if (defined PARALLELTX) || (defined PARALLELTXY)
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
   MPI_Isend(&phi[0],                              1, spinor_x_slice_vector, g_nb_x_dn, 85, g_cart_grid, &request[cntr]);
   cntr++;
   MPI_Irecv(&phi[24*(VOLUME+2*LX*LY*LZ)],         1, spinor_x_slice_cont,   g_nb_x_up, 85, g_cart_grid, &request[cntr]);
@@ -490,7 +649,7 @@ void xchange_field(double *phi) {
   MPI_Irecv(&phi[24*(VOLUME+2*LX*LY*LZ+T*LY*LZ)], 1, spinor_x_slice_cont,   g_nb_x_dn, 86, g_cart_grid, &request[cntr]);
   cntr++;
 #endif
-#if defined PARALLELTXY
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
   MPI_Isend(&phi[0],                                        1, spinor_y_slice_vector, g_nb_y_dn, 87, g_cart_grid, &request[cntr]);
   cntr++;
   MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ))],         1, spinor_y_slice_cont,   g_nb_y_up, 87, g_cart_grid, &request[cntr]);
@@ -500,6 +659,89 @@ void xchange_field(double *phi) {
   cntr++;
   MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ)+T*LX*LZ)], 1, spinor_y_slice_cont,   g_nb_y_dn, 88, g_cart_grid, &request[cntr]);
   cntr++;
+#endif
+#if defined PARALLELTXYZ
+  MPI_Isend(&phi[0],                                                 1, spinor_z_slice_vector, g_nb_z_dn, 89, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))],         1, spinor_z_slice_cont,   g_nb_z_up, 89, g_cart_grid, &request[cntr]);
+  cntr++;
+  
+  MPI_Isend(&phi[24*(LZ-1)],                                         1, spinor_z_slice_vector, g_nb_z_up, 90, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY)], 1, spinor_z_slice_cont,   g_nb_z_dn, 90, g_cart_grid, &request[cntr]);
+  cntr++;
+#endif
+  xchange_field_nreq = cntr;
+#endif
+}
+
+/*****************************************************
+ * complete the exchange started by xchange_field_start
+ *****************************************************/
+void xchange_field_wait(void) {
+#ifdef MPI
+  MPI_Status status[120];
+  MPI_Waitall(xchange_field_nreq, xchange_field_request, status);
+  xchange_field_nreq = 0;
+#endif
+}
+
+void xchange_field(double *phi) {
+  xchange_field_start(phi);
+  xchange_field_wait();
+}
+
+/*****************************************************
+ * exchange a single precision spinor field
+ *****************************************************/
+void xchange_field_flt(float *phi) {
+#ifdef MPI
+  int cntr=0;
+
+  MPI_Request request[120];
+  MPI_Status status[120];
+
+  MPI_Isend(&phi[0],                 1, spinor_time_slice_cont_flt, g_nb_t_dn, 83, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*VOLUME],         1, spinor_time_slice_cont_flt, g_nb_t_up, 83, g_cart_grid, &request[cntr]);
+  cntr++;
+  
+  MPI_Isend(&phi[24*(T-1)*LX*LY*LZ], 1, spinor_time_slice_cont_flt, g_nb_t_up, 84, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(T+1)*LX*LY*LZ], 1, spinor_time_slice_cont_flt, g_nb_t_dn, 84, g_cart_grid, &request[cntr]);
+  cntr++;
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  MPI_Isend(&phi[0],                              1, spinor_x_slice_vector_flt, g_nb_x_dn, 85, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*LX*LY*LZ)],         1, spinor_x_slice_cont_flt,   g_nb_x_up, 85, g_cart_grid, &request[cntr]);
+  cntr++;
+  
+  MPI_Isend(&phi[24*(LX-1)*LY*LZ],                1, spinor_x_slice_vector_flt, g_nb_x_up, 86, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*LX*LY*LZ+T*LY*LZ)], 1, spinor_x_slice_cont_flt,   g_nb_x_dn, 86, g_cart_grid, &request[cntr]);
+  cntr++;
+#endif
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  MPI_Isend(&phi[0],                                        1, spinor_y_slice_vector_flt, g_nb_y_dn, 87, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ))],         1, spinor_y_slice_cont_flt,   g_nb_y_up, 87, g_cart_grid, &request[cntr]);
+  cntr++;
+  
+  MPI_Isend(&phi[24*(LY-1)*LZ],                             1, spinor_y_slice_vector_flt, g_nb_y_up, 88, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ)+T*LX*LZ)], 1, spinor_y_slice_cont_flt,   g_nb_y_dn, 88, g_cart_grid, &request[cntr]);
+  cntr++;
+#endif
+#if defined PARALLELTXYZ
+  MPI_Isend(&phi[0],                                                 1, spinor_z_slice_vector_flt, g_nb_z_dn, 89, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))],         1, spinor_z_slice_cont_flt,   g_nb_z_up, 89, g_cart_grid, &request[cntr]);
+  cntr++;
+  
+  MPI_Isend(&phi[24*(LZ-1)],                                         1, spinor_z_slice_vector_flt, g_nb_z_up, 90, g_cart_grid, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY)], 1, spinor_z_slice_cont_flt,   g_nb_z_dn, 90, g_cart_grid, &request[cntr]);
+  cntr++;
 #endif
   MPI_Waitall(cntr, request, status);
 #endif
@@ -509,10 +751,10 @@ void xchange_field(double *phi) {
  * exchange a spinor field defined on an a timeslice communicator
  ****************************************************************/
 void xchange_field_timeslice(double *phi) {
-#if (defined PARALLELTX) || (defined PARALLELTXY)
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
   int cntr=0;
-  MPI_Request request[12];
-  MPI_Status status[12];
+  MPI_Request request[16];
+  MPI_Status status[16];
 
   MPI_Isend(&phi[0],                              1, spinor_x_slice_vector, g_ts_nb_x_dn, 83, g_ts_comm, &request[cntr]);
   cntr++;
@@ -524,7 +766,7 @@ void xchange_field_timeslice(double *phi) {
   MPI_Irecv(&phi[24*(VOLUME+2*LX*LY*LZ+T*LY*LZ)], 1, spinor_x_slice_cont,   g_ts_nb_x_dn, 84, g_ts_comm, &request[cntr]);
   cntr++;
 
-#if defined PARALLELTXY
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
   MPI_Isend(&phi[0],                                        1, spinor_y_slice_vector, g_ts_nb_y_dn, 85, g_ts_comm, &request[cntr]);
   cntr++;
   MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ))],         1, spinor_y_slice_cont,   g_ts_nb_y_up, 85, g_ts_comm, &request[cntr]);
@@ -536,7 +778,80 @@ void xchange_field_timeslice(double *phi) {
   cntr++;
 #endif
 
+#if defined PARALLELTXYZ
+  MPI_Isend(&phi[0],                                                 1, spinor_z_slice_vector, g_ts_nb_z_dn, 87, g_ts_comm, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))],         1, spinor_z_slice_cont,   g_ts_nb_z_up, 87, g_ts_comm, &request[cntr]);
+  cntr++;
+  
+  MPI_Isend(&phi[24*(LZ-1)],                                         1, spinor_z_slice_vector, g_ts_nb_z_up, 88, g_ts_comm, &request[cntr]);
+  cntr++;
+  MPI_Irecv(&phi[24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY)], 1, spinor_z_slice_cont,   g_ts_nb_z_dn, 88, g_ts_comm, &request[cntr]);
+  cntr++;
+#endif
+
+  MPI_Waitall(cntr, request, status);
+#endif
+}
+
+/*****************************************************
+ * exchange the spatial halos of n timeslice fields
+ * - as xchange_field_timeslice, all messages of the
+ *   block are posted before a single wait
+ *****************************************************/
+void xchange_field_timeslice_block(double **phi, int n) {
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  int k, cntr=0;
+  MPI_Request *request = NULL;
+  MPI_Status *status = NULL;
+
+  if(n <= 0) return;
+  request = (MPI_Request*)malloc(12*n*sizeof(MPI_Request));
+  status  = (MPI_Status* )malloc(12*n*sizeof(MPI_Status));
+  if(request == NULL || status == NULL) {
+    fprintf(stderr, "[xchange_field_timeslice_block] Error, could not allocate requests\n");
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+
+  for(k=0; k<n; k++) {
+    MPI_Isend(&phi[k][0],                              1, spinor_x_slice_vector, g_ts_nb_x_dn, 83, g_ts_comm, &request[cntr]);
+    cntr++;
+    MPI_Irecv(&phi[k][24*(VOLUME+2*LX*LY*LZ)],         1, spinor_x_slice_cont,   g_ts_nb_x_up, 83, g_ts_comm, &request[cntr]);
+    cntr++;
+
+    MPI_Isend(&phi[k][24*(LX-1)*LY*LZ],                1, spinor_x_slice_vector, g_ts_nb_x_up, 84, g_ts_comm, &request[cntr]);
+    cntr++;
+    MPI_Irecv(&phi[k][24*(VOLUME+2*LX*LY*LZ+T*LY*LZ)], 1, spinor_x_slice_cont,   g_ts_nb_x_dn, 84, g_ts_comm, &request[cntr]);
+    cntr++;
+
+#if (defined PARALLELTXY) || (defined PARALLELTXYZ)
+    MPI_Isend(&phi[k][0],                                        1, spinor_y_slice_vector, g_ts_nb_y_dn, 85, g_ts_comm, &request[cntr]);
+    cntr++;
+    MPI_Irecv(&phi[k][24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ))],         1, spinor_y_slice_cont,   g_ts_nb_y_up, 85, g_ts_comm, &request[cntr]);
+    cntr++;
+
+    MPI_Isend(&phi[k][24*(LY-1)*LZ],                             1, spinor_y_slice_vector, g_ts_nb_y_up, 86, g_ts_comm, &request[cntr]);
+    cntr++;
+    MPI_Irecv(&phi[k][24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ)+T*LX*LZ)], 1, spinor_y_slice_cont,   g_ts_nb_y_dn, 86, g_ts_comm, &request[cntr]);
+    cntr++;
+#endif
+
+#if defined PARALLELTXYZ
+    MPI_Isend(&phi[k][0],                                                 1, spinor_z_slice_vector, g_ts_nb_z_dn, 87, g_ts_comm, &request[cntr]);
+    cntr++;
+    MPI_Irecv(&phi[k][24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ))],         1, spinor_z_slice_cont,   g_ts_nb_z_up, 87, g_ts_comm, &request[cntr]);
+    cntr++;
+
+    MPI_Isend(&phi[k][24*(LZ-1)],                                         1, spinor_z_slice_vector, g_ts_nb_z_up, 88, g_ts_comm, &request[cntr]);
+    cntr++;
+    MPI_Irecv(&phi[k][24*(VOLUME+2*(LX*LY*LZ+T*LY*LZ+T*LX*LZ)+T*LX*LY)], 1, spinor_z_slice_cont,   g_ts_nb_z_dn, 88, g_ts_comm, &request[cntr]);
+    cntr++;
+#endif
+  }
+
   MPI_Waitall(cntr, request, status);
+  free(request);
+  free(status);
 #endif
 }
 
@@ -570,7 +885,7 @@ void plaquette(double *pl) {
 #else
   *pl = pl_loc;
 #endif
-  *pl = *pl / ((double)T_global * (double)(LX*g_nproc_x) * (double)(LY*g_nproc_y) * (double)LZ * 18.);
+  *pl = *pl / ((double)T_global * (double)(LX*g_nproc_x) * (double)(LY*g_nproc_y) * (double)(LZ*g_nproc_z) * 18.);
 
   linksum[0] = 0.;
   linksum[1] = 0.;
@@ -622,7 +937,7 @@ void plaquette2(double *pl, double*gfield) {
 #else
   *pl = pl_loc;
 #endif
-  *pl = *pl / ((double)T_global * (double)(LX*g_nproc_x) * (double)(LY*g_nproc_y) * (double)LZ * 18.);
+  *pl = *pl / ((double)T_global * (double)(LX*g_nproc_x) * (double)(LY*g_nproc_y) * (double)(LZ*g_nproc_z) * 18.);
 }
 
 /*****************************************************
@@ -702,7 +1017,7 @@ int write_contraction (double *s, int *nsource, char *filename, int Nmu,
       }
     }
 #ifdef MPI
-#  if !(defined PARALLELTX || defined PARALLELTXY)
+#  if !(defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ)
     for(i=1; i<g_nproc; i++) {
       MPI_Recv(ti, 2, MPI_INT, i, 100+i, g_cart_grid, &status);
       count = (unsigned long int)Nmu * (unsigned long int)(ti[0]*LX*LY*LZ) * 2;
@@ -1968,6 +2283,7 @@ void set_default_input_values(void) {
   N_ape        = _default_N_ape;
   N_Jacobi     = _default_N_Jacobi;
   alpha_ape    = _default_alpha_ape;
+  g_ape_cache  = _default_ape_cache;
   kappa_Jacobi = _default_kappa_Jacobi;
   g_source_timeslice  = _default_source_timeslice;
   g_no_extra_masses = _default_no_extra_masses;
@@ -1992,6 +2308,7 @@ void set_default_input_values(void) {
   g_propagator_bc_type = _default_propagator_bc_type;
   g_propagator_gamma_basis = _default_propagator_gamma_basis;
   g_propagator_precision = _default_propagator_precision;
+  g_propagator_codec = _default_propagator_codec;
   g_write_source = _default_write_source;
   g_read_source = _default_read_source;
 
@@ -2025,10 +2342,18 @@ void set_default_input_values(void) {
 
   g_m5 = _default_m5;
   g_m0 = _default_m0;
+  g_b5 = _default_b5;
+  g_c5 = _default_c5;
 
   g_cpu_prec = _default_cpu_prec;
   g_gpu_prec = _default_gpu_prec;
   g_gpu_prec_sloppy = _default_gpu_prec_sloppy;
+  g_inverter_type = _default_inverter_type;
+  strcpy(g_inverter_type_name, _default_inverter_type_name);
+  g_deflation_nev = _default_deflation_nev;
+  g_deflation_krylov = _default_deflation_krylov;
+  g_deflation_precision = _default_deflation_precision;
+  strcpy(g_deflation_filename_prefix, _default_deflation_filename_prefix);
 
   g_space_dilution_depth = _default_space_dilution_depth;
 
@@ -3149,7 +3474,9 @@ void contract_twopoint_snk_momentum(double *contr, const int idsource, const int
   int VOL3 = LX*LY*LZ;
   int sx0=0, sx1=0, sx2=0, sx3=0;
   double ssource[4], spinor1[24], spinor2[24];
-  double phase, cphase, sphase, px, py, pz;
+  double ephase[2], cphase, sphase;
+  int sx[3];
+  momentum_phase ph;
   double tmp[2], re, im;
   complex w;
 
@@ -3186,19 +3513,20 @@ void contract_twopoint_snk_momentum(double *contr, const int idsource, const int
     //fprintf(stdout, "# [contract_twopoint_snk_momentum] source coordinates = (%d, %d, %d, %d)\n", sx0, sx1, sx2, sx3);
   }
 
-  px = 2.*M_PI*(double)snk_mom[0]/(double)LX;
-  py = 2.*M_PI*(double)snk_mom[1]/(double)LY;
-  pz = 2.*M_PI*(double)snk_mom[2]/(double)LZ;
-  // fprintf(stdout, "# [contract_twopoint_snk_momentum] p = (%e, %e, %e)\n", px, py, pz);
+  sx[0] = sx1; sx[1] = sx2; sx[2] = sx3;
+  if(init_momentum_phase(&ph, 1, snk_mom, sx) != 0) {
+    fprintf(stderr, "[contract_twopoint_snk_momentum] Error from init_momentum_phase\n");
+    EXIT(1);
+  }
 
   for(x0=0; x0<T; x0++) {
     for(x1=0; x1<LX; x1++) {
     for(x2=0; x2<LY; x2++) {
     for(x3=0; x3<LZ; x3++) {
       iix = g_ipt[x0][x1][x2][x3];
-      phase = (double)(x1-sx1)*px + (double)(x2-sx2)*py + (double)(x3-sx3)*pz;
-      cphase = cos( phase );
-      sphase = sin( phase );
+      _momentum_phase_site(ephase, &ph, 0, x1, x2, x3);
+      cphase = ephase[0];
+      sphase = ephase[1];
 
       tmp[0] = 0.; tmp[1] = 0.;
       for(mu=0; mu<4; mu++) {
@@ -3235,6 +3563,7 @@ void contract_twopoint_snk_momentum(double *contr, const int idsource, const int
     }}}  // of x3, x2, x1
     tt++;
   }      // of x0
+  fini_momentum_phase(&ph);
 }
 #else
 void contract_twopoint_snk_momentum(double *contr, const int idsource, const int idsink, double **chi, double **phi, int n_c, int* snk_mom) {
@@ -3242,7 +3571,8 @@ void contract_twopoint_snk_momentum(double *contr, const int idsource, const int
   int x0, iix, psource[4], isimag;
   int sx0=0, sx1=0, sx2=0, sx3=0;
   double ssource[4];
-  double px, py, pz;
+  int sx[3];
+  momentum_phase ph;
 
   psource[0] = gamma_permutation[idsource][ 0] / 6;
   psource[1] = gamma_permutation[idsource][ 6] / 6;
@@ -3277,15 +3607,16 @@ void contract_twopoint_snk_momentum(double *contr, const int idsource, const int
     //fprintf(stdout, "# [contract_twopoint_snk_momentum] source coordinates = (%d, %d, %d, %d)\n", sx0, sx1, sx2, sx3);
   }
 
-  px = 2.*M_PI*(double)snk_mom[0]/(double)LX;
-  py = 2.*M_PI*(double)snk_mom[1]/(double)LY;
-  pz = 2.*M_PI*(double)snk_mom[2]/(double)LZ;
-  // fprintf(stdout, "# [contract_twopoint_snk_momentum] p = (%e, %e, %e)\n", px, py, pz);
+  sx[0] = sx1; sx[1] = sx2; sx[2] = sx3;
+  if(init_momentum_phase(&ph, 1, snk_mom, sx) != 0) {
+    fprintf(stderr, "[contract_twopoint_snk_momentum] Error from init_momentum_phase\n");
+    EXIT(1);
+  }
 
-#pragma omp parallel private(x0, iix) shared(T,LX,LY,LZ, sx0,sx1,sx2,sx3, px, py, pz, isimag, ssource, psource, contr, chi, phi, n_c, snk_mom)
+#pragma omp parallel private(x0, iix) shared(T,LX,LY,LZ, sx0,sx1,sx2,sx3, ph, isimag, ssource, psource, contr, chi, phi, n_c, snk_mom)
 {
   int x1, x2, x3, ix, tt=0, mu, c, j;
-  double phase, cphase, sphase;
+  double ephase[2], cphase, sphase;
   double tmp[2], re, im;
   complex w;
   double spinor1[24], spinor2[24];
@@ -3302,9 +3633,9 @@ void contract_twopoint_snk_momentum(double *contr, const int idsource, const int
     for(x2=0; x2<LY; x2++) {
     for(x3=0; x3<LZ; x3++) {
       iix = g_ipt[x0][x1][x2][x3];
-      phase = (double)(x1-sx1)*px + (double)(x2-sx2)*py + (double)(x3-sx3)*pz;
-      cphase = cos( phase );
-      sphase = sin( phase );
+      _momentum_phase_site(ephase, &ph, 0, x1, x2, x3);
+      cphase = ephase[0];
+      sphase = ephase[1];
 
       tmp[0] = 0.; tmp[1] = 0.;
       for(mu=0; mu<4; mu++) {
@@ -3342,6 +3673,7 @@ void contract_twopoint_snk_momentum(double *contr, const int idsource, const int
     tt += num_threads;
   }      // of x0
 }  // end of parallel region
+  fini_momentum_phase(&ph);
 }
 #endif
 
@@ -3357,7 +3689,9 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
   int VOL3 = LX*LY*LZ;
   int sx0=0, sx1=0, sx2=0, sx3=0;
   double ssource[4], spinor1[24], spinor2[24];
-  double phase, cphase, sphase, px, py, pz;
+  double ephase[2], cphase, sphase;
+  int sx[3];
+  momentum_phase ph;
   double tmp[2], re, im;
   complex w;
 
@@ -3394,10 +3728,11 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
     //fprintf(stdout, "# [contract_twopoint_snk_momentum] source coordinates = (%d, %d, %d, %d)\n", sx0, sx1, sx2, sx3);
   }
 
-  px = 2.*M_PI*(double)snk_mom[0]/(double)LX;
-  py = 2.*M_PI*(double)snk_mom[1]/(double)LY;
-  pz = 2.*M_PI*(double)snk_mom[2]/(double)LZ;
-  // fprintf(stdout, "# [contract_twopoint_snk_momentum] p = (%e, %e, %e)\n", px, py, pz);
+  sx[0] = sx1; sx[1] = sx2; sx[2] = sx3;
+  if(init_momentum_phase(&ph, 1, snk_mom, sx) != 0) {
+    fprintf(stderr, "[contract_twopoint_snk_momentum] Error from init_momentum_phase\n");
+    EXIT(1);
+  }
 
   tt = 0;
   for(x0=tmin; x0<=tmax; x0++) {
@@ -3405,9 +3740,9 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
     for(x2=0; x2<LY; x2++) {
     for(x3=0; x3<LZ; x3++) {
       iix = g_ipt[x0][x1][x2][x3];
-      phase = (double)(x1-sx1)*px + (double)(x2-sx2)*py + (double)(x3-sx3)*pz;
-      cphase = cos( phase );
-      sphase = sin( phase );
+      _momentum_phase_site(ephase, &ph, 0, x1, x2, x3);
+      cphase = ephase[0];
+      sphase = ephase[1];
 
       tmp[0] = 0.; tmp[1] = 0.;
       for(mu=0; mu<4; mu++) {
@@ -3444,6 +3779,7 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
     }}}  // of x3, x2, x1
     tt++;
   }      // of x0
+  fini_momentum_phase(&ph);
 }
 #else
 void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, const int idsink, double **chi, double **phi, int n_c, int* snk_mom, int tmin, int tmax) {
@@ -3451,7 +3787,8 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
   int x0, iix, tt, psource[4], isimag;
   int sx0=0, sx1=0, sx2=0, sx3=0;
   double ssource[4];
-  double px, py, pz;
+  int sx[3];
+  momentum_phase ph;
   double *contr_threads=NULL;
   int num_threads;
 
@@ -3488,10 +3825,11 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
     //fprintf(stdout, "# [contract_twopoint_snk_momentum] source coordinates = (%d, %d, %d, %d)\n", sx0, sx1, sx2, sx3);
   }
 
-  px = 2.*M_PI*(double)snk_mom[0]/(double)LX;
-  py = 2.*M_PI*(double)snk_mom[1]/(double)LY;
-  pz = 2.*M_PI*(double)snk_mom[2]/(double)LZ;
-  // fprintf(stdout, "# [contract_twopoint_snk_momentum] p = (%e, %e, %e)\n", px, py, pz);
+  sx[0] = sx1; sx[1] = sx2; sx[2] = sx3;
+  if(init_momentum_phase(&ph, 1, snk_mom, sx) != 0) {
+    fprintf(stderr, "[contract_twopoint_snk_momentum] Error from init_momentum_phase\n");
+    EXIT(1);
+  }
 
 #pragma omp parallel shared(num_threads)
 {
@@ -3507,10 +3845,10 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
 
     memset(contr_threads, 0, 2*num_threads * sizeof(double));
 
-#pragma omp parallel private(iix) shared(T,LX,LY,LZ, x0, sx0,sx1,sx2,sx3, px, py, pz, isimag, ssource, psource, contr, chi, phi, n_c, snk_mom, num_threads, tmin, tmax, contr_threads)
+#pragma omp parallel private(iix) shared(T,LX,LY,LZ, x0, sx0,sx1,sx2,sx3, ph, isimag, ssource, psource, contr, chi, phi, n_c, snk_mom, num_threads, tmin, tmax, contr_threads)
 {
     int x1, x2, x3, ix, mu, c, j;
-    double phase, cphase, sphase;
+    double ephase[2], cphase, sphase;
     double tmp[2], re, im;
     complex w;
     double spinor1[24], spinor2[24];
@@ -3531,9 +3869,9 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
       x2 = iix / LZ;
       x3 = iix - LZ * x2;
 
-      phase = (double)(x1-sx1)*px + (double)(x2-sx2)*py + (double)(x3-sx3)*pz;
-      cphase = cos( phase );
-      sphase = sin( phase );
+      _momentum_phase_site(ephase, &ph, 0, x1, x2, x3);
+      cphase = ephase[0];
+      sphase = ephase[1];
 
       iix = x0 * VOL3 + ix;
 
@@ -3573,6 +3911,7 @@ void contract_twopoint_snk_momentum_trange(double *contr, const int idsource, co
   }      // of x0
 
   free(contr_threads);
+  fini_momentum_phase(&ph);
 }
 #endif
 
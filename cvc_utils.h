@@ -21,7 +21,11 @@ void xchange_gauge(void);
 void xchange_gauge_field(double*);
 void xchange_gauge_field_timeslice(double *);
 void xchange_field(double*);
+void xchange_field_start(double *phi);
+void xchange_field_wait(void);
+void xchange_field_flt(float *phi);
 void xchange_field_timeslice(double *);
+void xchange_field_timeslice_block(double **phi, int n);
 void xchange_field_5d(double *phi);
 
 int write_contraction (double *s, int *nsource, char *filename, int Nmu,
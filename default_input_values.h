@@ -68,6 +68,7 @@
 #define _default_N_Jacobi -1
 
 #define _default_alpha_ape 0.
+#define _default_ape_cache 0
 #define _default_kappa_Jacobi 0.
 
 #define _default_source_timeslice 0
@@ -107,6 +108,7 @@
 #define _default_propagator_bc_type 0
 #define _default_propagator_gamma_basis 0
 #define _default_propagator_precision 32
+#define _default_propagator_codec 0
 #define _default_write_source 0
 #define _default_read_source 0
 #define _default_nsample 1
@@ -127,11 +129,18 @@
 #define _default_verbose  0
 #define _default_m0 0.
 #define _default_m5 0.
+#define _default_b5 1.
+#define _default_c5 0.
 
 #define _default_cpu_prec 2
 #define _default_gpu_prec 2
 #define _default_gpu_prec_sloppy 1
+#define _default_inverter_type 0
 #define _default_inverter_type_name "none"
+#define _default_deflation_nev 0
+#define _default_deflation_krylov 0
+#define _default_deflation_precision 1.e-06
+#define _default_deflation_filename_prefix "none"
 
 #define _default_space_dilution_depth 0
 #define _default_mms_id -1
@@ -0,0 +1,601 @@
+/****************************************************
+ * deflation.c
+ *
+ * PURPOSE:
+ * - low-mode eigenspace of the hermitian operator A
+ *   of invert_Qtm_her / invert_Q_Wilson_her,
+ *   A = g5 Q(mu) g5 Q(-mu) or A = g5 D_W (cf. apply_Q_her)
+ * - set up once per gauge configuration with
+ *   init_deflation, used for every right-hand side
+ *   by the deflated CG (inverter_type = deflated_cg)
+ * - the eigenvectors are computed with a thick-restart
+ *   Lanczos, i.e. Lanczos with full reorthogonalization
+ *   and Rayleigh-Ritz on the projected matrix, restarted
+ *   with the lowest Ritz vectors
+ * - g5 D_W is indefinite; for Wilson fermions the Lanczos
+ *   runs on A^2 and A is diagonalized in the resulting
+ *   subspace afterwards
+ * - only the converged Ritz pairs are kept
+ * - optionally cached in LIME format as
+ *   <deflation_filename_prefix>.<Nconf>: a cvc-deflation-info
+ *   record (fermion type, nev, number of eigenvectors,
+ *   kappa, mu, eigenvalues), then one scidac-binary-data
+ *   record per eigenvector or, with propagator_codec, one
+ *   cvc-compressed-spinor-data record per eigenvector;
+ *   the file is used only if the info record matches the
+ *   input and the record count, and if the Rayleigh
+ *   quotients after reading reproduce the eigenvalues
+ *   (different gauge field with the same Nconf)
+ ****************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#include "global.h"
+#include "cvc_complex.h"
+#include "cvc_linalg.h"
+#include "mpi_init.h"
+#include "cvc_utils.h"
+#include "propagator_io.h"
+#include "spinor_codec.h"
+#include "invert_Qtm.h"
+#include "deflation.h"
+
+#ifdef F_
+#define _F(s) s##_
+#else
+#define _F(s) s
+#endif
+
+void _F(zheev)(char *jobz, char *uplo, int *n, double a[], int *lda, double w[], double work[], int *lwork, double *rwork, int *info);
+
+#define _DEFLATION_INFO_TYPE "cvc-deflation-info"
+/* relative eigenvalue difference allowed for a cached
+ * eigenspace, loose enough for the lossy codecs */
+#define _DEFLATION_EIGENVALUE_TOL 1.e-4
+
+static double **eigenvector_field = NULL;
+static double *eigenvalue = NULL;
+static int eigenspace_dim = 0;
+static int eigenspace_fermion_type = -1;
+
+/****************************************************
+ * c[i] = <v[i], w>, i = 0,...,n-1 with a single
+ * global reduction
+ ****************************************************/
+static void block_scalar_product(complex *c, double **v, int n, double *w) {
+  int i, ix, iix;
+  complex p;
+
+  for(i=0; i<n; i++) { c[i].re = 0.; c[i].im = 0.; }
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    for(i=0; i<n; i++) {
+      _co_eq_fv_dag_ti_fv(&p, v[i]+iix, w+iix);
+      c[i].re += p.re;
+      c[i].im += p.im;
+    }
+    iix+=24;
+  }
+#ifdef MPI
+  MPI_Allreduce(MPI_IN_PLACE, c, 2*n, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#endif
+}
+
+/****************************************************
+ * w = w + sign sum_i c[i] v[i]
+ ****************************************************/
+static void block_axpy(double *w, double **v, complex *c, int n, double sign) {
+  int i, ix, iix;
+  double spinor1[24];
+
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    for(i=0; i<n; i++) {
+      _fv_eq_fv_ti_co(spinor1, v[i]+iix, &c[i]);
+      _fv_ti_eq_re(spinor1, sign);
+      _fv_pl_eq_fv(w+iix, spinor1);
+    }
+    iix+=24;
+  }
+}
+
+/****************************************************
+ * v[i] = sum_j v[j] Y[j,i], i = 0,...,k-1;
+ * Y column-major m x m complex
+ ****************************************************/
+static void rotate_basis(double **v, double *Y, int m, int k) {
+  int i, j, ix, iix;
+  double *tmp = NULL, spinor1[24];
+  complex c;
+
+  tmp = (double*)malloc(24*k*sizeof(double));
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    for(i=0; i<k; i++) {
+      _fv_eq_zero(tmp+24*i);
+      for(j=0; j<m; j++) {
+        c.re = Y[2*(j+i*m)  ];
+        c.im = Y[2*(j+i*m)+1];
+        _fv_eq_fv_ti_co(spinor1, v[j]+iix, &c);
+        _fv_pl_eq_fv(tmp+24*i, spinor1);
+      }
+    }
+    for(i=0; i<k; i++) {
+      _fv_eq_fv(v[i]+iix, tmp+24*i);
+    }
+    iix+=24;
+  }
+  free(tmp);
+}
+
+/****************************************************
+ * operator for the Lanczos: A for tm, A^2 for Wilson
+ ****************************************************/
+static void apply_lanczos_op(double *w, double *v, double *aux, int fermion_type) {
+  if(fermion_type == _TM_FERMION) {
+    apply_Q_her(w, v, aux, fermion_type);
+  } else {
+    apply_Q_her(aux, v, NULL, fermion_type);
+    apply_Q_her(w, aux, NULL, fermion_type);
+  }
+}
+
+/****************************************************
+ * diagonalize A in the span of v[0],...,v[n-1]
+ ****************************************************/
+static int rayleigh_ritz_her(double **v, double *lambda, int n, int fermion_type, double *w, double *aux) {
+  int i, j, info, lwork;
+  double *M=NULL, *work=NULL, *rwork=NULL;
+  complex *c=NULL;
+
+  M     = (double*)calloc(2*n*n, sizeof(double));
+  rwork = (double*)calloc(3*n, sizeof(double));
+  lwork = 2*n;
+  work  = (double*)calloc(2*lwork, sizeof(double));
+  c     = (complex*)calloc(n, sizeof(complex));
+  if(M==NULL || rwork==NULL || work==NULL || c==NULL) {
+    fprintf(stderr, "[rayleigh_ritz_her] Error, could not allocate memory\n");
+    free(M);
+    free(rwork);
+    free(work);
+    free(c);
+    return(-1);
+  }
+
+  for(j=0; j<n; j++) {
+    apply_Q_her(w, v[j], aux, fermion_type);
+    block_scalar_product(c, v, j+1, w);
+    for(i=0; i<=j; i++) {
+      M[2*(i+j*n)  ] = c[i].re;
+      M[2*(i+j*n)+1] = c[i].im;
+    }
+  }
+  _F(zheev)("V", "U", &n, M, &n, lambda, work, &lwork, rwork, &info);
+  if(info == 0) rotate_basis(v, M, n, n);
+
+  free(M);
+  free(rwork);
+  free(work);
+  free(c);
+  return(info);
+}
+
+/****************************************************
+ * Rayleigh quotients and residuals of the
+ * eigenvectors of A
+ ****************************************************/
+static void rayleigh_quotients(int n, int fermion_type, double *w, double *aux) {
+  int i, ix, iix;
+  double norm, spinor1[24];
+
+  for(i=0; i<n; i++) {
+    apply_Q_her(w, eigenvector_field[i], aux, fermion_type);
+    spinor_scalar_product_re(&(eigenvalue[i]), eigenvector_field[i], w, VOLUME);
+    iix=0;
+    for(ix=0; ix<VOLUME; ix++) {
+      _fv_eq_fv_ti_re(spinor1, eigenvector_field[i]+iix, eigenvalue[i]);
+      _fv_mi_eq_fv(w+iix, spinor1);
+      iix+=24;
+    }
+    spinor_scalar_product_re(&norm, w, w, VOLUME);
+    if(g_cart_id==0) fprintf(stdout, "# [init_deflation] eigenvalue %3d %25.16e residuum %e\n", i, eigenvalue[i], sqrt(norm)/fabs(eigenvalue[i]));
+  }
+}
+
+/****************************************************
+ * thick-restart Lanczos for the lowest nev
+ * eigenpairs of apply_lanczos_op in a basis of
+ * dimension m
+ *
+ * - v must hold m fields with halo; on exit
+ *   v[0],...,v[nconv-1] are the converged Ritz
+ *   vectors, lambda the Ritz values
+ * - returns nconv or -1 on error
+ * - Ritz pair i is converged if
+ *   |A y_i - theta_i y_i| <= g_deflation_precision * theta_i
+ *   with A the Lanczos operator
+ * - at most niter_max operator applications
+ ****************************************************/
+static int lanczos_her(double **v, double *lambda, int nev, int m, int fermion_type, double *w, double *aux) {
+
+  int i, j, k=0, kk, ipass, info, lwork, napply=0, nconv=0, nrestart;
+  double *H=NULL, *Y=NULL, *theta=NULL, *work=NULL, *rwork=NULL, *res=NULL;
+  double norm, beta=0., *tmp=NULL;
+  complex *c=NULL;
+
+  H     = (double*)calloc(2*m*m, sizeof(double));
+  Y     = (double*)calloc(2*m*m, sizeof(double));
+  theta = (double*)calloc(m, sizeof(double));
+  res   = (double*)calloc(m, sizeof(double));
+  rwork = (double*)calloc(3*m, sizeof(double));
+  lwork = 2*m;
+  work  = (double*)calloc(2*lwork, sizeof(double));
+  c     = (complex*)calloc(m, sizeof(complex));
+  if(H==NULL || Y==NULL || theta==NULL || res==NULL || rwork==NULL || work==NULL || c==NULL) {
+    fprintf(stderr, "[lanczos_her] Error, could not allocate memory\n");
+    free(H);
+    free(Y);
+    free(theta);
+    free(res);
+    free(rwork);
+    free(work);
+    free(c);
+    return(-1);
+  }
+
+  /* random normalized start vector */
+  rangauss(v[0], 24*VOLUME);
+  spinor_scalar_product_re(&norm, v[0], v[0], VOLUME);
+  norm = 1. / sqrt(norm);
+  for(i=0; i<24*VOLUME; i++) v[0][i] *= norm;
+
+  for(nrestart=0; ; nrestart++) {
+
+    /*************************
+     * extend the basis from
+     * k to m vectors
+     *************************/
+    for(j=k; j<m; j++) {
+      apply_lanczos_op(w, v[j], aux, fermion_type);
+      napply++;
+      /* classical Gram-Schmidt, twice */
+      for(ipass=0; ipass<2; ipass++) {
+        block_scalar_product(c, v, j+1, w);
+        block_axpy(w, v, c, j+1, -1.);
+        for(i=0; i<=j; i++) {
+          H[2*(i+j*m)  ] += c[i].re;
+          H[2*(i+j*m)+1] += c[i].im;
+        }
+      }
+      spinor_scalar_product_re(&beta, w, w, VOLUME);
+      beta = sqrt(beta);
+      if(j<m-1) {
+        norm = 1. / beta;
+        for(i=0; i<24*VOLUME; i++) v[j+1][i] = w[i] * norm;
+      }
+    }
+
+    /*************************
+     * Rayleigh-Ritz
+     *************************/
+    memcpy((void*)Y, (void*)H, 2*m*m*sizeof(double));
+    _F(zheev)("V", "U", &m, Y, &m, theta, work, &lwork, rwork, &info);
+    if(info != 0) {
+      fprintf(stderr, "[lanczos_her] Error from zheev, info = %d\n", info);
+      nconv = -1;
+      break;
+    }
+    nconv = 0;
+    for(i=0; i<m; i++) {
+      res[i] = beta * sqrt( Y[2*(m-1+i*m)]*Y[2*(m-1+i*m)] + Y[2*(m-1+i*m)+1]*Y[2*(m-1+i*m)+1] );
+      if(i<nev && res[i] <= g_deflation_precision * fabs(theta[i])) nconv++;
+    }
+    if(g_cart_id==0) {
+      fprintf(stdout, "# [lanczos_her] restart %d after %d applications: %d of %d converged, lowest Ritz value %e\n",
+          nrestart, napply, nconv, nev, theta[0]);
+    }
+
+    if(nconv == nev || napply >= niter_max) {
+      rotate_basis(v, Y, m, nev);
+      break;
+    }
+
+    /*************************
+     * restart with the lowest
+     * kk Ritz vectors and the
+     * residual vector
+     *************************/
+    kk = (m + nev) / 2;
+    rotate_basis(v, Y, m, kk);
+    norm = 1. / beta;
+    for(i=0; i<24*VOLUME; i++) v[kk][i] = w[i] * norm;
+    memset(H, 0, 2*m*m*sizeof(double));
+    for(i=0; i<kk; i++) H[2*(i+i*m)] = theta[i];
+    k = kk;
+  }
+
+  if(nconv >= 0) {
+    /* move the converged pairs to the front */
+    nconv = 0;
+    for(i=0; i<nev; i++) {
+      if(g_cart_id==0) fprintf(stdout, "# [lanczos_her] eigenvalue %3d %25.16e residuum %e\n", i, theta[i], res[i]/fabs(theta[i]));
+      if(res[i] <= g_deflation_precision * fabs(theta[i])) {
+        if(nconv != i) {
+          tmp = v[nconv];
+          v[nconv] = v[i];
+          v[i] = tmp;
+        }
+        lambda[nconv] = theta[i];
+        nconv++;
+      }
+    }
+  }
+  if(nconv >= 0 && nconv != nev && g_cart_id==0) {
+    fprintf(stdout, "# [lanczos_her] Warning, only %d of %d eigenvectors converged\n", nconv, nev);
+  }
+
+  free(H);
+  free(Y);
+  free(theta);
+  free(res);
+  free(rwork);
+  free(work);
+  free(c);
+  return(nconv);
+}
+
+/****************************************************
+ * info record of the eigenvector cache, written
+ * by process 0 as the first record of the file
+ ****************************************************/
+static int write_deflation_info(char *filename, int fermion_type, int nev, int n, double *lambda) {
+  FILE *ofs = NULL;
+  LimeWriter *limewriter = NULL;
+  LimeRecordHeader *limeheader = NULL;
+  int i, status = 0;
+  char *message = NULL;
+  n_uint64_t bytes;
+
+  if(g_cart_id==0) {
+    message = (char*)malloc(500 + 30*n);
+    ofs = fopen(filename, "w");
+    if(message == NULL || ofs == (FILE*)NULL) {
+      fprintf(stderr, "[write_deflation_info] Could not open file %s for writing\n", filename);
+      status = 1;
+    } else {
+      limewriter = limeCreateWriter( ofs );
+      bytes = sprintf(message, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<cvcDeflation>\n<fermionType>%d</fermionType>\n<nev>%d</nev>\n<nconv>%d</nconv>\n<kappa>%25.16e</kappa>\n<mu>%25.16e</mu>\n<eigenvalues>\n",
+          fermion_type, nev, n, g_kappa, g_mu);
+      for(i=0; i<n; i++) bytes += sprintf(message+bytes, "%25.16e\n", lambda[i]);
+      bytes += sprintf(message+bytes, "</eigenvalues>\n</cvcDeflation>");
+      limeheader = limeCreateHeader(1, 1, _DEFLATION_INFO_TYPE, bytes);
+      if(limewriter == (LimeWriter*)NULL || limeWriteRecordHeader( limeheader, limewriter) < 0) {
+        fprintf(stderr, "[write_deflation_info] LIME write header error for file %s\n", filename);
+        status = 1;
+      } else {
+        limeWriteRecordData(message, &bytes, limewriter);
+      }
+      limeDestroyHeader( limeheader );
+      if(limewriter != (LimeWriter*)NULL) limeDestroyWriter( limewriter );
+      fclose(ofs);
+    }
+    free(message);
+  }
+#ifdef MPI
+  MPI_Bcast(&status, 1, MPI_INT, 0, g_cart_grid);
+#endif
+  return(status);
+}
+
+/****************************************************
+ * read and check the info record of the cache
+ *
+ * - process 0 reads, the result is broadcast
+ * - returns 0 if fermion type, nev, kappa and mu match
+ *   the input and the file holds n eigenvector records;
+ *   n and the eigenvalues in *n, lambda (size nev)
+ ****************************************************/
+static int read_deflation_info(char *filename, int fermion_type, int nev, int *n, double *lambda) {
+  FILE *ifs = NULL;
+  LimeReader *limereader = NULL;
+  int i, status = 1, nrecord = 0, ftype = -1, nev_file = 0, pos, len;
+  double kappa_file = 0., mu_file = 0.;
+  char *message = NULL, *header_type = NULL;
+  n_uint64_t bytes;
+
+  *n = 0;
+  if(g_cart_id==0) {
+    if((ifs = fopen(filename, "r")) != (FILE*)NULL) {
+      limereader = limeCreateReader( ifs );
+      while( limereader != (LimeReader*)NULL && limeReaderNextRecord(limereader) == LIME_SUCCESS ) {
+        header_type = limeReaderType(limereader);
+        if(strcmp(header_type, "scidac-binary-data") == 0 || strcmp(header_type, _COMPRESSED_SPINOR_TYPE) == 0) {
+          nrecord++;
+        } else if(strcmp(header_type, _DEFLATION_INFO_TYPE) == 0 && message == NULL) {
+          bytes = limeReaderBytes(limereader);
+          message = (char*)calloc(bytes+1, sizeof(char));
+          if(message != NULL) limeReaderReadData(message, &bytes, limereader);
+        }
+      }
+      if(limereader != (LimeReader*)NULL) limeDestroyReader(limereader);
+      fclose(ifs);
+    }
+    if(message == NULL) {
+      fprintf(stderr, "[read_deflation_info] no %s record in file %s\n", _DEFLATION_INFO_TYPE, filename);
+    } else if(sscanf(message, "<?xml version=\"1.0\" encoding=\"UTF-8\"?> <cvcDeflation> <fermionType>%d</fermionType> <nev>%d</nev> <nconv>%d</nconv> <kappa>%lf</kappa> <mu>%lf</mu> <eigenvalues>%n",
+          &ftype, &nev_file, n, &kappa_file, &mu_file, &pos) != 5) {
+      fprintf(stderr, "[read_deflation_info] could not parse the %s record in file %s\n", _DEFLATION_INFO_TYPE, filename);
+    } else if(ftype != fermion_type || nev_file != nev || *n <= 0 || *n > nev
+        || fabs(kappa_file - g_kappa) > 1.e-14 * fabs(g_kappa) || fabs(mu_file - g_mu) > 1.e-14 * fabs(g_mu)) {
+      fprintf(stdout, "# [read_deflation_info] file %s is for fermion type %d, nev %d, kappa %e, mu %e\n", filename, ftype, nev_file, kappa_file, mu_file);
+    } else if(nrecord != *n) {
+      fprintf(stderr, "[read_deflation_info] file %s has %d eigenvector records, not %d\n", filename, nrecord, *n);
+    } else {
+      status = 0;
+      for(i=0; i<*n && status==0; i++) {
+        if(sscanf(message+pos, "%lf%n", lambda+i, &len) != 1) status = 1;
+        else pos += len;
+      }
+      if(status != 0) fprintf(stderr, "[read_deflation_info] could not parse the eigenvalues in file %s\n", filename);
+    }
+    free(message);
+  }
+#ifdef MPI
+  MPI_Bcast(&status, 1, MPI_INT, 0, g_cart_grid);
+  MPI_Bcast(n, 1, MPI_INT, 0, g_cart_grid);
+  if(status == 0) MPI_Bcast(lambda, *n, MPI_DOUBLE, 0, g_cart_grid);
+#endif
+  return(status);
+}
+
+/****************************************************
+ * set up the eigenspace for the current gauge field
+ *
+ * - g_deflation_nev eigenvectors in a Lanczos basis of
+ *   dimension g_deflation_krylov (default nev + max(nev, 20))
+ * - uses g_spinor_field[kwork], [kwork+1] as work fields
+ * - returns the number of converged eigenvectors kept,
+ *   -1 if none converged
+ ****************************************************/
+int init_deflation(int fermion_type, int kwork) {
+
+  int i, m, nev, nconv=0, status, read_flag=0;
+  double **v=NULL, *w=NULL, *aux=NULL, *lambda_file=NULL;
+  char filename[200];
+  FILE *ofs=NULL;
+
+  free_deflation();
+
+  nev = g_deflation_nev;
+  if(nev <= 0) return(0);
+  m = g_deflation_krylov > nev+1 ? g_deflation_krylov : nev + (nev > 20 ? nev : 20);
+
+  if(kwork+2 > no_fields) return(-2);
+  w   = g_spinor_field[kwork  ];
+  aux = g_spinor_field[kwork+1];
+
+  v = (double**)calloc(m, sizeof(double*));
+  for(i=0; i<m; i++) alloc_spinor_field(&v[i], VOLUMEPLUSRAND);
+  eigenvalue = (double*)calloc(nev, sizeof(double));
+  lambda_file = (double*)calloc(nev, sizeof(double));
+  eigenvector_field = v;
+  eigenspace_dim = nev;
+  eigenspace_fermion_type = fermion_type;
+
+  /*************************
+   * try to read the
+   * eigenvectors
+   *************************/
+  if(strcmp(g_deflation_filename_prefix, "none") != 0) {
+    sprintf(filename, "%s.%.4d", g_deflation_filename_prefix, Nconf);
+    if( (ofs = fopen(filename, "r")) != NULL ) {
+      fclose(ofs);
+      read_flag = read_deflation_info(filename, fermion_type, nev, &nconv, lambda_file) == 0;
+      for(i=0; i<nconv && read_flag; i++) {
+        if(read_lime_spinor(v[i], filename, i) != 0) read_flag = 0;
+      }
+      if(read_flag) {
+        rayleigh_quotients(nconv, fermion_type, w, aux);
+        for(i=0; i<nconv; i++) {
+          if(fabs(eigenvalue[i] - lambda_file[i]) > _DEFLATION_EIGENVALUE_TOL * fabs(lambda_file[i])) read_flag = 0;
+        }
+      }
+      if(g_cart_id==0) {
+        if(read_flag) fprintf(stdout, "# [init_deflation] read %d eigenvectors from file %s\n", nconv, filename);
+        else fprintf(stdout, "# [init_deflation] could not use eigenvectors from file %s, recomputing\n", filename);
+      }
+    }
+  }
+
+  if(!read_flag) {
+    nconv = lanczos_her(v, eigenvalue, nev, m, fermion_type, w, aux);
+    status = nconv > 0 ? 0 : -1;
+    if(nconv == 0 && g_cart_id==0) fprintf(stderr, "[init_deflation] Error, no eigenvector converged\n");
+    if(status == 0 && fermion_type != _TM_FERMION) {
+      status = rayleigh_ritz_her(v, eigenvalue, nconv, fermion_type, w, aux);
+      if(status == 0) rayleigh_quotients(nconv, fermion_type, w, aux);
+      else status = -1;
+    }
+    if(status < 0) {
+      /* free_deflation frees the first nev fields */
+      for(i=nev; i<m; i++) free(v[i]);
+      free_deflation();
+      free(lambda_file);
+      return(-1);
+    }
+    if(strcmp(g_deflation_filename_prefix, "none") != 0) {
+      if(g_cart_id==0) fprintf(stdout, "# [init_deflation] writing %d eigenvectors to file %s\n", nconv, filename);
+      /* all records with the same writer, read_lime_spinor counts
+       * the records of one type only */
+      if(write_deflation_info(filename, fermion_type, nev, nconv, eigenvalue) == 0) {
+        for(i=0; i<nconv; i++) {
+          if(g_propagator_codec != _SPINOR_CODEC_NONE) {
+            write_lime_spinor_compressed(v[i], filename, 1, g_propagator_codec);
+          } else {
+            write_lime_spinor(v[i], filename, 1, 64);
+          }
+        }
+      }
+    }
+  }
+
+  /* keep only the converged eigenvectors */
+  for(i=nconv; i<m; i++) free(v[i]);
+  eigenspace_dim = nconv;
+  free(lambda_file);
+
+  return(eigenspace_dim);
+}
+
+void free_deflation(void) {
+  int i;
+  if(eigenvector_field != NULL) {
+    for(i=0; i<eigenspace_dim; i++) free(eigenvector_field[i]);
+    free(eigenvector_field);
+    eigenvector_field = NULL;
+  }
+  if(eigenvalue != NULL) {
+    free(eigenvalue);
+    eigenvalue = NULL;
+  }
+  eigenspace_dim = 0;
+  eigenspace_fermion_type = -1;
+}
+
+/****************************************************
+ * eigenvectors and eigenvalues of the current
+ * eigenspace, returns its dimension
+ ****************************************************/
+int get_deflation_eigenspace(double ***v, double **lambda) {
+  if(v != NULL) *v = eigenvector_field;
+  if(lambda != NULL) *lambda = eigenvalue;
+  return(eigenspace_dim);
+}
+
+/****************************************************
+ * x = x + V Lambda^{-1} V^dagger r
+ *
+ * - returns the number of eigenvectors used, 0 if no
+ *   eigenspace was set up for this fermion type
+ ****************************************************/
+int deflate_her(double *x, double *r, int fermion_type) {
+  int i;
+  complex *c=NULL;
+
+  if(eigenspace_dim == 0 || fermion_type != eigenspace_fermion_type) return(0);
+
+  c = (complex*)malloc(eigenspace_dim*sizeof(complex));
+  block_scalar_product(c, eigenvector_field, eigenspace_dim, r);
+  for(i=0; i<eigenspace_dim; i++) {
+    c[i].re /= eigenvalue[i];
+    c[i].im /= eigenvalue[i];
+  }
+  block_axpy(x, eigenvector_field, c, eigenspace_dim, 1.);
+  free(c);
+  return(eigenspace_dim);
+}
@@ -0,0 +1,7 @@
+#ifndef _DEFLATION_H
+#define _DEFLATION_H
+int init_deflation(int fermion_type, int kwork);
+void free_deflation(void);
+int deflate_her(double *x, double *r, int fermion_type);
+int get_deflation_eigenspace(double ***v, double **lambda);
+#endif
@@ -42,6 +42,7 @@
 #include "smearing_techniques.h"
 #include "make_H3orbits.h"
 #include "contractions_io.h"
+#include "spinor_prefetch.h"
 
 void usage() {
   fprintf(stdout, "Code to perform contractions for proton 2-pt. function\n");
@@ -53,6 +54,7 @@ void usage() {
   fprintf(stdout, "         -F fermion type [default Wilson fermion, id 1]\n");
   fprintf(stdout, "         -t number of threads for OPENMP [default 1]\n");
   fprintf(stdout, "         -g do random gauge transformation [default no gauge transformation]\n");
+  fprintf(stdout, "         -b number of propagator sets to read ahead [default 1, 0 = no prefetch]\n");
   fprintf(stdout, "         -h? this help\n");
 #ifdef MPI
   MPI_Abort(MPI_COMM_WORLD, 1);
@@ -90,7 +92,6 @@ int main(int argc, char **argv) {
   double ratime, retime;
   double plaq_m, plaq_r;
   int mode = -1;
-  double *work=NULL;
   fermion_propagator_type *fp1=NULL, *fp2=NULL, *fp3=NULL, *fp4=NULL, *fpaux=NULL, *uprop=NULL, *dprop=NULL;
   spinor_propagator_type *sp1=NULL, *sp2=NULL;
   double q[3], phase, *gauge_trafo=NULL, spinor1[24];
@@ -105,6 +106,12 @@ int main(int argc, char **argv) {
 /***********************************************************/
   int *qlatt_id=NULL, *qlatt_count=NULL, **qlatt_rep=NULL, **qlatt_map=NULL, qlatt_nclass=0;
   int use_lattice_momenta = 0;
+  int prefetch_nbuf = 1, *prefetch_position = NULL;
+  char **prefetch_filename = NULL;
+  spinor_prefetch prefetch;
+#if (defined MPI) && (defined HAVE_PTHREAD)
+  int mpi_thread_provided;
+#endif
   double **qlatt_list=NULL;
 /***********************************************************/
 
@@ -138,11 +145,14 @@ int main(int argc, char **argv) {
    fftwnd_plan plan_p;
 //#endif 
 
-#ifdef MPI
+#if (defined MPI) && (defined HAVE_PTHREAD)
+  /* the prefetch I/O thread makes no MPI calls */
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &mpi_thread_provided);
+#elif (defined MPI)
   MPI_Init(&argc, &argv);
 #endif
 
-  while ((c = getopt(argc, argv, "Sah?vgf:F:P:s:m:")) != -1) {
+  while ((c = getopt(argc, argv, "Sah?vgf:F:P:s:m:b:")) != -1) {
     switch (c) {
     case 'v':
       verbose = 1;
@@ -191,6 +201,10 @@ int main(int argc, char **argv) {
       smear_seq_source = 1;
       fprintf(stdout, "# [] will smear sequential soucre\n");
       break;
+    case 'b':
+      prefetch_nbuf = atoi(optarg);
+      fprintf(stdout, "# [] will read ahead %d propagator set(s)\n", prefetch_nbuf);
+      break;
     case 'h':
     case '?':
     default:
@@ -226,6 +240,12 @@ int main(int argc, char **argv) {
 
   // initialize MPI parameters
   mpi_init(argc, argv);
+#if (defined MPI) && (defined HAVE_PTHREAD)
+  if(mpi_thread_provided < MPI_THREAD_FUNNELED) {
+    if(g_cart_id==0) fprintf(stdout, "# [] MPI provides thread level %d only, no prefetch\n", mpi_thread_provided);
+    prefetch_nbuf = 0;
+  }
+#endif
 
 #ifdef OPENMP
   status = fftw_threads_init();
@@ -280,14 +300,15 @@ int main(int argc, char **argv) {
 
     if(N_ape > 0) {
       if(g_cart_id==0) fprintf(stdout, "# [delta_pp_2_pi_N_sequential_v4_mpi] APE smearing gauge field with paramters N_APE=%d, alpha_APE=%e\n", N_ape, alpha_ape);
-#ifdef OPENMP
-      APE_Smearing_Step_threads(g_gauge_field, N_ape, alpha_ape);
-#else
-      for(i=0; i<N_ape; i++) {
-        APE_Smearing_Step(g_gauge_field, alpha_ape);
+      if(g_ape_cache) {
+        status = APE_Smearing_cached(g_gauge_field, N_ape, alpha_ape, gaugefilename_prefix, Nconf);
+      } else {
+        status = APE_Smearing(g_gauge_field, N_ape, alpha_ape);
+      }
+      if(status != 0) {
+        fprintf(stderr, "[delta_pp_2_pi_N_sequential_v4_mpi] Error from APE smearing, status was %d\n", status);
+        EXIT(22);
       }
-#endif
-      xchange_gauge_field(g_gauge_field);
     }
     plaquette(&plaq_m);
     if(g_cart_id==0) {
@@ -372,10 +393,8 @@ int main(int argc, char **argv) {
   g_spinor_field = NULL;
   if(mode == 2) {
     no_fields = 2*n_s*n_c;
-    if(N_Jacobi>0) no_fields++;
     g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
     for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOLUME+RAND);
-    if(N_Jacobi>0) work = g_spinor_field[no_fields-1];
   }
   
   if(mode == 2) {
@@ -485,26 +504,49 @@ int main(int argc, char **argv) {
       for(i=0;i<g_num_threads;i++) create_sp(sp2+i);
     }
   
-  
+    /******************************************************
+     * queue the up-type and the sequential propagators
+     * for the prefetch
+     ******************************************************/
+    prefetch_filename = (char**)malloc((rel_momentum_no+1)*n_s*n_c*sizeof(char*));
+    prefetch_position = (int*)calloc((rel_momentum_no+1)*n_s*n_c, sizeof(int));
+    if(prefetch_filename == NULL || prefetch_position == NULL) {
+      fprintf(stderr, "[] Error, could not allocate prefetch queue\n");
+      EXIT(173);
+    }
+    for(i=0; i<(rel_momentum_no+1)*n_s*n_c; i++) {
+      prefetch_filename[i] = (char*)malloc(200*sizeof(char));
+      imom = i / (n_s*n_c) - 1;
+      is   = i % (n_s*n_c);
+      if(imom < 0) {
+        sprintf(prefetch_filename[i], "%s.%.4d.t%.2dx%.2dy%.2dz%.2d.%.2d.inverted", filename_prefix, Nconf, sx0, sx1, sx2, sx3, is);
+      } else {
+        sprintf(prefetch_filename[i], "seq_%s.%.4d.t%.2dx%.2dy%.2dz%.2d.%.2d.qx%.2dqy%.2dqz%.2d.inverted",
+            filename_prefix, Nconf, sx0, sx1, sx2, sx3, is,
+            rel_momentum_list[imom][0],rel_momentum_list[imom][1],rel_momentum_list[imom][2]);
+      }
+    }
+    if(init_spinor_prefetch(&prefetch, prefetch_nbuf, rel_momentum_no+1, n_s*n_c, prefetch_filename, prefetch_position) != 0) {
+      fprintf(stderr, "[] Error from init_spinor_prefetch\n");
+      EXIT(174);
+    }
+    for(i=0; i<(rel_momentum_no+1)*n_s*n_c; i++) free(prefetch_filename[i]);
+    free(prefetch_filename);
+    free(prefetch_position);
+
     // read timeslice of the 12 up-type propagators and smear them
     for(is=0;is<n_s*n_c;is++) {
       sprintf(filename, "%s.%.4d.t%.2dx%.2dy%.2dz%.2d.%.2d.inverted", filename_prefix, Nconf, sx0, sx1, sx2, sx3, is);
-      status = read_lime_spinor(g_spinor_field[is], filename, 0);
+      status = spinor_prefetch_read(&prefetch, g_spinor_field[is], filename, 0);
       if(status != 0) {
         fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
         EXIT(102);
       }
-      if(N_Jacobi > 0) {
-        if(g_cart_id==0) fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-            is, N_Jacobi, kappa_Jacobi);
-#ifdef OPENMP
-        Jacobi_Smearing_Step_one_threads(g_gauge_field, g_spinor_field[is], work, N_Jacobi, kappa_Jacobi);
-#else
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(g_gauge_field, g_spinor_field[is], work, kappa_Jacobi);
-        }
-#endif
-      }
+    }
+    if(N_Jacobi > 0) {
+      if(g_cart_id==0) fprintf(stdout, "# [] Jacobi smearing up-type propagator with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+          N_Jacobi, kappa_Jacobi);
+      Jacobi_Smearing_Propagator(g_gauge_field, g_spinor_field, n_s*n_c, N_Jacobi, kappa_Jacobi);
     }
   
     /******************************************************
@@ -517,22 +559,16 @@ int main(int argc, char **argv) {
         sprintf(filename, "seq_%s.%.4d.t%.2dx%.2dy%.2dz%.2d.%.2d.qx%.2dqy%.2dqz%.2d.inverted",
             filename_prefix, Nconf, sx0, sx1, sx2, sx3, is,
             rel_momentum_list[imom][0],rel_momentum_list[imom][1],rel_momentum_list[imom][2]);
-        status = read_lime_spinor(g_spinor_field[n_s*n_c+is], filename, 0);
+        status = spinor_prefetch_read(&prefetch, g_spinor_field[n_s*n_c+is], filename, 0);
         if(status != 0) {
           fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
           EXIT(102);
         }
-        if(N_Jacobi > 0) {
-          if(g_cart_id==0) fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-              is, N_Jacobi, kappa_Jacobi);
-#ifdef OPENMP
-          Jacobi_Smearing_Step_one_threads(g_gauge_field, g_spinor_field[n_s*n_c+is], work, N_Jacobi, kappa_Jacobi);
-#else
-          for(c=0; c<N_Jacobi; c++) {
-            Jacobi_Smearing_Step_one(g_gauge_field, g_spinor_field[n_s*n_c+is], work, kappa_Jacobi);
-          }
-#endif
-        }
+      }
+      if(N_Jacobi > 0) {
+        if(g_cart_id==0) fprintf(stdout, "# [] Jacobi smearing sequential propagator with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+            N_Jacobi, kappa_Jacobi);
+        Jacobi_Smearing_Propagator(g_gauge_field, g_spinor_field+n_s*n_c, n_s*n_c, N_Jacobi, kappa_Jacobi);
       }
   
       /******************************************************
@@ -795,6 +831,8 @@ int main(int argc, char **argv) {
   
     }    // of loop on relative momenta
 
+    fini_spinor_prefetch(&prefetch);
+
     // free the fermion propagator points
     for(i=0;i<g_num_threads;i++) {
       free_fp( uprop+i );
@@ -89,7 +89,6 @@ int main(int argc, char **argv) {
   double ratime, retime;
   //double plaq_m, plaq_r;
   int mode = -1;
-  double *work=NULL;
   fermion_propagator_type *fp1=NULL, *fp2=NULL, *fp3=NULL, *fp4=NULL, *fpaux=NULL, *uprop=NULL, *dprop=NULL;
   spinor_propagator_type *sp1=NULL, *sp2=NULL;
   double q[3], phase, *gauge_trafo=NULL, spinor1[24];
@@ -379,13 +378,10 @@ if(mode == 2) {
     g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
     for(i=0; i<no_fields-1; i++) alloc_spinor_field(&g_spinor_field[i], VOL3);
     alloc_spinor_field(&g_spinor_field[no_fields-1], VOLUME);
-    if(N_Jacobi>0) work = g_spinor_field[1];
   } else if(mode == 2) {
     no_fields = 2*n_s*n_c;
-    if(N_Jacobi>0) no_fields++;
     g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
     for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOL3);
-    if(N_Jacobi>0) work = g_spinor_field[no_fields-1];
   }
   
   spinor_field_checksum = (DML_Checksum*)malloc(n_s*n_c * sizeof(DML_Checksum) );
@@ -428,13 +424,7 @@ if(mode == 1) {
           fprintf(stdout, "# [] Warning, mismatch in checksums\n");
         }
       }
-#ifdef OPENMP
-      status = APE_Smearing_Step_Timeslice_threads(g_gauge_field, N_ape, alpha_ape);
-#else
-      for(i=0; i<N_ape; i++) {
-        status = APE_Smearing_Step_Timeslice(g_gauge_field, alpha_ape);
-      }
-#endif
+      status = APE_Smearing_Timeslice(g_gauge_field, N_ape, alpha_ape);
     }
     // read timeslice of the 12 down-type propagators and smear them
     for(is=0;is<n_s*n_c;is++) {
@@ -451,13 +441,7 @@ if(mode == 1) {
       if(N_Jacobi > 0) {
         fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
             is, N_Jacobi, kappa_Jacobi);
-#ifdef OPENMP
-        Jacobi_Smearing_Step_one_Timeslice_threads(g_gauge_field, g_spinor_field[0], work, N_Jacobi, kappa_Jacobi);
-#else
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one_Timeslice(g_gauge_field, g_spinor_field[0], work, kappa_Jacobi);
-        }
-#endif
+        Jacobi_Smearing_Timeslice_block(g_gauge_field, g_spinor_field, 1, N_Jacobi, kappa_Jacobi);
       }
 
       for(imom=0;imom<rel_momentum_no;imom++) {
@@ -572,13 +556,7 @@ if(mode == 2) {
         fprintf(stderr, "[] Error, could not read gauge field\n");
         exit(21);
       }
-#ifdef OPENMP
-      status = APE_Smearing_Step_Timeslice_threads(g_gauge_field, N_ape, alpha_ape);
-#else
-      for(i=0; i<N_ape; i++) {
-        status = APE_Smearing_Step_Timeslice(g_gauge_field, alpha_ape);
-      }
-#endif
+      status = APE_Smearing_Timeslice(g_gauge_field, N_ape, alpha_ape);
     }
 
     // read timeslice of the 12 up-type propagators and smear them
@@ -590,22 +568,16 @@ if(mode == 2) {
           fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
           exit(102);
         }
-        if(N_Jacobi > 0) {
-          fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-              is, N_Jacobi, kappa_Jacobi);
-#ifdef OPENMP
-          Jacobi_Smearing_Step_one_Timeslice_threads(g_gauge_field, g_spinor_field[is], work, N_Jacobi, kappa_Jacobi);
-#else
-          for(c=0; c<N_Jacobi; c++) {
-            Jacobi_Smearing_Step_one_Timeslice(g_gauge_field, g_spinor_field[is], work, kappa_Jacobi);
-          }
-#endif
-        }
 //      } else {  // of if do_gt == 0
 //        // apply gt
 //        apply_gt_prop(gauge_trafo, g_spinor_field[is], is/n_c, is%n_c, 4, filename_prefix, g_source_location);
 //      } // of if do_gt == 0
     }
+    if(N_Jacobi > 0) {
+      fprintf(stdout, "# [] Jacobi smearing propagator timeslice %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+          timeslice, N_Jacobi, kappa_Jacobi);
+      Jacobi_Smearing_Timeslice_block(g_gauge_field, g_spinor_field, n_s*n_c, N_Jacobi, kappa_Jacobi);
+    }
 
 
     /******************************************************
@@ -623,22 +595,16 @@ if(mode == 2) {
             fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
             exit(102);
           }
-          if(N_Jacobi > 0) {
-            fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-                 is, N_Jacobi, kappa_Jacobi);
-#ifdef OPENMP
-            Jacobi_Smearing_Step_one_Timeslice_threads(g_gauge_field, g_spinor_field[n_s*n_c+is], work, N_Jacobi, kappa_Jacobi);
-#else
-            for(c=0; c<N_Jacobi; c++) {
-              Jacobi_Smearing_Step_one_Timeslice(g_gauge_field, g_spinor_field[n_s*n_c+is], work, kappa_Jacobi);
-            }
-#endif
-          }
 //        } else {  // of if do_gt == 0
 //          // apply gt
 //          apply_gt_prop(gauge_trafo, g_spinor_field[n_s*n_c+is], is/n_c, is%n_c, 4, filename_prefix, g_source_location);
 //        } // of if do_gt == 0
       }
+      if(N_Jacobi > 0) {
+        fprintf(stdout, "# [] Jacobi smearing sequential propagator timeslice %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+             timeslice, N_Jacobi, kappa_Jacobi);
+        Jacobi_Smearing_Timeslice_block(g_gauge_field, g_spinor_field+n_s*n_c, n_s*n_c, N_Jacobi, kappa_Jacobi);
+      }
   
   
       /******************************************************
@@ -89,7 +89,6 @@ int main(int argc, char **argv) {
   char filename[200], contype[200], gauge_field_filename[200];
   double ratime, retime;
   //double plaq_m, plaq_r;
-  double *work=NULL;
   fermion_propagator_type fp1=NULL, fp2=NULL, fp3=NULL, fp4=NULL, fpaux=NULL, uprop=NULL, dprop=NULL, *stochastic_fp=NULL;
   spinor_propagator_type sp1, sp2;
   double q[3], phase, *gauge_trafo=NULL;
@@ -384,12 +383,9 @@ int main(int argc, char **argv) {
   } else {
     no_fields =   n_s*n_c+3;
   }
-  if(N_Jacobi>0) no_fields++;
 
   g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
   for(i=0; i<no_fields-2; i++) alloc_spinor_field(&g_spinor_field[i], VOL3);
-  // work
-  if(N_Jacobi>0) work = g_spinor_field[no_fields-4];
   // stochastic_fv
   stochastic_fv = g_spinor_field[no_fields-3];
   // stochastic source and propagator
@@ -510,13 +506,7 @@ int main(int argc, char **argv) {
       fprintf(stderr, "[] Error, could not read gauge field\n");
       exit(21);
     }
-    for(i=0; i<N_ape; i++) {
-#ifdef OPENMP
-      status = APE_Smearing_Step_Timeslice_threads(g_gauge_field, alpha_ape);
-#else
-      status = APE_Smearing_Step_Timeslice(g_gauge_field, alpha_ape);
-#endif
-    }
+    status = APE_Smearing_Timeslice(g_gauge_field, N_ape, alpha_ape);
   }
   // read timeslice of the 12 up-type propagators and smear them
   //
@@ -535,17 +525,11 @@ int main(int argc, char **argv) {
       fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
       exit(102);
     }
-    if(N_Jacobi > 0) {
-      fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-          is, N_Jacobi, kappa_Jacobi);
-      for(c=0; c<N_Jacobi; c++) {
-#ifdef OPENMP
-        Jacobi_Smearing_Step_one_Timeslice_threads(g_gauge_field, g_spinor_field[is], work, kappa_Jacobi);
-#else
-        Jacobi_Smearing_Step_one_Timeslice(g_gauge_field, g_spinor_field[is], work, kappa_Jacobi);
-#endif
-      }
-    }
+  }
+  if(N_Jacobi > 0) {
+    fprintf(stdout, "# [] Jacobi smearing propagator timeslice %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+        source_timeslice, N_Jacobi, kappa_Jacobi);
+    Jacobi_Smearing_Timeslice_block(g_gauge_field, g_spinor_field, n_s*n_c, N_Jacobi, kappa_Jacobi);
   }
   for(is=0;is<g_fv_dim;is++) {
     for(ix=0;ix<VOL3;ix++) {
@@ -613,13 +597,7 @@ int main(int argc, char **argv) {
           exit(21);
         }
 
-        for(i=0; i<N_ape; i++) {
-#ifdef OPENMP
-          status = APE_Smearing_Step_Timeslice_threads(g_gauge_field, alpha_ape);
-#else
-          status = APE_Smearing_Step_Timeslice(g_gauge_field, alpha_ape);
-#endif
-        }
+        status = APE_Smearing_Timeslice(g_gauge_field, N_ape, alpha_ape);
 
       }
 
@@ -631,17 +609,11 @@ int main(int argc, char **argv) {
             fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
             exit(102);
           }
-          if(N_Jacobi > 0) {
-            fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-                is, N_Jacobi, kappa_Jacobi);
-            for(c=0; c<N_Jacobi; c++) {
-#ifdef OPENMP
-              Jacobi_Smearing_Step_one_Timeslice_threads(g_gauge_field, g_spinor_field[is], work, kappa_Jacobi);
-#else
-              Jacobi_Smearing_Step_one_Timeslice(g_gauge_field, g_spinor_field[is], work, kappa_Jacobi);
-#endif
-            }
-          }
+      }
+      if(N_Jacobi > 0) {
+        fprintf(stdout, "# [] Jacobi smearing propagator timeslice %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+            timeslice, N_Jacobi, kappa_Jacobi);
+        Jacobi_Smearing_Timeslice_block(g_gauge_field, g_spinor_field, n_s*n_c, N_Jacobi, kappa_Jacobi);
       }
 
       if(fermion_type == _TM_FERMION) {
@@ -654,19 +626,13 @@ int main(int argc, char **argv) {
               fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
               exit(102);
             }
-            if(N_Jacobi > 0) {
-              fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-                   is, N_Jacobi, kappa_Jacobi);
-              for(c=0; c<N_Jacobi; c++) {
-#ifdef OPENMP
-                Jacobi_Smearing_Step_one_Timeslice_threads(g_gauge_field, g_spinor_field[n_s*n_c+is], work, kappa_Jacobi);
-#else
-                Jacobi_Smearing_Step_one_Timeslice(g_gauge_field, g_spinor_field[n_s*n_c+is], work, kappa_Jacobi);
-#endif
-              }
-            }
         }
       }
+        if(do_gt == 0 && N_Jacobi > 0) {
+          fprintf(stdout, "# [] Jacobi smearing down-type propagator timeslice %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+               timeslice, N_Jacobi, kappa_Jacobi);
+          Jacobi_Smearing_Timeslice_block(g_gauge_field, g_spinor_field+n_s*n_c, n_s*n_c, N_Jacobi, kappa_Jacobi);
+        }
 
   
       /******************************************************
@@ -88,7 +88,6 @@ int main(int argc, char **argv) {
   char filename[200], contype[200], gauge_field_filename[200];
   double ratime, retime;
   //double plaq_m, plaq_r;
-  double *work=NULL;
   fermion_propagator_type fp1=NULL, fp2=NULL, fp3=NULL, uprop=NULL, dprop=NULL;
   spinor_propagator_type sp1, sp2;
   double q[3], phase, *gauge_trafo=NULL;
@@ -257,11 +256,8 @@ int main(int argc, char **argv) {
 //  if(fermion_type == _TM_FERMION) {
 //    no_fields *= 2;
 //  }
-  if(N_Jacobi>0) no_fields++;
   g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
-  for(i=0; i<no_fields-1; i++) alloc_spinor_field(&g_spinor_field[i], VOL3);
-  alloc_spinor_field(&g_spinor_field[no_fields-1], VOL3);
-  work = g_spinor_field[no_fields-1];
+  for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOL3);
 
   spinor_field_checksum = (DML_Checksum*)malloc(no_fields * sizeof(DML_Checksum) );
   if(spinor_field_checksum == NULL ) {
@@ -332,13 +328,7 @@ int main(int argc, char **argv) {
         exit(21);
       }
 
-#ifdef OPENMP
-      status = APE_Smearing_Step_Timeslice_threads(g_gauge_field, N_ape, alpha_ape);
-#else
-      for(i=0; i<N_ape; i++) {
-        status = APE_Smearing_Step_Timeslice(g_gauge_field, alpha_ape);
-      }
-#endif
+      status = APE_Smearing_Timeslice(g_gauge_field, N_ape, alpha_ape);
 
     }
 
@@ -351,22 +341,16 @@ int main(int argc, char **argv) {
           fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
           exit(102);
         }
-        if(N_Jacobi > 0) {
-          fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-              is, N_Jacobi, kappa_Jacobi);
-#ifdef OPENMP
-          Jacobi_Smearing_Step_one_Timeslice_threads(g_gauge_field, g_spinor_field[is], work, N_Jacobi, kappa_Jacobi);
-#else
-          for(c=0; c<N_Jacobi; c++) {
-            Jacobi_Smearing_Step_one_Timeslice(g_gauge_field, g_spinor_field[is], work, kappa_Jacobi);
-          }
-#endif
-        }
       } else {  // of if do_gt == 0
         // apply gt
         apply_gt_prop(gauge_trafo, g_spinor_field[is], is/n_c, is%n_c, 4, filename_prefix, g_source_location);
       } // of if do_gt == 0
     }
+    if(do_gt == 0 && N_Jacobi > 0) {
+      fprintf(stdout, "# [] Jacobi smearing propagator timeslice %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+          timeslice, N_Jacobi, kappa_Jacobi);
+      Jacobi_Smearing_Timeslice_block(g_gauge_field, g_spinor_field, n_s*n_c, N_Jacobi, kappa_Jacobi);
+    }
 /*
     if(fermion_type == _TM_FERMION) {
       // read timeslice of the 12 down-type propagators, smear them
@@ -381,13 +365,7 @@ int main(int argc, char **argv) {
           if(N_Jacobi > 0) {
             fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
                  is, N_Jacobi, kappa_Jacobi);
-            for(c=0; c<N_Jacobi; c++) {
-#ifdef OPENMP
-              Jacobi_Smearing_Step_one_Timeslice_threads(g_gauge_field, g_spinor_field[n_s*n_c+is], work, kappa_Jacobi);
-#else
-              Jacobi_Smearing_Step_one_Timeslice(g_gauge_field, g_spinor_field[n_s*n_c+is], work, kappa_Jacobi);
-#endif
-            }
+            Jacobi_Smearing_Timeslice_block(g_gauge_field, g_spinor_field+n_s*n_c+is, 1, N_Jacobi, kappa_Jacobi);
           }
         } else {  // of if do_gt == 0
           // apply gt
@@ -0,0 +1,298 @@
+/********************
+ * dilution.c
+ *
+ * in-memory dilution engine for stochastic disconnected loops
+ *
+ * - one noise vector per sample from the counter-based rng
+ *   (keyed on g_seed, Nconf, sample), diluted in time, space
+ *   (even/odd or init_multigrid_decompositon colouring), spin
+ *   and colour
+ * - every partition is solved and handed to a contraction
+ *   callback which accumulates the loop; nothing is written
+ *   to disk in between
+ * - optionally hierarchical probing: the noise is multiplied
+ *   with Hadamard vectors over a nested colouring of the lattice
+ ********************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+#include "cvc_complex.h"
+#include "cvc_linalg.h"
+#include "global.h"
+#include "cvc_geometry.h"
+#include "cvc_utils.h"
+#include "ranphilox.h"
+#include "dilution.h"
+
+/********************
+ * set up the partitions
+ ********************/
+int init_dilution_scheme(dilution_scheme *d, int flags, int space_degree) {
+
+  d->flags        = flags;
+  d->space_degree = space_degree;
+  d->lexic2sub    = NULL;
+  d->sub2lexic    = NULL;
+  d->insub        = NULL;
+  d->probing_degree = 0;
+  d->nhp          = 1;
+  d->hp_colour    = NULL;
+
+  d->nt = (flags & _DILUTION_TIME)  ? T_global : 1;
+  d->ns = (flags & _DILUTION_SPIN)  ? 4 : 1;
+  d->nc = (flags & _DILUTION_COLOR) ? 3 : 1;
+  d->nx = 1;
+  if(space_degree > 0) {
+    if(init_multigrid_decompositon(space_degree, &(d->lexic2sub), &(d->sub2lexic), &(d->insub)) != 0) {
+      if(g_cart_id==0) fprintf(stderr, "[init_dilution_scheme] Error from init_multigrid_decompositon for degree %d\n", space_degree);
+      return(1);
+    }
+    d->nx = 1<<((space_degree/2)*4 + space_degree%2);
+  }
+  d->npart = d->nt * d->nx * d->ns * d->nc;
+
+  if(g_cart_id==0) {
+    fprintf(stdout, "# [init_dilution_scheme] time %d x space %d x spin %d x colour %d = %d partitions\n",
+        d->nt, d->nx, d->ns, d->nc, d->npart);
+  }
+  return(0);
+}
+
+void fini_dilution_scheme(dilution_scheme *d) {
+  if(d->space_degree > 0) fini_multigrid_decompositon(&(d->lexic2sub), &(d->sub2lexic), &(d->insub));
+  if(d->hp_colour != NULL) free(d->hp_colour);
+  d->hp_colour = NULL;
+  d->npart = 0;
+}
+
+/********************
+ * hierarchical probing
+ *
+ * level l has the colour classes of init_multigrid_decompositon
+ * with degree l (number of colours as there),
+ *   l = 2k:   x mod 2^k in all directions
+ *   l = 2k+1: in addition the parity of the 2^k-blocks
+ * each level refines the previous one; the colours are labelled
+ * such that the colour of level l is the colour of level
+ * probing_degree mod N_l. Then with the Hadamard matrix
+ *   H[c][j] = (-1)^popcount(c & j)
+ *   sum_{j<N_l} H[c][j] H[c'][j] = N_l delta(c mod N_l, c' mod N_l),
+ * i.e. the first N_l probing vectors z_j(x) = H[c(x)][j] eta(x)
+ * probe level l, and raising the level only adds vectors
+ ********************/
+int hierarchical_probing_ncolour(int degree) {
+  return( 1<<((degree/2)*4 + degree%2) );
+}
+
+static int hierarchical_probing_colour(int *gx, int degree) {
+  int k, c=0, n=1;
+
+  for(k=0; 2*k+1<=degree; k++) {
+    /* level 2k+1: parity of the 2^k-blocks */
+    c += n * ( ( (gx[0]>>k) + (gx[1]>>k) + (gx[2]>>k) + (gx[3]>>k) ) & 1 );
+    n *= 2;
+    if(2*k+2 > degree) break;
+    /* level 2k+2: bit k of x_0, x_1, x_2; bit k of x_3 follows from the parity */
+    c += n * ( ((gx[0]>>k)&1) + 2*((gx[1]>>k)&1) + 4*((gx[2]>>k)&1) );
+    n *= 8;
+  }
+  return(c);
+}
+
+static int hadamard_sign(int c, int j) {
+  int b = c & j, p = 0;
+  while(b) { p ^= 1; b &= b-1; }
+  return(1 - 2*p);
+}
+
+int init_dilution_probing(dilution_scheme *d, int degree) {
+
+  int ix, x0, x1, x2, x3, gx[4];
+  int length = 1<<((degree+1)/2);
+
+  if(T_global%length != 0 || LX_global%length != 0 || LY_global%length != 0 || LZ_global%length != 0) {
+    if(g_cart_id==0) fprintf(stderr, "[init_dilution_probing] Error, lattice extents must be multiples of %d for degree %d\n", length, degree);
+    return(1);
+  }
+
+  if(d->hp_colour != NULL) free(d->hp_colour);
+  if( (d->hp_colour = (int*)malloc(VOLUME*sizeof(int))) == NULL ) {
+    fprintf(stderr, "[init_dilution_probing] Error, could not allocate colour field\n");
+    return(2);
+  }
+
+  for(x0=0; x0<T;  x0++) {
+    gx[0] = x0 + Tstart;
+  for(x1=0; x1<LX; x1++) {
+    gx[1] = x1 + LXstart;
+  for(x2=0; x2<LY; x2++) {
+    gx[2] = x2 + LYstart;
+  for(x3=0; x3<LZ; x3++) {
+    gx[3] = x3 + LZstart;
+    ix = g_ipt[x0][x1][x2][x3];
+    d->hp_colour[ix] = hierarchical_probing_colour(gx, degree);
+  }}}}
+
+  d->npart /= d->nhp;
+  d->probing_degree = degree;
+  d->nhp   = hierarchical_probing_ncolour(degree);
+  d->npart *= d->nhp;
+
+  if(g_cart_id==0) {
+    fprintf(stdout, "# [init_dilution_probing] hierarchical probing degree %d with %d vectors, %d partitions\n",
+        degree, d->nhp, d->npart);
+  }
+  return(0);
+}
+
+/********************
+ * s = P_ipart eta on the local volume
+ ********************/
+void dilution_project(double *s, double *eta, dilution_scheme *d, int ipart) {
+
+  int ix, k, it, isub, is, ic, keep, jhp;
+  unsigned int VOL3 = LX*LY*LZ;
+  int comp[12];
+  double sign;
+
+  jhp   = ipart / (d->npart / d->nhp);
+  ipart = ipart % (d->npart / d->nhp);
+
+  ic   =   ipart % d->nc;
+  is   = ( ipart / d->nc ) % d->ns;
+  isub = ( ipart / (d->nc * d->ns) ) % d->nx;
+  it   =   ipart / (d->nc * d->ns * d->nx);
+
+  /* spin-colour components k = 3*spin + colour in the partition */
+  for(k=0; k<12; k++) {
+    comp[k] = ( d->ns==1 || k/3==is ) && ( d->nc==1 || k%3==ic );
+  }
+
+#ifdef OPENMP
+#pragma omp parallel for private(k, keep, sign)
+#endif
+  for(ix=0; ix<VOLUME; ix++) {
+    keep = ( d->nt==1 || ix/VOL3 + Tstart == it ) && ( d->nx==1 || d->insub[ix] == isub );
+    sign = d->nhp==1 ? 1. : (double)hadamard_sign(d->hp_colour[ix], jhp);
+    for(k=0; k<12; k++) {
+      s[_GSI(ix)+2*k  ] = keep && comp[k] ? sign * eta[_GSI(ix)+2*k  ] : 0.;
+      s[_GSI(ix)+2*k+1] = keep && comp[k] ? sign * eta[_GSI(ix)+2*k+1] : 0.;
+    }
+  }
+}
+
+/********************
+ * one stochastic sample through all partitions
+ * - solve(xi, phi, kwork) as invert_Qtm, using
+ *   g_spinor_field[kwork], ...
+ * - contract(src, sol, data) gets both fields with halo
+ * - eta, src, phi: VOLUMEPLUSRAND spinor fields
+ ********************/
+int dilution_run(dilution_scheme *d, int sample, dilution_solver solve, int kwork,
+    dilution_contraction contract, void *data, double *eta, double *src, double *phi) {
+  return( dilution_run_partitions(d, sample, 0, d->npart, solve, kwork, contract, data, eta, src, phi) );
+}
+
+/********************
+ * partitions ipart_start, ..., ipart_end-1 only; the noise of
+ * the sample is regenerated, so further partitions (e.g. the
+ * next probing level) can be added in a later call
+ ********************/
+int dilution_run_partitions(dilution_scheme *d, int sample, int ipart_start, int ipart_end, dilution_solver solve, int kwork,
+    dilution_contraction contract, void *data, double *eta, double *src, double *phi) {
+
+  int ipart, niter, status;
+
+  if(ipart_start < 0 || ipart_end > d->npart) {
+    if(g_cart_id==0) fprintf(stderr, "[dilution_run_partitions] Error, partitions %d to %d out of range\n", ipart_start, ipart_end);
+    return(3);
+  }
+
+  status = ranphilox_spinor_field(&eta, 1, sample, g_noise_type, -1, g_seed, Nconf);
+  if(status != 0) return(status);
+
+  for(ipart=ipart_start; ipart<ipart_end; ipart++) {
+    dilution_project(src, eta, d, ipart);
+    xchange_field(src);
+
+    memset(phi, 0, _GSI(VOLUMEPLUSRAND)*sizeof(double));
+    niter = solve(phi, src, kwork);
+    if(niter < 0) {
+      if(g_cart_id==0) fprintf(stderr, "[dilution_run_partitions] Error, solver returned %d for sample %d, partition %d\n", niter, sample, ipart);
+      return(2);
+    }
+    xchange_field(phi);
+
+    if( (status = contract(src, phi, data)) != 0 ) return(status);
+  }
+  return(0);
+}
+
+/********************
+ * local loops
+ *   loop[_GWI(g,ix,VOLUME)] += eta(x)^+ gamma_g phi(x), g = 0,...,15
+ ********************/
+int dilution_contract_local(double *eta, double *phi, void *data) {
+
+  int ix, g;
+  double *loop = (double*)data;
+  double spinor1[24];
+  complex w;
+
+#ifdef OPENMP
+#pragma omp parallel for private(g, spinor1, w)
+#endif
+  for(ix=0; ix<VOLUME; ix++) {
+    for(g=0; g<16; g++) {
+      _fv_eq_gamma_ti_fv(spinor1, g, phi+_GSI(ix));
+      _co_eq_fv_dag_ti_fv(&w, eta+_GSI(ix), spinor1);
+      loop[_GWI(g,ix,VOLUME)  ] += w.re;
+      loop[_GWI(g,ix,VOLUME)+1] += w.im;
+    }
+  }
+  return(0);
+}
+
+/********************
+ * conserved vector current loop as in avc_disc_stochastic.c
+ *   disc[_GWI(mu,ix,VOLUME)] -= 1/2 eta(x)^+ (1-gamma_mu) U_mu(x) phi(x+mu)
+ *                             + 1/2 eta(x+mu)^+ (1+gamma_mu) U_mu(x)^+ phi(x)
+ ********************/
+int dilution_contract_cvc(double *eta, double *phi, void *data) {
+
+  int ix, mu;
+  double *disc = (double*)data;
+  double spinor1[24], spinor2[24], U_[18];
+  complex w;
+
+#ifdef OPENMP
+#pragma omp parallel for private(mu, spinor1, spinor2, U_, w)
+#endif
+  for(ix=0; ix<VOLUME; ix++) {
+    for(mu=0; mu<4; mu++) {
+      _cm_eq_cm_ti_co(U_, &g_gauge_field[_GGI(ix, mu)], &co_phase_up[mu]);
+
+      _fv_eq_cm_ti_fv(spinor1, U_, phi+_GSI(g_iup[ix][mu]));
+      _fv_eq_gamma_ti_fv(spinor2, mu, spinor1);
+      _fv_mi_eq_fv(spinor2, spinor1);
+      _co_eq_fv_dag_ti_fv(&w, eta+_GSI(ix), spinor2);
+      disc[_GWI(mu,ix,VOLUME)  ] -= 0.5 * w.re;
+      disc[_GWI(mu,ix,VOLUME)+1] -= 0.5 * w.im;
+
+      _fv_eq_cm_dag_ti_fv(spinor1, U_, phi+_GSI(ix));
+      _fv_eq_gamma_ti_fv(spinor2, mu, spinor1);
+      _fv_pl_eq_fv(spinor2, spinor1);
+      _co_eq_fv_dag_ti_fv(&w, eta+_GSI(g_iup[ix][mu]), spinor2);
+      disc[_GWI(mu,ix,VOLUME)  ] -= 0.5 * w.re;
+      disc[_GWI(mu,ix,VOLUME)+1] -= 0.5 * w.im;
+    }
+  }
+  return(0);
+}
@@ -0,0 +1,52 @@
+/********************
+ * dilution.h
+ *
+ * in-memory dilution engine for stochastic loops:
+ * noise -> diluted source -> solve -> contract,
+ * accumulated on the fly without intermediate files
+ ********************/
+#ifndef _DILUTION_H
+#define _DILUTION_H
+
+#define _DILUTION_TIME  1
+#define _DILUTION_SPIN  2
+#define _DILUTION_COLOR 4
+
+/********************
+ * partition ipart = ( ( it * nx + ix ) * ns + is ) * nc + ic
+ * - it: global timeslice (nt = T_global with time dilution, else 1)
+ * - ix: spatial colour from init_multigrid_decompositon of degree
+ *   space_degree (1 = even/odd, 0 = no space dilution)
+ * - is, ic: spin and colour (ns = 4, nc = 3 if diluted, else 1)
+ * with hierarchical probing the partitions are repeated for each
+ * probing vector j = 0, ..., nhp-1,
+ *   ipart = j * ( nt * nx * ns * nc ) + ( partition as above )
+ * the first N_l vectors are the probing vectors of level l, so
+ * an estimate from the first N_l vectors is normalized by 1/N_l
+ ********************/
+typedef struct {
+  int flags;
+  int space_degree;
+  int nt, nx, ns, nc;
+  int npart;
+  int *lexic2sub, **sub2lexic, *insub;
+  int probing_degree, nhp;
+  int *hp_colour;
+} dilution_scheme;
+
+typedef int (*dilution_solver)(double *xi, double *phi, int kwork);
+typedef int (*dilution_contraction)(double *eta, double *phi, void *data);
+
+int init_dilution_scheme(dilution_scheme *d, int flags, int space_degree);
+void fini_dilution_scheme(dilution_scheme *d);
+int hierarchical_probing_ncolour(int degree);
+int init_dilution_probing(dilution_scheme *d, int degree);
+void dilution_project(double *s, double *eta, dilution_scheme *d, int ipart);
+int dilution_run(dilution_scheme *d, int sample, dilution_solver solve, int kwork,
+    dilution_contraction contract, void *data, double *eta, double *src, double *phi);
+int dilution_run_partitions(dilution_scheme *d, int sample, int ipart_start, int ipart_end, dilution_solver solve, int kwork,
+    dilution_contraction contract, void *data, double *eta, double *src, double *phi);
+
+int dilution_contract_local(double *eta, double *phi, void *data);
+int dilution_contract_cvc(double *eta, double *phi, void *data);
+#endif
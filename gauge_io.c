@@ -29,6 +29,7 @@
 #include"propagator_io.h"
 #include"gauge_io.h"
 #include "cvc_utils.h"
+#include "io_mpiio.h"
 
 #define MAXBUF 1048576
 
@@ -185,6 +186,59 @@ int write_binary_gauge_data(LimeWriter * limewriter,
 }
 
 
+#ifdef MPI
+/***********************************************************************
+ * write_binary_gauge_data_mpiio
+ *
+ * ILDG site order and mu-order x,y,z,t; byte swap, precision and
+ * checksum into a block in file order, collective write at offset
+ * (io_mpiio.c)
+ ***********************************************************************/
+static int write_binary_gauge_data_mpiio(char * filename, MPI_Offset offset, const int prec, DML_Checksum * ans) {
+
+  int t, x, y, z, status;
+  unsigned int iy, ix;
+  size_t site_bytes = 72 * (prec == 32 ? sizeof(float) : sizeof(double));
+  double tmp3[72];
+  char *buffer = NULL, *site;
+  DML_SiteRank rank;
+  int words_bigendian = big_endian();
+
+  DML_checksum_init(ans);
+  if( (buffer = (char*)malloc(VOLUME*site_bytes)) == NULL ) {
+    fprintf(stderr, "[write_binary_gauge_data_mpiio] Error, could not allocate buffer\n");
+    return(1);
+  }
+
+  for(iy = 0; iy < VOLUME; iy++) {
+    t = iy / (LZ*LY*LX);
+    z = (iy % (LZ*LY*LX)) / (LY*LX);
+    y = (iy % (LY*LX)) / LX;
+    x = iy % LX;
+    ix = g_ipt[t][x][y][z];
+    memcpy(tmp3   , g_gauge_field + _GGI(ix,1), 18*sizeof(double));
+    memcpy(tmp3+18, g_gauge_field + _GGI(ix,2), 18*sizeof(double));
+    memcpy(tmp3+36, g_gauge_field + _GGI(ix,3), 18*sizeof(double));
+    memcpy(tmp3+54, g_gauge_field + _GGI(ix,0), 18*sizeof(double));
+    site = buffer + iy * site_bytes;
+    if(!words_bigendian) {
+      if(prec == 32) byte_swap_assign_double2single((float*)site, tmp3, 72);
+      else           byte_swap_assign(site, tmp3, 72);
+    } else {
+      if(prec == 32) double2single((float*)site, tmp3, 72);
+      else           memcpy(site, tmp3, site_bytes);
+    }
+    rank = (DML_SiteRank) ((((Tstart+t)*LZ_global + LZstart + z)*LY_global + LYstart + y)*(DML_SiteRank)LX_global + LXstart + x);
+    DML_checksum_accum(ans, rank, site, site_bytes);
+  }
+
+  status = mpiio_write_lattice(buffer, filename, offset, _MPIIO_TZYX, site_bytes);
+  free(buffer);
+  DML_checksum_combine(ans);
+  return(status);
+}
+#endif
+
 int write_lime_gauge_field(char * filename, const double plaq, const int counter, const int prec) {
   FILE * ofs = NULL;
   LimeWriter * limewriter = NULL;
@@ -193,6 +247,9 @@ int write_lime_gauge_field(char * filename, const double plaq, const int counter
   int ME_flag=0, MB_flag=0, status=0;
   n_uint64_t bytes;
   DML_Checksum checksum;
+#ifdef MPI
+  MPI_Offset offset;
+#endif
 
   write_xlf_info(plaq, counter, filename, 0, (char*)NULL);
 
@@ -217,7 +274,7 @@ int write_lime_gauge_field(char * filename, const double plaq, const int counter
     }
     write_ildg_format_xml("temp.xml", limewriter, prec); 
 
-    bytes = ((n_uint64_t)LX)*((n_uint64_t)LY)*((n_uint64_t)LZ)*((n_uint64_t)T_global)*((n_uint64_t)72*sizeof(double));
+    bytes = ((n_uint64_t)LX_global)*((n_uint64_t)LY_global)*((n_uint64_t)LZ_global)*((n_uint64_t)T_global)*((n_uint64_t)72*sizeof(double));
     if(prec == 32) bytes = bytes/((n_uint64_t)2);
     MB_flag=0; ME_flag=0;
     limeheader = limeCreateHeader(MB_flag, ME_flag, "ildg-binary-data", bytes);
@@ -233,6 +290,25 @@ int write_lime_gauge_field(char * filename, const double plaq, const int counter
     limeDestroyHeader( limeheader );
   }
 
+#ifdef MPI
+  /* header by process 0, data collectively behind it */
+  if(g_cart_id == 0) {
+    offset = (MPI_Offset)ftello(ofs);
+    limeDestroyWriter( limewriter );
+    fflush(ofs);
+    fclose(ofs);
+  }
+  MPI_Bcast(&offset, 1, MPI_OFFSET, 0, g_cart_grid);
+  status = write_binary_gauge_data_mpiio(filename, offset, prec, &checksum);
+  if(status != 0) {
+    fprintf(stderr, "Error while writing to file %s\n", filename);
+    return(status);
+  }
+  if(g_proc_id == 0) {
+    printf("# checksum for Gauge field written to file %s is %#x %#x\n",
+	   filename, checksum.suma, checksum.sumb);
+  }
+#else
   write_binary_gauge_data(limewriter, prec, &checksum);
   if(g_proc_id == 0) {
     printf("# checksum for Gauge field written to file %s is %#x %#x\n",
@@ -244,6 +320,7 @@ int write_lime_gauge_field(char * filename, const double plaq, const int counter
     fflush(ofs);
     fclose(ofs);
   }
+#endif
   write_checksum(filename, &checksum);
 
   return(0);
@@ -269,9 +346,9 @@ int write_ildg_format_xml(char *filename, LimeWriter * limewriter, const int pre
   fprintf(ofs, "  <version> 1.0 </version>\n");
   fprintf(ofs, "  <field> su3gauge </field>\n");
   fprintf(ofs, "  <precision> %d </precision>\n", prec);
-  fprintf(ofs, "  <lx> %d </lx>\n", LX);
-  fprintf(ofs, "  <ly> %d </ly>\n", LY);
-  fprintf(ofs, "  <lz> %d </lz>\n", LZ);
+  fprintf(ofs, "  <lx> %d </lx>\n", LX_global);
+  fprintf(ofs, "  <ly> %d </ly>\n", LY_global);
+  fprintf(ofs, "  <lz> %d </lz>\n", LZ_global);
   fprintf(ofs, "  <lt> %d </lt>\n", T_global);
   fprintf(ofs, "</ildgFormat>");
   fclose( ofs );
@@ -419,9 +496,6 @@ n_uint64_t file_size(FILE *fp)
 }
 
 int read_nersc_gauge_field(double*s, char*filename, double *plaq) {
-#if (defined PARALLELTX) || (defined PARALLELTXY) 
-  EXIT_WITH_MSG(1, "[read_nersc_gauge_field] >1-dim. parallel version not yet implemented\n");
-#endif
 /*
   this is the NERSC header format:
   BEGIN_HEADER
@@ -456,7 +530,6 @@ int read_nersc_gauge_field(double*s, char*filename, double *plaq) {
   int length;
   float *ftmp=NULL;
   FILE *ifs=NULL;
-  size_t iread;
   uint64_t bytes;
   uint32_t checksum, *iptr, utmp, cks;
   int words_bigendian = big_endian();
@@ -464,6 +537,9 @@ int read_nersc_gauge_field(double*s, char*filename, double *plaq) {
   double u[12], U_[18];
 #ifdef MPI
   int ibuf;
+  MPI_Offset offset;
+#else
+  size_t iread;
 #endif
 
   ifs = fopen(filename, "r");
@@ -497,7 +573,7 @@ int read_nersc_gauge_field(double*s, char*filename, double *plaq) {
     else if(strcmp(item, "DIMENSION_3") == 0) { l3 = atoi(value); }
     else if(strcmp(item, "DIMENSION_4") == 0) { l4 = atoi(value); }
     else if(strcmp(item, "PLAQUETTE")   == 0) { sscanf(line, "%s = %lf", item, plaq); }
-    else if(strcmp(item, "CHECKSUM")    == 0) { sscanf(line, "%s = %lx", value, &cks); }
+    else if(strcmp(item, "CHECKSUM")    == 0) { sscanf(line, "%s = %x", value, &cks); }
   }
 
   if(!end_flag) { EXIT_WITH_MSG(4, "[read_nersc_gauge_field] Error, could not reach end of header\n"); }
@@ -506,22 +582,26 @@ int read_nersc_gauge_field(double*s, char*filename, double *plaq) {
   
   if(g_cart_id==0) fprintf(stdout, "# [read_nersc_gauge_field] l1=%d, l2=%d, l3=%d, l4=%d\n",l1, l2, l3, l4);
 
-//  lvol = l1 * l2 * l3 * l4;
-  lvol = l1 * l2 * l3 * T;
-
-  if(lvol==0) { EXIT_WITH_MSG(5, "[read_nersc_gauge_field] Error, zero volume\n"); }
+  if(l1 != LX_global || l2 != LY_global || l3 != LZ_global) {
+    EXIT_WITH_MSG(5, "[read_nersc_gauge_field] Error, spatial lattice size in file does not match\n");
+  }
+  lvol = VOLUME;
  
   ftmp = (float*)malloc(lvol*48*sizeof(float));
   if(ftmp == NULL) { EXIT_WITH_MSG(6, "[read_nersc_gauge_field] Error, could not alloc ftmp\n"); }
 
 #ifdef MPI
-  bytes = l1*l2*l3*g_proc_coords[0]*T*48*sizeof(float);
-  fseek(ifs,bytes, SEEK_CUR);
-#endif
-
+  /* binary data start after the header, local sub-lattice collectively */
+  offset = (MPI_Offset)ftello(ifs);
+  fclose(ifs);
+  if(mpiio_read_lattice(ftmp, filename, offset, _MPIIO_TZYX, 48*sizeof(float)) != 0) {
+    EXIT_WITH_MSG(7, "[read_nersc_gauge_field] Error, could not read proper amount of data\n");
+  }
+#else
   iread = fread(ftmp, sizeof(float), 48*lvol, ifs);
   if(iread != 48*lvol) { EXIT_WITH_MSG(7, "[read_nersc_gauge_field] Error, could not read proper amount of data\n"); }
   fclose(ifs);
+#endif
 
   if(!words_bigendian) {
     byte_swap(ftmp, 48*lvol);
@@ -540,7 +620,7 @@ int read_nersc_gauge_field(double*s, char*filename, double *plaq) {
   MPI_Allreduce(&checksum, &ibuf, 1, MPI_INT, MPI_SUM, g_cart_grid);
   checksum = ibuf;
 #endif
-  fprintf(stdout, "# [] checksum: read  %#lx; calculated %#lx\n", cks, checksum);
+  fprintf(stdout, "# [] checksum: read  %#x; calculated %#x\n", cks, checksum);
   if(cks != checksum) { EXIT_WITH_MSG(8, "[] Error, checksums do not match\n"); }
 
   nu[0] = 1;
@@ -552,9 +632,9 @@ int read_nersc_gauge_field(double*s, char*filename, double *plaq) {
   //   with mu=0,1,2,3; u=0,1; c=0,1,2, r=0,1
   iy = 0;
   for(x4=0; x4<T; x4++) {  // t
-  for(x3=0; x3<l3; x3++) {  // z
-  for(x2=0; x2<l2; x2++) {  // y
-  for(x1=0; x1<l1; x1++) {  // x
+  for(x3=0; x3<LZ; x3++) {  // z
+  for(x2=0; x2<LY; x2++) {  // y
+  for(x1=0; x1<LX; x1++) {  // x
     ix = g_ipt[x4][x1][x2][x3];
     for(mu=0;mu<4;mu++) {
       idx = 48*iy + 12*mu;
@@ -675,7 +755,7 @@ int read_nersc_gauge_field_timeslice(double*s, char*filename, int timeslice, uin
     else if(strcmp(item, "DIMENSION_3") == 0) { l3 = atoi(value); }
     else if(strcmp(item, "DIMENSION_4") == 0) { l4 = atoi(value); }
     else if(strcmp(item, "PLAQUETTE")   == 0) { sscanf(line, "%s = %lf", item, &plaq); }
-    else if(strcmp(item, "CHECKSUM")    == 0) { sscanf(line, "%s = %lx", value, &cks); }
+    else if(strcmp(item, "CHECKSUM")    == 0) { sscanf(line, "%s = %x", value, &cks); }
   }
 
   if(!end_flag) {
@@ -729,7 +809,7 @@ int read_nersc_gauge_field_timeslice(double*s, char*filename, int timeslice, uin
   }
 
   if(timeslice==T_global-1) {
-    fprintf(stdout, "# [] checksum: read  %#lx; calculated %#lx\n", cks, *checksum);
+    fprintf(stdout, "# [] checksum: read  %#x; calculated %#x\n", cks, *checksum);
     if(cks != *checksum) {
       fprintf(stderr, "[] Warning, checksums do not match\n");
       return_value = 8;
@@ -935,9 +1015,6 @@ int read_nersc_gauge_binary_data_3col(FILE*ifs, double*s, DML_Checksum*ans) {
 
 
 int read_nersc_gauge_field_3x3(double*s, char*filename, double *plaq) {
-#if (defined PARALLELTX) || (defined PARALLELTXY)
-  EXIT_WITH_MSG(1, "\n[read_nersc_gauge_field_3x3] Error, 2- and 3-dim. parallel versions not yet implemented; exit\n");
-#endif
 /*
   this is the NERSC header format:
   BEGIN_HEADER
@@ -972,7 +1049,6 @@ int read_nersc_gauge_field_3x3(double*s, char*filename, double *plaq) {
   int length;
   double *ftmp=NULL;
   FILE *ifs=NULL;
-  size_t iread;
   uint64_t bytes;
   uint32_t checksum, *iptr, utmp, cks;
   int words_bigendian = big_endian();
@@ -980,7 +1056,9 @@ int read_nersc_gauge_field_3x3(double*s, char*filename, double *plaq) {
   double u[12], U_[18];
 #ifdef MPI
   int ibuf;
-  long int offset;
+  MPI_Offset offset;
+#else
+  size_t iread;
 #endif
 
   ifs = fopen(filename, "r");
@@ -1017,7 +1095,7 @@ int read_nersc_gauge_field_3x3(double*s, char*filename, double *plaq) {
     else if(strcmp(item, "DIMENSION_3") == 0) { l3 = atoi(value); }
     else if(strcmp(item, "DIMENSION_4") == 0) { l4 = atoi(value); }
     else if(strcmp(item, "PLAQUETTE")   == 0) { sscanf(line, "%s = %lf", item, plaq); }
-    else if(strcmp(item, "CHECKSUM")    == 0) { sscanf(line, "%s = %lx", value, &cks); }
+    else if(strcmp(item, "CHECKSUM")    == 0) { sscanf(line, "%s = %x", value, &cks); }
   }
 
   if(!end_flag) {
@@ -1029,13 +1107,11 @@ int read_nersc_gauge_field_3x3(double*s, char*filename, double *plaq) {
   
   if(g_cart_id==0) fprintf(stdout, "# [] l1=%d, l2=%d, l3=%d, l4=%d\n",l1, l2, l3, l4);
 
-//  lvol = l1 * l2 * l3 * l4;
-  lvol = l1 * l2 * l3 * T;
-
-  if(lvol==0) {
-    if(g_cart_id==0) fprintf(stderr, "[] Error, zero volume\n");
+  if(l1 != LX_global || l2 != LY_global || l3 != LZ_global) {
+    if(g_cart_id==0) fprintf(stderr, "[] Error, spatial lattice size in file does not match\n");
     EXIT(5);
   }
+  lvol = VOLUME;
  
   ftmp = (double*)malloc(lvol*72*sizeof(double));
   if(ftmp == NULL) {
@@ -1043,18 +1119,21 @@ int read_nersc_gauge_field_3x3(double*s, char*filename, double *plaq) {
     EXIT(6);
   }
 #ifdef MPI
-    offset = 72*(long int)l1*l2*l3*g_proc_coords[0]*T*sizeof(double);
-    //fprintf(stdout, "# [%d] offset = %ld\n", g_cart_id, offset);
-    if(fseek(ifs, offset, SEEK_CUR) != 0) {
-      EXIT(10);
-    }
-#endif
+  /* binary data start after the header, local sub-lattice collectively */
+  offset = (MPI_Offset)ftello(ifs);
+  fclose(ifs);
+  if(mpiio_read_lattice(ftmp, filename, offset, _MPIIO_TZYX, 72*sizeof(double)) != 0) {
+    if(g_cart_id==0) fprintf(stderr, "[] Error, could not read proper amount of data\n");
+    EXIT(7);
+  }
+#else
   iread = fread(ftmp, sizeof(double), 72*lvol, ifs);
   if(iread != 72*lvol) {
     if(g_cart_id==0) fprintf(stderr, "[] Error, could not read proper amount of data\n");
     EXIT(7);
   }
   fclose(ifs);
+#endif
 
   if(!words_bigendian) {
     // fprintf(stdout, "# [] performing byte swap\n");
@@ -1075,7 +1154,7 @@ int read_nersc_gauge_field_3x3(double*s, char*filename, double *plaq) {
     MPI_Allreduce(&checksum, &ibuf, 1, MPI_INT, MPI_SUM, g_cart_grid);
     checksum = ibuf;
 #endif
-  if(g_cart_id==0) fprintf(stdout, "# [] checksum: read  %#lx; calculated %#lx\n", cks, checksum);
+  if(g_cart_id==0) fprintf(stdout, "# [] checksum: read  %#x; calculated %#x\n", cks, checksum);
 
   if(cks != checksum) {
     if(g_cart_id==0) fprintf(stderr, "[] Error, checksums do not match\n");
@@ -1091,9 +1170,9 @@ int read_nersc_gauge_field_3x3(double*s, char*filename, double *plaq) {
   //   with mu=0,1,2,3; u=0,1,2; c=0,1,2, r=0,1
   iy = 0;
   for(x4=0; x4<T; x4++) {  // t
-  for(x3=0; x3<l3; x3++) {  // z
-  for(x2=0; x2<l2; x2++) {  // y
-  for(x1=0; x1<l1; x1++) {  // x
+  for(x3=0; x3<LZ; x3++) {  // z
+  for(x2=0; x2<LY; x2++) {  // y
+  for(x1=0; x1<LX; x1++) {  // x
     ix = g_ipt[x4][x1][x2][x3];
     for(mu=0;mu<4;mu++) {
       idx = 72*iy + 18*mu;
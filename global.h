@@ -15,6 +15,14 @@
 #define _WILSON_FERMION    1
 #define _DW_WILSON_FERMION 2
 
+#define _DEFAULT_INVERTER      0
+#define _PIPELINED_CG_INVERTER 1
+#define _DEFLATED_CG_INVERTER  2
+#define _EO_CG_INVERTER        3
+#define _SIMD_BICGSTAB_INVERTER 4
+#define _MIXED_BICGSTAB_INVERTER 5
+#define _BLOCK_BICGSTAB_INVERTER 6
+
 #ifdef MPI
 #define EXIT(_i) { MPI_Abort(MPI_COMM_WORLD, (_i)); MPI_Finalize(); exit((_i)); }
 #else
@@ -82,12 +90,13 @@ EXTERN int ** g_iup, **g_iup_5d;
 EXTERN int ** g_idn, **g_idn_5d;
 EXTERN int *g_lexic2eo, *g_eo2lexic, *g_iseven, *g_isevent, *g_lexic2eot, *g_eot2lexic;
 EXTERN int *g_lexic2eo_5d, *g_eo2lexic_5d, *g_iseven_5d, *g_isevent_5d, *g_lexic2eot_5d, *g_eot2lexic_5d;
+EXTERN int *g_interior2lexic, *g_boundary2lexic, g_interior_volume, g_boundary_volume;
 
 EXTERN double **g_spinor_field;
 
 EXTERN double *g_gauge_field;
 
-EXTERN double g_kappa, g_mu, g_musigma, g_mudelta, g_mubar, g_epsbar, g_m5, g_m0, g_kappa5d;
+EXTERN double g_kappa, g_mu, g_musigma, g_mudelta, g_mubar, g_epsbar, g_m5, g_m0, g_kappa5d, g_b5, g_c5;
 
 EXTERN int g_proc_id, g_nproc;
 EXTERN int g_cart_id;
@@ -109,6 +118,7 @@ EXTERN int g_nb_z_up, g_nb_z_dn;
 EXTERN int g_ts_nb_up, g_ts_nb_dn;
 EXTERN int g_ts_nb_x_up, g_ts_nb_x_dn;
 EXTERN int g_ts_nb_y_up, g_ts_nb_y_dn;
+EXTERN int g_ts_nb_z_up, g_ts_nb_z_dn;
 
 EXTERN int g_nproc_t, g_nproc_x, g_nproc_y, g_nproc_z;
 
@@ -147,6 +157,7 @@ EXTERN double g_prop_normsqr;
 EXTERN double g_qhatsqr_min, g_qhatsqr_max;
 
 EXTERN int Nlong, N_ape, N_Jacobi;
+EXTERN int g_ape_cache;
 EXTERN double alpha_ape, kappa_Jacobi;
 EXTERN int g_source_timeslice, g_no_extra_masses, g_no_light_masses, g_no_strange_masses;
 
@@ -164,7 +175,7 @@ EXTERN int g_gauge_file_format;
 EXTERN char g_rng_filename[100];
 EXTERN int g_source_index[2];
 EXTERN int g_propagator_bc_type, g_propagator_gamma_basis;
-EXTERN int g_propagator_precision;
+EXTERN int g_propagator_precision, g_propagator_codec;
 EXTERN int g_write_source, g_read_source;
 EXTERN int g_nsample;
 EXTERN int g_sv_dim, g_cv_dim, g_fv_dim, g_cm_dim, g_fp_dim;
@@ -179,6 +190,9 @@ EXTERN int g_source_proc_id;
 EXTERN int g_cpu_prec, g_gpu_prec, g_gpu_prec_sloppy;
 EXTERN int g_inverter_type;
 EXTERN char g_inverter_type_name[200];
+EXTERN int g_deflation_nev, g_deflation_krylov;
+EXTERN double g_deflation_precision;
+EXTERN char g_deflation_filename_prefix[200];
 EXTERN int g_space_dilution_depth;
 EXTERN int g_mms_id;
 EXTERN int g_check_inversion;
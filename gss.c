@@ -210,8 +210,8 @@ int main(int argc, char **argv) {
           }
           break;
         default:
-          usage();
-          break;
+          fprintf(stderr, "[gss] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+          EXIT(1);
       }
 
       /* first part: at source location  */
@@ -248,8 +248,8 @@ int main(int argc, char **argv) {
             }
             break;
           default:
-            usage();
-            break;
+            fprintf(stderr, "[gss] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+            EXIT(1);
         }
     
         index = _GSI(ix);
@@ -269,6 +269,9 @@ int main(int argc, char **argv) {
             case 2:
               ranz2(ran, 24);
               break;
+            default:
+              fprintf(stderr, "[gss] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+              EXIT(1);
           }
           g_spinor_field[0][_GSI(ix)   ] = ran[ 0];
           g_spinor_field[0][_GSI(ix)+ 1] = ran[ 1];
@@ -265,6 +265,9 @@ int main(int argc, char **argv) {
           case 2:
             ranz2(ran, 6);
             break;
+          default:
+            fprintf(stderr, "[gss_color] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+            EXIT(1);
         }
 
 /**************************************************/
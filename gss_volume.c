@@ -13,6 +13,9 @@
  * - noise type
  *   1 Gaussian noise
  *   2 Z2 noise
+ *   3 Z4 noise, 4 U(1) noise (counter-based rng only)
+ * - option -c: counter-based rng keyed on (seed, gid, sid, site),
+ *   no rng state file is read or written
  * DONE:
  * TODO:
  * CHANGES:
@@ -43,6 +46,8 @@
 #include "ranlxd.h"
 #include "smearing_techniques.h"
 #include "fuzz.h"
+#include "ranphilox.h"
+#include "prepare_source.h"
 
 void usage() {
   fprintf(stdout, "Code to prepare stochastic timeslice sources\n");
@@ -60,6 +65,7 @@ int main(int argc, char **argv) {
   int precision = 32;
   int *rng_state=NULL;
   int rng_readin=0;
+  int use_ranphilox=0;
   double alpha_ape=0., kappa_Jacobi = 0.;
   double ran[24];
   double *gauge_field_f = (double*)NULL;
@@ -68,7 +74,7 @@ int main(int argc, char **argv) {
   FILE *ofs;
   DML_Checksum checksum;
 
-  while ((c = getopt(argc, argv, "h?prf:i:a:n:l:K:t:")) != -1) {
+  while ((c = getopt(argc, argv, "h?prcf:i:a:n:l:K:t:")) != -1) {
     switch (c) {
     case 'f':
       strcpy(filename, optarg);
@@ -98,6 +104,9 @@ int main(int argc, char **argv) {
     case 'r':
       rng_readin = 1;
       break;
+    case 'c':
+      use_ranphilox = 1;
+      break;
     case '?':
     default:
       usage();
@@ -150,7 +159,9 @@ int main(int argc, char **argv) {
   }
 
   /* initialize random number generator */
-  if(rng_readin==0) {
+  if(use_ranphilox) {
+    fprintf(stdout, "# using counter-based rng with seed %u\n", g_seed);
+  } else if(rng_readin==0) {
     fprintf(stdout, "# ranldxd: using seed %u and level 2\n", g_seed);
     rlxd_init(2, g_seed);
   } else {
@@ -188,16 +199,30 @@ int main(int argc, char **argv) {
       fprintf(stdout, "# Generating volume sources for gid=%d and sid=%d\n", gid, sid);
       for(x0=0; x0<T_global; x0++) {
 
-        for(ix=0; ix<VOL3; ix++) {
-          switch(g_noise_type) {
-            case 1:
-              rangauss(ran, 24);
-              break;
-            case 2:
-              ranz2(ran, 24);
-              break;
+        if(use_ranphilox) {
+          /* T = 1, the timeslice enters through Tstart;
+           * the sources are keyed on Nconf */
+          Tstart = x0;
+          Nconf  = gid;
+          if(prepare_timeslice_source_batch(g_spinor_field, 1, sid, -1) != 0) {
+            fprintf(stderr, "[gss_volume] Error from prepare_timeslice_source_batch\n");
+            EXIT(2);
+          }
+        } else {
+          for(ix=0; ix<VOL3; ix++) {
+            switch(g_noise_type) {
+              case 1:
+                rangauss(ran, 24);
+                break;
+              case 2:
+                ranz2(ran, 24);
+                break;
+              default:
+                fprintf(stderr, "[gss_volume] Error, noise type %d needs the counter-based rng, option -c\n", g_noise_type);
+                EXIT(1);
+            }
+            _fv_eq_fv(g_spinor_field[0]+_GSI(ix), ran);
           }
-          _fv_eq_fv(g_spinor_field[0]+_GSI(ix), ran);
         }
 
         fprintf(stdout, "# finished generating source\n");
@@ -231,6 +256,8 @@ int main(int argc, char **argv) {
   for(i=0; i<no_fields; i++) free(g_spinor_field[i]);
   free(g_spinor_field);
 
+  if(use_ranphilox) return(0);
+
   c = rlxd_size();
   if( (rng_state = (int*)malloc(c*sizeof(int))) == (int*)NULL ) {
     fprintf(stderr, "Error, could not save the random number generator state\n");
@@ -57,6 +57,7 @@ void usage() {
 int main(int argc, char **argv) {
   
   int c, i, j, k, ll, sl;
+  int exitstatus;
   int count, hidx;
   int filename_set = 0;
   int timeslice, mms1=0, mms2=0, mms2_min=0;
@@ -254,8 +255,13 @@ int main(int argc, char **argv) {
   }
   for(x0=0; x0<T; x0++) {
     memcpy((void*)gauge_field_timeslice, (void*)(g_gauge_field+_GGI(g_ipt[x0][0][0][0],0)), 72*VOL3*sizeof(double));
-    for(i=0; i<N_ape; i++) {
-      APE_Smearing_Step_Timeslice(gauge_field_timeslice, alpha_ape);
+    if(APE_Smearing_Timeslice(gauge_field_timeslice, N_ape, alpha_ape) != 0) {
+      fprintf(stderr, "Error from APE smearing\n");
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 3);
+      MPI_Finalize();
+#endif
+      exit(2);
     }
     if(Nlong > -1) {
       fuzzed_links_Timeslice(gauge_field_f, gauge_field_timeslice, Nlong, x0);
@@ -265,9 +271,18 @@ int main(int argc, char **argv) {
   }
   free(gauge_field_timeslice);
 #else
-  for(i=0; i<N_ape; i++) {
-    APE_Smearing_Step(g_gauge_field, alpha_ape);
-    xchange_gauge_field_timeslice(g_gauge_field);
+  if(g_ape_cache) {
+    exitstatus = APE_Smearing_cached(g_gauge_field, N_ape, alpha_ape, gaugefilename_prefix, Nconf);
+  } else {
+    exitstatus = APE_Smearing(g_gauge_field, N_ape, alpha_ape);
+  }
+  if(exitstatus != 0) {
+    fprintf(stderr, "Error from APE smearing, status was %d\n", exitstatus);
+#ifdef MPI
+    MPI_Abort(MPI_COMM_WORLD, 3);
+    MPI_Finalize();
+#endif
+    exit(2);
   }
 
   alloc_gauge_field(&gauge_field_f, VOLUMEPLUSRAND);
@@ -456,13 +471,7 @@ int main(int argc, char **argv) {
           ll = 1; 
           chi = &g_spinor_field[0];
           psi = &g_spinor_field[n_s*n_c];
-          for(i = 0; i < 2*n_s*n_c; i++) {
-            xchange_field_timeslice(g_spinor_field[i]);
-            for(c=0; c<N_Jacobi; c++) {
-              Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i], work, kappa_Jacobi);
-              xchange_field_timeslice(g_spinor_field[i]);
-            }
-          }
+          Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field, 2*n_s*n_c, N_Jacobi, kappa_Jacobi);
         }
       } else if(j==2) {
         if(Nlong>-1) {
@@ -539,13 +548,7 @@ int main(int argc, char **argv) {
           /* smeared-smeared -> phi[0-3]^dagger.phi[4-7] -> f.pf */
           chi = &g_spinor_field[0];
           psi = &g_spinor_field[n_s*n_c];
-          for(i = 0; i < 2*n_s*n_c; i++) {
-            xchange_field_timeslice(g_spinor_field[i]);
-            for(c=0; c<N_Jacobi; c++) {
-              Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i], work, kappa_Jacobi);
-              xchange_field_timeslice(g_spinor_field[i]);
-            }
-          }
+          Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field, 2*n_s*n_c, N_Jacobi, kappa_Jacobi);
         }
       }
 
@@ -754,13 +757,7 @@ int main(int argc, char **argv) {
             ll = 1; 
             chi = &g_spinor_field[0];
             psi = &g_spinor_field[n_s*n_c];
-            for(i = 0; i < 2*n_s*n_c; i++) {
-              xchange_field_timeslice(g_spinor_field[i]);
-              for(c=0; c<N_Jacobi; c++) {
-                Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i], work, kappa_Jacobi);
-                xchange_field_timeslice(g_spinor_field[i]);
-              }
-            }
+            Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field, 2*n_s*n_c, N_Jacobi, kappa_Jacobi);
           }
         } else if(j==2) {
           if(Nlong>-1) {
@@ -822,13 +819,7 @@ int main(int argc, char **argv) {
             /* smeared-smeared -> phi[0-3]^dagger.phi[4-7] -> f.pf */
             chi = &g_spinor_field[0];
             psi = &g_spinor_field[n_s*n_c];
-            for(i = 0; i < 2*n_s*n_c; i++) {
-              xchange_field_timeslice(g_spinor_field[i]);
-              for(c=0; c<N_Jacobi; c++) {
-                Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i], work, kappa_Jacobi);
-                xchange_field_timeslice(g_spinor_field[i]);
-              }
-            }
+            Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field, 2*n_s*n_c, N_Jacobi, kappa_Jacobi);
           }
         }
 
@@ -1009,12 +1000,8 @@ int main(int argc, char **argv) {
           /* local-smeared */
           for(i = 0; i < n_s*n_c; i++) {
             memcpy((void*)g_spinor_field[i+n_s*n_c], (void*)g_spinor_field[i], 24*VOLUMEPLUSRAND*sizeof(double));
-            xchange_field_timeslice(g_spinor_field[i+n_s*n_c]);
-            for(c=0; c<N_Jacobi; c++) {
-              Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+n_s*n_c], work, kappa_Jacobi);
-              xchange_field_timeslice(g_spinor_field[i+n_s*n_c]);
-            }
           }
+          Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+n_s*n_c, n_s*n_c, N_Jacobi, kappa_Jacobi);
         }
       } else if(j==2) {
         if(Nlong>-1) {
@@ -1058,12 +1045,8 @@ int main(int argc, char **argv) {
           /* smeared-smeared -> phi[0-3]^dagger.phi[4-7] -> f.pf */
           for(i = 0; i < n_s*n_c; i++) {
             memcpy((void*)g_spinor_field[i+3*n_s*n_c], (void*)g_spinor_field[i+2*n_s*n_c], 24*VOLUMEPLUSRAND*sizeof(double));
-            xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c]);
-            for(c=0; c<N_Jacobi; c++) {
-              Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+3*n_s*n_c], work, kappa_Jacobi);
-              xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c]);
-            }
           }
+          Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+3*n_s*n_c, n_s*n_c, N_Jacobi, kappa_Jacobi);
         }
       }
     }  /* of j=0,...,3 for light */
@@ -1111,13 +1094,7 @@ int main(int argc, char **argv) {
             ll = 1; 
             chi = &g_spinor_field[n_s*n_c];
             psi = &g_spinor_field[hidx];
-            for(i = 0; i < n_s*n_c; i++) {
-              xchange_field_timeslice(g_spinor_field[i+hidx]);
-              for(c=0; c<N_Jacobi; c++) {
-                Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+hidx], work, kappa_Jacobi);
-                xchange_field_timeslice(g_spinor_field[i+hidx]);
-              }
-            }
+            Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+hidx, n_s*n_c, N_Jacobi, kappa_Jacobi);
           }
         } else if(j==2) {
           if(Nlong>-1) {
@@ -1156,13 +1133,7 @@ int main(int argc, char **argv) {
             /* smeared-smeared -> phi[0-3]^dagger.phi[4-7] -> f.pf */
             chi = &g_spinor_field[3*n_s*n_c];
             psi = &g_spinor_field[hidx];
-            for(i = 0; i < n_s*n_c; i++) {
-              xchange_field_timeslice(g_spinor_field[i+hidx]);
-              for(c=0; c<N_Jacobi; c++) {
-                Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+hidx], work, kappa_Jacobi);
-                xchange_field_timeslice(g_spinor_field[i+hidx]);
-              }
-            }
+            Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+hidx, n_s*n_c, N_Jacobi, kappa_Jacobi);
           }
         }
 
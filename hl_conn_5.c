@@ -68,6 +68,7 @@ void usage() {
 int main(int argc, char **argv) {
   
   int c, i, j, k, k2, ll, sl, t, j1;
+  int exitstatus;
   int count;
   long unsigned int VOL3;
   int filename_set = 0;
@@ -364,8 +365,13 @@ int main(int argc, char **argv) {
     }
     for(x0=0; x0<T; x0++) {
       memcpy((void*)gauge_field_timeslice, (void*)(g_gauge_field+_GGI(g_ipt[x0][0][0][0],0)), 72*VOL3*sizeof(double));
-      for(i=0; i<N_ape; i++) {
-        APE_Smearing_Step_Timeslice(gauge_field_timeslice, alpha_ape);
+      if(APE_Smearing_Timeslice(gauge_field_timeslice, N_ape, alpha_ape) != 0) {
+        fprintf(stderr, "Error from APE smearing\n");
+#ifdef MPI
+        MPI_Abort(MPI_COMM_WORLD, 3);
+        MPI_Finalize();
+#endif
+        exit(2);
       }
       if(Nlong > -1) {
         fuzzed_links_Timeslice(gauge_field_f, gauge_field_timeslice, Nlong, x0);
@@ -375,9 +381,18 @@ int main(int argc, char **argv) {
     }
     free(gauge_field_timeslice);
 #else
-    for(i=0; i<N_ape; i++) {
-      APE_Smearing_Step(g_gauge_field, alpha_ape);
-      xchange_gauge_field_timeslice(g_gauge_field);
+    if(g_ape_cache) {
+      exitstatus = APE_Smearing_cached(g_gauge_field, N_ape, alpha_ape, gaugefilename_prefix, Nconf);
+    } else {
+      exitstatus = APE_Smearing(g_gauge_field, N_ape, alpha_ape);
+    }
+    if(exitstatus != 0) {
+      fprintf(stderr, "Error from APE smearing, status was %d\n", exitstatus);
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 3);
+      MPI_Finalize();
+#endif
+      exit(2);
     }
 
     alloc_gauge_field(&gauge_field_f, VOLUMEPLUSRAND);
@@ -569,19 +584,13 @@ if(g_local_local || g_local_smeared) {
       }
       if(N_Jacobi>0) {
         memcpy((void*)g_spinor_field[i+n_s*n_c+index_min], (void*)g_spinor_field[i+index_min], 24*VOLUME*sizeof(double));
-        xchange_field_timeslice(g_spinor_field[i+n_s*n_c+index_min]);
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+n_s*n_c+index_min], work, kappa_Jacobi);
-          xchange_field_timeslice(g_spinor_field[i+n_s*n_c+index_min]);
-        }
         memcpy((void*)g_spinor_field[i+3*n_s*n_c+index_min], (void*)g_spinor_field[i+2*n_s*n_c+index_min], 24*VOLUME*sizeof(double));
-        xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c+index_min]);
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+3*n_s*n_c+index_min], work, kappa_Jacobi);
-          xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c+index_min]);
-        }
       }
     }  /* of i=0, ... , n_s*n_c */
+    if(N_Jacobi>0) {
+      Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+n_s*n_c+index_min, n_s*n_c, N_Jacobi, kappa_Jacobi);
+      Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+3*n_s*n_c+index_min, n_s*n_c, N_Jacobi, kappa_Jacobi);
+    }
 #ifdef MPI
     retime = MPI_Wtime();
 #else
@@ -735,19 +744,13 @@ if(g_local_local || g_local_smeared) {
       }
       if(N_Jacobi>0) {
         memcpy((void*)g_spinor_field[i+n_s*n_c+index_min], (void*)g_spinor_field[i+index_min], 24*VOLUME*sizeof(double));
-        xchange_field_timeslice(g_spinor_field[i+n_s*n_c+index_min]);
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+n_s*n_c+index_min], work, kappa_Jacobi);
-          xchange_field_timeslice(g_spinor_field[i+n_s*n_c+index_min]);
-        }
         memcpy((void*)g_spinor_field[i+3*n_s*n_c+index_min], (void*)g_spinor_field[i+2*n_s*n_c+index_min], 24*VOLUME*sizeof(double));
-        xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c+index_min]);
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+3*n_s*n_c+index_min], work, kappa_Jacobi);
-          xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c+index_min]);
-        }
       }
     }  
+    if(N_Jacobi>0) {
+      Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+n_s*n_c+index_min, n_s*n_c, N_Jacobi, kappa_Jacobi);
+      Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+3*n_s*n_c+index_min, n_s*n_c, N_Jacobi, kappa_Jacobi);
+    }
 #ifdef MPI
     retime = MPI_Wtime();
 #else
@@ -1036,19 +1039,13 @@ if(g_smeared_smeared || g_smeared_local) {
       }
       if(N_Jacobi>0) {
         memcpy((void*)g_spinor_field[i+n_s*n_c+index_min], (void*)g_spinor_field[i+index_min], 24*VOLUME*sizeof(double));
-        xchange_field_timeslice(g_spinor_field[i+n_s*n_c+index_min]);
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+n_s*n_c+index_min], work, kappa_Jacobi);
-          xchange_field_timeslice(g_spinor_field[i+n_s*n_c+index_min]);
-        }
         memcpy((void*)g_spinor_field[i+3*n_s*n_c+index_min], (void*)g_spinor_field[i+2*n_s*n_c+index_min], 24*VOLUME*sizeof(double));
-        xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c+index_min]);
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+3*n_s*n_c+index_min], work, kappa_Jacobi);
-          xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c+index_min]);
-        }
       }
     }  /* of i=0, ... , n_s*n_c */
+    if(N_Jacobi>0) {
+      Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+n_s*n_c+index_min, n_s*n_c, N_Jacobi, kappa_Jacobi);
+      Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+3*n_s*n_c+index_min, n_s*n_c, N_Jacobi, kappa_Jacobi);
+    }
 #ifdef MPI
     retime = MPI_Wtime();
 #else
@@ -1231,19 +1228,13 @@ if(g_smeared_smeared || g_smeared_local) {
       }
       if(N_Jacobi>0) {
         memcpy((void*)g_spinor_field[i+n_s*n_c+index_min], (void*)g_spinor_field[i+index_min], 24*VOLUME*sizeof(double));
-        xchange_field_timeslice(g_spinor_field[i+n_s*n_c+index_min]);
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+n_s*n_c+index_min], work, kappa_Jacobi);
-          xchange_field_timeslice(g_spinor_field[i+n_s*n_c+index_min]);
-        }
         memcpy((void*)g_spinor_field[i+3*n_s*n_c+index_min], (void*)g_spinor_field[i+2*n_s*n_c+index_min], 24*VOLUME*sizeof(double));
-        xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c+index_min]);
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(gauge_field_f, g_spinor_field[i+3*n_s*n_c+index_min], work, kappa_Jacobi);
-          xchange_field_timeslice(g_spinor_field[i+3*n_s*n_c+index_min]);
-        }
       }
     }  
+    if(N_Jacobi>0) {
+      Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+n_s*n_c+index_min, n_s*n_c, N_Jacobi, kappa_Jacobi);
+      Jacobi_Smearing_Propagator(gauge_field_f, g_spinor_field+3*n_s*n_c+index_min, n_s*n_c, N_Jacobi, kappa_Jacobi);
+    }
 #ifdef MPI
     retime = MPI_Wtime();
 #else
@@ -239,6 +239,9 @@ int main(int argc, char **argv) {
   ratime = MPI_Wtime();
 #else
   ratime = (double)clock() / CLOCKS_PER_SEC;
+#endif
+#ifdef OPENMP
+#pragma omp parallel for private(mu)
 #endif
   for(ix=0; ix<VOLUME; ix++) {
     for(mu=0; mu<4; mu++) {
@@ -34,6 +34,7 @@
 #include "read_input_parser.h"
 #include "invert_Qtm.h"
 #include "gauge_io.h"
+#include "deflation.h"
 
 void usage() {
   fprintf(stdout, "Code to invert D_tm\n");
@@ -67,6 +68,11 @@ int main(int argc, char **argv) {
   double spinor1[24], spinor2[24], U_[18];
   complex w, w1, *cp1, *cp2, *cp3;
   FILE *ofs;
+  int k, source_timeslice;
+  double *mms_masses=NULL, **mms_fields=NULL;
+  int nsource, block_flag;
+  double **block_xi=NULL, **block_phi=NULL;
+  char *mms_extra_masses_file="cvc.extra_masses.input";
 
 #ifdef MPI
   MPI_Init(&argc, &argv);
@@ -180,11 +186,34 @@ int main(int argc, char **argv) {
   plaquette(&plaq);
   if(g_cart_id==0) fprintf(stdout, "# Measured plaquette value: %25.16e\n", plaq);
 
+  // with the block solver all point sources are solved at once
+  nsource = g_sourceid_step > 0 ? (g_sourceid2 - g_sourceid) / g_sourceid_step + 1 : 0;
+  block_flag = g_inverter_type == _BLOCK_BICGSTAB_INVERTER && g_no_extra_masses == 0 && nsource > 0;
+
   // allocate memory for the spinor fields
-  no_fields = 9;
+  // (with extra masses: source, 3 + number of masses work fields and one solution per mass;
+  //  block solver: 6 work fields, source and solution per point source)
+  if(block_flag) {
+    no_fields = 8*nsource;
+  } else {
+    no_fields = 9 + 2*g_no_extra_masses;
+  }
   g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
   for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOLUMEPLUSRAND);
 
+  // low-mode eigenspace for the deflated solver, reused for all sources
+  if(g_inverter_type == _DEFLATED_CG_INVERTER) {
+    status = init_deflation(_TM_FERMION, 2);
+    if(status < 0) {
+      fprintf(stderr, "[invert] Error from init_deflation, status was %d\n", status);
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 24);
+      MPI_Finalize();
+#endif
+      exit(24);
+    }
+  }
+
 
   // the source locaton
   sl0 = g_source_location/(LX*LY*LZ);
@@ -192,6 +221,7 @@ int main(int argc, char **argv) {
   sl2 = ( g_source_location%(LY*LZ) ) / (LZ);
   sl3 = g_source_location%LZ;
   if(g_cart_id==0) fprintf(stdout, "# global sl = (%d, %d, %d, %d)\n", sl0, sl1, sl2, sl3);
+  source_timeslice = sl0;
   have_source_flag = sl0-Tstart>=0 && sl0-Tstart<T;
   sl0 -= Tstart;
   fprintf(stdout, "# [%d] have source: %d\n", g_cart_id, have_source_flag);
@@ -206,10 +236,102 @@ int main(int argc, char **argv) {
   //plaquette(&plaq);
   //if(g_cart_id==0) fprintf(stdout, "# Measured plaquette value after write/reread: %25.16e\n", plaq);
 
+  /*********************************************
+   * read the extra masses for mms
+   * - mass[0] is g_mu
+   *********************************************/
+  if( (mms_masses = (double*)calloc(g_no_extra_masses+1, sizeof(double))) == NULL ) {
+    fprintf(stderr, "Error, could allocate mms_masses\n");
+#ifdef MPI
+    MPI_Abort(MPI_COMM_WORLD, 7);
+    MPI_Finalize();
+#endif
+    exit(6);
+  }
+  mms_masses[0] = g_mu;
+  if(g_no_extra_masses>0) {
+    if( (ofs=fopen(mms_extra_masses_file, "r"))==NULL ) {
+      fprintf(stderr, "Error, could not open file %s for reading\n", mms_extra_masses_file);
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 8);
+      MPI_Finalize();
+#endif
+      exit(7);
+    }
+    for(i=0; i<g_no_extra_masses; i++) {
+      if(fscanf(ofs, "%lf", mms_masses+i+1) != 1) {
+        fprintf(stderr, "Error, could not read extra mass no. %d from file %s\n", i, mms_extra_masses_file);
+#ifdef MPI
+        MPI_Abort(MPI_COMM_WORLD, 8);
+        MPI_Finalize();
+#endif
+        exit(7);
+      }
+    }
+    fclose(ofs);
+    if(g_cart_id==0) {
+      fprintf(stdout, "# mms masses:\n");
+      for(i=0; i<=g_no_extra_masses; i++) fprintf(stdout, "# mass[%2d] = %e\n", i, mms_masses[i]);
+    }
+    mms_fields = (double**)calloc(g_no_extra_masses+1, sizeof(double*));
+    for(k=0; k<=g_no_extra_masses; k++) mms_fields[k] = g_spinor_field[6+g_no_extra_masses+k];
+  }
+
+  /***********************************************
+   * block solver for all point sources, the
+   * solutions are written as in the loop below
+   ***********************************************/
+  if(block_flag) {
+    block_phi = (double**)malloc(2*nsource*sizeof(double*));
+    block_xi  = block_phi + nsource;
+    for(k=0; k<nsource; k++) {
+      i = g_sourceid + k*g_sourceid_step;
+      block_phi[k] = g_spinor_field[6*nsource+k];
+      block_xi[k]  = g_spinor_field[7*nsource+k];
+      memset(block_phi[k], 0, VOLUMEPLUSRAND*24*sizeof(double));
+      memset(block_xi[k], 0, VOLUMEPLUSRAND*24*sizeof(double));
+      if(have_source_flag) {
+        ix = g_ipt[sl0][sl1][sl2][sl3];
+        block_phi[k][_GSI(ix)+2*i] = 1.;
+        block_xi[k][_GSI(ix)+2*i]  = 1.;
+      }
+      xchange_field(block_phi[k]);
+    }
+
+    status = invert_Qtm_block(block_xi, block_phi, nsource, 0);
+    if(status < 0) {
+      fprintf(stderr, "[invert] Error from invert_Qtm_block, status was %d\n", status);
+    }
+
+    for(k=0; k<nsource; k++) {
+      i = g_sourceid + k*g_sourceid_step;
+      xchange_field(block_xi[k]);
+      Q_phi_tbc(g_spinor_field[0], block_xi[k]);
+      for(ix=0; ix<VOLUME; ix++) {
+        _fv_eq_fv_mi_fv(g_spinor_field[1]+_GSI(ix), g_spinor_field[0]+_GSI(ix), block_phi[k]+_GSI(ix));
+      }
+      spinor_scalar_product_re(&norm2, block_phi[k], block_phi[k], VOLUME);
+      spinor_scalar_product_re(&norm, g_spinor_field[1], g_spinor_field[1], VOLUME);
+      if(g_cart_id==0) fprintf(stdout, "# [invert] source %d: absolut residuum squared = %e, relative residuum = %e\n", i, norm, sqrt(norm / norm2));
+
+      sprintf(filename, "%s.%.4d.%.2d.inverted", filename_prefix, Nconf, i);
+      status = write_propagator(block_xi[k], filename, 0, g_propagator_precision);
+      if(status != 0) {
+        fprintf(stderr, "Error from write_propagator, status was %d\n", status);
+#ifdef MPI
+        MPI_Abort(MPI_COMM_WORLD, 22);
+        MPI_Finalize();
+#endif
+        exit(22);
+      }
+    }
+    free(block_phi);
+  }
+
   /***********************************************
    * (1) check the Dirac operator against HMC
    ***********************************************/
-  for(i=g_sourceid; i<=g_sourceid2; i+=g_sourceid_step) {
+  for(i=g_sourceid; !block_flag && i<=g_sourceid2; i+=g_sourceid_step) {
 /*
     sprintf(filename, "source.%.4d.%.2d.inverted", Nconf, i);
     if(g_cart_id==0) fprintf(stdout, "\n\n# Source number %d from file %s\n", i, filename);
@@ -248,6 +370,35 @@ int main(int argc, char **argv) {
     }
     xchange_field(g_spinor_field[0]);
  
+    /***********************************************
+     * multi-mass inversion, write one propagator
+     * per mass
+     ***********************************************/
+    if(g_no_extra_masses>0) {
+      status = invert_Qtm_her_mms(mms_fields, g_spinor_field[0], mms_masses, g_no_extra_masses+1, 2);
+      if(status < 0) {
+        fprintf(stderr, "Error from invert_Qtm_her_mms, status was %d\n", status);
+#ifdef MPI
+        MPI_Abort(MPI_COMM_WORLD, 23);
+        MPI_Finalize();
+#endif
+        exit(23);
+      }
+      for(k=0; k<=g_no_extra_masses; k++) {
+        sprintf(filename, "%s.%.4d.%.2d.%.2d.cgmms.%.2d.inverted", filename_prefix, Nconf, source_timeslice, i, k);
+        if(g_cart_id==0) fprintf(stdout, "# [invert] writing propagator for mass %d to file %s\n", k, filename);
+        status = write_propagator(mms_fields[k], filename, 0, g_propagator_precision);
+        if(status != 0) {
+          fprintf(stderr, "Error from write_propagator, status was %d\n", status);
+#ifdef MPI
+          MPI_Abort(MPI_COMM_WORLD, 22);
+          MPI_Finalize();
+#endif
+          exit(22);
+        }
+      }
+      continue;
+    }
 
     //for(ix=0; ix<VOLUME; ix++) { _fv_eq_zero(g_spinor_field[1]+_GSI(ix)); }
     memset(g_spinor_field[1], 0, VOLUMEPLUSRAND*24*sizeof(double));
@@ -378,6 +529,9 @@ int main(int argc, char **argv) {
   free(g_gauge_field);
   for(i=0; i<no_fields; i++) free(g_spinor_field[i]);
   free(g_spinor_field);
+  free(mms_masses);
+  if(mms_fields != NULL) free(mms_fields);
+  free_deflation();
   free_geometry();
 
   if(g_cart_id==0) {
@@ -23,6 +23,9 @@
 #include "Q_phi.h"
 #include "cvc_utils.h"
 #include "invert_Qtm.h"
+#include "deflation.h"
+#include "Q_mobius_phi.h"
+#include "Q_phi_simd.h"
 
 
 void spinor_scalar_product_co(complex *w, double *xi, double *phi, int V) {
@@ -83,6 +86,104 @@ void spinor_scalar_product_re(double *r, double *xi, double *phi, int V) {
 #endif
 }
 
+/*****************************************************
+ * fused kernels for the BiCGStab iteration
+ * - each update is a single sweep over the fields
+ * - the scalar products needed next are accumulated
+ *   in the same sweep and reduced in one call
+ *****************************************************/
+
+/* s = r - alpha p2 */
+static void bicgstab_update_s(double *s, double *r, double *p2, complex *alpha, int V) {
+
+  int ix, iix;
+  double spinor1[24];
+
+  iix=0;
+  for(ix=0; ix<V; ix++) {
+    _fv_eq_fv_ti_co(spinor1, p2+iix, alpha);
+    _fv_eq_fv_mi_fv(s+iix, r+iix, spinor1);
+    iix+=24;
+  }
+}
+
+/* w = <t, s>, u = <t, t> */
+static void bicgstab_dot_ts(complex *w, double *u, double *t, double *s, int V) {
+
+  int ix, iix;
+  complex p;
+  double buffer[3];
+
+  buffer[0] = 0.; buffer[1] = 0.; buffer[2] = 0.;
+  iix=0;
+  for(ix=0; ix<V; ix++) {
+    _co_eq_fv_dag_ti_fv(&p, t+iix, s+iix);
+    buffer[0] += p.re;
+    buffer[1] += p.im;
+    _co_eq_fv_dag_ti_fv(&p, t+iix, t+iix);
+    buffer[2] += p.re;
+    iix+=24;
+  }
+#ifdef MPI
+  MPI_Allreduce(MPI_IN_PLACE, buffer, 3, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#endif
+  w->re = buffer[0];
+  w->im = buffer[1];
+  *u    = buffer[2];
+}
+
+/* r = s - omega t, x = x + alpha p + omega s,
+ * norm = <r, r>, w = <r0, r> */
+static void bicgstab_update_rx(double *r, double *x, double *s, double *t, double *p, double *r0,
+  complex *alpha, complex *omega, double *norm, complex *w, int V) {
+
+  int ix, iix;
+  complex c;
+  double spinor1[24];
+  double buffer[3];
+
+  buffer[0] = 0.; buffer[1] = 0.; buffer[2] = 0.;
+  iix=0;
+  for(ix=0; ix<V; ix++) {
+    _fv_eq_fv_ti_co(spinor1, t+iix, omega);
+    _fv_eq_fv_mi_fv(r+iix, s+iix, spinor1);
+
+    _fv_eq_fv_ti_co(spinor1, s+iix, omega);
+    _fv_pl_eq_fv(x+iix, spinor1);
+    _fv_eq_fv_ti_co(spinor1, p+iix, alpha);
+    _fv_pl_eq_fv(x+iix, spinor1);
+
+    _co_eq_fv_dag_ti_fv(&c, r+iix, r+iix);
+    buffer[0] += c.re;
+    _co_eq_fv_dag_ti_fv(&c, r0+iix, r+iix);
+    buffer[1] += c.re;
+    buffer[2] += c.im;
+    iix+=24;
+  }
+#ifdef MPI
+  MPI_Allreduce(MPI_IN_PLACE, buffer, 3, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#endif
+  *norm = buffer[0];
+  w->re = buffer[1];
+  w->im = buffer[2];
+}
+
+/* p = r + beta (p - omega p2) */
+static void bicgstab_update_p(double *p, double *r, double *p2, complex *omega, complex *beta, int V) {
+
+  int ix, iix;
+  double spinor1[24], spinor2[24];
+
+  iix=0;
+  for(ix=0; ix<V; ix++) {
+    _fv_eq_fv_ti_co(spinor1, p2+iix, omega);
+    _fv_eq_fv_mi_fv(spinor1, p+iix, spinor1);
+    _fv_eq_fv_ti_co(spinor2, spinor1, beta);
+    _fv_eq_fv_pl_fv(p+iix, r+iix, spinor2);
+    iix+=24;
+  }
+}
+
 int invert_Qtm(double *xi, double *phi, int kwork) {
 
   int ix, niter, iix;
@@ -94,10 +195,12 @@ int invert_Qtm(double *xi, double *phi, int kwork) {
   double *p_ptr  = (double*)NULL;
   double *p2_ptr = (double*)NULL;
   double u, norm, normb;
-  double spinor1[24], spinor2[24];
   complex alpha, beta, omega;
   complex w, w2, w3, r0rn;
 
+  if(g_inverter_type == _SIMD_BICGSTAB_INVERTER) return(invert_Qtm_simd(xi, phi, kwork));
+  if(g_inverter_type == _MIXED_BICGSTAB_INVERTER && g_cpu_prec != 2) return(invert_Qtm_mixed(xi, phi, kwork));
+
   /*************************
    * set the fields
    *************************/
@@ -153,86 +256,41 @@ int invert_Qtm(double *xi, double *phi, int kwork) {
   /* p2 = D p */
   Q_phi_tbc(p2_ptr, p_ptr);
 
+  /* r0rn = <r2, r1> = <p, p> */
+  r0rn.re = norm; r0rn.im = 0.;
+
   /*************************
    * start iteration
    *************************/
   for(niter=0; niter<=niter_max; niter++) {
         
-    spinor_scalar_product_co(&r0rn, r2_ptr, r1_ptr, VOLUME);
     spinor_scalar_product_co(&w, r2_ptr, p2_ptr, VOLUME);
     _co_eq_co_ti_co_inv(&alpha, &r0rn, &w);
 
-/*
-    if(g_cart_id==0) fprintf(stdout, "\nr0rn =\t%25.16e +i %25.16e\n"\
-      "w =\t%25.16e +i %25.16e\nalpha =\t%25.16e +i %25.16e\n", r0rn.re, r0rn.im, w.re, w.im, alpha.re, alpha.im);
-*/
-
     /* the new complete s */
-    iix=0;
-    for(ix=0; ix<VOLUME; ix++) {
-      _fv_eq_fv_ti_co(spinor1, p2_ptr+iix, &alpha);
-      _fv_eq_fv_mi_fv(s_ptr+iix, r1_ptr+iix, spinor1);
-      iix+=24;
-    }
-    xchange_field(s_ptr);
+    bicgstab_update_s(s_ptr, r1_ptr, p2_ptr, &alpha, VOLUME);
 
-    /* the new t */
-    Q_phi_tbc(t_ptr, s_ptr);
+    /* the new t, exchange of s overlapped with the interior sites */
+    Q_phi_tbc_overlap(t_ptr, s_ptr);
 
-    spinor_scalar_product_co(&w, t_ptr, s_ptr, VOLUME);
-    spinor_scalar_product_re(&u, t_ptr, t_ptr, VOLUME);
+    bicgstab_dot_ts(&w, &u, t_ptr, s_ptr, VOLUME);
     _co_eq_co_ti_re(&omega, &w, 1./u);
-/*
-    if(g_cart_id==0) fprintf(stdout, "i\nw =\t%25.16e +i %25.16e\n"\
-      "u =\t%25.16e\nomega =\t%25.16e +i %25.16e\n", w.re, w.im, u, omega.re, omega.im);
-*/
-    
-
-    /* the new r1 */
-    iix=0;
-    for(ix=0; ix<VOLUME; ix++) {
-      _fv_eq_fv_ti_co(spinor1, t_ptr+iix, &omega);
-      _fv_eq_fv_mi_fv(r1_ptr+iix, s_ptr+iix, spinor1);
-      iix+=24;
-    }
 
-    spinor_scalar_product_re(&norm, r1_ptr, r1_ptr, VOLUME);
+    /* the new r1 and x; norm = <r1, r1> and w = <r2, r1> */
+    bicgstab_update_rx(r1_ptr, x_ptr, s_ptr, t_ptr, p_ptr, r2_ptr, &alpha, &omega, &norm, &w, VOLUME);
     if(g_cart_id==0) fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
     if(norm<=solver_precision*normb) break;
 
-    /* the new x */
-    iix=0;
-    for(ix=0; ix<VOLUME; ix++) {
-      _fv_eq_fv_ti_co(spinor1, s_ptr+iix, &omega);
-      _fv_pl_eq_fv(x_ptr+iix, spinor1);
-      _fv_eq_fv_ti_co(spinor1, p_ptr+iix, &alpha);
-      _fv_pl_eq_fv(x_ptr+iix, spinor1);
-      iix+=24;
-    }
-
-    spinor_scalar_product_co(&w, r2_ptr, r1_ptr, VOLUME);
     _co_eq_co_ti_co_inv(&w2, &w, &r0rn);
     _co_eq_co_ti_co_inv(&w3, &alpha, &omega);
     _co_eq_co_ti_co(&beta, &w2, &w3);
     r0rn.re = w.re; r0rn.im = w.im;
-/*
-    if(g_cart_id==0) fprintf(stdout, "\nw =\t%25.16e +i %25.16e\n"\
-      "w2 =\t%25.16e +i %25.16e\nw3 =\t%25.16e +i %25.16e\nbeta =\t%25.16e +i %25.16e\n", w.re, w.im, w2.re, w2.im, w3.re, w3.im, beta.re, beta.im);
-*/
 
     /* the new p */
-    iix=0;
-    for(ix=0; ix<VOLUME; ix++) {
-      _fv_eq_fv_ti_co(spinor1, p2_ptr+iix, &omega);
-      _fv_eq_fv_mi_fv(spinor1, p_ptr+iix, spinor1);
-      _fv_eq_fv_ti_co(spinor2, spinor1, &beta);
-      _fv_eq_fv_pl_fv(p_ptr+iix, r1_ptr+iix, spinor2);
-      iix+=24;
-    }
-    xchange_field(p_ptr);
+    bicgstab_update_p(p_ptr, r1_ptr, p2_ptr, &omega, &beta, VOLUME);
 
-    /* the new p2 */
-    Q_phi_tbc(p2_ptr, p_ptr);
+    /* the new p2, exchange of p overlapped with the interior sites */
+    Q_phi_tbc_overlap(p2_ptr, p_ptr);
 
   }
 
@@ -289,6 +347,11 @@ int invert_Qtm_her(double *xi, double *phi, int kwork) {
   complex alpha, beta, omega;
   complex w, w2, w3, r0rn;
 
+  if(g_inverter_type == _PIPELINED_CG_INVERTER) return(invert_Qtm_her_pipelined(xi, phi, kwork));
+  if(g_inverter_type == _DEFLATED_CG_INVERTER)  return(invert_Qtm_her_deflated(xi, phi, kwork));
+  if(g_inverter_type == _SIMD_BICGSTAB_INVERTER) return(invert_Qtm_simd(xi, phi, kwork));
+  if(g_inverter_type == _MIXED_BICGSTAB_INVERTER && g_cpu_prec != 2) return(invert_Qtm_mixed(xi, phi, kwork));
+
   /*************************
    * set the fields
    *************************/
@@ -489,10 +552,11 @@ int invert_Q_Wilson(double *xi, double *phi, int kwork) {
   double *p_ptr  = (double*)NULL;
   double *p2_ptr = (double*)NULL;
   double u, norm, normb;
-  double spinor1[24], spinor2[24];
   complex alpha, beta, omega;
   complex w, w2, w3, r0rn;
 
+  if(g_inverter_type == _MIXED_BICGSTAB_INVERTER && g_cpu_prec != 2) return(invert_Q_Wilson_mixed(xi, phi, kwork));
+
   /*************************
    * set the fields
    *************************/
@@ -548,94 +612,44 @@ int invert_Q_Wilson(double *xi, double *phi, int kwork) {
   /* p2 = D p */
   Q_Wilson_phi(p2_ptr, p_ptr);
 
+  /* r0rn = <r2, r1> = <p, p> */
+  r0rn.re = norm; r0rn.im = 0.;
+
   /*************************
    * start iteration
    *************************/
   for(niter=0; niter<=niter_max; niter++) {
         
-    spinor_scalar_product_co(&r0rn, r2_ptr, r1_ptr, VOLUME);
     spinor_scalar_product_co(&w, r2_ptr, p2_ptr, VOLUME);
     _co_eq_co_ti_co_inv(&alpha, &r0rn, &w);
 
-
-    //if(g_cart_id==0) fprintf(stdout, "\nr0rn =\t%25.16e +i %25.16e\n"\
-    //  "w =\t%25.16e +i %25.16e\nalpha =\t%25.16e +i %25.16e\n", r0rn.re, r0rn.im, w.re, w.im, alpha.re, alpha.im);
-
-
     /* the new complete s */
-    iix=0;
-    for(ix=0; ix<VOLUME; ix++) {
-      _fv_eq_fv_ti_co(spinor1, p2_ptr+iix, &alpha);
-      _fv_eq_fv_mi_fv(s_ptr+iix, r1_ptr+iix, spinor1);
-      iix+=24;
-    }
-    xchange_field(s_ptr);
+    bicgstab_update_s(s_ptr, r1_ptr, p2_ptr, &alpha, VOLUME);
 
-    /* the new t */
-    Q_Wilson_phi(t_ptr, s_ptr);
+    /* the new t, exchange of s overlapped with the interior sites */
+    Q_Wilson_phi_overlap(t_ptr, s_ptr);
 
-    spinor_scalar_product_co(&w, t_ptr, s_ptr, VOLUME);
-    spinor_scalar_product_re(&u, t_ptr, t_ptr, VOLUME);
+    bicgstab_dot_ts(&w, &u, t_ptr, s_ptr, VOLUME);
     _co_eq_co_ti_re(&omega, &w, 1./u);
 
-    //if(g_cart_id==0) fprintf(stdout, "i\nw =\t%25.16e +i %25.16e\n"\
-    //  "u =\t%25.16e\nomega =\t%25.16e +i %25.16e\n", w.re, w.im, u, omega.re, omega.im);
-
-    
-
-    /* the new r1 */
-    iix=0;
-    for(ix=0; ix<VOLUME; ix++) {
-      _fv_eq_fv_ti_co(spinor1, t_ptr+iix, &omega);
-      _fv_eq_fv_mi_fv(r1_ptr+iix, s_ptr+iix, spinor1);
-      iix+=24;
-    }
-
-    spinor_scalar_product_re(&norm, r1_ptr, r1_ptr, VOLUME);
+    /* the new r1 and x; norm = <r1, r1> and w = <r2, r1> */
+    bicgstab_update_rx(r1_ptr, x_ptr, s_ptr, t_ptr, p_ptr, r2_ptr, &alpha, &omega, &norm, &w, VOLUME);
     if(g_cart_id==0) {
       fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
       fflush(stdout);
     }
     if(norm<=solver_precision*normb) break;
 
-    /* the new x */
-    iix=0;
-    for(ix=0; ix<VOLUME; ix++) {
-      _fv_eq_fv_ti_co(spinor1, s_ptr+iix, &omega);
-      _fv_pl_eq_fv(x_ptr+iix, spinor1);
-      _fv_eq_fv_ti_co(spinor1, p_ptr+iix, &alpha);
-      _fv_pl_eq_fv(x_ptr+iix, spinor1);
-      iix+=24;
-    }
-
-    spinor_scalar_product_co(&w, r2_ptr, r1_ptr, VOLUME);
     _co_eq_co_ti_co_inv(&w2, &w, &r0rn);
     _co_eq_co_ti_co_inv(&w3, &alpha, &omega);
     _co_eq_co_ti_co(&beta, &w2, &w3);
     r0rn.re = w.re; r0rn.im = w.im;
 
-
-    //spinor_scalar_product_re(&norm, r1_ptr, r1_ptr, VOLUME);
-    //if(g_cart_id==0) fprintf(stdout, "# [%d] (1) norm of r1 = %25.16e\n", g_cart_id, norm);
-    //spinor_scalar_product_re(&norm, r2_ptr, r2_ptr, VOLUME);
-    //if(g_cart_id==0) fprintf(stdout, "# [%d] (1) norm of r2 = %25.16e\n", g_cart_id, norm);
-    //if(g_cart_id==0) fprintf(stdout, "\n(1) w =\t%25.16e +i %25.16e\n"\
-    //  "(1) w2 =\t%25.16e +i %25.16e\n(1) w3 =\t%25.16e +i %25.16e\n(1) beta =\t%25.16e +i %25.16e\n", w.re, w.im, w2.re, w2.im, w3.re, w3.im, beta.re, beta.im);
-
-
     /* the new p */
-    iix=0;
-    for(ix=0; ix<VOLUME; ix++) {
-      _fv_eq_fv_ti_co(spinor1, p2_ptr+iix, &omega);
-      _fv_eq_fv_mi_fv(spinor1, p_ptr+iix, spinor1);
-      _fv_eq_fv_ti_co(spinor2, spinor1, &beta);
-      _fv_eq_fv_pl_fv(p_ptr+iix, r1_ptr+iix, spinor2);
-      iix+=24;
-    }
-    xchange_field(p_ptr);
+    bicgstab_update_p(p_ptr, r1_ptr, p2_ptr, &omega, &beta, VOLUME);
 
-    /* the new p2 */
-    Q_Wilson_phi(p2_ptr, p_ptr);
+    /* the new p2, exchange of p overlapped with the interior sites */
+    Q_Wilson_phi_overlap(p2_ptr, p_ptr);
 
   }
 
@@ -689,6 +703,10 @@ int invert_Q_Wilson_her(double *xi, double *phi, int kwork) {
   complex alpha, w;
   double beta, r0r0, rnrn;
 
+  if(g_inverter_type == _PIPELINED_CG_INVERTER) return(invert_Q_Wilson_her_pipelined(xi, phi, kwork));
+  if(g_inverter_type == _DEFLATED_CG_INVERTER)  return(invert_Q_Wilson_her_deflated(xi, phi, kwork));
+  if(g_inverter_type == _MIXED_BICGSTAB_INVERTER && g_cpu_prec != 2) return(invert_Q_Wilson_mixed(xi, phi, kwork));
+
   /*************************
    * set the fields
    *************************/
@@ -837,7 +855,6 @@ int invert_Q_DW_Wilson(double *xi, double *phi, int kwork) {
   double *p_ptr  = (double*)NULL;
   double *p2_ptr = (double*)NULL;
   double u, norm, normb;
-  double spinor1[24], spinor2[24];
   complex alpha, beta, omega;
   complex w, w2, w3, r0rn;
   unsigned int V5 = VOLUME * L5;
@@ -897,88 +914,44 @@ int invert_Q_DW_Wilson(double *xi, double *phi, int kwork) {
   /* p2 = D p */
   Q_DW_Wilson_phi(p2_ptr, p_ptr);
 
+  /* r0rn = <r2, r1> = <p, p> */
+  r0rn.re = norm; r0rn.im = 0.;
+
   /*************************
    * start iteration
    *************************/
   for(niter=0; niter<=niter_max; niter++) {
         
-    spinor_scalar_product_co(&r0rn, r2_ptr, r1_ptr, V5);
     spinor_scalar_product_co(&w, r2_ptr, p2_ptr, V5);
     _co_eq_co_ti_co_inv(&alpha, &r0rn, &w);
 
-
-    //if(g_cart_id==0) fprintf(stdout, "\nr0rn =\t%25.16e +i %25.16e\n"\
-    //  "w =\t%25.16e +i %25.16e\nalpha =\t%25.16e +i %25.16e\n", r0rn.re, r0rn.im, w.re, w.im, alpha.re, alpha.im);
-
-
     /* the new complete s */
-    iix=0;
-    for(ix=0; ix<V5; ix++) {
-      _fv_eq_fv_ti_co(spinor1, p2_ptr+iix, &alpha);
-      _fv_eq_fv_mi_fv(s_ptr+iix, r1_ptr+iix, spinor1);
-      iix+=24;
-    }
+    bicgstab_update_s(s_ptr, r1_ptr, p2_ptr, &alpha, V5);
+
     xchange_field_5d(s_ptr);
 
     /* the new t */
     Q_DW_Wilson_phi(t_ptr, s_ptr);
 
-    spinor_scalar_product_co(&w, t_ptr, s_ptr, V5);
-    spinor_scalar_product_re(&u, t_ptr, t_ptr, V5);
+    bicgstab_dot_ts(&w, &u, t_ptr, s_ptr, V5);
     _co_eq_co_ti_re(&omega, &w, 1./u);
 
-    //if(g_cart_id==0) fprintf(stdout, "i\nw =\t%25.16e +i %25.16e\n"\
-    //  "u =\t%25.16e\nomega =\t%25.16e +i %25.16e\n", w.re, w.im, u, omega.re, omega.im);
-
-    /* the new r1 */
-    iix=0;
-    for(ix=0; ix<V5; ix++) {
-      _fv_eq_fv_ti_co(spinor1, t_ptr+iix, &omega);
-      _fv_eq_fv_mi_fv(r1_ptr+iix, s_ptr+iix, spinor1);
-      iix+=24;
-    }
-
-    spinor_scalar_product_re(&norm, r1_ptr, r1_ptr, V5);
+    /* the new r1 and x; norm = <r1, r1> and w = <r2, r1> */
+    bicgstab_update_rx(r1_ptr, x_ptr, s_ptr, t_ptr, p_ptr, r2_ptr, &alpha, &omega, &norm, &w, V5);
     if(g_cart_id==0) {
       fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
       fflush(stdout);
     }
     if(norm<=solver_precision*normb) break;
 
-    /* the new x */
-    iix=0;
-    for(ix=0; ix<V5; ix++) {
-      _fv_eq_fv_ti_co(spinor1, s_ptr+iix, &omega);
-      _fv_pl_eq_fv(x_ptr+iix, spinor1);
-      _fv_eq_fv_ti_co(spinor1, p_ptr+iix, &alpha);
-      _fv_pl_eq_fv(x_ptr+iix, spinor1);
-      iix+=24;
-    }
-
-    spinor_scalar_product_co(&w, r2_ptr, r1_ptr, V5);
     _co_eq_co_ti_co_inv(&w2, &w, &r0rn);
     _co_eq_co_ti_co_inv(&w3, &alpha, &omega);
     _co_eq_co_ti_co(&beta, &w2, &w3);
     r0rn.re = w.re; r0rn.im = w.im;
 
-
-    //spinor_scalar_product_re(&norm, r1_ptr, r1_ptr, V5);
-    //if(g_cart_id==0) fprintf(stdout, "# [%d] (1) norm of r1 = %25.16e\n", g_cart_id, norm);
-    //spinor_scalar_product_re(&norm, r2_ptr, r2_ptr, V5);
-    //if(g_cart_id==0) fprintf(stdout, "# [%d] (1) norm of r2 = %25.16e\n", g_cart_id, norm);
-    //if(g_cart_id==0) fprintf(stdout, "\n(1) w =\t%25.16e +i %25.16e\n"\
-    //  "(1) w2 =\t%25.16e +i %25.16e\n(1) w3 =\t%25.16e +i %25.16e\n(1) beta =\t%25.16e +i %25.16e\n", w.re, w.im, w2.re, w2.im, w3.re, w3.im, beta.re, beta.im);
-
-
     /* the new p */
-    iix=0;
-    for(ix=0; ix<V5; ix++) {
-      _fv_eq_fv_ti_co(spinor1, p2_ptr+iix, &omega);
-      _fv_eq_fv_mi_fv(spinor1, p_ptr+iix, spinor1);
-      _fv_eq_fv_ti_co(spinor2, spinor1, &beta);
-      _fv_eq_fv_pl_fv(p_ptr+iix, r1_ptr+iix, spinor2);
-      iix+=24;
-    }
+    bicgstab_update_p(p_ptr, r1_ptr, p2_ptr, &omega, &beta, V5);
+
     xchange_field_5d(p_ptr);
 
     /* the new p2 */
@@ -1037,6 +1010,11 @@ int invert_Q_DW_Wilson_her(double *xi, double *phi, int kwork) {
   double beta, r0r0, rnrn;
   unsigned int V5 = VOLUME * L5;
 
+  /* even/odd preconditioned solver with the fused operator, required for Moebius parameters */
+  if(g_inverter_type == _EO_CG_INVERTER || g_b5 != 1. || g_c5 != 0.) {
+    return(invert_Q_DW_Mobius_eo(xi, phi, kwork));
+  }
+
   /*************************
    * set the fields
    *************************/
@@ -1183,3 +1161,1812 @@ int invert_Q_DW_Wilson_her(double *xi, double *phi, int kwork) {
 
   return(niter);
 }
+
+/****************************************************************
+ * invert_Q_DW_Mobius_eo
+ *
+ * - solve phi = D xi for the (Moebius) domain wall operator
+ *   of Q_mobius_phi.c, xi and phi in the layout _G5DI
+ * - even/odd preconditioned CG on Mhat^+ Mhat for the odd
+ *   sites in the s-inner layout, xi on input is the start
+ *   vector
+ * - work fields kwork,...,kwork+3 (5d), each holding two
+ *   odd/even half fields
+ ****************************************************************/
+int invert_Q_DW_Mobius_eo(double *xi, double *phi, int kwork) {
+
+  int ix, iix, niter;
+  const int V5h = VOLUME / 2 * L5;
+  double *full_ptr=NULL, *x_ptr=NULL, *re_ptr=NULL, *r_ptr=NULL, *p_ptr=NULL, *q_ptr=NULL, *w_ptr=NULL;
+  double normb, norm=0., norm_new, alpha, beta, pq;
+  double spinor1[24];
+
+  if(kwork+4 > no_fields) return(-2);
+
+  /*************************
+   * set the fields
+   *************************/
+  full_ptr = g_spinor_field[kwork  ];
+  x_ptr    = g_spinor_field[kwork+1];
+  r_ptr    = g_spinor_field[kwork+2];
+  q_ptr    = g_spinor_field[kwork+3];
+
+  if( full_ptr==NULL || x_ptr==NULL || r_ptr==NULL || q_ptr==NULL || xi==NULL || phi==NULL ) return(-2);
+
+  re_ptr = x_ptr + _GSI(V5h);
+  p_ptr  = r_ptr + _GSI(V5h);
+  w_ptr  = q_ptr + _GSI(V5h);
+
+  /* returns at once if the driver has set up the tables */
+  if(init_Q_DW_Mobius() != 0) {
+    if(g_cart_id==0) fprintf(stderr, "[invert_Q_DW_Mobius_eo] Error from init_Q_DW_Mobius\n");
+    return(-2);
+  }
+
+  /*************************
+   * odd source and start vector
+   *************************/
+  spinor_field_5d_to_sinner(full_ptr, phi);
+  Q_DW_Mobius_eo_prepare(r_ptr, re_ptr, full_ptr);
+
+  /* normb = |Mhat^+ b|^2 */
+  Q_DW_Mobius_eo_dag_phi(q_ptr, r_ptr);
+  spinor_scalar_product_re(&normb, q_ptr, q_ptr, V5h);
+  if(g_cart_id==0) fprintf(stdout, "# [invert_Q_DW_Mobius_eo] norm of r.-h. side: %e\n", normb);
+
+  /* r = Mhat^+ (b - Mhat x) */
+  spinor_field_5d_to_sinner(full_ptr, xi);
+  for(ix=0; ix<VOLUME/2; ix++) {
+    memcpy(x_ptr+_GSI5(ix,0), full_ptr+_GSI5(g_eo2lexic[VOLUME/2+ix],0), 24*L5*sizeof(double));
+  }
+  Q_DW_Mobius_eo_phi(w_ptr, x_ptr);
+  iix=0;
+  for(ix=0; ix<V5h; ix++) {
+    _fv_eq_fv_mi_fv(w_ptr+iix, r_ptr+iix, w_ptr+iix);
+    iix+=24;
+  }
+  Q_DW_Mobius_eo_dag_phi(r_ptr, w_ptr);
+
+  memcpy((void*)p_ptr, (void*)r_ptr, 24*V5h*sizeof(double));
+  spinor_scalar_product_re(&norm, r_ptr, r_ptr, V5h);
+
+  /*************************
+   * start iteration
+   *************************/
+  for(niter=0; niter<=niter_max; niter++) {
+    if(g_cart_id==0) fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
+    if(norm<=solver_precision*normb) break;
+
+    /* q = Mhat^+ Mhat p */
+    Q_DW_Mobius_eo_phi(w_ptr, p_ptr);
+    Q_DW_Mobius_eo_dag_phi(q_ptr, w_ptr);
+    spinor_scalar_product_re(&pq, w_ptr, w_ptr, V5h);
+    alpha = norm / pq;
+
+    /* x = x + alpha p, r = r - alpha q */
+    iix=0;
+    for(ix=0; ix<V5h; ix++) {
+      _fv_eq_fv_ti_re(spinor1, p_ptr+iix, alpha);
+      _fv_pl_eq_fv(x_ptr+iix, spinor1);
+      _fv_eq_fv_ti_re(spinor1, q_ptr+iix, alpha);
+      _fv_mi_eq_fv(r_ptr+iix, spinor1);
+      iix+=24;
+    }
+    spinor_scalar_product_re(&norm_new, r_ptr, r_ptr, V5h);
+    beta = norm_new / norm;
+    norm = norm_new;
+
+    /* p = r + beta p */
+    iix=0;
+    for(ix=0; ix<V5h; ix++) {
+      _fv_eq_fv_ti_re(spinor1, p_ptr+iix, beta);
+      _fv_eq_fv_pl_fv(p_ptr+iix, r_ptr+iix, spinor1);
+      iix+=24;
+    }
+  }
+
+  /*******************************
+   * get final solution
+   *******************************/
+  Q_DW_Mobius_eo_reconstruct(full_ptr, x_ptr, re_ptr);
+  spinor_field_sinner_to_5d(xi, full_ptr);
+  xchange_field_5d(xi);
+
+  /*************************
+   * output
+   *************************/
+  if(norm<=solver_precision*normb && niter<=niter_max) {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# [invert_Q_DW_Mobius_eo] CG converged after %d steps with relative residuum %e\n", niter, norm/normb);
+    }
+  } else {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# [invert_Q_DW_Mobius_eo] No convergence in CG; after %d steps relative residuum is %e\n", niter, norm/normb);
+    }
+    return(-3);
+  }
+
+  /*************************
+   * check the solution
+   *************************/
+  xchange_field_sinner(full_ptr);
+  Q_DW_Mobius_phi(q_ptr, full_ptr);
+  spinor_field_5d_to_sinner(r_ptr, phi);
+  iix=0;
+  for(ix=0; ix<VOLUME*L5; ix++) {
+    _fv_mi_eq_fv(q_ptr+iix, r_ptr+iix);
+    iix+=24;
+  }
+  spinor_scalar_product_re(&norm, q_ptr, q_ptr, VOLUME*L5);
+  spinor_scalar_product_re(&normb, r_ptr, r_ptr, VOLUME*L5);
+  if(g_cart_id==0) {
+    fprintf(stdout, "# [invert_Q_DW_Mobius_eo] true relative squared residuum is %e\n", norm/normb);
+  }
+
+  return(niter);
+}
+
+/****************************************************************
+ * scalar products restricted to the sites of parity ieo
+ * - full lattice fields, sites taken from g_eo2lexic
+ ****************************************************************/
+void spinor_scalar_product_co_eo(complex *w, double *xi, double *phi, int ieo) {
+
+  unsigned int i, iix;
+  const unsigned int N = VOLUME / 2;
+  const unsigned int offset = ieo * N;
+  complex p, p2;
+#ifdef MPI
+  complex pall;
+#endif
+
+  p2.re = 0.;
+  p2.im = 0.;
+
+  for(i=0; i<N; i++) {
+    iix = _GSI( g_eo2lexic[offset + i] );
+    _co_eq_fv_dag_ti_fv(&p, xi+iix, phi+iix);
+    p2.re += p.re;
+    p2.im += p.im;
+  }
+
+#ifdef MPI
+  pall.re=0.; pall.im=0.;
+  MPI_Allreduce(&p2, &pall, 2, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+  w->re = pall.re;
+  w->im = pall.im;
+#else
+  w->re = p2.re;
+  w->im = p2.im;
+#endif
+}
+
+void spinor_scalar_product_re_eo(double *r, double *xi, double *phi, int ieo) {
+
+  unsigned int i, iix;
+  const unsigned int N = VOLUME / 2;
+  const unsigned int offset = ieo * N;
+  double w;
+  complex p;
+#ifdef MPI
+  double wall;
+#endif
+
+  w = 0.;
+  for(i=0; i<N; i++) {
+    iix = _GSI( g_eo2lexic[offset + i] );
+    _co_eq_fv_dag_ti_fv(&p, xi+iix, phi+iix);
+    w += p.re;
+  }
+#ifdef MPI
+  wall = 0.;
+  MPI_Allreduce(&w, &wall, 1, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+  *r = wall;
+#else
+  *r = w;
+#endif
+}
+
+/****************************************************************
+ * invert_eo
+ *
+ * - solve phi = Q xi with even/odd preconditioning,
+ *   Q = Q_phi_tbc   for fermion_type = _TM_FERMION,
+ *   Q = Q_Wilson_phi for fermion_type = _WILSON_FERMION
+ * - BiCGStab for the Schur complement on the odd sites
+ *     ( M_oo - H_oe M_ee^{-1} H_eo ) xi_o = phi_o - H_oe M_ee^{-1} phi_e
+ *   and reconstruction of the even sites
+ *     xi_e = M_ee^{-1} ( phi_e - H_eo xi_o )
+ * - the odd sites of xi are used as initial guess
+ * - needs 7 work fields starting at g_spinor_field[kwork]
+ * - returns the number of iterations or -3 for no convergence;
+ *   xi holds the full (reconstructed) solution in both cases
+ ****************************************************************/
+static int invert_eo(double *xi, double *phi, int kwork, double mutm, int fermion_type) {
+
+  unsigned int i, iix;
+  const unsigned int N = VOLUME / 2;
+  int niter, status=0;
+  double *r1_ptr = (double*)NULL; 
+  double *r2_ptr = (double*)NULL;
+  double *s_ptr  = (double*)NULL;
+  double *t_ptr  = (double*)NULL;
+  double *x_ptr  = (double*)NULL;
+  double *p_ptr  = (double*)NULL;
+  double *p2_ptr = (double*)NULL;
+  double *aux    = (double*)NULL;
+  double u, norm, normb;
+  double spinor1[24], spinor2[24];
+  complex alpha, beta, omega;
+  complex w, w2, w3, r0rn;
+
+  /*************************
+   * set the fields
+   *************************/
+  r1_ptr = g_spinor_field[kwork];
+  r2_ptr = g_spinor_field[kwork+1];
+  s_ptr  = g_spinor_field[kwork+2];
+  t_ptr  = g_spinor_field[kwork+3];
+  p_ptr  = g_spinor_field[kwork+4];
+  p2_ptr = g_spinor_field[kwork+5];
+  aux    = g_spinor_field[kwork+6];
+  x_ptr  = xi;
+
+  if( r1_ptr==(double*)NULL ||  r2_ptr==(double*)NULL || s_ptr==(double*)NULL || t_ptr==(double*)NULL || 
+      p_ptr==(double*)NULL || p2_ptr==(double*)NULL || aux==(double*)NULL || x_ptr==(double*)NULL || phi==(double*)NULL ) return(-2);
+
+  /*************************
+   * initialize
+   *************************/
+  
+  alpha.re = 0.; alpha.im = 0.;
+  beta.re  = 0.; beta.im  = 0.;
+  omega.re = 0.; omega.im = 0.;
+  w.re     = 0.; w.im     = 0.;
+  w2.re    = 0.; w2.im    = 0.;
+  w3.re    = 0.; w3.im    = 0.;
+  u        = 0.;
+
+  /* normb of the full r.-h. side */
+  spinor_scalar_product_re(&normb, phi, phi, VOLUME);
+  if(g_cart_id==0) fprintf(stdout, "# norm of r.-h. side: %e\n", normb);
+
+  /* r2_o = phi_o - H_oe M_ee^{-1} phi_e, prepared source */
+  M_eo_diag_inv(aux, phi, 0, mutm);
+  xchange_field(aux);
+  Hopping_eo(r2_ptr, aux, 1, fermion_type);
+  for(i=0; i<N; i++) {
+    iix = _GSI( g_eo2lexic[N + i] );
+    _fv_eq_fv_mi_fv(r2_ptr+iix, phi+iix, r2_ptr+iix);
+  }
+
+  /* p_o = r2_o - Qhat x_o */
+  xchange_field(x_ptr);
+  Q_eo_SchurComplement(p_ptr, x_ptr, mutm, fermion_type, aux);
+  for(i=0; i<N; i++) {
+    iix = _GSI( g_eo2lexic[N + i] );
+    _fv_eq_fv_mi_fv(p_ptr+iix, r2_ptr+iix, p_ptr+iix);
+  }
+  xchange_field(p_ptr);
+
+  /* check the norm */
+  spinor_scalar_product_re_eo(&norm, p_ptr, p_ptr, 1);
+  if(norm<=solver_precision*normb) {
+    if(g_cart_id==0) fprintf(stdout, "start spinor solves to requested precision\n");
+    niter = 0;
+  } else {
+
+    /* r1 = p = r2 */
+    for(i=0; i<N; i++) {
+      iix = _GSI( g_eo2lexic[N + i] );
+      _fv_eq_fv(r1_ptr+iix, p_ptr+iix);
+      _fv_eq_fv(r2_ptr+iix, p_ptr+iix);
+    }
+  
+    /* p2 = Qhat p */
+    Q_eo_SchurComplement(p2_ptr, p_ptr, mutm, fermion_type, aux);
+
+    /*************************
+     * start iteration
+     *************************/
+    for(niter=0; niter<=niter_max; niter++) {
+        
+      spinor_scalar_product_co_eo(&r0rn, r2_ptr, r1_ptr, 1);
+      spinor_scalar_product_co_eo(&w, r2_ptr, p2_ptr, 1);
+      _co_eq_co_ti_co_inv(&alpha, &r0rn, &w);
+
+      /* the new complete s */
+      for(i=0; i<N; i++) {
+        iix = _GSI( g_eo2lexic[N + i] );
+        _fv_eq_fv_ti_co(spinor1, p2_ptr+iix, &alpha);
+        _fv_eq_fv_mi_fv(s_ptr+iix, r1_ptr+iix, spinor1);
+      }
+      xchange_field(s_ptr);
+
+      /* the new t */
+      Q_eo_SchurComplement(t_ptr, s_ptr, mutm, fermion_type, aux);
+
+      spinor_scalar_product_co_eo(&w, t_ptr, s_ptr, 1);
+      spinor_scalar_product_re_eo(&u, t_ptr, t_ptr, 1);
+      _co_eq_co_ti_re(&omega, &w, 1./u);
+
+      /* the new r1 */
+      for(i=0; i<N; i++) {
+        iix = _GSI( g_eo2lexic[N + i] );
+        _fv_eq_fv_ti_co(spinor1, t_ptr+iix, &omega);
+        _fv_eq_fv_mi_fv(r1_ptr+iix, s_ptr+iix, spinor1);
+      }
+
+      spinor_scalar_product_re_eo(&norm, r1_ptr, r1_ptr, 1);
+      if(g_cart_id==0) fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
+
+      /* the new x */
+      for(i=0; i<N; i++) {
+        iix = _GSI( g_eo2lexic[N + i] );
+        _fv_eq_fv_ti_co(spinor1, s_ptr+iix, &omega);
+        _fv_pl_eq_fv(x_ptr+iix, spinor1);
+        _fv_eq_fv_ti_co(spinor1, p_ptr+iix, &alpha);
+        _fv_pl_eq_fv(x_ptr+iix, spinor1);
+      }
+      if(norm<=solver_precision*normb) break;
+
+      spinor_scalar_product_co_eo(&w, r2_ptr, r1_ptr, 1);
+      _co_eq_co_ti_co_inv(&w2, &w, &r0rn);
+      _co_eq_co_ti_co_inv(&w3, &alpha, &omega);
+      _co_eq_co_ti_co(&beta, &w2, &w3);
+      r0rn.re = w.re; r0rn.im = w.im;
+
+      /* the new p */
+      for(i=0; i<N; i++) {
+        iix = _GSI( g_eo2lexic[N + i] );
+        _fv_eq_fv_ti_co(spinor1, p2_ptr+iix, &omega);
+        _fv_eq_fv_mi_fv(spinor1, p_ptr+iix, spinor1);
+        _fv_eq_fv_ti_co(spinor2, spinor1, &beta);
+        _fv_eq_fv_pl_fv(p_ptr+iix, r1_ptr+iix, spinor2);
+      }
+      xchange_field(p_ptr);
+
+      /* the new p2 */
+      Q_eo_SchurComplement(p2_ptr, p_ptr, mutm, fermion_type, aux);
+    }
+
+    /*************************
+     * output
+     *************************/
+    if(norm<=solver_precision*normb && niter<=niter_max) {
+      if(g_cart_id==0) {
+        fprintf(stdout, "# BiCGStab (even/odd) converged after %d steps with relative residuum %e\n", niter, norm/normb);
+      }
+    } else {
+      if(g_cart_id==0) {
+        fprintf(stdout, "# No convergence in BiCGStab (even/odd); after %d steps relative residuum is %e\n", niter, norm/normb);
+      }
+      /* xi is still reconstructed on all sites */
+      status = -3;
+    }
+  }
+
+  /*************************
+   * reconstruct the even sites
+   *   x_e = M_ee^{-1} ( phi_e - H_eo x_o )
+   *************************/
+  xchange_field(x_ptr);
+  Hopping_eo(aux, x_ptr, 0, fermion_type);
+  for(i=0; i<N; i++) {
+    iix = _GSI( g_eo2lexic[i] );
+    _fv_eq_fv_mi_fv(aux+iix, phi+iix, aux+iix);
+  }
+  M_eo_diag_inv(x_ptr, aux, 0, mutm);
+
+  /*************************
+   * check the solution with the full operator
+   *************************/
+  xchange_field(x_ptr);
+  if(fermion_type == _TM_FERMION) {
+    Q_phi_tbc(p_ptr, x_ptr);
+  } else {
+    Q_Wilson_phi(p_ptr, x_ptr);
+  }
+  for(i=0; i<VOLUME; i++) {
+    iix = _GSI(i);
+    _fv_mi_eq_fv(p_ptr+iix, phi+iix);
+  }
+  spinor_scalar_product_re(&norm, p_ptr, p_ptr, VOLUME);
+  if(g_cart_id==0) {
+    fprintf(stdout, "# true relative squared residuum is %e\n", norm/normb);
+  }
+
+  return(status == 0 ? niter : status);
+}
+
+/****************************************************************
+ * invert_Qtm_eo
+ * - phi = Q_phi_tbc xi with even/odd preconditioning,
+ *   twisted mass g_mu
+ ****************************************************************/
+int invert_Qtm_eo(double *xi, double *phi, int kwork) {
+  return( invert_eo(xi, phi, kwork, g_mu, _TM_FERMION) );
+}
+
+/****************************************************************
+ * invert_Q_Wilson_eo
+ * - phi = Q_Wilson_phi xi with even/odd preconditioning
+ ****************************************************************/
+int invert_Q_Wilson_eo(double *xi, double *phi, int kwork) {
+  return( invert_eo(xi, phi, kwork, 0., _WILSON_FERMION) );
+}
+
+/****************************************************************
+ * scalar products for single precision spinor fields;
+ * local sums are accumulated in double precision
+ ****************************************************************/
+void spinor_scalar_product_co_flt(complex *w, float *xi, float *phi, int V) {
+
+  int ix, iix, i;
+  double p2re = 0., p2im = 0.;
+  float pre, pim;
+  double pall[2], p2[2];
+
+  iix=0;
+  for(ix=0; ix<V; ix++) {
+    pre = 0.; pim = 0.;
+    for(i=0; i<12; i++) {
+      pre += xi[iix+2*i] * phi[iix+2*i  ] + xi[iix+2*i+1] * phi[iix+2*i+1];
+      pim += xi[iix+2*i] * phi[iix+2*i+1] - xi[iix+2*i+1] * phi[iix+2*i  ];
+    }
+    p2re += pre;
+    p2im += pim;
+    iix+=24;
+  }
+  p2[0] = p2re; p2[1] = p2im;
+
+#ifdef MPI
+  MPI_Allreduce(p2, pall, 2, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#else
+  pall[0] = p2[0]; pall[1] = p2[1];
+#endif
+  w->re = pall[0];
+  w->im = pall[1];
+}
+
+void spinor_scalar_product_re_flt(double *r, float *xi, float *phi, int V) {
+
+  int ix, iix, i;
+  double w = 0.;
+  float p;
+#ifdef MPI
+  double wall;
+#endif
+
+  iix=0;
+  for(ix=0; ix<V; ix++) {
+    p = 0.;
+    for(i=0; i<24; i++) p += xi[iix+i] * phi[iix+i];
+    w += p;
+    iix+=24;
+  }
+#ifdef MPI
+  wall = 0.;
+  MPI_Allreduce(&w, &wall, 1, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+  *r = wall;
+#else
+  *r = w;
+#endif
+}
+
+/****************************************************************
+ * BiCGStab in single precision for Q_phi_tbc_flt / Q_Wilson_phi_flt
+ * - x = 0 initially, iterate until |r|^2 <= eps * |b|^2
+ * - work holds 6 float fields
+ * - returns number of iterations or -3 for no convergence
+ ****************************************************************/
+static int bicgstab_flt(float *x, float *b, float **work, float *gauge, int fermion_type, double eps, int nmax) {
+
+  int ix, niter;
+  float *r1_ptr = work[0];
+  float *r2_ptr = work[1];
+  float *s_ptr  = work[2];
+  float *t_ptr  = work[3];
+  float *p_ptr  = work[4];
+  float *p2_ptr = work[5];
+  double u, norm, normb;
+  complex alpha, beta, omega;
+  complex w, w2, w3, r0rn;
+  void (*Q)(float*, float*, float*) = fermion_type == _TM_FERMION ? Q_phi_tbc_flt : Q_Wilson_phi_flt;
+
+  memset(x, 0, 24*VOLUME*sizeof(float));
+  memcpy(p_ptr,  b, 24*VOLUME*sizeof(float));
+  memcpy(r1_ptr, b, 24*VOLUME*sizeof(float));
+  memcpy(r2_ptr, b, 24*VOLUME*sizeof(float));
+  xchange_field_flt(p_ptr);
+
+  spinor_scalar_product_re_flt(&normb, b, b, VOLUME);
+  norm = normb;
+
+  /* p2 = D p */
+  Q(p2_ptr, p_ptr, gauge);
+
+  for(niter=0; niter<=nmax; niter++) {
+        
+    spinor_scalar_product_co_flt(&r0rn, r2_ptr, r1_ptr, VOLUME);
+    spinor_scalar_product_co_flt(&w, r2_ptr, p2_ptr, VOLUME);
+    _co_eq_co_ti_co_inv(&alpha, &r0rn, &w);
+
+    /* the new complete s */
+    for(ix=0; ix<24*VOLUME; ix+=2) {
+      s_ptr[ix  ] = r1_ptr[ix  ] - ( alpha.re * p2_ptr[ix] - alpha.im * p2_ptr[ix+1] );
+      s_ptr[ix+1] = r1_ptr[ix+1] - ( alpha.re * p2_ptr[ix+1] + alpha.im * p2_ptr[ix] );
+    }
+    xchange_field_flt(s_ptr);
+
+    /* the new t */
+    Q(t_ptr, s_ptr, gauge);
+
+    spinor_scalar_product_co_flt(&w, t_ptr, s_ptr, VOLUME);
+    spinor_scalar_product_re_flt(&u, t_ptr, t_ptr, VOLUME);
+    _co_eq_co_ti_re(&omega, &w, 1./u);
+
+    /* the new x and r1 */
+    for(ix=0; ix<24*VOLUME; ix+=2) {
+      x[ix  ] += omega.re * s_ptr[ix  ] - omega.im * s_ptr[ix+1] + alpha.re * p_ptr[ix  ] - alpha.im * p_ptr[ix+1];
+      x[ix+1] += omega.re * s_ptr[ix+1] + omega.im * s_ptr[ix  ] + alpha.re * p_ptr[ix+1] + alpha.im * p_ptr[ix  ];
+      r1_ptr[ix  ] = s_ptr[ix  ] - ( omega.re * t_ptr[ix  ] - omega.im * t_ptr[ix+1] );
+      r1_ptr[ix+1] = s_ptr[ix+1] - ( omega.re * t_ptr[ix+1] + omega.im * t_ptr[ix  ] );
+    }
+
+    spinor_scalar_product_re_flt(&norm, r1_ptr, r1_ptr, VOLUME);
+    if(g_verbose && g_cart_id==0) fprintf(stdout, "# [%d] single precision residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
+    if(norm<=eps*normb) break;
+
+    spinor_scalar_product_co_flt(&w, r2_ptr, r1_ptr, VOLUME);
+    _co_eq_co_ti_co_inv(&w2, &w, &r0rn);
+    _co_eq_co_ti_co_inv(&w3, &alpha, &omega);
+    _co_eq_co_ti_co(&beta, &w2, &w3);
+
+    /* the new p = r1 + beta ( p - omega p2 ) */
+    for(ix=0; ix<24*VOLUME; ix+=2) {
+      float a_re = p_ptr[ix  ] - ( omega.re * p2_ptr[ix  ] - omega.im * p2_ptr[ix+1] );
+      float a_im = p_ptr[ix+1] - ( omega.re * p2_ptr[ix+1] + omega.im * p2_ptr[ix  ] );
+      p_ptr[ix  ] = r1_ptr[ix  ] + beta.re * a_re - beta.im * a_im;
+      p_ptr[ix+1] = r1_ptr[ix+1] + beta.re * a_im + beta.im * a_re;
+    }
+    xchange_field_flt(p_ptr);
+
+    /* the new p2 */
+    Q(p2_ptr, p_ptr, gauge);
+  }
+
+  return( niter <= nmax ? niter+1 : -3 );
+}
+
+/****************************************************************
+ * invert_mixed
+ *
+ * - solve phi = Q xi by defect correction with single precision
+ *   BiCGStab as inner solver,
+ *   Q = Q_phi_tbc   for fermion_type = _TM_FERMION,
+ *   Q = Q_Wilson_phi for fermion_type = _WILSON_FERMION
+ * - outer loop in double precision: r = phi - Q xi, solve Q e = r
+ *   in single precision to relative residuum reliable_delta, xi += e;
+ *   stop when |r|^2 <= solver_precision |phi|^2
+ * - xi is used as initial guess
+ * - needs 2 work fields starting at g_spinor_field[kwork]
+ * - g_cpu_prec = 2 falls back to the double precision solver
+ * - invert_Qtm, invert_Q_Wilson and their _her versions dispatch
+ *   here for inverter_type = mixed_bicgstab
+ ****************************************************************/
+static int invert_mixed(double *xi, double *phi, int kwork, int fermion_type) {
+
+  int ix, i, niter=0, niter_inner, nouter;
+  const int N = 24 * VOLUMEPLUSRAND;
+  double *r_ptr  = (double*)NULL;
+  double *q_ptr  = (double*)NULL;
+  float *gauge_flt = (float*)NULL;
+  float *r_flt = (float*)NULL, *e_flt = (float*)NULL;
+  float *work_flt[6];
+  double norm, normb, eps_inner;
+  void (*Q)(double*, double*) = fermion_type == _TM_FERMION ? Q_phi_tbc : Q_Wilson_phi;
+
+  if(g_cpu_prec == 2) {
+    if(fermion_type == _TM_FERMION) {
+      return( invert_Qtm(xi, phi, kwork) );
+    } else {
+      return( invert_Q_Wilson(xi, phi, kwork) );
+    }
+  }
+  if(g_cpu_prec == 0 && g_cart_id==0) {
+    fprintf(stdout, "# [invert_mixed] Warning, half precision not available on CPU, using single precision\n");
+  }
+
+  /*************************
+   * set the fields
+   *************************/
+  r_ptr = g_spinor_field[kwork];
+  q_ptr = g_spinor_field[kwork+1];
+  if( r_ptr==(double*)NULL || q_ptr==(double*)NULL || xi==(double*)NULL || phi==(double*)NULL ) return(-2);
+
+  alloc_gauge_field_flt(&gauge_flt, 72*VOLUMEPLUSRAND);
+  alloc_spinor_field_flt(&r_flt, N);
+  alloc_spinor_field_flt(&e_flt, N);
+  for(i=0; i<6; i++) alloc_spinor_field_flt(&work_flt[i], N);
+
+  for(ix=0; ix<72*VOLUMEPLUSRAND; ix++) gauge_flt[ix] = (float)g_gauge_field[ix];
+
+  /* inner solver precision, reliable_delta is relative to the residuum */
+  eps_inner = reliable_delta * reliable_delta;
+
+  spinor_scalar_product_re(&normb, phi, phi, VOLUME);
+  if(g_cart_id==0) fprintf(stdout, "# norm of r.-h. side: %e\n", normb);
+
+  for(nouter=0; niter<=niter_max; nouter++) {
+
+    /* r = phi - Q xi in double precision */
+    xchange_field(xi);
+    Q(q_ptr, xi);
+    for(ix=0; ix<24*VOLUME; ix++) r_ptr[ix] = phi[ix] - q_ptr[ix];
+
+    spinor_scalar_product_re(&norm, r_ptr, r_ptr, VOLUME);
+    if(g_cart_id==0) fprintf(stdout, "# [%d] residuum after outer iteration %d (%d inner iterations): %25.16e\n", g_cart_id, nouter, niter, norm);
+    if(norm<=solver_precision*normb) break;
+
+    /* solve Q e = r in single precision; r is normalized to avoid underflow */
+    for(ix=0; ix<24*VOLUME; ix++) r_flt[ix] = (float)( r_ptr[ix] / sqrt(norm) );
+    niter_inner = bicgstab_flt(e_flt, r_flt, work_flt, gauge_flt, fermion_type, eps_inner, niter_max-niter);
+    if(niter_inner < 0) {
+      niter = niter_max+1;
+      break;
+    }
+    niter += niter_inner;
+
+    /* xi = xi + e */
+    for(ix=0; ix<24*VOLUME; ix++) xi[ix] += sqrt(norm) * (double)e_flt[ix];
+  }
+
+  free(gauge_flt);
+  free(r_flt);
+  free(e_flt);
+  for(i=0; i<6; i++) free(work_flt[i]);
+
+  /*************************
+   * output
+   *************************/
+  if(norm<=solver_precision*normb && niter<=niter_max) {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# mixed precision BiCGStab converged after %d outer and %d inner steps with relative residuum %e\n", nouter, niter, norm/normb);
+    }
+  } else {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# No convergence in mixed precision BiCGStab; after %d steps relative residuum is %e\n", niter, norm/normb);
+    }
+    return(-3);
+  }
+
+  return(niter);
+}
+
+/****************************************************************
+ * invert_Qtm_mixed
+ * - phi = Q_phi_tbc xi, mixed precision
+ ****************************************************************/
+int invert_Qtm_mixed(double *xi, double *phi, int kwork) {
+  return( invert_mixed(xi, phi, kwork, _TM_FERMION) );
+}
+
+/****************************************************************
+ * invert_Q_Wilson_mixed
+ * - phi = Q_Wilson_phi xi, mixed precision
+ ****************************************************************/
+int invert_Q_Wilson_mixed(double *xi, double *phi, int kwork) {
+  return( invert_mixed(xi, phi, kwork, _WILSON_FERMION) );
+}
+
+/****************************************************************
+ * scalar products for nrhs pairs of fields with a single
+ * global reduction
+ ****************************************************************/
+static void spinor_scalar_product_co_block(complex *w, double **xi, double **phi, int nrhs, int V) {
+
+  int ix, iix, k;
+  complex p;
+  double *p2 = (double*)calloc(2*nrhs, sizeof(double));
+
+  for(k=0; k<nrhs; k++) {
+    iix=0;
+    for(ix=0; ix<V; ix++) {
+      _co_eq_fv_dag_ti_fv(&p, xi[k]+iix, phi[k]+iix);
+      p2[2*k  ] += p.re;
+      p2[2*k+1] += p.im;
+      iix+=24;
+    }
+  }
+#ifdef MPI
+  MPI_Allreduce(MPI_IN_PLACE, p2, 2*nrhs, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#endif
+  for(k=0; k<nrhs; k++) {
+    w[k].re = p2[2*k  ];
+    w[k].im = p2[2*k+1];
+  }
+  free(p2);
+}
+
+/****************************************************************
+ * invert_Qtm_block
+ *
+ * - solve phi[k] = Q_phi_tbc xi[k], k = 0, ..., nrhs-1,
+ *   with BiCGStab for all nrhs systems in lockstep
+ * - the operator is applied with Q_phi_tbc_block to all
+ *   not yet converged systems at once, the scalar products
+ *   of all systems are reduced together
+ * - xi[k] are used as initial guess
+ * - needs 6*nrhs work fields starting at g_spinor_field[kwork]
+ * - returns the maximal number of iterations, -2 for missing
+ *   fields and -3 if any of the systems did not converge
+ * - used by invert for inverter_type = block_bicgstab
+ ****************************************************************/
+int invert_Qtm_block(double **xi, double **phi, int nrhs, int kwork) {
+
+  int ix, iix, k, l, niter, nactive, nold, status=0;
+  double **r1_ptr=NULL, **r2_ptr=NULL, **s_ptr=NULL, **t_ptr=NULL, **p_ptr=NULL, **p2_ptr=NULL;
+  double **a_x=NULL, **a_r1=NULL, **a_r2=NULL, **a_s=NULL, **a_t=NULL, **a_p=NULL, **a_p2=NULL;
+  double *normb=NULL, *norm=NULL;
+  double spinor1[24], spinor2[24];
+  complex *alpha=NULL, *beta=NULL, *omega=NULL, *r0rn=NULL, *w=NULL, *u=NULL;
+  complex w2, w3;
+  int *active=NULL, *niter_rhs=NULL;
+
+  if(nrhs <= 0) return(0);
+  for(k=0; k<nrhs; k++) {
+    if(xi[k]==(double*)NULL || phi[k]==(double*)NULL) return(-2);
+  }
+  for(k=0; k<6*nrhs; k++) {
+    if(g_spinor_field[kwork+k]==(double*)NULL) return(-2);
+  }
+
+  /*************************
+   * set the fields
+   *************************/
+  r1_ptr = (double**)malloc(13*nrhs*sizeof(double*));
+  r2_ptr = r1_ptr +   nrhs;
+  s_ptr  = r1_ptr + 2*nrhs;
+  t_ptr  = r1_ptr + 3*nrhs;
+  p_ptr  = r1_ptr + 4*nrhs;
+  p2_ptr = r1_ptr + 5*nrhs;
+  a_x    = r1_ptr + 6*nrhs;
+  a_r1   = r1_ptr + 7*nrhs;
+  a_r2   = r1_ptr + 8*nrhs;
+  a_s    = r1_ptr + 9*nrhs;
+  a_t    = r1_ptr +10*nrhs;
+  a_p    = r1_ptr +11*nrhs;
+  a_p2   = r1_ptr +12*nrhs;
+  for(k=0; k<nrhs; k++) {
+    r1_ptr[k] = g_spinor_field[kwork+6*k  ];
+    r2_ptr[k] = g_spinor_field[kwork+6*k+1];
+    s_ptr[k]  = g_spinor_field[kwork+6*k+2];
+    t_ptr[k]  = g_spinor_field[kwork+6*k+3];
+    p_ptr[k]  = g_spinor_field[kwork+6*k+4];
+    p2_ptr[k] = g_spinor_field[kwork+6*k+5];
+  }
+
+  alpha  = (complex*)malloc(6*nrhs*sizeof(complex));
+  beta   = alpha +   nrhs;
+  omega  = alpha + 2*nrhs;
+  r0rn   = alpha + 3*nrhs;
+  w      = alpha + 4*nrhs;
+  u      = alpha + 5*nrhs;
+  normb  = (double*)malloc(2*nrhs*sizeof(double));
+  norm   = normb + nrhs;
+  active    = (int*)malloc(2*nrhs*sizeof(int));
+  niter_rhs = active + nrhs;
+
+  /*************************
+   * initialize
+   *************************/
+
+  /* normb */
+  spinor_scalar_product_co_block(w, phi, phi, nrhs, VOLUME);
+  for(k=0; k<nrhs; k++) normb[k] = w[k].re;
+
+  /* p = phi - D xi */
+  for(k=0; k<nrhs; k++) xchange_field(xi[k]);
+  Q_phi_tbc_block(p_ptr, xi, nrhs);
+  for(k=0; k<nrhs; k++) {
+    iix=0;
+    for(ix=0; ix<VOLUME; ix++) {
+      _fv_eq_fv_mi_fv(p_ptr[k]+iix, phi[k]+iix, p_ptr[k]+iix);
+      iix+=24;
+    }
+    xchange_field(p_ptr[k]);
+  }
+
+  /* check the norm */
+  spinor_scalar_product_co_block(w, p_ptr, p_ptr, nrhs, VOLUME);
+  nactive = 0;
+  for(k=0; k<nrhs; k++) {
+    norm[k] = w[k].re;
+    niter_rhs[k] = 0;
+    if(g_cart_id==0) fprintf(stdout, "# [invert_Qtm_block] norm of r.-h. side %d: %e\n", k, normb[k]);
+    if(norm[k]<=solver_precision*normb[k]) {
+      if(g_cart_id==0) fprintf(stdout, "# [invert_Qtm_block] start spinor %d solves to requested precision\n", k);
+    } else {
+      active[nactive++] = k;
+      /* r1 = p = r2 */
+      memcpy((void*)r1_ptr[k], (void*)p_ptr[k], 24*VOLUME*sizeof(double));
+      memcpy((void*)r2_ptr[k], (void*)p_ptr[k], 24*VOLUME*sizeof(double));
+      r0rn[k].re = norm[k];
+      r0rn[k].im = 0.;
+    }
+  }
+
+  /*************************
+   * start iteration
+   *************************/
+  for(niter=0; niter<=niter_max && nactive>0; niter++) {
+
+    /* pointer lists for the active systems */
+    for(l=0; l<nactive; l++) {
+      k = active[l];
+      a_x[l]  = xi[k];
+      a_r1[l] = r1_ptr[k];
+      a_r2[l] = r2_ptr[k];
+      a_s[l]  = s_ptr[k];
+      a_t[l]  = t_ptr[k];
+      a_p[l]  = p_ptr[k];
+      a_p2[l] = p2_ptr[k];
+    }
+
+    /* the new p2 = D p */
+    Q_phi_tbc_block(a_p2, a_p, nactive);
+
+    spinor_scalar_product_co_block(w, a_r2, a_p2, nactive, VOLUME);
+    for(l=0; l<nactive; l++) {
+      k = active[l];
+      _co_eq_co_ti_co_inv(&alpha[k], &r0rn[k], &w[l]);
+    }
+
+    /* the new complete s */
+    for(l=0; l<nactive; l++) {
+      k = active[l];
+      iix=0;
+      for(ix=0; ix<VOLUME; ix++) {
+        _fv_eq_fv_ti_co(spinor1, a_p2[l]+iix, &alpha[k]);
+        _fv_eq_fv_mi_fv(a_s[l]+iix, a_r1[l]+iix, spinor1);
+        iix+=24;
+      }
+      xchange_field(a_s[l]);
+    }
+
+    /* the new t */
+    Q_phi_tbc_block(a_t, a_s, nactive);
+
+    spinor_scalar_product_co_block(w, a_t, a_s, nactive, VOLUME);
+    spinor_scalar_product_co_block(u, a_t, a_t, nactive, VOLUME);
+    for(l=0; l<nactive; l++) {
+      k = active[l];
+      _co_eq_co_ti_re(&omega[k], &w[l], 1./u[l].re);
+    }
+
+    /* the new x and r1 */
+    for(l=0; l<nactive; l++) {
+      k = active[l];
+      iix=0;
+      for(ix=0; ix<VOLUME; ix++) {
+        _fv_eq_fv_ti_co(spinor1, a_s[l]+iix, &omega[k]);
+        _fv_pl_eq_fv(a_x[l]+iix, spinor1);
+        _fv_eq_fv_ti_co(spinor1, a_p[l]+iix, &alpha[k]);
+        _fv_pl_eq_fv(a_x[l]+iix, spinor1);
+        _fv_eq_fv_ti_co(spinor1, a_t[l]+iix, &omega[k]);
+        _fv_eq_fv_mi_fv(a_r1[l]+iix, a_s[l]+iix, spinor1);
+        iix+=24;
+      }
+    }
+
+    spinor_scalar_product_co_block(u, a_r1, a_r1, nactive, VOLUME);
+    spinor_scalar_product_co_block(w, a_r2, a_r1, nactive, VOLUME);
+
+    for(l=0; l<nactive; l++) {
+      k = active[l];
+      norm[k] = u[l].re;
+      if(g_cart_id==0) fprintf(stdout, "# [%d] residuum %d after iteration %d: %25.16e\n", g_cart_id, k, niter, norm[k]);
+      niter_rhs[k] = niter;
+
+      _co_eq_co_ti_co_inv(&w2, &w[l], &r0rn[k]);
+      _co_eq_co_ti_co_inv(&w3, &alpha[k], &omega[k]);
+      _co_eq_co_ti_co(&beta[k], &w2, &w3);
+      r0rn[k] = w[l];
+    }
+
+    /* remove the converged systems, the new p for the others */
+    nold    = nactive;
+    nactive = 0;
+    for(l=0; l<nold; l++) {
+      k = active[l];
+      if(norm[k]<=solver_precision*normb[k]) continue;
+      active[nactive++] = k;
+      iix=0;
+      for(ix=0; ix<VOLUME; ix++) {
+        _fv_eq_fv_ti_co(spinor1, p2_ptr[k]+iix, &omega[k]);
+        _fv_eq_fv_mi_fv(spinor1, p_ptr[k]+iix, spinor1);
+        _fv_eq_fv_ti_co(spinor2, spinor1, &beta[k]);
+        _fv_eq_fv_pl_fv(p_ptr[k]+iix, r1_ptr[k]+iix, spinor2);
+        iix+=24;
+      }
+      xchange_field(p_ptr[k]);
+    }
+  }
+
+  /*************************
+   * output
+   *************************/
+  niter = 0;
+  for(k=0; k<nrhs; k++) {
+    if(norm[k]<=solver_precision*normb[k]) {
+      if(g_cart_id==0) {
+        fprintf(stdout, "# [invert_Qtm_block] BiCGStab %d converged after %d steps with relative residuum %e\n", k, niter_rhs[k], norm[k]/normb[k]);
+      }
+    } else {
+      if(g_cart_id==0) {
+        fprintf(stdout, "# [invert_Qtm_block] No convergence in BiCGStab %d; after %d steps relative residuum is %e\n", k, niter_rhs[k], norm[k]/normb[k]);
+      }
+      status = -3;
+    }
+    if(niter_rhs[k] > niter) niter = niter_rhs[k];
+  }
+
+  /*************************
+   * check the solution
+   *************************/
+  if(status == 0) {
+    for(k=0; k<nrhs; k++) xchange_field(xi[k]);
+    Q_phi_tbc_block(p_ptr, xi, nrhs);
+    for(k=0; k<nrhs; k++) {
+      iix=0;
+      for(ix=0; ix<VOLUME; ix++) {
+        _fv_mi_eq_fv(p_ptr[k]+iix, phi[k]+iix);
+        iix+=24;
+      }
+    }
+    spinor_scalar_product_co_block(w, p_ptr, p_ptr, nrhs, VOLUME);
+    if(g_cart_id==0) {
+      for(k=0; k<nrhs; k++) {
+        fprintf(stdout, "# [invert_Qtm_block] true relative squared residuum %d is %e\n", k, w[k].re/normb[k]);
+      }
+    }
+  }
+
+  free(r1_ptr);
+  free(alpha);
+  free(normb);
+  free(active);
+
+  return(status == 0 ? niter : status);
+}
+
+/****************************************************************
+ * invert_Qtm_her_mms
+ *
+ * - multi-shift CG for the tm Dirac operator with the list of
+ *   twisted masses mass[0], ..., mass[nmass-1]
+ * - CG on A(mu) = g5 Q(mu) g5 Q(-mu) = g5 Q(mu) (g5 Q(mu))^+
+ *   with r.-h. side g5 phi; the shifted systems differ only
+ *   by the shift mu_k^2 - mu_0^2, where mu_0 is the smallest |mass|
+ * - the solution of phi = Q(mu_k) xi[k] is reconstructed as
+ *   xi[k] = g5 Q(-mu_k) y_k
+ * - starts from xi[k] = 0
+ * - needs 3 + nmass work fields starting at g_spinor_field[kwork]
+ * - returns the number of iterations, -2 for missing fields
+ *   and -3 for no convergence
+ ****************************************************************/
+int invert_Qtm_her_mms(double **xi, double *phi, double *mass, int nmass, int kwork) {
+
+  int ix, iix, k, k0, niter, nactive;
+  double *r_ptr   = (double*)NULL; 
+  double *p_ptr   = (double*)NULL;
+  double *q_ptr   = (double*)NULL;
+  double *aux     = (double*)NULL;
+  double **ps_ptr = (double**)NULL;
+  double *sigma=NULL, *zeta=NULL, *zeta_old=NULL, *alpha_s=NULL, *beta_s=NULL;
+  int *active=NULL;
+  double normb, norm, norm_new, pq, alpha, alpha_old, beta, beta_old, zeta_new;
+  double spinor1[24];
+
+  /*************************
+   * set the fields
+   *************************/
+  if(nmass <= 0) return(0);
+  if(kwork + 3 + nmass > no_fields) return(-2);
+  r_ptr = g_spinor_field[kwork];
+  p_ptr = g_spinor_field[kwork+1];
+  q_ptr = g_spinor_field[kwork+2];
+  aux   = g_spinor_field[kwork+3];
+  if( r_ptr==(double*)NULL || p_ptr==(double*)NULL || q_ptr==(double*)NULL || aux==(double*)NULL || phi==(double*)NULL ) return(-2);
+  for(k=0; k<nmass; k++) {
+    if(xi[k]==(double*)NULL) return(-2);
+  }
+
+  /* the base system has the smallest mass */
+  k0 = 0;
+  for(k=1; k<nmass; k++) {
+    if(fabs(mass[k]) < fabs(mass[k0])) k0 = k;
+  }
+
+  ps_ptr   = (double**)malloc(nmass*sizeof(double*));
+  sigma    = (double*)malloc(5*nmass*sizeof(double));
+  zeta     = sigma +   nmass;
+  zeta_old = sigma + 2*nmass;
+  alpha_s  = sigma + 3*nmass;
+  beta_s   = sigma + 4*nmass;
+  active   = (int*)malloc(nmass*sizeof(int));
+  if(ps_ptr==NULL || sigma==NULL || active==NULL) {
+    fprintf(stderr, "[invert_Qtm_her_mms] Error, could not allocate memory\n");
+    free(ps_ptr);
+    free(sigma);
+    free(active);
+    return(-2);
+  }
+  ix = 4;
+  for(k=0; k<nmass; k++) {
+    ps_ptr[k] = k==k0 ? p_ptr : g_spinor_field[kwork + ix++];
+    if(ps_ptr[k]==(double*)NULL) {
+      free(ps_ptr);
+      free(sigma);
+      free(active);
+      return(-2);
+    }
+    sigma[k]    = mass[k]*mass[k] - mass[k0]*mass[k0];
+    zeta[k]     = 1.;
+    zeta_old[k] = 1.;
+    active[k]   = 1;
+  }
+
+  /*************************
+   * initialize
+   *************************/
+
+  /* r = p_k = g5 phi, y_k = 0 */
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    _fv_eq_gamma_ti_fv(r_ptr+iix, 5, phi+iix);
+    iix+=24;
+  }
+  for(k=0; k<nmass; k++) {
+    memcpy((void*)ps_ptr[k], (void*)r_ptr, 24*VOLUME*sizeof(double));
+    memset((void*)xi[k], 0, 24*VOLUME*sizeof(double));
+  }
+  spinor_scalar_product_re(&normb, r_ptr, r_ptr, VOLUME);
+  if(g_cart_id==0) fprintf(stdout, "# norm of r.-h. side: %e\n", normb);
+  norm      = normb;
+  alpha_old = 1.;
+  beta_old  = 0.;
+  nactive   = nmass;
+
+  /*************************
+   * start iteration
+   *************************/
+  for(niter=0; niter<=niter_max; niter++) {
+
+    /* q = A(mu_0) p */
+    xchange_field(p_ptr);
+    Qf5(aux, p_ptr, -mass[k0]);
+    xchange_field(aux);
+    Qf5(q_ptr, aux, mass[k0]);
+
+    spinor_scalar_product_re(&pq, p_ptr, q_ptr, VOLUME);
+    alpha = norm / pq;
+
+    /* coefficients of the shifted systems */
+    for(k=0; k<nmass; k++) {
+      if(k==k0) {
+        zeta_new   = 1.;
+        alpha_s[k] = alpha;
+      } else if(active[k]) {
+        zeta_new = zeta[k] * zeta_old[k] * alpha_old /
+          ( alpha * beta_old * (zeta_old[k] - zeta[k]) + zeta_old[k] * alpha_old * (1. + sigma[k] * alpha) );
+        alpha_s[k] = alpha * zeta_new / zeta[k];
+      } else {
+        continue;
+      }
+      beta_s[k]   = zeta_new / zeta[k];
+      zeta_old[k] = zeta[k];
+      zeta[k]     = zeta_new;
+
+      /* the new y_k */
+      iix=0;
+      for(ix=0; ix<VOLUME; ix++) {
+        _fv_eq_fv_ti_re(spinor1, ps_ptr[k]+iix, alpha_s[k]);
+        _fv_pl_eq_fv(xi[k]+iix, spinor1);
+        iix+=24;
+      }
+    }
+
+    /* the new r */
+    iix=0;
+    for(ix=0; ix<VOLUME; ix++) {
+      _fv_eq_fv_ti_re(spinor1, q_ptr+iix, alpha);
+      _fv_mi_eq_fv(r_ptr+iix, spinor1);
+      iix+=24;
+    }
+
+    spinor_scalar_product_re(&norm_new, r_ptr, r_ptr, VOLUME);
+    if(g_cart_id==0) fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm_new);
+    if(norm_new<=solver_precision*normb) break;
+
+    beta = norm_new / norm;
+
+    /* the new p_k, remove the converged shifted systems */
+    for(k=0; k<nmass; k++) {
+      if(!active[k]) continue;
+      if(k!=k0 && zeta[k]*zeta[k]*norm_new<=solver_precision*normb) {
+        if(g_cart_id==0) fprintf(stdout, "# [invert_Qtm_her_mms] mass %d converged after %d steps\n", k, niter);
+        active[k] = 0;
+        nactive--;
+        continue;
+      }
+      beta_s[k] = beta * beta_s[k] * beta_s[k];
+      iix=0;
+      for(ix=0; ix<VOLUME; ix++) {
+        _fv_eq_fv_ti_re(spinor1, ps_ptr[k]+iix, beta_s[k]);
+        _fv_eq_fv_ti_re(ps_ptr[k]+iix, r_ptr+iix, zeta[k]);
+        _fv_pl_eq_fv(ps_ptr[k]+iix, spinor1);
+        iix+=24;
+      }
+    }
+
+    norm      = norm_new;
+    alpha_old = alpha;
+    beta_old  = beta;
+  }
+
+  /*************************
+   * output
+   *************************/
+  if(norm_new<=solver_precision*normb && niter<=niter_max) {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# CG-M converged after %d steps with relative residuum %e\n", niter, norm_new/normb);
+    }
+  } else {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# No convergence in CG-M; after %d steps relative residuum is %e\n", niter, norm_new/normb);
+    }
+    niter = -3;
+  }
+
+  /*************************
+   * xi[k] = g5 Q(-mu_k) y_k,
+   * check the solutions
+   *************************/
+  for(k=0; k<nmass && niter>=0; k++) {
+    xchange_field(xi[k]);
+    Qf5(aux, xi[k], -mass[k]);
+    memcpy((void*)xi[k], (void*)aux, 24*VOLUME*sizeof(double));
+    xchange_field(xi[k]);
+    Q_phi(q_ptr, xi[k], mass[k]);
+    iix=0;
+    for(ix=0; ix<VOLUME; ix++) {
+      _fv_mi_eq_fv(q_ptr+iix, phi+iix);
+      iix+=24;
+    }
+    spinor_scalar_product_re(&norm, q_ptr, q_ptr, VOLUME);
+    if(g_cart_id==0) {
+      fprintf(stdout, "# mass %d mu = %e true relative squared residuum is %e\n", k, mass[k], norm/normb);
+    }
+  }
+
+  free(ps_ptr);
+  free(sigma);
+  free(active);
+
+  return(niter);
+}
+
+/*****************************************************
+ * y = A x with the hermitian operator of
+ * invert_Qtm_her and invert_Q_Wilson_her
+ *
+ * - tm:     A = g5 Q(mu) g5 Q(-mu)
+ * - Wilson: A = g5 D_W
+ * - x is exchanged here; aux is a work field for tm
+ *****************************************************/
+void apply_Q_her(double *y, double *x, double *aux, int fermion_type) {
+  xchange_field(x);
+  if(fermion_type == _TM_FERMION) {
+    Qf5(aux, x, -g_mu);
+    xchange_field(aux);
+    Qf5(y, aux, g_mu);
+  } else {
+    Q_g5_Wilson_phi(y, x);
+  }
+}
+
+/*****************************************************
+ * final solution and true residual for the
+ * hermitian problems, xi = g5 Q(-mu) y for tm;
+ * r is overwritten
+ *****************************************************/
+static void her_final_solution(double *x, double *aux, int fermion_type) {
+  xchange_field(x);
+  if(fermion_type == _TM_FERMION) {
+    Qf5(aux, x, -g_mu);
+    memcpy((void*)x, (void*)aux, 24*VOLUME*sizeof(double));
+    xchange_field(x);
+  }
+}
+
+static void her_check_solution(double *r, double *x, double *phi, double normb, int fermion_type) {
+  int ix, iix;
+  double norm;
+
+  if(fermion_type == _TM_FERMION) {
+    Q_phi_tbc(r, x);
+  } else {
+    Q_Wilson_phi(r, x);
+  }
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    _fv_mi_eq_fv(r+iix, phi+iix);
+    iix+=24;
+  }
+  spinor_scalar_product_re(&norm, r, r, VOLUME);
+  if(g_cart_id==0) {
+    fprintf(stdout, "# true relative squared residuum is %e\n", norm/normb);
+  }
+}
+
+/*****************************************************
+ * pipelined CG for the hermitian problems
+ * solved by invert_Qtm_her and invert_Q_Wilson_her
+ *
+ * - tm:     A = g5 Q(mu) g5 Q(-mu), b = g5 phi,
+ *           xi = g5 Q(-mu) y
+ * - Wilson: A = g5 D_W, b = g5 phi, xi = y
+ *
+ * - Ghysels-Vanroose recurrences without preconditioner;
+ *   the scalar products <r, r> and <w, r> are reduced
+ *   with a non-blocking MPI_Iallreduce while A w is
+ *   applied
+ * - one operator application, one reduction and one
+ *   fused vector update per iteration
+ * - work fields: r, w, p, s, z, n (+ aux for tm)
+ *****************************************************/
+static int invert_her_pipelined(double *xi, double *phi, int kwork, int fermion_type) {
+
+  int ix, iix, niter, nwork;
+  double *r_ptr=NULL, *w_ptr=NULL, *p_ptr=NULL, *s_ptr=NULL, *z_ptr=NULL, *n_ptr=NULL, *aux=NULL;
+  double *x_ptr = xi;
+  double normb, norm=0., gamma=0., gamma_old=0., delta=0., alpha=0., alpha_old=0., beta=0.;
+  double buffer[2];
+  double spinor1[24];
+  complex c;
+#ifdef MPI
+  MPI_Request request;
+  MPI_Status status;
+#endif
+
+  nwork = fermion_type == _TM_FERMION ? 7 : 6;
+  if(kwork+nwork > no_fields) return(-2);
+
+  /*************************
+   * set the fields
+   *************************/
+  r_ptr = g_spinor_field[kwork  ];
+  w_ptr = g_spinor_field[kwork+1];
+  p_ptr = g_spinor_field[kwork+2];
+  s_ptr = g_spinor_field[kwork+3];
+  z_ptr = g_spinor_field[kwork+4];
+  n_ptr = g_spinor_field[kwork+5];
+  if(fermion_type == _TM_FERMION) aux = g_spinor_field[kwork+6];
+
+  if( r_ptr==NULL || w_ptr==NULL || p_ptr==NULL || s_ptr==NULL || z_ptr==NULL || n_ptr==NULL ||
+      (fermion_type==_TM_FERMION && aux==NULL) || x_ptr==NULL || phi==NULL ) return(-2);
+
+  /* normb */
+  spinor_scalar_product_re(&normb, phi, phi, VOLUME);
+  if(g_cart_id==0) fprintf(stdout, "# norm of r.-h. side: %e\n", normb);
+
+  /* r = gamma5 phi - A xi, w = A r */
+  apply_Q_her(r_ptr, x_ptr, aux, fermion_type);
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    _fv_eq_gamma_ti_fv(spinor1, 5, phi+iix);
+    _fv_eq_fv_mi_fv(r_ptr+iix, spinor1, r_ptr+iix);
+    iix+=24;
+  }
+  apply_Q_her(w_ptr, r_ptr, aux, fermion_type);
+
+  memset(p_ptr, 0, 24*VOLUME*sizeof(double));
+  memset(s_ptr, 0, 24*VOLUME*sizeof(double));
+  memset(z_ptr, 0, 24*VOLUME*sizeof(double));
+
+  /* local parts of <r, r> and <w, r> */
+  buffer[0] = 0.; buffer[1] = 0.;
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    _co_eq_fv_dag_ti_fv(&c, r_ptr+iix, r_ptr+iix);
+    buffer[0] += c.re;
+    _co_eq_fv_dag_ti_fv(&c, w_ptr+iix, r_ptr+iix);
+    buffer[1] += c.re;
+    iix+=24;
+  }
+
+  /*************************
+   * start iteration
+   *************************/
+  for(niter=0; niter<=niter_max; niter++) {
+
+    /* reduce <r, r>, <w, r> while n = A w is computed */
+#ifdef MPI
+    MPI_Iallreduce(MPI_IN_PLACE, buffer, 2, MPI_DOUBLE, MPI_SUM, g_cart_grid, &request);
+#endif
+    apply_Q_her(n_ptr, w_ptr, aux, fermion_type);
+#ifdef MPI
+    MPI_Wait(&request, &status);
+#endif
+    gamma = buffer[0];
+    delta = buffer[1];
+
+    norm = gamma;
+    if(g_cart_id==0) fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
+    if(norm<=solver_precision*normb) break;
+
+    if(niter > 0) {
+      beta  = gamma / gamma_old;
+      alpha = gamma / ( delta - beta * gamma / alpha_old );
+    } else {
+      beta  = 0.;
+      alpha = gamma / delta;
+    }
+    gamma_old = gamma;
+    alpha_old = alpha;
+
+    /* z = n + beta z, s = w + beta s, p = r + beta p,
+     * x = x + alpha p, r = r - alpha s, w = w - alpha z;
+     * local parts of the new <r, r> and <w, r> */
+    buffer[0] = 0.; buffer[1] = 0.;
+    iix=0;
+    for(ix=0; ix<VOLUME; ix++) {
+      _fv_eq_fv_ti_re(spinor1, z_ptr+iix, beta);
+      _fv_eq_fv_pl_fv(z_ptr+iix, n_ptr+iix, spinor1);
+      _fv_eq_fv_ti_re(spinor1, s_ptr+iix, beta);
+      _fv_eq_fv_pl_fv(s_ptr+iix, w_ptr+iix, spinor1);
+      _fv_eq_fv_ti_re(spinor1, p_ptr+iix, beta);
+      _fv_eq_fv_pl_fv(p_ptr+iix, r_ptr+iix, spinor1);
+
+      _fv_eq_fv_ti_re(spinor1, p_ptr+iix, alpha);
+      _fv_pl_eq_fv(x_ptr+iix, spinor1);
+      _fv_eq_fv_ti_re(spinor1, s_ptr+iix, alpha);
+      _fv_mi_eq_fv(r_ptr+iix, spinor1);
+      _fv_eq_fv_ti_re(spinor1, z_ptr+iix, alpha);
+      _fv_mi_eq_fv(w_ptr+iix, spinor1);
+
+      _co_eq_fv_dag_ti_fv(&c, r_ptr+iix, r_ptr+iix);
+      buffer[0] += c.re;
+      _co_eq_fv_dag_ti_fv(&c, w_ptr+iix, r_ptr+iix);
+      buffer[1] += c.re;
+      iix+=24;
+    }
+  }
+
+  /*******************************
+   * get final solution
+   *******************************/
+  her_final_solution(x_ptr, aux, fermion_type);
+
+  /*************************
+   * output
+   *************************/
+  if(norm<=solver_precision*normb && niter<=niter_max) {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# pipelined CG converged after %d steps with relative residuum %e\n", niter, norm/normb);
+    }
+  } else {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# No convergence in pipelined CG; after %d steps relative residuum is %e\n", niter, norm/normb);
+    }
+    return(-3);
+  }
+
+  /*************************
+   * check the solution
+   *************************/
+  her_check_solution(r_ptr, x_ptr, phi, normb, fermion_type);
+
+  return(niter);
+}
+
+int invert_Qtm_her_pipelined(double *xi, double *phi, int kwork) {
+  return(invert_her_pipelined(xi, phi, kwork, _TM_FERMION));
+}
+
+int invert_Q_Wilson_her_pipelined(double *xi, double *phi, int kwork) {
+  return(invert_her_pipelined(xi, phi, kwork, _WILSON_FERMION));
+}
+
+/*****************************************************
+ * deflated CG for the hermitian problems
+ * solved by invert_Qtm_her and invert_Q_Wilson_her
+ *
+ * - the start vector is corrected with the low-mode
+ *   eigenspace of A set up by init_deflation,
+ *   y += V Lambda^{-1} V^dagger (b - A y),
+ *   after which plain CG works on the deflated
+ *   condition number
+ * - without eigenspace this is the undeflated CG
+ * - work fields: r, p, q (+ aux for tm)
+ *****************************************************/
+static int invert_her_deflated(double *xi, double *phi, int kwork, int fermion_type) {
+
+  int ix, iix, niter, nwork, ndefl;
+  double *r_ptr=NULL, *p_ptr=NULL, *q_ptr=NULL, *aux=NULL;
+  double *x_ptr = xi;
+  double normb, norm=0., norm_new, alpha, beta, pq;
+  double spinor1[24];
+  complex c;
+
+  nwork = fermion_type == _TM_FERMION ? 4 : 3;
+  if(kwork+nwork > no_fields) return(-2);
+
+  /*************************
+   * set the fields
+   *************************/
+  r_ptr = g_spinor_field[kwork  ];
+  p_ptr = g_spinor_field[kwork+1];
+  q_ptr = g_spinor_field[kwork+2];
+  if(fermion_type == _TM_FERMION) aux = g_spinor_field[kwork+3];
+
+  if( r_ptr==NULL || p_ptr==NULL || q_ptr==NULL || (fermion_type==_TM_FERMION && aux==NULL) ||
+      x_ptr==NULL || phi==NULL ) return(-2);
+
+  /* normb */
+  spinor_scalar_product_re(&normb, phi, phi, VOLUME);
+  if(g_cart_id==0) fprintf(stdout, "# norm of r.-h. side: %e\n", normb);
+
+  /* q = gamma5 phi, r = q - A xi */
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    _fv_eq_gamma_ti_fv(q_ptr+iix, 5, phi+iix);
+    iix+=24;
+  }
+  apply_Q_her(r_ptr, x_ptr, aux, fermion_type);
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    _fv_eq_fv_mi_fv(r_ptr+iix, q_ptr+iix, r_ptr+iix);
+    iix+=24;
+  }
+
+  /* deflate the start vector and recompute the residual */
+  ndefl = deflate_her(x_ptr, r_ptr, fermion_type);
+  if(ndefl > 0) {
+    apply_Q_her(r_ptr, x_ptr, aux, fermion_type);
+    iix=0;
+    for(ix=0; ix<VOLUME; ix++) {
+      _fv_eq_fv_mi_fv(r_ptr+iix, q_ptr+iix, r_ptr+iix);
+      iix+=24;
+    }
+  }
+  if(g_cart_id==0) fprintf(stdout, "# deflated start vector with %d eigenvectors\n", ndefl);
+
+  memcpy((void*)p_ptr, (void*)r_ptr, 24*VOLUME*sizeof(double));
+  spinor_scalar_product_re(&norm, r_ptr, r_ptr, VOLUME);
+
+  /*************************
+   * start iteration
+   *************************/
+  for(niter=0; niter<=niter_max; niter++) {
+    if(g_cart_id==0) fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
+    if(norm<=solver_precision*normb) break;
+
+    apply_Q_her(q_ptr, p_ptr, aux, fermion_type);
+    spinor_scalar_product_re(&pq, p_ptr, q_ptr, VOLUME);
+    alpha = norm / pq;
+
+    /* x = x + alpha p, r = r - alpha q, local part of <r, r> */
+    norm_new = 0.;
+    iix=0;
+    for(ix=0; ix<VOLUME; ix++) {
+      _fv_eq_fv_ti_re(spinor1, p_ptr+iix, alpha);
+      _fv_pl_eq_fv(x_ptr+iix, spinor1);
+      _fv_eq_fv_ti_re(spinor1, q_ptr+iix, alpha);
+      _fv_mi_eq_fv(r_ptr+iix, spinor1);
+      _co_eq_fv_dag_ti_fv(&c, r_ptr+iix, r_ptr+iix);
+      norm_new += c.re;
+      iix+=24;
+    }
+#ifdef MPI
+    MPI_Allreduce(MPI_IN_PLACE, &norm_new, 1, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#endif
+    beta = norm_new / norm;
+    norm = norm_new;
+
+    /* p = r + beta p */
+    iix=0;
+    for(ix=0; ix<VOLUME; ix++) {
+      _fv_eq_fv_ti_re(spinor1, p_ptr+iix, beta);
+      _fv_eq_fv_pl_fv(p_ptr+iix, r_ptr+iix, spinor1);
+      iix+=24;
+    }
+  }
+
+  /*******************************
+   * get final solution
+   *******************************/
+  her_final_solution(x_ptr, aux, fermion_type);
+
+  /*************************
+   * output
+   *************************/
+  if(norm<=solver_precision*normb && niter<=niter_max) {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# deflated CG converged after %d steps with relative residuum %e\n", niter, norm/normb);
+    }
+  } else {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# No convergence in deflated CG; after %d steps relative residuum is %e\n", niter, norm/normb);
+    }
+    return(-3);
+  }
+
+  /*************************
+   * check the solution
+   *************************/
+  her_check_solution(r_ptr, x_ptr, phi, normb, fermion_type);
+
+  return(niter);
+}
+
+int invert_Qtm_her_deflated(double *xi, double *phi, int kwork) {
+  return(invert_her_deflated(xi, phi, kwork, _TM_FERMION));
+}
+
+int invert_Q_Wilson_her_deflated(double *xi, double *phi, int kwork) {
+  return(invert_her_deflated(xi, phi, kwork, _WILSON_FERMION));
+}
+
+/*****************************************************
+ * BiCGStab on AoSoA fields (Q_phi_simd.h)
+ *
+ * - same recurrences and fused updates as invert_Qtm,
+ *   with all Krylov fields kept in the AoSoA layout and
+ *   D applied by the vectorized Q_phi_tbc_aosoa
+ * - complex component c of the sites of block ib is
+ *   stored at 2*_AOSOA_BLOCK*(12*ib+c) (real parts) and
+ *   _AOSOA_BLOCK further (imaginary parts), so the
+ *   updates run over 12*V/_AOSOA_BLOCK such rows
+ *****************************************************/
+
+/* s = r - alpha p2 */
+static void bicgstab_update_s_aosoa(double *s, double *r, double *p2, complex *alpha, int V) {
+
+  int i, l;
+  double *s_, *r_, *p2_;
+
+  for(i=0; i<12*V/_AOSOA_BLOCK; i++) {
+    s_  = s  + 2*_AOSOA_BLOCK*i;
+    r_  = r  + 2*_AOSOA_BLOCK*i;
+    p2_ = p2 + 2*_AOSOA_BLOCK*i;
+    for(l=0; l<_AOSOA_BLOCK; l++) {
+      s_[l]              = r_[l]              - alpha->re * p2_[l] + alpha->im * p2_[_AOSOA_BLOCK+l];
+      s_[_AOSOA_BLOCK+l] = r_[_AOSOA_BLOCK+l] - alpha->re * p2_[_AOSOA_BLOCK+l] - alpha->im * p2_[l];
+    }
+  }
+}
+
+/* w = <t, s>, u = <t, t> */
+static void bicgstab_dot_ts_aosoa(complex *w, double *u, double *t, double *s, int V) {
+
+  int i, l;
+  double *t_, *s_;
+  double buffer[3];
+
+  buffer[0] = 0.; buffer[1] = 0.; buffer[2] = 0.;
+  for(i=0; i<12*V/_AOSOA_BLOCK; i++) {
+    t_ = t + 2*_AOSOA_BLOCK*i;
+    s_ = s + 2*_AOSOA_BLOCK*i;
+    for(l=0; l<_AOSOA_BLOCK; l++) {
+      buffer[0] += t_[l] * s_[l] + t_[_AOSOA_BLOCK+l] * s_[_AOSOA_BLOCK+l];
+      buffer[1] += t_[l] * s_[_AOSOA_BLOCK+l] - t_[_AOSOA_BLOCK+l] * s_[l];
+      buffer[2] += t_[l] * t_[l] + t_[_AOSOA_BLOCK+l] * t_[_AOSOA_BLOCK+l];
+    }
+  }
+#ifdef MPI
+  MPI_Allreduce(MPI_IN_PLACE, buffer, 3, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#endif
+  w->re = buffer[0];
+  w->im = buffer[1];
+  *u    = buffer[2];
+}
+
+/* r = s - omega t, x = x + alpha p + omega s,
+ * norm = <r, r>, w = <r0, r> */
+static void bicgstab_update_rx_aosoa(double *r, double *x, double *s, double *t, double *p, double *r0,
+  complex *alpha, complex *omega, double *norm, complex *w, int V) {
+
+  int i, l;
+  double *r_, *x_, *s_, *t_, *p_, *r0_;
+  double buffer[3];
+
+  buffer[0] = 0.; buffer[1] = 0.; buffer[2] = 0.;
+  for(i=0; i<12*V/_AOSOA_BLOCK; i++) {
+    r_  = r  + 2*_AOSOA_BLOCK*i;
+    x_  = x  + 2*_AOSOA_BLOCK*i;
+    s_  = s  + 2*_AOSOA_BLOCK*i;
+    t_  = t  + 2*_AOSOA_BLOCK*i;
+    p_  = p  + 2*_AOSOA_BLOCK*i;
+    r0_ = r0 + 2*_AOSOA_BLOCK*i;
+    for(l=0; l<_AOSOA_BLOCK; l++) {
+      r_[l]              = s_[l]              - omega->re * t_[l] + omega->im * t_[_AOSOA_BLOCK+l];
+      r_[_AOSOA_BLOCK+l] = s_[_AOSOA_BLOCK+l] - omega->re * t_[_AOSOA_BLOCK+l] - omega->im * t_[l];
+
+      x_[l]              += alpha->re * p_[l] - alpha->im * p_[_AOSOA_BLOCK+l]
+                          + omega->re * s_[l] - omega->im * s_[_AOSOA_BLOCK+l];
+      x_[_AOSOA_BLOCK+l] += alpha->re * p_[_AOSOA_BLOCK+l] + alpha->im * p_[l]
+                          + omega->re * s_[_AOSOA_BLOCK+l] + omega->im * s_[l];
+
+      buffer[0] += r_[l] * r_[l] + r_[_AOSOA_BLOCK+l] * r_[_AOSOA_BLOCK+l];
+      buffer[1] += r0_[l] * r_[l] + r0_[_AOSOA_BLOCK+l] * r_[_AOSOA_BLOCK+l];
+      buffer[2] += r0_[l] * r_[_AOSOA_BLOCK+l] - r0_[_AOSOA_BLOCK+l] * r_[l];
+    }
+  }
+#ifdef MPI
+  MPI_Allreduce(MPI_IN_PLACE, buffer, 3, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#endif
+  *norm = buffer[0];
+  w->re = buffer[1];
+  w->im = buffer[2];
+}
+
+/* p = r + beta (p - omega p2) */
+static void bicgstab_update_p_aosoa(double *p, double *r, double *p2, complex *omega, complex *beta, int V) {
+
+  int i, l;
+  double *p_, *r_, *p2_;
+  double qre, qim;
+
+  for(i=0; i<12*V/_AOSOA_BLOCK; i++) {
+    p_  = p  + 2*_AOSOA_BLOCK*i;
+    r_  = r  + 2*_AOSOA_BLOCK*i;
+    p2_ = p2 + 2*_AOSOA_BLOCK*i;
+    for(l=0; l<_AOSOA_BLOCK; l++) {
+      qre = p_[l]              - omega->re * p2_[l] + omega->im * p2_[_AOSOA_BLOCK+l];
+      qim = p_[_AOSOA_BLOCK+l] - omega->re * p2_[_AOSOA_BLOCK+l] - omega->im * p2_[l];
+      p_[l]              = r_[l]              + beta->re * qre - beta->im * qim;
+      p_[_AOSOA_BLOCK+l] = r_[_AOSOA_BLOCK+l] + beta->re * qim + beta->im * qre;
+    }
+  }
+}
+
+/* iteration of invert_Qtm on AoSoA fields;
+ * work fields: r1, r2, s, t, p, p2 */
+static int bicgstab_aosoa(double *x_ptr, double *b_ptr, double **work, double normb) {
+
+  int i, niter;
+  double *r1_ptr = work[0];
+  double *r2_ptr = work[1];
+  double *s_ptr  = work[2];
+  double *t_ptr  = work[3];
+  double *p_ptr  = work[4];
+  double *p2_ptr = work[5];
+  double u, norm;
+  complex alpha, beta, omega;
+  complex w, w2, w3, r0rn;
+
+  /* p = phi - D xi */
+  xchange_field_aosoa(x_ptr);
+  Q_phi_tbc_aosoa(p_ptr, x_ptr);
+  norm = 0.;
+  for(i=0; i<24*VOLUME; i++) {
+    p_ptr[i] = b_ptr[i] - p_ptr[i];
+    norm += p_ptr[i] * p_ptr[i];
+  }
+#ifdef MPI
+  MPI_Allreduce(MPI_IN_PLACE, &norm, 1, MPI_DOUBLE, MPI_SUM, g_cart_grid);
+#endif
+  if(norm<=solver_precision*normb) {
+    if(g_cart_id==0) fprintf(stdout, "start spinor solves to requested precision\n");
+    return(0);
+  }
+
+  /* r1 = p = r2 */
+  memcpy((void*)r1_ptr, (void*)p_ptr, 24*VOLUME*sizeof(double));
+  memcpy((void*)r2_ptr, (void*)p_ptr, 24*VOLUME*sizeof(double));
+
+  /* p2 = D p */
+  xchange_field_aosoa(p_ptr);
+  Q_phi_tbc_aosoa(p2_ptr, p_ptr);
+
+  /* r0rn = <r2, r1> = <p, p> */
+  r0rn.re = norm; r0rn.im = 0.;
+
+  for(niter=0; niter<=niter_max; niter++) {
+
+    bicgstab_dot_ts_aosoa(&w, &u, r2_ptr, p2_ptr, VOLUME);
+    _co_eq_co_ti_co_inv(&alpha, &r0rn, &w);
+
+    bicgstab_update_s_aosoa(s_ptr, r1_ptr, p2_ptr, &alpha, VOLUME);
+
+    xchange_field_aosoa(s_ptr);
+    Q_phi_tbc_aosoa(t_ptr, s_ptr);
+
+    bicgstab_dot_ts_aosoa(&w, &u, t_ptr, s_ptr, VOLUME);
+    _co_eq_co_ti_re(&omega, &w, 1./u);
+
+    bicgstab_update_rx_aosoa(r1_ptr, x_ptr, s_ptr, t_ptr, p_ptr, r2_ptr, &alpha, &omega, &norm, &w, VOLUME);
+    if(g_cart_id==0) fprintf(stdout, "# [%d] residuum after iteration %d: %25.16e\n", g_cart_id, niter, norm);
+    if(norm<=solver_precision*normb) break;
+
+    _co_eq_co_ti_co_inv(&w2, &w, &r0rn);
+    _co_eq_co_ti_co_inv(&w3, &alpha, &omega);
+    _co_eq_co_ti_co(&beta, &w2, &w3);
+    r0rn.re = w.re; r0rn.im = w.im;
+
+    bicgstab_update_p_aosoa(p_ptr, r1_ptr, p2_ptr, &omega, &beta, VOLUME);
+
+    xchange_field_aosoa(p_ptr);
+    Q_phi_tbc_aosoa(p2_ptr, p_ptr);
+  }
+
+  if(norm<=solver_precision*normb && niter<=niter_max) {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# SIMD BiCGStab converged after %d steps with relative residuum %e\n", niter, norm/normb);
+    }
+  } else {
+    if(g_cart_id==0) {
+      fprintf(stdout, "# No convergence in SIMD BiCGStab; after %d steps relative residuum is %e\n", niter, norm/normb);
+    }
+    return(-3);
+  }
+  return(niter);
+}
+
+/*****************************************************
+ * invert_Qtm_simd
+ * - solve phi = D_tm xi with BiCGStab on AoSoA fields;
+ *   xi and phi are converted once per solve
+ * - used by invert_Qtm and invert_Qtm_her for
+ *   inverter_type = simd_bicgstab
+ * - the true residual is computed with Q_phi_tbc in
+ *   g_spinor_field[kwork]
+ *****************************************************/
+int invert_Qtm_simd(double *xi, double *phi, int kwork) {
+
+  int i, ix, iix, niter;
+  double *work[8];
+  double *r_ptr = NULL;
+  double norm, normb;
+
+  if(kwork >= no_fields) return(-2);
+  r_ptr = g_spinor_field[kwork];
+  if(r_ptr==(double*)NULL || xi==(double*)NULL || phi==(double*)NULL) return(-2);
+
+  if(init_Q_phi_simd() != 0) return(-2);
+  for(i=0; i<8; i++) alloc_spinor_field_aosoa(&work[i], VOLUMEPLUSRAND);
+
+  /* normb */
+  spinor_scalar_product_re(&normb, phi, phi, VOLUME);
+  if(g_cart_id==0) fprintf(stdout, "# norm of r.-h. side: %e\n", normb);
+
+  spinor_field_aos_to_aosoa(work[0], phi, VOLUME);
+  spinor_field_aos_to_aosoa(work[1], xi, VOLUME);
+
+  niter = bicgstab_aosoa(work[1], work[0], work+2, normb);
+
+  spinor_field_aosoa_to_aos(xi, work[1], VOLUME);
+  xchange_field(xi);
+  for(i=0; i<8; i++) free(work[i]);
+  free_Q_phi_simd();
+  if(niter < 0) return(niter);
+
+  /*************************
+   * check the solution
+   *************************/
+  Q_phi_tbc(r_ptr, xi);
+  iix=0;
+  for(ix=0; ix<VOLUME; ix++) {
+    _fv_mi_eq_fv(r_ptr+iix, phi+iix);
+    iix+=24;
+  }
+  spinor_scalar_product_re(&norm, r_ptr, r_ptr, VOLUME);
+  if(g_cart_id==0) {
+    fprintf(stdout, "# true relative squared residuum is %e\n", norm/normb);
+  }
+
+  return(niter);
+}
@@ -8,8 +8,27 @@ void spinor_scalar_product_re(double *r, double *xi, double *phi, int V);
 void spinor_scalar_product_co(complex *w, double *xi, double *phi, int V);
 int invert_Qtm(double *xi, double *phi, int kwork);
 int invert_Qtm_her(double *xi, double *phi, int kwork);
+int invert_Qtm_simd(double *xi, double *phi, int kwork);
+int invert_Qtm_block(double **xi, double **phi, int nrhs, int kwork);
+int invert_Qtm_her_mms(double **xi, double *phi, double *mass, int nmass, int kwork);
+int invert_Qtm_her_pipelined(double *xi, double *phi, int kwork);
+int invert_Q_Wilson_her_pipelined(double *xi, double *phi, int kwork);
+int invert_Qtm_her_deflated(double *xi, double *phi, int kwork);
+int invert_Q_Wilson_her_deflated(double *xi, double *phi, int kwork);
+void apply_Q_her(double *y, double *x, double *aux, int fermion_type);
 int invert_Q_Wilson(double *xi, double *phi, int kwork);
 int invert_Q_Wilson_her(double *xi, double *phi, int kwork);
 int invert_Q_DW_Wilson(double *xi, double *phi, int kwork);
 int invert_Q_DW_Wilson_her(double *xi, double *phi, int kwork);
+int invert_Q_DW_Mobius_eo(double *xi, double *phi, int kwork);
+
+void spinor_scalar_product_re_eo(double *r, double *xi, double *phi, int ieo);
+void spinor_scalar_product_co_eo(complex *w, double *xi, double *phi, int ieo);
+int invert_Qtm_eo(double *xi, double *phi, int kwork);
+int invert_Q_Wilson_eo(double *xi, double *phi, int kwork);
+
+void spinor_scalar_product_re_flt(double *r, float *xi, float *phi, int V);
+void spinor_scalar_product_co_flt(complex *w, float *xi, float *phi, int V);
+int invert_Qtm_mixed(double *xi, double *phi, int kwork);
+int invert_Q_Wilson_mixed(double *xi, double *phi, int kwork);
 #endif
@@ -52,6 +52,7 @@ extern "C" {
 #include "Q_phi.h"
 #include "read_input_parser.h"
 #include "invert_Qtm.h"
+#include "Q_mobius_phi.h"
 #include "gauge_io.h"
 #include "smearing_techniques.h"
 #include "prepare_source.h"
@@ -106,6 +107,7 @@ int main(int argc, char **argv) {
   double ratime, retime;
   double plaq_r=0., plaq_m=0., norm, norm2;
   double spinor1[24];
+  double *work = NULL;
   double *gauge_qdp[4], *gauge_field_timeslice=NULL, *gauge_field_smeared=NULL;
   double _1_2_kappa, _2_kappa, phase;
   FILE *ofs;
@@ -492,6 +494,16 @@ int main(int argc, char **argv) {
   g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
   for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOLUMEPLUSRAND*L5);
 
+  // the Moebius operator of Q_mobius_phi.c for the residuum check and the
+  //   even/odd solver, set up once per run
+  if(g_b5 != 1. || g_c5 != 0. || g_inverter_type == _EO_CG_INVERTER) {
+    if(init_Q_DW_Mobius() != 0) {
+      if(g_cart_id==0) fprintf(stderr, "[invert_dw_quda] Error from init_Q_DW_Mobius\n");
+      EXIT(6);
+    }
+    alloc_spinor_field(&work, VOLUMEPLUSRAND*L5);
+  }
+
   switch(g_source_type) {
     case 0:
     case 5:
@@ -1050,7 +1062,15 @@ int main(int argc, char **argv) {
         }
 #endif
 
-        Q_DW_Wilson_phi(g_spinor_field[2], g_spinor_field[1]);
+        if(g_b5 != 1. || g_c5 != 0.) {
+          // Moebius parameters: apply the operator of Q_mobius_phi.c in the s-inner layout
+          spinor_field_5d_to_sinner(g_spinor_field[2], g_spinor_field[1]);
+          xchange_field_sinner(g_spinor_field[2]);
+          Q_DW_Mobius_phi(work, g_spinor_field[2]);
+          spinor_field_sinner_to_5d(g_spinor_field[2], work);
+        } else {
+          Q_DW_Wilson_phi(g_spinor_field[2], g_spinor_field[1]);
+        }
   
         for(ix=0;ix<VOLUME*L5;ix++) {
           _fv_mi_eq_fv(g_spinor_field[2]+_GSI(ix), g_spinor_field[0]+_GSI(ix));
@@ -1131,6 +1151,8 @@ int main(int argc, char **argv) {
       free(g_spinor_field);
     }
   }
+  free_Q_DW_Mobius();
+  if(work != NULL) free(work);
   free_geometry();
 
   if(g_source_momentum_set && full_orbit) {
@@ -7,6 +7,9 @@
  *
  * read_lime_gauge_field_singleprec
  *
+ * without LEMON the MPI versions read collectively
+ * with MPI-IO (io_mpiio.c)
+ *
  * Autor: 
  *        Carsten Urbach <urbach@ifh.de>
  *
@@ -43,9 +46,96 @@
 #include "dml.h"
 #include "io.h"
 #include "io_utils.h"
+#include "io_mpiio.h"
 
 /* #define MAXBUF 1048576 */
 
+#if !(defined HAVE_LIBLEMON) && (defined MPI)
+/****************************************************
+ * read_lime_gauge_field_mpiio
+ *
+ * collective read of the ildg-binary-data record;
+ * prec = 0 takes the precision from the record length
+ ****************************************************/
+static int read_lime_gauge_field_mpiio(const char * filename, int prec) {
+
+  int status, t, x, y, z, mu;
+  unsigned int iy, ix;
+  MPI_Offset offset;
+  n_uint64_t bytes, vol = (n_uint64_t)LX_global*LY_global*LZ_global*T_global;
+  size_t site_bytes;
+  char *buffer = NULL, *site;
+  double tmp[72];
+  int words_bigendian = big_endian();
+  DML_Checksum checksum;
+  DML_SiteRank rank;
+
+  status = mpiio_lime_record((char*)filename, "ildg-binary-data", 0, &offset, &bytes);
+  if(status != 0) {
+    if(g_cart_id==0) fprintf(stderr, "no ildg-binary-data record found in file %s\n",filename);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(-2);
+  }
+  if(bytes == vol*72*sizeof(double) && prec != 32) prec = 64;
+  else if(bytes == vol*72*sizeof(float) && prec != 64) prec = 32;
+  else {
+    if(g_cart_id==0) {
+      fprintf(stderr, "Probably wrong lattice size or precision (bytes=%llu) in file %s\n", (unsigned long long)bytes, filename);
+      fprintf(stderr, "Aborting...!\n");
+    }
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(501);
+  }
+  if(g_cart_id==0) fprintf(stdout, "# reading gauge field %s in %d bit precision with MPI-IO\n", filename, prec);
+
+  site_bytes = 72 * (prec == 32 ? sizeof(float) : sizeof(double));
+  if( (buffer = (char*)malloc(VOLUME*site_bytes)) == NULL ) {
+    fprintf(stderr, "Error, could not allocate buffer for gauge field\n");
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(500);
+  }
+  if(mpiio_read_lattice(buffer, (char*)filename, offset, _MPIIO_TZYX, site_bytes) != 0) {
+    fprintf(stderr, "MPI-IO read error while reading file %s!\n Aborting...\n", filename);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(500);
+  }
+
+  DML_checksum_init(&checksum);
+  for(iy = 0; iy < VOLUME; iy++) {
+    t = iy / (LZ*LY*LX);
+    z = (iy % (LZ*LY*LX)) / (LY*LX);
+    y = (iy % (LY*LX)) / LX;
+    x = iy % LX;
+    site = buffer + iy * site_bytes;
+    rank = (DML_SiteRank) ((((Tstart+t)*LZ_global + LZstart + z)*LY_global + LYstart + y)*(DML_SiteRank)LX_global + LXstart + x);
+    DML_checksum_accum(&checksum, rank, site, site_bytes);
+    if(!words_bigendian) {
+      if(prec == 32) byte_swap_assign_single2double(tmp, site, 72);
+      else           byte_swap_assign(tmp, site, 72);
+    } else {
+      if(prec == 32) single2double(tmp, site, 72);
+      else           memcpy(tmp, site, site_bytes);
+    }
+    /* ILDG has mu-order: x,y,z,t */
+    ix = g_ipt[t][x][y][z];
+    for(mu = 1; mu < 4; mu++) {
+      memcpy(g_gauge_field + _GGI(ix,mu), tmp + 18*(mu-1), 18*sizeof(double));
+    }
+    memcpy(g_gauge_field + _GGI(ix,0), tmp + 54, 18*sizeof(double));
+  }
+  free(buffer);
+
+  DML_checksum_combine(&checksum);
+  if(g_cart_id==0) fprintf(stdout, "# checksum for gaugefield %s is %#x %#x\n",
+            filename, checksum.suma, checksum.sumb);
+  return(0);
+}
+#endif
+
 #ifdef HAVE_LIBLEMON
 int read_lime_gauge_field_doubleprec(const char * filename) {
   MPI_File *ifs=NULL;
@@ -187,6 +277,10 @@ int read_lime_gauge_field_doubleprec(const char * filename) {
   free(filebuffer);
   return(0);
 }
+#elif (defined MPI)
+int read_lime_gauge_field_doubleprec(const char * filename) {
+  return(read_lime_gauge_field_mpiio(filename, 0));
+}
 #else
 int read_lime_gauge_field_doubleprec(const char * filename) {
   FILE * ifs;
@@ -477,6 +571,10 @@ int read_lime_gauge_field_singleprec(const char * filename) {
   free(filebuffer);
   return(0);
 }
+#elif (defined MPI)
+int read_lime_gauge_field_singleprec(const char * filename) {
+  return(read_lime_gauge_field_mpiio(filename, 32));
+}
 #else
 int read_lime_gauge_field_singleprec(const char * filename) {
 
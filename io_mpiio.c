@@ -0,0 +1,171 @@
+/********************
+ * io_mpiio.c
+ *
+ * collective MPI-IO for lattice fields
+ *
+ * - mpiio_lime_record: process 0 walks the LIME record headers
+ *   (144 bytes each: magic, version, flags, 64 bit data length,
+ *   128 byte type; data padded to multiples of 8 bytes) and
+ *   broadcasts offset and length of the data of the position-th
+ *   record of a given type
+ * - mpiio_read_lattice / mpiio_write_lattice: the local sub-lattice
+ *   as a 4-dim. subarray of the global lattice with the site data
+ *   as elementary type; the buffer holds the local sites in file
+ *   order, i.e. [T][LZ][LY][LX] for _MPIIO_TZYX and [T][LX][LY][LZ]
+ *   for _MPIIO_TXYZ
+ * - byte swap, precision and checksum are left to the callers
+ ********************/
+#ifdef MPI
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <mpi.h>
+#include "lime.h"
+#include "global.h"
+#include "io_mpiio.h"
+
+#define _LIME_MAGIC 0x456789ab
+#define _LIME_HEADER_BYTES 144
+
+/********************
+ * return value 0 on success, 1 if the file could not be opened,
+ * 2 if there is no such record, 3 if the file is not in LIME format
+ ********************/
+int mpiio_lime_record(char *filename, char *type, int position, MPI_Offset *offset, n_uint64_t *bytes) {
+
+  int i, getpos = -1;
+  unsigned char header[_LIME_HEADER_BYTES];
+  unsigned int magic;
+  n_uint64_t length, pos = 0;
+  long long buffer[3] = {0, 0, 0};
+  FILE *ifs = NULL;
+
+  if(g_cart_id == 0) {
+    if( (ifs = fopen(filename, "r")) == NULL ) {
+      fprintf(stderr, "[mpiio_lime_record] Error, could not open file %s for reading\n", filename);
+      buffer[0] = 1;
+    } else {
+      buffer[0] = 2;
+      while( fseeko(ifs, (off_t)pos, SEEK_SET) == 0 && fread(header, 1, _LIME_HEADER_BYTES, ifs) == _LIME_HEADER_BYTES ) {
+        magic = ((unsigned int)header[0] << 24) | ((unsigned int)header[1] << 16) | ((unsigned int)header[2] << 8) | header[3];
+        if(magic != _LIME_MAGIC) {
+          fprintf(stderr, "[mpiio_lime_record] Error, no LIME record at byte %llu of file %s\n", (unsigned long long)pos, filename);
+          buffer[0] = 3;
+          break;
+        }
+        length = 0;
+        for(i=0; i<8; i++) length = (length << 8) | header[8+i];
+        header[_LIME_HEADER_BYTES-1] = '\0';
+        if(strcmp((char*)header+16, type) == 0) getpos++;
+        if(getpos == position) {
+          buffer[0] = 0;
+          buffer[1] = (long long)(pos + _LIME_HEADER_BYTES);
+          buffer[2] = (long long)length;
+          break;
+        }
+        pos += _LIME_HEADER_BYTES + ((length + 7) / 8) * 8;
+      }
+      fclose(ifs);
+    }
+  }
+  MPI_Bcast(buffer, 3, MPI_LONG_LONG, 0, g_cart_grid);
+  *offset = (MPI_Offset)buffer[1];
+  *bytes  = (n_uint64_t)buffer[2];
+  return((int)buffer[0]);
+}
+
+/********************
+ * file view for the local sub-lattice
+ ********************/
+static int mpiio_lattice_view(MPI_File fh, MPI_Offset offset, int order, size_t site_bytes, MPI_Datatype *site, MPI_Datatype *view) {
+  int gsizes[4], lsizes[4], starts[4];
+
+  gsizes[0] = T_global;
+  lsizes[0] = T;
+  starts[0] = Tstart;
+  if(order == _MPIIO_TZYX) {
+    gsizes[1] = LZ_global; lsizes[1] = LZ; starts[1] = LZstart;
+    gsizes[2] = LY_global; lsizes[2] = LY; starts[2] = LYstart;
+    gsizes[3] = LX_global; lsizes[3] = LX; starts[3] = LXstart;
+  } else {
+    gsizes[1] = LX_global; lsizes[1] = LX; starts[1] = LXstart;
+    gsizes[2] = LY_global; lsizes[2] = LY; starts[2] = LYstart;
+    gsizes[3] = LZ_global; lsizes[3] = LZ; starts[3] = LZstart;
+  }
+
+  MPI_Type_contiguous((int)site_bytes, MPI_BYTE, site);
+  MPI_Type_commit(site);
+  MPI_Type_create_subarray(4, gsizes, lsizes, starts, MPI_ORDER_C, *site, view);
+  MPI_Type_commit(view);
+  return(MPI_File_set_view(fh, offset, *site, *view, "native", MPI_INFO_NULL));
+}
+
+/********************
+ * read VOLUME sites of site_bytes each, starting at offset
+ ********************/
+int mpiio_read_lattice(void *buffer, char *filename, MPI_Offset offset, int order, size_t site_bytes) {
+  int status, count;
+  MPI_File fh;
+  MPI_Status mstatus;
+  MPI_Datatype site, view;
+
+  status = MPI_File_open(g_cart_grid, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+  if(status != MPI_SUCCESS) {
+    if(g_cart_id == 0) fprintf(stderr, "[mpiio_read_lattice] Error, could not open file %s for reading\n", filename);
+    return(1);
+  }
+
+  status = mpiio_lattice_view(fh, offset, order, site_bytes, &site, &view);
+  if(status == MPI_SUCCESS) {
+    status = MPI_File_read_all(fh, buffer, VOLUME, site, &mstatus);
+    if(status == MPI_SUCCESS) {
+      MPI_Get_count(&mstatus, site, &count);
+      if(count != VOLUME) status = !MPI_SUCCESS;
+    }
+  }
+  MPI_File_close(&fh);
+  MPI_Type_free(&view);
+  MPI_Type_free(&site);
+
+  if(status != MPI_SUCCESS) {
+    fprintf(stderr, "[mpiio_read_lattice] Error, could not read %d sites from file %s\n", VOLUME, filename);
+    return(2);
+  }
+  return(0);
+}
+
+/********************
+ * write VOLUME sites of site_bytes each, starting at offset;
+ * the file content before offset is kept
+ ********************/
+int mpiio_write_lattice(void *buffer, char *filename, MPI_Offset offset, int order, size_t site_bytes) {
+  int status;
+  MPI_File fh;
+  MPI_Status mstatus;
+  MPI_Datatype site, view;
+
+  status = MPI_File_open(g_cart_grid, filename, MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &fh);
+  if(status != MPI_SUCCESS) {
+    if(g_cart_id == 0) fprintf(stderr, "[mpiio_write_lattice] Error, could not open file %s for writing\n", filename);
+    return(1);
+  }
+
+  status = mpiio_lattice_view(fh, offset, order, site_bytes, &site, &view);
+  if(status == MPI_SUCCESS) {
+    status = MPI_File_write_all(fh, buffer, VOLUME, site, &mstatus);
+  }
+  MPI_File_close(&fh);
+  MPI_Type_free(&view);
+  MPI_Type_free(&site);
+
+  if(status != MPI_SUCCESS) {
+    fprintf(stderr, "[mpiio_write_lattice] Error, could not write %d sites to file %s\n", VOLUME, filename);
+    return(2);
+  }
+  return(0);
+}
+
+#endif  /* of ifdef MPI */
@@ -0,0 +1,27 @@
+/********************
+ * io_mpiio.h
+ *
+ * collective MPI-IO access to lattice fields in files,
+ * the built-in alternative to LEMON
+ * - the local sub-lattice is a subarray file view, all processes
+ *   read / write their part with one MPI_File_read_all /
+ *   MPI_File_write_all
+ * - LIME records are located by process 0 only
+ ********************/
+#ifndef _IO_MPIIO_H
+#define _IO_MPIIO_H
+
+#ifdef MPI
+#include <mpi.h>
+#include "lime.h"
+
+/* site order in the file, slowest to fastest index */
+#define _MPIIO_TZYX 0  /* ILDG, SciDAC, NERSC: x runs fastest */
+#define _MPIIO_TXYZ 1  /* cvc contractions: z runs fastest */
+
+int mpiio_lime_record(char *filename, char *type, int position, MPI_Offset *offset, n_uint64_t *bytes);
+int mpiio_read_lattice(void *buffer, char *filename, MPI_Offset offset, int order, size_t site_bytes);
+int mpiio_write_lattice(void *buffer, char *filename, MPI_Offset offset, int order, size_t site_bytes);
+#endif
+
+#endif
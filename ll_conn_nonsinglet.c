@@ -35,6 +35,7 @@
 #include "fuzz2.h"
 #include "read_input_parser.h"
 #include "smearing_techniques.h"
+#include "contract_twopoint_batch.h"
 
 void usage() {
   fprintf(stdout, "\n\nCode to perform contractions for LL connected contributions\n");
@@ -87,6 +88,8 @@ int main(int argc, char **argv) {
   double c_conf_gamma_sign[]  = {1., 1., 1., -1., -1., -1., -1., 1., 1., 1., -1., -1.,  1.,  1., 1., 1.};
   double n_conf_gamma_sign[]  = {1., 1., 1., -1., -1., -1., -1., 1., 1., 1.,  1.,  1., -1., -1., 1., 1.};
   double *conf_gamma_sign=NULL;
+  int xidout[64];
+  double xfactor[64];
 
   /**************************************************************************************************
    * charged stuff
@@ -388,15 +391,18 @@ int main(int argc, char **argv) {
 
     /* (pseudo-)scalar sector */
     for(idx=0; idx<16; idx++) {
-      contract_twopoint_xdep(cconn + 2*(count*K + idx), xgindex1[idx], xgindex2[idx], chi, psi, n_c, K, 1.0, prec);
+      xidout[idx]  = idx;
+      xfactor[idx] = 1.0;
     }
     /* (pseudo-)vector sector */
     for(idx = 16; idx < 64; idx+=3) {
       for(i = 0; i < 3; i++) {
-        contract_twopoint_xdep(cconn + 2*(count*K + (16+(idx-16)/3)), 
-          xgindex1[idx+i], xgindex2[idx+i], chi, psi, n_c, K, conf_gamma_sign[(idx-16)/3]*xvsign[idx-16+i], prec);
+        xidout[idx+i]  = 16+(idx-16)/3;
+        xfactor[idx+i] = conf_gamma_sign[(idx-16)/3]*xvsign[idx-16+i];
       }
     }
+    /* all 64 structures in one pass */
+    contract_twopoint_xdep_batch(cconn + 2*count*K, 64, xgindex1, xgindex2, xidout, xfactor, chi, psi, n_c, K);
   }}
 
   /***************************************************************
@@ -0,0 +1,275 @@
+/********************
+ * momentum_phase.c
+ *
+ * momentum phase tables and batched momentum projection
+ *
+ * - init_momentum_phase: cos / sin only for the distinct momentum
+ *   components per direction, (nk_x LX + nk_y LY + nk_z LZ) calls
+ *   in total instead of one per site and momentum
+ * - momentum_projection:
+ *     out[2*(ip*nt + t)] += sum_x phase[ip][x] field[2*(t*VOL3 + x)]
+ *   summed over the spatial process grid;
+ *   one zgemm with the full phase table or, if the momentum list is
+ *   dense (at least half of the box spanned by its distinct components),
+ *   a separable Fourier transform in z, y and x that needs no full table
+ ********************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+#include "global.h"
+#include "momentum_phase.h"
+
+#ifdef F_
+#define _F(s) s##_
+#else
+#define _F(s) s
+#endif
+
+void _F(zgemm)(char *transa, char *transb, int *m, int *n, int *k, double *alpha, double *a, int *lda,
+    double *b, int *ldb, double *beta, double *c, int *ldc);
+
+/********************
+ * momenta mom[3*ip+d], ip < nmom;
+ * source_coords = global spatial source coordinates or NULL for 0
+ ********************/
+int init_momentum_phase(momentum_phase *p, int nmom, int *mom, int *source_coords) {
+
+  int d, ip, j, x;
+  int L[3], start[3], L_global[3];
+  double phase;
+
+  L[0] = LX; L[1] = LY; L[2] = LZ;
+  start[0] = LXstart; start[1] = LYstart; start[2] = LZstart;
+  L_global[0] = LX_global; L_global[1] = LY_global; L_global[2] = LZ_global;
+
+  p->nmom  = nmom;
+  p->phase = NULL;
+  p->e[0]  = NULL;
+  p->mom   = (int*)malloc(6*nmom*sizeof(int));
+  p->k[0]  = (int*)malloc(3*nmom*sizeof(int));
+  if(p->mom == NULL || p->k[0] == NULL) {
+    fprintf(stderr, "[init_momentum_phase] Error, could not allocate memory\n");
+    free(p->mom); free(p->k[0]);
+    p->mom = NULL; p->k[0] = NULL;
+    return(1);
+  }
+  memcpy(p->mom, mom, 3*nmom*sizeof(int));
+  p->kidx = p->mom + 3*nmom;
+  p->k[1] = p->k[0] + nmom;
+  p->k[2] = p->k[1] + nmom;
+
+  for(d=0; d<3; d++) {
+    p->nk[d] = 0;
+    for(ip=0; ip<nmom; ip++) {
+      for(j=0; j<p->nk[d] && p->k[d][j] != mom[3*ip+d]; j++);
+      if(j == p->nk[d]) p->k[d][p->nk[d]++] = mom[3*ip+d];
+      p->kidx[3*ip+d] = j;
+    }
+  }
+
+  p->e[0] = (double*)malloc(2*(p->nk[0]*LX + p->nk[1]*LY + p->nk[2]*LZ)*sizeof(double));
+  if(p->e[0] == NULL) {
+    fprintf(stderr, "[init_momentum_phase] Error, could not allocate memory\n");
+    free(p->mom); free(p->k[0]);
+    p->mom = NULL; p->k[0] = NULL;
+    return(1);
+  }
+  p->e[1] = p->e[0] + 2*p->nk[0]*LX;
+  p->e[2] = p->e[1] + 2*p->nk[1]*LY;
+
+  for(d=0; d<3; d++) {
+    for(j=0; j<p->nk[d]; j++) {
+      for(x=0; x<L[d]; x++) {
+        phase = 2. * M_PI * (double)p->k[d][j] * (double)(x + start[d] - (source_coords==NULL ? 0 : source_coords[d])) / (double)L_global[d];
+        p->e[d][2*(j*L[d]+x)  ] = cos(phase);
+        p->e[d][2*(j*L[d]+x)+1] = sin(phase);
+      }
+    }
+  }
+  return(0);
+}
+
+void fini_momentum_phase(momentum_phase *p) {
+  if(p->mom   != NULL) free(p->mom);
+  if(p->k[0]  != NULL) free(p->k[0]);
+  if(p->e[0]  != NULL) free(p->e[0]);
+  if(p->phase != NULL) free(p->phase);
+  p->mom = NULL; p->kidx = NULL; p->phase = NULL;
+  p->k[0] = NULL; p->k[1] = NULL; p->k[2] = NULL;
+  p->e[0] = NULL; p->e[1] = NULL; p->e[2] = NULL;
+  p->nmom = 0;
+}
+
+/********************
+ * full table phase[2*(ip*VOL3 + x)] on the local timeslice
+ ********************/
+int momentum_phase_table(momentum_phase *p) {
+  int ix, ip;
+  int VOL3 = LX*LY*LZ;
+
+  if(p->phase != NULL) return(0);
+  p->phase = (double*)malloc(2*p->nmom*VOL3*sizeof(double));
+  if(p->phase == NULL) {
+    fprintf(stderr, "[momentum_phase_table] Error, could not allocate memory\n");
+    return(1);
+  }
+#ifdef OPENMP
+#pragma omp parallel for private(ip)
+#endif
+  for(ix=0; ix<VOL3; ix++) {
+    for(ip=0; ip<p->nmom; ip++) {
+      _momentum_phase_site(p->phase+2*(ip*VOL3+ix), p, ip, ix/(LY*LZ), (ix%(LY*LZ))/LZ, ix%LZ);
+    }
+  }
+  return(0);
+}
+
+/********************
+ * separable transform of field[2*(t*VOL3+x)] for t < nt
+ * into out[2*(ip*nt+t)]
+ ********************/
+static int momentum_projection_separable(double *out, momentum_phase *p, double *field, int nt) {
+  int t;
+  int nkx = p->nk[0], nky = p->nk[1], nkz = p->nk[2];
+  int VOL3 = LX*LY*LZ;
+  size_t items = 2*(LX*LY*nkz + LX*nky*nkz + nkx*nky*nkz);
+#ifdef OPENMP
+  int nthreads = omp_get_max_threads();
+#else
+  int nthreads = 1;
+#endif
+  /* per-thread buffers, allocated before the parallel region so
+   * that every thread takes part in the work sharing */
+  double *work = (double*)malloc(nthreads*items*sizeof(double));
+
+  if(work == NULL) {
+    fprintf(stderr, "[momentum_projection_separable] Error, could not allocate memory\n");
+    return(1);
+  }
+
+#ifdef OPENMP
+#pragma omp parallel
+{
+  double *B1 = work + omp_get_thread_num()*items;
+#else
+  double *B1 = work;
+#endif
+  double *B2 = B1 + 2*LX*LY*nkz, *B3 = B2 + 2*LX*nky*nkz;
+  double *s, *e, *f;
+  int ip, x1, x2, x3, j1, j2, j3;
+
+#ifdef OPENMP
+#pragma omp for
+#endif
+  for(t=0; t<nt; t++) {
+    memset(B1, 0, items*sizeof(double));
+    /* z */
+    s = field + 2*t*VOL3;
+    for(x1=0; x1<LX*LY; x1++) {
+      for(j3=0; j3<nkz; j3++) {
+        f = B1 + 2*(x1*nkz+j3);
+        e = p->e[2] + 2*j3*LZ;
+        for(x3=0; x3<LZ; x3++) {
+          f[0] += e[2*x3] * s[2*(x1*LZ+x3)  ] - e[2*x3+1] * s[2*(x1*LZ+x3)+1];
+          f[1] += e[2*x3] * s[2*(x1*LZ+x3)+1] + e[2*x3+1] * s[2*(x1*LZ+x3)  ];
+        }
+      }
+    }
+    /* y */
+    for(x1=0; x1<LX; x1++) {
+      for(j2=0; j2<nky; j2++) {
+        e = p->e[1] + 2*j2*LY;
+        for(x2=0; x2<LY; x2++) {
+          for(j3=0; j3<nkz; j3++) {
+            f = B2 + 2*((x1*nky+j2)*nkz+j3);
+            s = B1 + 2*((x1*LY+x2)*nkz+j3);
+            f[0] += e[2*x2] * s[0] - e[2*x2+1] * s[1];
+            f[1] += e[2*x2] * s[1] + e[2*x2+1] * s[0];
+          }
+        }
+      }
+    }
+    /* x */
+    for(j1=0; j1<nkx; j1++) {
+      e = p->e[0] + 2*j1*LX;
+      for(x1=0; x1<LX; x1++) {
+        for(j2=0; j2<nky*nkz; j2++) {
+          f = B3 + 2*(j1*nky*nkz+j2);
+          s = B2 + 2*(x1*nky*nkz+j2);
+          f[0] += e[2*x1] * s[0] - e[2*x1+1] * s[1];
+          f[1] += e[2*x1] * s[1] + e[2*x1+1] * s[0];
+        }
+      }
+    }
+    for(ip=0; ip<p->nmom; ip++) {
+      f = B3 + 2*((p->kidx[3*ip]*nky + p->kidx[3*ip+1])*nkz + p->kidx[3*ip+2]);
+      out[2*(ip*nt+t)  ] = f[0];
+      out[2*(ip*nt+t)+1] = f[1];
+    }
+  }
+#ifdef OPENMP
+}  /* end of parallel region */
+#endif
+  free(work);
+  return(0);
+}
+
+/********************
+ * out[2*(ip*nt+t)] += sum_x phase[ip][x] field[2*(t*VOL3+x)]
+ ********************/
+int momentum_projection(double *out, momentum_phase *p, double *field, int nt) {
+  int i, status = 0;
+  int VOL3 = LX*LY*LZ, nmom = p->nmom;
+  double *C = NULL, *buffer = NULL;
+  double one[2] = {1., 0.}, zero[2] = {0., 0.};
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  int status_all;
+#endif
+
+  if(nmom == 0 || nt == 0) return(0);
+
+  C = (double*)malloc(2*nmom*nt*sizeof(double));
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  buffer = (double*)malloc(2*nmom*nt*sizeof(double));
+  if(buffer == NULL) status = 1;
+#endif
+  if(C == NULL || status != 0) {
+    fprintf(stderr, "[momentum_projection] Error, could not allocate memory\n");
+    status = 1;
+  } else if(p->nk[0] * p->nk[1] * p->nk[2] <= 2*nmom && p->phase == NULL) {
+    status = momentum_projection_separable(C, p, field, nt);
+  } else {
+    status = momentum_phase_table(p);
+    if(status == 0) {
+      _F(zgemm)("T", "N", &nt, &nmom, &VOL3, one, field, &VOL3, p->phase, &VOL3, zero, C, &nt);
+    }
+  }
+
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  /* all processes of the timeslice agree before the reduction */
+  MPI_Allreduce(&status, &status_all, 1, MPI_INT, MPI_MAX, g_ts_comm);
+  status = status_all;
+#endif
+  if(status != 0) {
+    free(C);
+    free(buffer);
+    return(status);
+  }
+
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
+  memcpy(buffer, C, 2*nmom*nt*sizeof(double));
+  MPI_Allreduce(buffer, C, 2*nmom*nt, MPI_DOUBLE, MPI_SUM, g_ts_comm);
+  free(buffer);
+#endif
+
+  for(i=0; i<2*nmom*nt; i++) out[i] += C[i];
+  free(C);
+  return(0);
+}
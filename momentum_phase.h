@@ -0,0 +1,47 @@
+/********************
+ * momentum_phase.h
+ *
+ * tables of the momentum phases
+ *   exp( i 2 pi k (x - x_src) / L ),  x, x_src global
+ * for a list of momenta on the local sub-lattice, factorized
+ * per direction, and the batched projection
+ *   out[p][t] = sum_x phase[p][x] field[t][x]
+ ********************/
+#ifndef _MOMENTUM_PHASE_H
+#define _MOMENTUM_PHASE_H
+
+/********************
+ * - k[d][j], j < nk[d]: distinct momentum components in direction d
+ * - kidx[3*ip+d]: index of component d of momentum ip in k[d]
+ * - e[d][2*(j*L_d + x)]: phase in direction d for component k[d][j]
+ *   at local coordinate x
+ * - phase[2*(ip*VOL3 + x)]: full table on the local timeslice,
+ *   built on demand by momentum_phase_table
+ ********************/
+typedef struct {
+  int nmom;
+  int *mom;
+  int nk[3];
+  int *k[3];
+  int *kidx;
+  double *e[3];
+  double *phase;
+} momentum_phase;
+
+/* _w = phase of momentum _ip at local spatial site (_x1, _x2, _x3) */
+#define _momentum_phase_site(_w, _p, _ip, _x1, _x2, _x3) {\
+  double *_ex = (_p)->e[0] + 2*((_p)->kidx[3*(_ip)  ]*LX + (_x1));\
+  double *_ey = (_p)->e[1] + 2*((_p)->kidx[3*(_ip)+1]*LY + (_x2));\
+  double *_ez = (_p)->e[2] + 2*((_p)->kidx[3*(_ip)+2]*LZ + (_x3));\
+  double _re = _ex[0]*_ey[0] - _ex[1]*_ey[1];\
+  double _im = _ex[0]*_ey[1] + _ex[1]*_ey[0];\
+  (_w)[0] = _re*_ez[0] - _im*_ez[1];\
+  (_w)[1] = _re*_ez[1] + _im*_ez[0];\
+}
+
+int init_momentum_phase(momentum_phase *p, int nmom, int *mom, int *source_coords);
+void fini_momentum_phase(momentum_phase *p);
+int momentum_phase_table(momentum_phase *p);
+int momentum_projection(double *out, momentum_phase *p, double *field, int nt);
+
+#endif
@@ -12,7 +12,9 @@ MPI_Datatype gauge_point;
 MPI_Datatype spinor_point;
 MPI_Datatype gauge_time_slice_cont;
 MPI_Datatype spinor_time_slice_cont;
-#  if defined PARALLELTX || defined PARALLELTXY
+MPI_Datatype spinor_point_flt;
+MPI_Datatype spinor_time_slice_cont_flt;
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
 MPI_Datatype gauge_x_slice_vector;
 MPI_Datatype gauge_x_subslice_cont;
 MPI_Datatype gauge_x_slice_cont;
@@ -35,18 +37,43 @@ MPI_Datatype gauge_yt_edge_vector;
 MPI_Datatype gauge_yt_edge_cont;
 MPI_Datatype gauge_yx_edge_vector;
 MPI_Datatype gauge_yx_edge_cont;
+
+MPI_Datatype spinor_x_subslice_cont_flt;
+MPI_Datatype spinor_x_slice_vector_flt;
+MPI_Datatype spinor_x_slice_cont_flt;
+MPI_Datatype spinor_y_slice_vector_flt;
+MPI_Datatype spinor_y_slice_cont_flt;
+#  endif
+
+#  if defined PARALLELTXYZ
+MPI_Datatype gauge_z_slice_vector;
+MPI_Datatype gauge_z_subslice_cont;
+MPI_Datatype gauge_z_slice_cont;
+
+MPI_Datatype spinor_z_slice_vector;
+MPI_Datatype spinor_z_slice_cont;
+
+MPI_Datatype gauge_zt_edge_vector;
+MPI_Datatype gauge_zt_edge_cont;
+MPI_Datatype gauge_zx_edge_vector;
+MPI_Datatype gauge_zx_edge_cont;
+MPI_Datatype gauge_zy_edge_vector;
+MPI_Datatype gauge_zy_edge_cont;
+
+MPI_Datatype spinor_z_slice_vector_flt;
+MPI_Datatype spinor_z_slice_cont_flt;
 #  endif
 
 #endif
 
 void mpi_init(int argc,char *argv[]) {
 
-#if (defined PARALLELTX || defined PARALLELTXY) && !(defined MPI)
+#if (defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ) && !(defined MPI)
   exit(555);
 #endif
 
 #ifdef MPI
-#if !(defined PARALLELTX || defined PARALLELTXY)
+#if !(defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ)
 
   int reorder=1;
   int namelen;
@@ -151,8 +178,8 @@ void mpi_init(int argc,char *argv[]) {
 		  g_cart_id, g_nb_list[6],
 		  g_cart_id, g_nb_list[7]);
 
-#else /* PARALLELTX || PARALLELTXY defined */
-#ifndef HAVE_QUDA
+#else /* PARALLELTX || PARALLELTXY || PARALLELTXYZ defined */
+#if !(defined HAVE_QUDA) || (defined PARALLELTXYZ)
   int reorder=1;
   int namelen;
   int dims[4], periods[4]={1,1,1,1};
@@ -163,8 +190,12 @@ void mpi_init(int argc,char *argv[]) {
   MPI_Get_processor_name(processor_name, &namelen);
 
   /* determine the neighbours in +/-t-direction */
+#if defined PARALLELTXYZ
+  g_nproc_t = g_nproc / ( g_nproc_x * g_nproc_y * g_nproc_z );
+#else
   g_nproc_t = g_nproc / ( g_nproc_x * g_nproc_y );
   g_nproc_z = 1;
+#endif
   dims[0] = g_nproc_t;
   dims[1] = g_nproc_x;
   dims[2] = g_nproc_y;
@@ -186,11 +217,17 @@ void mpi_init(int argc,char *argv[]) {
   LYstart   = g_proc_coords[2] * LY;
 
   LZ_global = LZ;
+#if defined PARALLELTXYZ
+  LZ        = LZ_global / g_nproc_z;
+#endif
   LZstart   = g_proc_coords[3] * LZ;
 
   MPI_Cart_shift(g_cart_grid, 0, 1, &g_nb_t_dn, &g_nb_t_up);
   MPI_Cart_shift(g_cart_grid, 1, 1, &g_nb_x_dn, &g_nb_x_up);
   MPI_Cart_shift(g_cart_grid, 2, 1, &g_nb_y_dn, &g_nb_y_up);
+#if defined PARALLELTXYZ
+  MPI_Cart_shift(g_cart_grid, 3, 1, &g_nb_z_dn, &g_nb_z_up);
+#endif
 
   g_nb_list[0] = g_nb_t_up;
   g_nb_list[1] = g_nb_t_dn;
@@ -201,8 +238,13 @@ void mpi_init(int argc,char *argv[]) {
   g_nb_list[4] = g_nb_y_up;
   g_nb_list[5] = g_nb_y_dn;
 
+#if defined PARALLELTXYZ
+  g_nb_list[6] = g_nb_z_up;
+  g_nb_list[7] = g_nb_z_dn;
+#else
   g_nb_list[6] = g_cart_id;
   g_nb_list[7] = g_cart_id;
+#endif
 
   MPI_Type_contiguous(72, MPI_DOUBLE, &gauge_point);
   MPI_Type_commit(&gauge_point);
@@ -262,6 +304,27 @@ void mpi_init(int argc,char *argv[]) {
   MPI_Type_contiguous(T*LX*LZ, spinor_point, &spinor_y_slice_cont);
   MPI_Type_commit(&spinor_y_slice_cont);
   
+#if defined PARALLELTXYZ
+  /* ------------------------------------------------------------------------ */
+
+  MPI_Type_contiguous(LX*LY, gauge_point, &gauge_z_subslice_cont);
+  MPI_Type_commit(&gauge_z_subslice_cont);
+
+  MPI_Type_contiguous(T*LX*LY, gauge_point, &gauge_z_slice_cont);
+  MPI_Type_commit(&gauge_z_slice_cont);
+
+  MPI_Type_vector(T*LX*LY, 1, LZ, gauge_point, &gauge_z_slice_vector);
+  MPI_Type_commit(&gauge_z_slice_vector);
+
+  /* ------------------------------------------------------------------------ */
+
+  MPI_Type_vector(T*LX*LY, 1, LZ, spinor_point, &spinor_z_slice_vector);
+  MPI_Type_commit(&spinor_z_slice_vector);
+
+  MPI_Type_contiguous(T*LX*LY, spinor_point, &spinor_z_slice_cont);
+  MPI_Type_commit(&spinor_z_slice_cont);
+
+#endif
   /* ========= the edges ==================================================== */
 
   /* --------- x-t-edge ----------------------------------------------------- */
@@ -287,6 +350,32 @@ void mpi_init(int argc,char *argv[]) {
   MPI_Type_vector(2*T, LZ, LX*LZ, gauge_point, &gauge_yx_edge_vector);
   MPI_Type_commit(&gauge_yx_edge_vector);
 
+#if defined PARALLELTXYZ
+  /* --------- z-t-edge ----------------------------------------------------- */
+
+  MPI_Type_contiguous(2*LX*LY, gauge_point, &gauge_zt_edge_cont);
+  MPI_Type_commit(&gauge_zt_edge_cont);
+
+  MPI_Type_vector(2, 1, T, gauge_z_subslice_cont, &gauge_zt_edge_vector);
+  MPI_Type_commit(&gauge_zt_edge_vector);
+
+  /* --------- z-x-edge ----------------------------------------------------- */
+
+  MPI_Type_contiguous(2*T*LY, gauge_point, &gauge_zx_edge_cont);
+  MPI_Type_commit(&gauge_zx_edge_cont);
+
+  MPI_Type_vector(2*T, LY, LX*LY, gauge_point, &gauge_zx_edge_vector);
+  MPI_Type_commit(&gauge_zx_edge_vector);
+
+  /* --------- z-y-edge ----------------------------------------------------- */
+
+  MPI_Type_contiguous(2*T*LX, gauge_point, &gauge_zy_edge_cont);
+  MPI_Type_commit(&gauge_zy_edge_cont);
+
+  MPI_Type_vector(2*T*LX, 1, LY, gauge_point, &gauge_zy_edge_vector);
+  MPI_Type_commit(&gauge_zy_edge_vector);
+#endif
+
   /* --------- sub lattices ------------------------------------------------- */
 
   dims[0]=0; dims[1]=1; dims[2]=1; dims[3]=1;
@@ -299,6 +388,9 @@ void mpi_init(int argc,char *argv[]) {
   g_ts_nb_x_dn = g_ts_nb_dn;
 
   MPI_Cart_shift(g_ts_comm, 1, 1, &g_ts_nb_y_dn, &g_ts_nb_y_up);
+#if defined PARALLELTXYZ
+  MPI_Cart_shift(g_ts_comm, 2, 1, &g_ts_nb_z_dn, &g_ts_nb_z_up);
+#endif
 
   /* ------------------------------------------------------------------------ */
 
@@ -364,6 +456,18 @@ void mpi_init(int argc,char *argv[]) {
 		  g_cart_id, g_ts_nb_x_dn,
 		  g_cart_id, g_ts_nb_y_up,
 		  g_cart_id, g_ts_nb_y_dn);
+#if defined PARALLELTXYZ
+  fprintf(stdout, "# [%2d] g_nproc_z = %3d\n"\
+		  "# [%2d] g_nb_z_up = %3d\n"\
+		  "# [%2d] g_nb_z_dn = %3d\n"\
+		  "# [%2d] g_ts_nb_z_up = %3d\n"\
+		  "# [%2d] g_ts_nb_z_dn = %3d\n",\
+                  g_cart_id, g_nproc_z,
+		  g_cart_id, g_nb_z_up,
+		  g_cart_id, g_nb_z_dn,
+		  g_cart_id, g_ts_nb_z_up,
+		  g_cart_id, g_ts_nb_z_dn);
+#endif
 #else  // HAVE_QUDA
   int reorder=1;
   int namelen;
@@ -586,7 +690,41 @@ void mpi_init(int argc,char *argv[]) {
 		  g_cart_id, g_ts_nb_y_dn);
 
 #endif
-#endif  /* of ifdef PARALLELTX || PARALLELTXY */
+#endif  /* of ifdef PARALLELTX || PARALLELTXY || PARALLELTXYZ */
+
+  /* ========= single precision spinor fields =============================== */
+
+  MPI_Type_contiguous(24, MPI_FLOAT, &spinor_point_flt);
+  MPI_Type_commit(&spinor_point_flt);
+
+  MPI_Type_contiguous(LX*LY*LZ, spinor_point_flt, &spinor_time_slice_cont_flt);
+  MPI_Type_commit(&spinor_time_slice_cont_flt);
+#if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
+
+  MPI_Type_contiguous(LY*LZ, spinor_point_flt, &spinor_x_subslice_cont_flt);
+  MPI_Type_commit(&spinor_x_subslice_cont_flt);
+
+  MPI_Type_vector(T, 1, LX, spinor_x_subslice_cont_flt, &spinor_x_slice_vector_flt);
+  MPI_Type_commit(&spinor_x_slice_vector_flt);
+
+  MPI_Type_contiguous(T*LY*LZ, spinor_point_flt, &spinor_x_slice_cont_flt);
+  MPI_Type_commit(&spinor_x_slice_cont_flt);
+
+  MPI_Type_vector(T*LX, LZ, LY*LZ, spinor_point_flt, &spinor_y_slice_vector_flt);
+  MPI_Type_commit(&spinor_y_slice_vector_flt);
+
+  MPI_Type_contiguous(T*LX*LZ, spinor_point_flt, &spinor_y_slice_cont_flt);
+  MPI_Type_commit(&spinor_y_slice_cont_flt);
+#endif
+#if defined PARALLELTXYZ
+
+  MPI_Type_vector(T*LX*LY, 1, LZ, spinor_point_flt, &spinor_z_slice_vector_flt);
+  MPI_Type_commit(&spinor_z_slice_vector_flt);
+
+  MPI_Type_contiguous(T*LX*LY, spinor_point_flt, &spinor_z_slice_cont_flt);
+  MPI_Type_commit(&spinor_z_slice_cont_flt);
+#endif
+
   fprintf(stdout, "[mpi_init] proc%.2d one host %s\n", g_cart_id, processor_name);
 #else  /* MPI not defined */
   g_nproc = 1;
@@ -9,8 +9,10 @@
 extern MPI_Datatype gauge_point;
 extern MPI_Datatype gauge_time_slice_cont;
 extern MPI_Datatype spinor_time_slice_cont;
+extern MPI_Datatype spinor_point_flt;
+extern MPI_Datatype spinor_time_slice_cont_flt;
 
-#  if defined PARALLELTX || defined PARALLELTXY
+#  if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
 extern MPI_Datatype gauge_x_slice_vector;
 extern MPI_Datatype gauge_x_slice_cont;
 extern MPI_Datatype gauge_x_subslice_cont;
@@ -34,7 +36,31 @@ extern MPI_Datatype gauge_yt_edge_cont;
 extern MPI_Datatype gauge_yx_edge_vector;
 extern MPI_Datatype gauge_yx_edge_cont;
 
+extern MPI_Datatype spinor_x_subslice_cont_flt;
+extern MPI_Datatype spinor_x_slice_vector_flt;
+extern MPI_Datatype spinor_x_slice_cont_flt;
+extern MPI_Datatype spinor_y_slice_vector_flt;
+extern MPI_Datatype spinor_y_slice_cont_flt;
 
+#  endif
+
+#  if defined PARALLELTXYZ
+extern MPI_Datatype gauge_z_slice_vector;
+extern MPI_Datatype gauge_z_subslice_cont;
+extern MPI_Datatype gauge_z_slice_cont;
+
+extern MPI_Datatype spinor_z_slice_vector;
+extern MPI_Datatype spinor_z_slice_cont;
+
+extern MPI_Datatype gauge_zt_edge_vector;
+extern MPI_Datatype gauge_zt_edge_cont;
+extern MPI_Datatype gauge_zx_edge_vector;
+extern MPI_Datatype gauge_zx_edge_cont;
+extern MPI_Datatype gauge_zy_edge_vector;
+extern MPI_Datatype gauge_zy_edge_cont;
+
+extern MPI_Datatype spinor_z_slice_vector_flt;
+extern MPI_Datatype spinor_z_slice_cont_flt;
 #  endif
 #  endif
 
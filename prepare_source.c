@@ -34,6 +34,7 @@
 #include "ranlxd.h"
 #include "smearing_techniques.h"
 #include "fuzz.h"
+#include "ranphilox.h"
 
 #ifndef _NON_ZERO
 #  define _NON_ZERO (5.e-14)
@@ -45,7 +46,7 @@ int count_nonzero_source_entries(double *s);
 double minimal_distance(double *s, int y0, int y1, int y2, int y3);
 
 int prepare_timeslice_source(double *s, double *gauge_field, int timeslice, unsigned int V, int*rng_state, int rng_reset) {
-#if !(defined PARALLELTX) && !(defined PARALLELTXY)
+#if !(defined PARALLELTX) && !(defined PARALLELTXY) && !(defined PARALLELTXYZ)
   int c;
   unsigned int ix, iix;
   int i, id=0;
@@ -84,6 +85,9 @@ int prepare_timeslice_source(double *s, double *gauge_field, int timeslice, unsi
         case 2:
           ranz2(ran, 24);
           break;
+        default:
+          fprintf(stderr, "[prepare_timeslice_source] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+          EXIT(1);
       }
 
       iix = _GSI(ts * VOL3 + ix);
@@ -123,8 +127,23 @@ int prepare_timeslice_source(double *s, double *gauge_field, int timeslice, unsi
 #endif
 }
 
+/******************************************************************
+ * nsample stochastic timeslice sources (volume sources for
+ * timeslice < 0) from the counter-based rng,
+ * keyed on g_seed, Nconf and the sample numbers sample0, ...;
+ * works for any process grid and needs no rng state
+ ******************************************************************/
+int prepare_timeslice_source_batch(double **s, int nsample, int sample0, int timeslice) {
+
+  if(timeslice >= T_global) {
+    if(g_cart_id==0) fprintf(stderr, "[prepare_timeslice_source_batch] Error, timeslice %d out of range\n", timeslice);
+    return(1);
+  }
+  return( ranphilox_spinor_field(s, nsample, sample0, g_noise_type, timeslice, g_seed, Nconf) );
+}
+
 int prepare_coherent_timeslice_source(double *s, double *gauge_field, int base, int delta, unsigned int V, int*rng_state, int rng_reset) {
-#if !(defined PARALLELTX) && !(defined PARALLELTXY)
+#if !(defined PARALLELTX) && !(defined PARALLELTXY) && !(defined PARALLELTXYZ)
   int c;
   unsigned int ix, iix;
   int nt, it;
@@ -171,6 +190,9 @@ int prepare_coherent_timeslice_source(double *s, double *gauge_field, int base,
           case 2:
             ranz2(ran, 24);
             break;
+          default:
+            fprintf(stderr, "[prepare_coherent_timeslice_source] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+            EXIT(1);
         }
   
         iix = _GSI(timeslice * VOL3 + ix);
@@ -217,7 +239,7 @@ int prepare_coherent_timeslice_source(double *s, double *gauge_field, int base,
 
 /* timeslice sources for one-end trick with spin dilution */
 int prepare_timeslice_source_one_end(double *s, double *gauge_field, int timeslice, int*momentum, unsigned int isc, int*rng_state, int rng_reset) {
-#if !(defined PARALLELTX) && !(defined PARALLELTXY)
+#if !(defined PARALLELTX) && !(defined PARALLELTXY) && !(defined PARALLELTXYZ)
   int c;
   unsigned int ix, iix, x1, x2, x3;
   int i, id, coords[4]; ;
@@ -268,6 +290,9 @@ int prepare_timeslice_source_one_end(double *s, double *gauge_field, int timesli
         case 2:
           ranz2(ran, 6);
           break;
+        default:
+          fprintf(stderr, "[prepare_timeslice_source_one_end] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+          EXIT(1);
       }
 
       iix = _GSI(timeslice * VOL3 + ix);
@@ -317,7 +342,7 @@ int prepare_timeslice_source_one_end(double *s, double *gauge_field, int timesli
 
 /* timeslice sources for one-end trick with spin and color dilution */
 int prepare_timeslice_source_one_end_color(double *s, double *gauge_field, int timeslice, int*momentum, unsigned int isc, int*rng_state, int rng_reset) {
-#if !(defined PARALLELTX) && !(defined PARALLELTXY)
+#if !(defined PARALLELTX) && !(defined PARALLELTXY) && !(defined PARALLELTXYZ)
   int c;
   unsigned int ix, iix, x1, x2, x3;
   int i, id, coords[4];
@@ -367,6 +392,9 @@ int prepare_timeslice_source_one_end_color(double *s, double *gauge_field, int t
         case 2:
           ranz2(ran, 2);
           break;
+        default:
+          fprintf(stderr, "[prepare_timeslice_source_one_end_color] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+          EXIT(1);
       }
  
       iix = _GSI(timeslice * VOL3 + ix);
@@ -595,6 +623,9 @@ int prepare_space_diluted_source(double *s, unsigned int degree, unsigned int nu
         case 2:
           ranz2(ran, num_comp*VLat);
           break;
+        default:
+          fprintf(stderr, "[prepare_space_diluted_source] Error, noise type %d needs the counter-based rng\n", g_noise_type);
+          EXIT(1);
       }
     }
 #ifdef MPI
@@ -23,6 +23,9 @@
 #  include <unistd.h>
 #endif
 #include "lime.h" 
+#ifdef OPENMP
+#  include <omp.h>
+#endif
 #ifdef HAVE_LIBLEMON
 #  include "lemon.h"
 #endif
@@ -35,6 +38,8 @@
 #include "cvc_utils.h"
 #include "Q_phi.h"
 #include "propagator_io.h"
+#include "io_mpiio.h"
+#include "spinor_codec.h"
 
 /* write a one flavour propagator to file */
 #ifdef HAVE_LIBLEMON
@@ -48,7 +53,11 @@ int write_propagator(double * const s, char * filename,
   int err = 0;
 
   write_propagator_format(filename, prec, 1);
-  err = write_lime_spinor(s, filename, 1, prec);
+  if(g_propagator_codec != _SPINOR_CODEC_NONE) {
+    err = write_lime_spinor_compressed(s, filename, 1, g_propagator_codec);
+  } else {
+    err = write_lime_spinor(s, filename, 1, prec);
+  }
   return(err);
 }
 #endif
@@ -115,7 +124,7 @@ int write_binary_spinor_data(double * const s, LimeWriter * limewriter,
     }
   }  /* of if g_cart_id == 0 */
 #ifdef MPI
-#if (defined PARALLELTX) || (defined PARALLELTXY)
+#if (defined PARALLELTX) || (defined PARALLELTXY) || (defined PARALLELTXYZ)
   return(1);
 #else
   tgeom[0] = Tstart;
@@ -181,7 +190,7 @@ int write_binary_spinor_data(double * const s, LimeWriter * limewriter,
     MPI_Barrier(g_cart_grid);
     fprintf(stdout, " [write_binary_spinor_data %d] finished iproc = %d\n", g_cart_id, iproc);
   }
-#endif  /* if PARALLELTX || PARALLELTXY*/
+#endif  /* if PARALLELTX || PARALLELTXY || PARALLELTXYZ */
 #endif
 
 
@@ -325,6 +334,231 @@ int read_binary_spinor_data(double * const s, LimeReader * limereader,
 }
 #endif /* HAVE_LIBLEMON */
 
+/************************************************************
+ * spinor_block_to_field
+ *
+ * checksum, byte swap and precision conversion of the local
+ * sites of timeslice t (global timeslice tg) from a block in
+ * file order into g_ipt ordering; site (x,y,z) is at
+ *   block + (z*zstride + y*ystride + x0 + x) * site bytes
+ * one (OpenMP-parallel) pass; the checksum is a sum (xor) over
+ * sites, the per-thread partial checksums are combined with
+ * DML_checksum_peq
+ ************************************************************/
+static void spinor_block_to_field(double * const s, char * const block, const int t, const int tg,
+    const size_t zstride, const size_t ystride, const int x0, const int prec, DML_Checksum *ans) {
+
+  int words_bigendian = big_endian();
+  size_t bytes = (prec == 32 ? 24*sizeof(float) : 24*sizeof(double));
+
+#ifdef OPENMP
+#pragma omp parallel
+{
+#endif
+  unsigned int ixyz, x, y, z;
+  n_uint64_t ix;
+  DML_SiteRank rank;
+  DML_Checksum checksum_thread;
+  char *site;
+
+  DML_checksum_init(&checksum_thread);
+#ifdef OPENMP
+#pragma omp for
+#endif
+  for(ixyz = 0; ixyz < LX*LY*LZ; ixyz++) {
+    z = ixyz / (LY*LX);
+    y = (ixyz % (LY*LX)) / LX;
+    x = ixyz % LX;
+    site = block + (z*zstride + y*ystride + x0 + x) * bytes;
+    rank = (DML_SiteRank) (((tg*LZ_global + LZstart + z)*(DML_SiteRank)LY_global + LYstart + y)*(DML_SiteRank)LX_global + LXstart + x);
+    DML_checksum_accum(&checksum_thread, rank, site, bytes);
+
+    ix = g_ipt[t][x][y][z]*(n_uint64_t)12;
+    if(!words_bigendian) {
+      if(prec == 32) byte_swap_assign_single2double(&s[2*ix], (float*)site, 24);
+      else           byte_swap_assign(&s[2*ix], site, 24);
+    } else {
+      if(prec == 32) single2double(&s[2*ix], (float*)site, 24);
+      else           memcpy(&s[2*ix], site, bytes);
+    }
+  }
+#ifdef OPENMP
+#pragma omp critical
+#endif
+  DML_checksum_peq(ans, &checksum_thread);
+#ifdef OPENMP
+}  /* end of parallel region */
+#endif
+}
+
+/************************************************************
+ * read_binary_spinor_data_bulk
+ *
+ * same result and checksum as read_binary_spinor_data (LIME),
+ * but the local part of each timeslice is read in large blocks:
+ * - without x- and y-decomposition the local timeslice is one
+ *   contiguous block of the record, read with a single call
+ * - otherwise one call per z-plane reads the contiguous span of
+ *   the local y-lines (all x, the other x-blocks are skipped)
+ * the block is then converted by spinor_block_to_field
+ ************************************************************/
+int read_binary_spinor_data_bulk(double * const s, LimeReader * limereader,
+    const int prec, DML_Checksum *ans) {
+
+  int status = read_binary_spinor_data_bulk_local(s, limereader, prec, ans);
+  if(status != 0) return(status);
+#ifdef MPI
+  DML_checksum_combine(ans);
+#endif
+  if(g_cart_id == 0) printf("[read_binary_spinor_data_bulk] The final checksum is %#x %#x\n", (*ans).suma, (*ans).sumb);
+  return(0);
+}
+
+/************************************************************
+ * read_binary_spinor_data_bulk_local
+ *
+ * the part of read_binary_spinor_data_bulk without communication,
+ * ans is the checksum of the local sites only
+ ************************************************************/
+int read_binary_spinor_data_bulk_local(double * const s, LimeReader * limereader,
+    const int prec, DML_Checksum *ans) {
+
+  int status=0, t, z, nread;
+  int LX_global_ = LX*g_nproc_x, LY_global_ = LY*g_nproc_y;
+  size_t bytes = (prec == 32 ? 24*sizeof(float) : 24*sizeof(double));
+  size_t plane = (size_t)LY * LX_global_;
+  n_uint64_t block_bytes;
+  char *buffer = NULL;
+
+  DML_checksum_init(ans);
+
+  buffer = (char*)malloc(LZ * plane * bytes);
+  if(buffer == NULL) {
+    fprintf(stderr, "[read_binary_spinor_data_bulk_local] Error, could not allocate buffer\n");
+    return(-1);
+  }
+
+  /* one block per timeslice or one block per z-plane */
+  nread = (g_nproc_x == 1 && g_nproc_y == 1) ? 1 : LZ;
+  for(t = 0; t < T; t++) {
+    for(z = 0; z < nread; z++) {
+      limeReaderSeek(limereader, (n_uint64_t)( (((Tstart+t)*LZ+z)*(n_uint64_t)LY_global_ + LYstart)*LX_global_ )*bytes, SEEK_SET);
+      block_bytes = (n_uint64_t)(LZ / nread) * plane * bytes;
+      status = limeReaderReadData(buffer + z*plane*bytes, &block_bytes, limereader);
+      if(status < 0 && status != LIME_EOR) {
+        free(buffer);
+        return(-1);
+      }
+    }
+    spinor_block_to_field(s, buffer, t, Tstart+t, plane, LX_global_, LXstart, prec, ans);
+  }
+  free(buffer);
+  return(0);
+}
+
+#ifdef MPI
+/************************************************************
+ * read_binary_spinor_data_mpiio
+ *
+ * collective read of the local sub-lattice from the record data
+ * at offset (io_mpiio.c), conversion timeslice by timeslice
+ ************************************************************/
+static int read_binary_spinor_data_mpiio(double * const s, char * filename, MPI_Offset offset,
+    const int prec, DML_Checksum *ans) {
+
+  int t;
+  size_t bytes = (prec == 32 ? 24*sizeof(float) : 24*sizeof(double));
+  char *buffer = NULL;
+
+  DML_checksum_init(ans);
+
+  buffer = (char*)malloc(VOLUME * bytes);
+  if(buffer == NULL) {
+    fprintf(stderr, "[read_binary_spinor_data_mpiio] Error, could not allocate buffer\n");
+    return(-1);
+  }
+  if(mpiio_read_lattice(buffer, filename, offset, _MPIIO_TZYX, bytes) != 0) {
+    free(buffer);
+    return(-1);
+  }
+  for(t = 0; t < T; t++) {
+    spinor_block_to_field(s, buffer + (size_t)t*LX*LY*LZ*bytes, t, Tstart+t, (size_t)LY*LX, LX, 0, prec, ans);
+  }
+  free(buffer);
+
+  DML_checksum_combine(ans);
+  if(g_cart_id == 0) printf("[read_binary_spinor_data_mpiio] The final checksum is %#x %#x\n", (*ans).suma, (*ans).sumb);
+  return(0);
+}
+
+/************************************************************
+ * write_binary_spinor_data_mpiio
+ *
+ * byte swap, precision conversion and checksum into a block in
+ * file order, collective write at offset
+ ************************************************************/
+static int write_binary_spinor_data_mpiio(double * const s, char * filename, MPI_Offset offset,
+    const int prec, DML_Checksum *ans) {
+
+  int status;
+  int words_bigendian = big_endian();
+  size_t bytes = (prec == 32 ? 24*sizeof(float) : 24*sizeof(double));
+  char *buffer = NULL;
+
+  DML_checksum_init(ans);
+
+  buffer = (char*)malloc(VOLUME * bytes);
+  if(buffer == NULL) {
+    fprintf(stderr, "[write_binary_spinor_data_mpiio] Error, could not allocate buffer\n");
+    return(-1);
+  }
+
+#ifdef OPENMP
+#pragma omp parallel
+{
+#endif
+  unsigned int iy, t, x, y, z;
+  DML_SiteRank rank;
+  DML_Checksum checksum_thread;
+  double *sp;
+  char *site;
+
+  DML_checksum_init(&checksum_thread);
+#ifdef OPENMP
+#pragma omp for
+#endif
+  for(iy = 0; iy < VOLUME; iy++) {
+    t = iy / (LZ*LY*LX);
+    z = (iy % (LZ*LY*LX)) / (LY*LX);
+    y = (iy % (LY*LX)) / LX;
+    x = iy % LX;
+    sp   = s + _GSI(g_ipt[t][x][y][z]);
+    site = buffer + iy * bytes;
+    if(!words_bigendian) {
+      if(prec == 32) byte_swap_assign_double2single((float*)site, sp, 24);
+      else           byte_swap_assign(site, sp, 24);
+    } else {
+      if(prec == 32) double2single((float*)site, sp, 24);
+      else           memcpy(site, sp, bytes);
+    }
+    rank = (DML_SiteRank) ((((Tstart+t)*LZ_global + LZstart + z)*(DML_SiteRank)LY_global + LYstart + y)*(DML_SiteRank)LX_global + LXstart + x);
+    DML_checksum_accum(&checksum_thread, rank, site, bytes);
+  }
+#ifdef OPENMP
+#pragma omp critical
+#endif
+  DML_checksum_peq(ans, &checksum_thread);
+#ifdef OPENMP
+}  /* end of parallel region */
+#endif
+
+  status = mpiio_write_lattice(buffer, filename, offset, _MPIIO_TZYX, bytes);
+  free(buffer);
+  DML_checksum_combine(ans);
+  return(status == 0 ? 0 : -1);
+}
+#endif  /* of ifdef MPI */
+
 /************************************************************
  *
  ************************************************************/
@@ -472,7 +706,7 @@ int write_propagator_format(char * filename, const int prec, const int no_flavou
       exit(500);
     }
   
-    sprintf(message, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<etmcFormat>\n<field>diracFermion</field>\n<precision>%d</precision>\n<flavours>%d</flavours>\n<lx>%d</lx>\n<ly>%d</ly>\n<lz>%d</lz>\n<lt>%d</lt>\n</etmcFormat>", prec, no_flavours, LX_global, LY, LZ, T_global);
+    sprintf(message, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<etmcFormat>\n<field>diracFermion</field>\n<precision>%d</precision>\n<flavours>%d</flavours>\n<lx>%d</lx>\n<ly>%d</ly>\n<lz>%d</lz>\n<lt>%d</lt>\n</etmcFormat>", prec, no_flavours, LX_global, LY_global, LZ_global, T_global);
     bytes = strlen( message );
     limeheader = limeCreateHeader(MB_flag, ME_flag, "etmc-propagator-format", bytes);
     status = limeWriteRecordHeader( limeheader, limewriter);
@@ -506,6 +740,9 @@ int write_lime_spinor(double * const s, char * filename,
   int ME_flag=0, MB_flag=0;
   n_uint64_t bytes;
   DML_Checksum checksum;
+#ifdef MPI
+  MPI_Offset offset;
+#endif
 
   if(g_cart_id==0) {
     if(append) {
@@ -533,7 +770,7 @@ int write_lime_spinor(double * const s, char * filename,
       exit(500);
     }
 
-    bytes = (LX*g_nproc_x)*LY*LZ*T_global*(n_uint64_t)24*sizeof(double)*prec/64;
+    bytes = (LX*g_nproc_x)*(LY*g_nproc_y)*LZ*T_global*(n_uint64_t)24*sizeof(double)*prec/64;
     MB_flag=0; ME_flag=1;
     limeheader = limeCreateHeader(MB_flag, ME_flag, "scidac-binary-data", bytes);
     status = limeWriteRecordHeader( limeheader, limewriter);
@@ -548,6 +785,22 @@ int write_lime_spinor(double * const s, char * filename,
     limeDestroyHeader( limeheader );
   }
   
+#ifdef MPI
+  /* header by process 0, data collectively behind it */
+  if(g_cart_id==0) {
+    offset = (MPI_Offset)ftello(ofs);
+    limeDestroyWriter( limewriter );
+    fflush(ofs);
+    fclose(ofs);
+  }
+  MPI_Bcast(&offset, 1, MPI_OFFSET, 0, g_cart_grid);
+  status = write_binary_spinor_data_mpiio(s, filename, offset, prec, &checksum);
+  if(status != 0) {
+    fprintf(stderr, "[write_lime_spinor] Error while writing to file %s \n", filename);
+    return(status);
+  }
+  if(g_cart_id==0) printf("# [write_lime_spinor] Final check sum is (%#x  %#x)\n", checksum.suma, checksum.sumb);
+#else
   status = write_binary_spinor_data(s, limewriter, prec, &checksum);
   if(g_cart_id==0) {
     printf("# [write_lime_spinor] Final check sum is (%#lx  %#lx)\n", checksum.suma, checksum.sumb);
@@ -558,6 +811,7 @@ int write_lime_spinor(double * const s, char * filename,
     fflush(ofs);
     fclose(ofs);
   }
+#endif
   write_checksum(filename, &checksum);
   return(0);
 }
@@ -682,6 +936,59 @@ int read_lime_spinor(double * const s, char * filename, const int position) {
   
   return(0);
 }
+#elif (defined MPI)
+int read_lime_spinor(double * const s, char * filename, const int position) {
+  int status=0, getpos;
+  MPI_Offset offset;
+  n_uint64_t bytes, prec = 32;
+  DML_Checksum checksum;
+
+  if(g_proc_id==0) fprintf(stdout, "# [read_lime_spinor] Reading Dirac-fermion field in LIME format from %s with MPI-IO\n", filename);
+
+  status = mpiio_lime_record(filename, "scidac-binary-data", position, &offset, &bytes);
+  if(status == 2 || status == 3) {
+    /* no such record or no LIME file: compressed record, each
+     * process reads its timeslices, otherwise CMI format */
+    DML_checksum_init(&checksum);
+    status = read_lime_spinor_compressed(s, filename, position, Tstart, T, &checksum);
+    status = status == 0 ? 0 : (status == 1 ? 1 : 2);
+    MPI_Allreduce(&status, &getpos, 1, MPI_INT, MPI_MAX, g_cart_grid);
+    if(getpos == 0) {
+      DML_checksum_combine(&checksum);
+      if(g_cart_id == 0) fprintf(stdout, "# [read_lime_spinor] checksum for compressed field in file %s position %d is %#x %#x\n",
+          filename, position, checksum.suma, checksum.sumb);
+      return(0);
+    } else if(getpos == 2) {
+      return(-1);
+    }
+    if(g_proc_id==0) {
+      fprintf(stderr, "[read_lime_spinor] no scidac-binary-data record found in file %s\n",filename);
+      fprintf(stderr, "[read_lime_spinor] try to read in CMI format\n");
+    }
+    return(read_cmi(s, filename));
+  } else if(status != 0) {
+    return(-1);
+  }
+  if(bytes == (n_uint64_t)LX_global*LY_global*LZ_global*T_global*(uint64_t)(24*sizeof(double))) prec = 64;
+  else if(bytes == (n_uint64_t)LX_global*LY_global*LZ_global*T_global*(uint64_t)(24*sizeof(float))) prec = 32;
+  else {
+    if(g_proc_id==0) fprintf(stderr, "[read_lime_spinor] wrong length in eospinor: bytes = %llu, not %llu. Aborting read!\n", 
+	    (unsigned long long)bytes, (unsigned long long)LX_global*LY_global*LZ_global*T_global*(uint64_t)(24*sizeof(double)));
+    return(-1);
+  }
+  if(g_cart_id == 0) printf("# [read_lime_spinor] %llu Bit precision read\n", (unsigned long long)prec);
+
+  status = read_binary_spinor_data_mpiio(s, filename, offset, prec, &checksum);
+
+  if(status < 0) {
+    fprintf(stderr, "[read_lime_spinor] MPI-IO read error occured with status = %d while reading file %s!\n Aborting...\n", 
+	    status, filename);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+    exit(500);
+  }
+  return(0);
+}
 #else
 int read_lime_spinor(double * const s, char * filename, const int position) {
   FILE * ifs;
@@ -714,9 +1021,18 @@ int read_lime_spinor(double * const s, char * filename, const int position) {
     if(getpos == position) break;
   }
   if(status == LIME_EOF) {
-    fprintf(stderr, "[read_lime_spinor] no scidac-binary-data record found in file %s\n",filename);
     limeDestroyReader(limereader);
     fclose(ifs);
+    DML_checksum_init(&checksum);
+    status = read_lime_spinor_compressed(s, filename, position, Tstart, T, &checksum);
+    if(status == 0) {
+      if(g_cart_id == 0) fprintf(stdout, "# [read_lime_spinor] checksum for compressed field in file %s position %d is %#x %#x\n",
+          filename, position, checksum.suma, checksum.sumb);
+      return(0);
+    } else if(status < 0) {
+      return(-1);
+    }
+    fprintf(stderr, "[read_lime_spinor] no scidac-binary-data record found in file %s\n",filename);
     if(g_proc_id==0) fprintf(stderr, "[read_lime_spinor] try to read in CMI format\n");
     return(read_cmi(s, filename));
   }
@@ -730,7 +1046,7 @@ int read_lime_spinor(double * const s, char * filename, const int position) {
   }
   if(g_cart_id == 0) printf("# [read_lime_spinor] %llu Bit precision read\n", prec);
 
-  status = read_binary_spinor_data(s, limereader, prec, &checksum);
+  status = read_binary_spinor_data_bulk(s, limereader, prec, &checksum);
 
   if(status < 0) {
     fprintf(stderr, "[read_lime_spinor] LIME read error occured with status = %d while reading file %s!\n Aborting...\n", 
@@ -748,6 +1064,610 @@ int read_lime_spinor(double * const s, char * filename, const int position) {
 }
 #endif  /* HAVE_LIBLEMON */
 
+/**************************************************
+ * read_lime_spinor_local
+ *
+ * LIME read of the local sub-lattice by each process
+ * on its own, without any communication (in particular
+ * usable from a thread other than the MPI thread);
+ * checksum is the checksum of the local sites only,
+ * to be combined by the caller
+ * - no CMI fallback, no z-decomposition
+ * - return value 0 on success, -1 otherwise
+ **************************************************/
+int read_lime_spinor_local(double * const s, char * filename, const int position, DML_Checksum *checksum) {
+  FILE * ifs;
+  int status=0, getpos=-1;
+  n_uint64_t bytes, volume;
+  char * header_type;
+  LimeReader * limereader;
+  int prec = 32;
+
+  if((ifs = fopen(filename, "r")) == (FILE*)NULL) {
+    fprintf(stderr, "[read_lime_spinor_local] Error opening file %s\n", filename);
+    return(-1);
+  }
+  limereader = limeCreateReader( ifs );
+  if( limereader == (LimeReader *)NULL ) {
+    fprintf(stderr, "[read_lime_spinor_local] Unable to open LimeReader\n");
+    fclose(ifs);
+    return(-1);
+  }
+  while( (status = limeReaderNextRecord(limereader)) != LIME_EOF ) {
+    if(status != LIME_SUCCESS ) {
+      status = LIME_EOF;
+      break;
+    }
+    header_type = limeReaderType(limereader);
+    if(strcmp("scidac-binary-data",header_type) == 0) getpos++;
+    if(getpos == position) break;
+  }
+  if(status == LIME_EOF) {
+    limeDestroyReader(limereader);
+    fclose(ifs);
+    DML_checksum_init(checksum);
+    if(read_lime_spinor_compressed(s, filename, position, Tstart, T, checksum) == 0) return(0);
+    fprintf(stderr, "[read_lime_spinor_local] no spinor data record at position %d in file %s\n", position, filename);
+    return(-1);
+  }
+  bytes  = limeReaderBytes(limereader);
+  volume = (n_uint64_t)(LX*g_nproc_x)*(LY*g_nproc_y)*LZ*T_global;
+  if(bytes == volume*24*sizeof(double)) prec = 64;
+  else if(bytes == volume*24*sizeof(float)) prec = 32;
+  else {
+    fprintf(stderr, "[read_lime_spinor_local] wrong length in spinor: bytes = %llu, not %llu\n",
+        (unsigned long long)bytes, (unsigned long long)(volume*24*sizeof(double)));
+    limeDestroyReader(limereader);
+    fclose(ifs);
+    return(-1);
+  }
+
+  status = read_binary_spinor_data_bulk_local(s, limereader, prec, checksum);
+
+  limeDestroyReader(limereader);
+  fclose(ifs);
+  return(status < 0 ? -1 : 0);
+}
+
+/**************************************************
+ * compressed Dirac-fermion fields
+ *
+ * LIME record cvc-compressed-spinor-data, all numbers
+ * big endian:
+ *   uint32 codec, uint32 T_global,
+ *   uint64 offset[T_global+1] of the timeslice chunks
+ *     relative to the start of the record,
+ *   chunks of the timeslices t=0,...,T_global-1
+ * the chunk encodings are in spinor_codec.c; every
+ * timeslice can be read on its own
+ **************************************************/
+
+static void put_uint64_be(unsigned char *b, n_uint64_t v) {
+  int i;
+  for(i=7; i>=0; i--) { b[i] = v & 0xff; v >>= 8; }
+}
+
+static n_uint64_t get_uint64_be(unsigned char *b) {
+  int i;
+  n_uint64_t v = 0;
+  for(i=0; i<8; i++) v = (v << 8) | b[i];
+  return(v);
+}
+
+/**************************************************
+ * timeslice tg of s in file order (z,y,x) on process 0;
+ * local = buffer of 24*LX*LY*LZ doubles;
+ * collective, the return value is the same on all processes
+ **************************************************/
+static int gather_spinor_timeslice(double *ts, double * const s, const int tg, double *local) {
+  unsigned int x, y, z;
+  int have = (tg >= Tstart && tg < Tstart+T);
+
+  if(have) {
+    for(z=0; z<LZ; z++) {
+    for(y=0; y<LY; y++) {
+    for(x=0; x<LX; x++) {
+      memcpy(local + 24*((z*LY+y)*LX+x), s + _GSI(g_ipt[tg-Tstart][x][y][z]), 24*sizeof(double));
+    }}}
+  }
+#ifdef MPI
+  {
+    int i, info[4], *all = NULL, *counts = NULL, *displs = NULL, status = 0, status_max;
+    double *recv = NULL, *b;
+    info[0] = have ? 24*LX*LY*LZ : 0;
+    info[1] = LXstart; info[2] = LYstart; info[3] = LZstart;
+    if(g_cart_id == 0) {
+      all    = (int*)malloc(6*g_nproc*sizeof(int));
+      recv   = (double*)malloc(24*(size_t)LX_global*LY_global*LZ_global*sizeof(double));
+      if(all == NULL || recv == NULL) {
+        fprintf(stderr, "[gather_spinor_timeslice] Error, could not allocate buffers\n");
+        status = 1;
+      } else {
+        counts = all + 4*g_nproc;
+        displs = all + 5*g_nproc;
+      }
+    }
+    MPI_Allreduce(&status, &status_max, 1, MPI_INT, MPI_MAX, g_cart_grid);
+    if(status_max != 0) {
+      if(all  != NULL) free(all);
+      if(recv != NULL) free(recv);
+      return(1);
+    }
+    MPI_Gather(info, 4, MPI_INT, all, 4, MPI_INT, 0, g_cart_grid);
+    if(g_cart_id == 0) {
+      for(i=0; i<g_nproc; i++) {
+        counts[i] = all[4*i];
+        displs[i] = i == 0 ? 0 : displs[i-1] + counts[i-1];
+      }
+    }
+    MPI_Gatherv(local, info[0], MPI_DOUBLE, recv, counts, displs, MPI_DOUBLE, 0, g_cart_grid);
+    if(g_cart_id == 0) {
+      for(i=0; i<g_nproc; i++) {
+        if(counts[i] == 0) continue;
+        b = recv + displs[i];
+        for(z=0; z<LZ; z++) {
+        for(y=0; y<LY; y++) {
+          memcpy(ts + 24*(((size_t)(all[4*i+3]+z)*LY_global + all[4*i+2]+y)*LX_global + all[4*i+1]),
+              b + 24*(z*LY+y)*LX, 24*LX*sizeof(double));
+        }}
+      }
+      free(all);
+      free(recv);
+    }
+  }
+#else
+  memcpy(ts, local, 24*(size_t)LX*LY*LZ*sizeof(double));
+#endif
+  return(0);
+}
+
+/**************************************************
+ * write_lime_spinor_compressed
+ *
+ * one cvc-compressed-spinor-data record with codec
+ * _SPINOR_CODEC_HALF16 or _SPINOR_CODEC_SHUFFLE32, followed
+ * by the scidac-checksum of the site records;
+ * the timeslices are gathered on process 0 and encoded
+ * there; for the byte-shuffle codec the chunk sizes are
+ * not known in advance, all timeslices are encoded twice
+ **************************************************/
+int write_lime_spinor_compressed(double * const s, char * filename, const int append, const int codec) {
+
+  FILE * ofs = NULL;
+  LimeWriter * limewriter = NULL;
+  LimeRecordHeader * limeheader = NULL;
+  int status = 0, tg;
+#ifdef MPI
+  int status_max;
+#endif
+  unsigned int VOL3g = LX_global*LY_global*LZ_global;
+  size_t chunk_bytes = 0, bound = spinor_codec_bound(codec, VOL3g);
+  n_uint64_t bytes, header_bytes = 8 + 8*(n_uint64_t)(T_global+1), *offset = NULL;
+  unsigned char *header = NULL;
+  double *ts = NULL, *local = NULL;
+  char *chunk = NULL;
+  DML_Checksum checksum, checksum_dummy;
+
+  DML_checksum_init(&checksum_dummy);
+  if(bound == 0) {
+    if(g_cart_id == 0) fprintf(stderr, "[write_lime_spinor_compressed] Error, unknown codec %d\n", codec);
+    return(1);
+  }
+  local = (double*)malloc(24*(size_t)LX*LY*LZ*sizeof(double));
+  offset = (n_uint64_t*)malloc((T_global+1)*sizeof(n_uint64_t));
+  if(g_cart_id == 0) {
+    ts     = (double*)malloc(24*(size_t)VOL3g*sizeof(double));
+    chunk  = (char*)malloc(bound);
+    header = (unsigned char*)malloc(header_bytes);
+  }
+  if(local == NULL || offset == NULL || (g_cart_id == 0 && (ts == NULL || chunk == NULL || header == NULL))) {
+    fprintf(stderr, "[write_lime_spinor_compressed] Error, could not allocate buffers\n");
+    status = 2;
+  }
+#ifdef MPI
+  MPI_Allreduce(&status, &status_max, 1, MPI_INT, MPI_MAX, g_cart_grid);
+  status = status_max;
+#endif
+  if(status != 0) {
+    if(local  != NULL) free(local);
+    if(offset != NULL) free(offset);
+    if(ts     != NULL) free(ts);
+    if(chunk  != NULL) free(chunk);
+    if(header != NULL) free(header);
+    return(2);
+  }
+
+  /* chunk offsets, on process 0; gather_spinor_timeslice fails
+   * on all processes or none, the encoder status is broadcast */
+  offset[0] = header_bytes;
+  for(tg=0; tg<T_global; tg++) {
+    if(codec != _SPINOR_CODEC_HALF16) {
+      if(gather_spinor_timeslice(ts, s, tg, local) != 0) {
+        status = 3;
+        break;
+      }
+    }
+    if(g_cart_id == 0) {
+      if(codec == _SPINOR_CODEC_HALF16) {
+        chunk_bytes = spinor_codec_site_bytes(codec) * (size_t)VOL3g;
+      } else if(status == 0) {
+        chunk_bytes = bound;
+        if(spinor_codec_encode(chunk, &chunk_bytes, ts, VOL3g, codec, 0, &checksum_dummy) != 0) {
+          fprintf(stderr, "[write_lime_spinor_compressed] Error, could not encode timeslice %d\n", tg);
+          status = 3;
+        }
+      }
+      offset[tg+1] = offset[tg] + chunk_bytes;
+    }
+  }
+#ifdef MPI
+  MPI_Bcast(&status, 1, MPI_INT, 0, g_cart_grid);
+  MPI_Bcast(offset, T_global+1, MPI_UNSIGNED_LONG_LONG, 0, g_cart_grid);
+#endif
+  if(status != 0) {
+    free(local);
+    free(offset);
+    if(g_cart_id == 0) {
+      free(ts);
+      free(chunk);
+      free(header);
+    }
+    return(3);
+  }
+
+  if(g_cart_id == 0) {
+    ofs = fopen(filename, append ? "a" : "w");
+    if(ofs == (FILE*)NULL) {
+      fprintf(stderr, "[write_lime_spinor_compressed] Could not open file %s for writing!\n Aborting...\n", filename);
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 1);
+      MPI_Finalize();
+#endif
+      exit(500);
+    }
+    limewriter = limeCreateWriter( ofs );
+    if(limewriter == (LimeWriter*)NULL) {
+      fprintf(stderr, "[write_lime_spinor_compressed] LIME error in file %s for writing!\n Aborting...\n", filename);
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 1);
+      MPI_Finalize();
+#endif
+      exit(500);
+    }
+    bytes = offset[T_global];
+    limeheader = limeCreateHeader(0, 1, _COMPRESSED_SPINOR_TYPE, bytes);
+    status = limeWriteRecordHeader( limeheader, limewriter);
+    if(status < 0 ) {
+      fprintf(stderr, "[write_lime_spinor_compressed] LIME write header error %d\n", status);
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 1);
+      MPI_Finalize();
+#endif
+      exit(500);
+    }
+    limeDestroyHeader( limeheader );
+
+    header[0] = (codec >> 24) & 0xff; header[1] = (codec >> 16) & 0xff; header[2] = (codec >> 8) & 0xff; header[3] = codec & 0xff;
+    header[4] = (T_global >> 24) & 0xff; header[5] = (T_global >> 16) & 0xff; header[6] = (T_global >> 8) & 0xff; header[7] = T_global & 0xff;
+    for(tg=0; tg<=T_global; tg++) put_uint64_be(header + 8 + 8*tg, offset[tg]);
+    limeWriteRecordData(header, &header_bytes, limewriter);
+  }
+
+  DML_checksum_init(&checksum);
+  for(tg=0; tg<T_global; tg++) {
+    if(gather_spinor_timeslice(ts, s, tg, local) != 0) {
+      if(g_cart_id == 0) fprintf(stderr, "[write_lime_spinor_compressed] Error, could not gather timeslice %d\n", tg);
+#ifdef MPI
+      MPI_Abort(MPI_COMM_WORLD, 1);
+      MPI_Finalize();
+#endif
+      exit(500);
+    }
+    if(g_cart_id == 0) {
+      chunk_bytes = bound;
+      status = spinor_codec_encode(chunk, &chunk_bytes, ts, VOL3g, codec, (DML_SiteRank)tg*VOL3g, &checksum);
+      if(status != 0 || chunk_bytes != offset[tg+1] - offset[tg]) {
+        fprintf(stderr, "[write_lime_spinor_compressed] Error, could not encode timeslice %d\n", tg);
+#ifdef MPI
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        MPI_Finalize();
+#endif
+        exit(500);
+      }
+      bytes = chunk_bytes;
+      limeWriteRecordData(chunk, &bytes, limewriter);
+    }
+  }
+
+  if(g_cart_id == 0) {
+    printf("# [write_lime_spinor_compressed] codec %d, %llu bytes, final check sum is (%#x  %#x)\n",
+        codec, (unsigned long long)offset[T_global], checksum.suma, checksum.sumb);
+    if(ferror(ofs)) {
+      fprintf(stderr, "[write_lime_spinor_compressed] Warning! Error while writing to file %s \n", filename);
+    }
+    limeDestroyWriter( limewriter );
+    fflush(ofs);
+    fclose(ofs);
+    free(ts);
+    free(chunk);
+    free(header);
+  }
+  free(local);
+  free(offset);
+  write_checksum(filename, &checksum);
+  return(0);
+}
+
+/**************************************************
+ * read_binary_spinor_data_compressed
+ *
+ * global timeslices tstart,...,tstart+nt-1 of the record
+ * into the local timeslices 0,...,nt-1 of s; the chunks
+ * are read with one call and decoded in parallel;
+ * the checksum of the local site records is added to ans;
+ * no communication
+ **************************************************/
+int read_binary_spinor_data_compressed(double * const s, LimeReader * limereader,
+    const int tstart, const int nt, DML_Checksum *ans) {
+
+  int codec, tglob, status = 0;
+  unsigned int VOL3g = LX_global*LY_global*LZ_global;
+  n_uint64_t header_bytes = 8 + 8*(n_uint64_t)(T_global+1), bytes, *offset = NULL;
+  unsigned char *header = NULL;
+  char *chunks = NULL;
+  size_t site_bytes;
+
+  header = (unsigned char*)malloc(header_bytes);
+  offset = (n_uint64_t*)malloc((T_global+1)*sizeof(n_uint64_t));
+  if(header == NULL || offset == NULL) {
+    fprintf(stderr, "[read_binary_spinor_data_compressed] Error, could not allocate memory\n");
+    if(header != NULL) free(header);
+    if(offset != NULL) free(offset);
+    return(-1);
+  }
+  limeReaderSeek(limereader, (n_uint64_t)0, SEEK_SET);
+  bytes = header_bytes;
+  status = limeReaderReadData(header, &bytes, limereader);
+  if(status < 0 && status != LIME_EOR) {
+    fprintf(stderr, "[read_binary_spinor_data_compressed] Error, could not read record header\n");
+    free(header);
+    free(offset);
+    return(-1);
+  }
+  codec = (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+  tglob = (header[4] << 24) | (header[5] << 16) | (header[6] << 8) | header[7];
+  site_bytes = spinor_codec_site_bytes(codec);
+  if(site_bytes == 0 || tglob != T_global) {
+    fprintf(stderr, "[read_binary_spinor_data_compressed] Error, codec %d, T %d\n", codec, tglob);
+    free(header);
+    free(offset);
+    return(-1);
+  }
+  for(tglob=0; tglob<=T_global; tglob++) offset[tglob] = get_uint64_be(header + 8 + 8*tglob);
+  free(header);
+  if(tstart < 0 || nt < 0 || tstart+nt > T_global) {
+    fprintf(stderr, "[read_binary_spinor_data_compressed] Error, timeslices %d to %d out of range\n", tstart, tstart+nt-1);
+    free(offset);
+    return(-1);
+  }
+
+  bytes = offset[tstart+nt] - offset[tstart];
+  chunks = (char*)malloc(bytes);
+  if(chunks == NULL) {
+    fprintf(stderr, "[read_binary_spinor_data_compressed] Error, could not allocate memory\n");
+    free(offset);
+    return(-1);
+  }
+  limeReaderSeek(limereader, offset[tstart], SEEK_SET);
+  status = limeReaderReadData(chunks, &bytes, limereader);
+  if(status < 0 && status != LIME_EOR) {
+    fprintf(stderr, "[read_binary_spinor_data_compressed] Error, could not read timeslices %d to %d\n", tstart, tstart+nt-1);
+    free(chunks);
+    free(offset);
+    return(-1);
+  }
+  status = 0;
+
+#ifdef OPENMP
+#pragma omp parallel
+{
+#endif
+  int t, ierr;
+  unsigned int x, y, z, isite;
+  DML_Checksum checksum_thread;
+  char *sites = (char*)malloc(site_bytes*VOL3g);
+
+  DML_checksum_init(&checksum_thread);
+#ifdef OPENMP
+#pragma omp for
+#endif
+  for(t=0; t<nt; t++) {
+    ierr = sites == NULL ? 1 : spinor_codec_unpack(sites, chunks + (offset[tstart+t] - offset[tstart]),
+        offset[tstart+t+1] - offset[tstart+t], VOL3g, codec);
+    if(ierr != 0) {
+      status = -1;
+      continue;
+    }
+    for(z=0; z<LZ; z++) {
+    for(y=0; y<LY; y++) {
+    for(x=0; x<LX; x++) {
+      isite = ((LZstart+z)*LY_global + LYstart+y)*LX_global + LXstart+x;
+      DML_checksum_accum(&checksum_thread, (DML_SiteRank)(tstart+t)*VOL3g + isite, sites + isite*site_bytes, site_bytes);
+      spinor_codec_site2double(s + _GSI(g_ipt[t][x][y][z]), sites + isite*site_bytes, codec);
+    }}}
+  }
+  if(sites != NULL) free(sites);
+#ifdef OPENMP
+#pragma omp critical
+#endif
+  DML_checksum_peq(ans, &checksum_thread);
+#ifdef OPENMP
+}  /* end of parallel region */
+#endif
+
+  free(chunks);
+  free(offset);
+  return(status);
+}
+
+/**************************************************
+ * read_lime_spinor_compressed
+ *
+ * global timeslices tstart,...,tstart+nt-1 from the
+ * position-th cvc-compressed-spinor-data record;
+ * per process, no communication, the checksum of the
+ * local sites is added to checksum
+ * - return value 0 on success, 1 if there is no such
+ *   record, -1 otherwise
+ **************************************************/
+int read_lime_spinor_compressed(double * const s, char * filename, const int position,
+    const int tstart, const int nt, DML_Checksum *checksum) {
+  FILE * ifs;
+  int status=0, getpos=-1;
+  LimeReader * limereader;
+
+  if((ifs = fopen(filename, "r")) == (FILE*)NULL) {
+    fprintf(stderr, "[read_lime_spinor_compressed] Error opening file %s\n", filename);
+    return(-1);
+  }
+  limereader = limeCreateReader( ifs );
+  if( limereader == (LimeReader *)NULL ) {
+    fprintf(stderr, "[read_lime_spinor_compressed] Unable to open LimeReader\n");
+    fclose(ifs);
+    return(-1);
+  }
+  while( (status = limeReaderNextRecord(limereader)) != LIME_EOF ) {
+    if(status != LIME_SUCCESS ) {
+      status = LIME_EOF;
+      break;
+    }
+    if(strcmp(_COMPRESSED_SPINOR_TYPE, limeReaderType(limereader)) == 0) getpos++;
+    if(getpos == position) break;
+  }
+  if(status == LIME_EOF) {
+    limeDestroyReader(limereader);
+    fclose(ifs);
+    return(1);
+  }
+
+  status = read_binary_spinor_data_compressed(s, limereader, tstart, nt, checksum);
+
+  limeDestroyReader(limereader);
+  fclose(ifs);
+  return(status < 0 ? -1 : 0);
+}
+
+/**************************************************
+ * read_lime_spinor_trange
+ *
+ * the global timeslices tlist[0],...,tlist[nt-1] of the
+ * position-th spinor field (scidac-binary-data or
+ * cvc-compressed-spinor-data record) in filename;
+ * the file is opened and the record is looked up once
+ * - s holds nt timeslices of the local spatial sub-lattice,
+ *   timeslice tlist[k] at the sites g_ipt[k][x][y][z],
+ *   i.e. s is laid out like a field with T = nt
+ * - per process, no communication: under MPI every process
+ *   reads its own list of timeslices
+ * - the checksum of the sites read is added to checksum
+ * - return value 0 on success, -1 otherwise
+ **************************************************/
+int read_lime_spinor_trange(double * const s, char * filename, const int position,
+    const int nt, const int * const tlist, DML_Checksum *checksum) {
+  FILE * ifs;
+  int status=0, getpos=-1, cgetpos=-1, compressed=0, prec=32, k, n, z, nread;
+  unsigned int VOL3 = LX*LY*LZ;
+  n_uint64_t bytes, volume;
+  size_t site_bytes, plane = (size_t)LY * LX_global;
+  char * header_type, *buffer = NULL;
+  LimeReader * limereader;
+
+  for(k=0; k<nt; k++) {
+    if(tlist[k] < 0 || tlist[k] >= T_global) {
+      fprintf(stderr, "[read_lime_spinor_trange] Error, timeslice %d out of range\n", tlist[k]);
+      return(-1);
+    }
+  }
+
+  if((ifs = fopen(filename, "r")) == (FILE*)NULL) {
+    fprintf(stderr, "[read_lime_spinor_trange] Error opening file %s\n", filename);
+    return(-1);
+  }
+  limereader = limeCreateReader( ifs );
+  if( limereader == (LimeReader *)NULL ) {
+    fprintf(stderr, "[read_lime_spinor_trange] Unable to open LimeReader\n");
+    fclose(ifs);
+    return(-1);
+  }
+  while( (status = limeReaderNextRecord(limereader)) != LIME_EOF ) {
+    if(status != LIME_SUCCESS ) {
+      status = LIME_EOF;
+      break;
+    }
+    header_type = limeReaderType(limereader);
+    if(strcmp("scidac-binary-data",header_type) == 0) getpos++;
+    if(strcmp(_COMPRESSED_SPINOR_TYPE,header_type) == 0) cgetpos++;
+    if(getpos == position) break;
+    if(cgetpos == position) {
+      compressed = 1;
+      break;
+    }
+  }
+  if(status == LIME_EOF) {
+    fprintf(stderr, "[read_lime_spinor_trange] no spinor data record at position %d in file %s\n", position, filename);
+    limeDestroyReader(limereader);
+    fclose(ifs);
+    return(-1);
+  }
+
+  status = 0;
+  if(compressed) {
+    /* runs of consecutive timeslices, one call per run of at most T timeslices */
+    for(k=0; k<nt && status == 0; k+=n) {
+      for(n=1; k+n<nt && n<T && tlist[k+n] == tlist[k]+n; n++);
+      status = read_binary_spinor_data_compressed(s + _GSI((size_t)k*VOL3), limereader, tlist[k], n, checksum);
+    }
+  } else {
+    bytes  = limeReaderBytes(limereader);
+    volume = (n_uint64_t)LX_global*LY_global*LZ_global*T_global;
+    if(bytes == volume*24*sizeof(double)) prec = 64;
+    else if(bytes == volume*24*sizeof(float)) prec = 32;
+    else {
+      fprintf(stderr, "[read_lime_spinor_trange] wrong length in spinor: bytes = %llu, not %llu\n",
+          (unsigned long long)bytes, (unsigned long long)(volume*24*sizeof(double)));
+      status = -1;
+    }
+    site_bytes = (prec == 32 ? 24*sizeof(float) : 24*sizeof(double));
+    if(status == 0 && (buffer = (char*)malloc(LZ * plane * site_bytes)) == NULL) {
+      fprintf(stderr, "[read_lime_spinor_trange] Error, could not allocate buffer\n");
+      status = -1;
+    }
+
+    /* one block per timeslice or one block per z-plane, as in read_binary_spinor_data_bulk_local */
+    nread = (LX == LX_global && LY == LY_global && LZ == LZ_global) ? 1 : LZ;
+    for(k=0; k<nt && status == 0; k++) {
+      for(z=0; z<nread; z++) {
+        limeReaderSeek(limereader,
+            ((((n_uint64_t)tlist[k]*LZ_global + LZstart + z)*LY_global + LYstart)*LX_global)*site_bytes, SEEK_SET);
+        bytes = (n_uint64_t)(LZ / nread) * plane * site_bytes;
+        status = limeReaderReadData(buffer + z*plane*site_bytes, &bytes, limereader);
+        if(status < 0 && status != LIME_EOR) {
+          fprintf(stderr, "[read_lime_spinor_trange] LIME read error %d for timeslice %d in file %s\n", status, tlist[k], filename);
+          status = -1;
+          break;
+        }
+        status = 0;
+      }
+      if(status == 0) spinor_block_to_field(s + _GSI((size_t)k*VOL3), buffer, 0, tlist[k], plane, LX_global, LXstart, prec, checksum);
+    }
+    if(buffer != NULL) free(buffer);
+  }
+
+  limeDestroyReader(limereader);
+  fclose(ifs);
+  return(status < 0 ? -1 : 0);
+}
+
 /**************************************************
  * read propagator in CMI format
  *
@@ -1306,9 +2226,17 @@ int read_lime_spinor_timeslice(double * const s, int timeslice, char * filename,
     if(getpos == position) break;
   }
   if(status == LIME_EOF) {
-    fprintf(stderr, "[read_lime_spinor_timeslice] no scidac-binary-data record found in file %s\n",filename);
     limeDestroyReader(limereader);
     fclose(ifs);
+    if(timeslice == 0) DML_checksum_init(checksum);
+    status = read_lime_spinor_compressed(s, filename, position, timeslice, 1, checksum);
+    if(status == 0) {
+      if(timeslice == T_global - 1) printf("# [read_lime_spinor_timeslice] The final checksum for prop file %s is %#x %#x\n", filename, checksum->suma, checksum->sumb);
+      return(0);
+    } else if(status < 0) {
+      return(-1);
+    }
+    fprintf(stderr, "[read_lime_spinor_timeslice] no scidac-binary-data record found in file %s\n",filename);
     if(g_proc_id==0) fprintf(stderr, "[read_lime_spinor_timeslice] try to read in CMI format\n");
     return(read_cmi(s, filename));
   }
@@ -23,6 +23,20 @@ int write_checksum(char * filename, DML_Checksum *checksum);
 
 int read_lime_spinor(double * const s, char * filename, const int position);
 
+int read_binary_spinor_data_bulk(double * const s, LimeReader * limereader, const int prec, DML_Checksum *ans);
+int read_binary_spinor_data_bulk_local(double * const s, LimeReader * limereader, const int prec, DML_Checksum *ans);
+
+int read_lime_spinor_local(double * const s, char * filename, const int position, DML_Checksum *checksum);
+
+#define _COMPRESSED_SPINOR_TYPE "cvc-compressed-spinor-data"
+int write_lime_spinor_compressed(double * const s, char * filename, const int append, const int codec);
+int read_binary_spinor_data_compressed(double * const s, LimeReader * limereader, const int tstart, const int nt, DML_Checksum *ans);
+int read_lime_spinor_compressed(double * const s, char * filename, const int position,
+    const int tstart, const int nt, DML_Checksum *checksum);
+
+int read_lime_spinor_trange(double * const s, char * filename, const int position,
+    const int nt, const int * const tlist, DML_Checksum *checksum);
+
 int read_cmi(double *v, const char * filename);
 int write_binary_spinor_data_timeslice(double * const s, LimeWriter * limewriter,
   const int prec, int timeslice, DML_Checksum * ans);
@@ -89,7 +89,6 @@ int main(int argc, char **argv) {
   double ratime, retime;
   double plaq_m, plaq_r, dsign, dtmp, dtmp2;
   double *gauge_field_timeslice=NULL, *gauge_field_f=NULL;
-  double **chi=NULL, **chi2=NULL, **psi=NULL, **psi2=NULL, *work=NULL;
   double scs[18];
   fermion_propagator_type fp1=NULL, fp2=NULL, fp3=NULL, uprop=NULL, dprop=NULL;
   spinor_propagator_type sp1, sp2;
@@ -243,13 +242,19 @@ int main(int argc, char **argv) {
     if(N_ape>0) {
       if(g_cart_id==0) fprintf(stdout, "# apply APE smearing with parameters N_ape = %d, alpha_ape = %f\n", N_ape, alpha_ape);
       fprintf(stdout, "# [] APE smearing gauge field with paramters N_APE=%d, alpha_APE=%e\n", N_ape, alpha_ape);
-#ifdef OPENMP
-      APE_Smearing_Step_threads(g_gauge_field, N_ape, alpha_ape);
-#else
-      for(i=0; i<N_ape; i++) {
-        APE_Smearing_Step(g_gauge_field, alpha_ape);
+      if(g_ape_cache) {
+        status = APE_Smearing_cached(g_gauge_field, N_ape, alpha_ape, gaugefilename_prefix, Nconf);
+      } else {
+        status = APE_Smearing(g_gauge_field, N_ape, alpha_ape);
       }
+      if(status != 0) {
+        fprintf(stderr, "[] Error from APE smearing, status was %d\n", status);
+#ifdef MPI
+        MPI_Abort(MPI_COMM_WORLD, 22);
+        MPI_Finalize();
 #endif
+        exit(22);
+      }
     }
   } else {
     g_gauge_field = NULL;
@@ -280,11 +285,8 @@ int main(int argc, char **argv) {
   if(fermion_type == _TM_FERMION) {
     no_fields *= 2;
   }
-  if(N_Jacobi>0) no_fields++;
   g_spinor_field = (double**)calloc(no_fields, sizeof(double*));
-  for(i=0; i<no_fields-1; i++) alloc_spinor_field(&g_spinor_field[i], VOLUME);
-  alloc_spinor_field(&g_spinor_field[no_fields-1], VOLUMEPLUSRAND);
-  work = g_spinor_field[no_fields-1];
+  for(i=0; i<no_fields; i++) alloc_spinor_field(&g_spinor_field[i], VOLUME);
 
   // allocate memory for the contractions
   items = 2*2*T;
@@ -328,22 +330,16 @@ int main(int argc, char **argv) {
         fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
         exit(102);
       }
-      if(N_Jacobi > 0) {
-        fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-             is, N_Jacobi, kappa_Jacobi);
-#ifdef OPENMP
-        Jacobi_Smearing_Step_one_threads(g_gauge_field, g_spinor_field[is], work, N_Jacobi, kappa_Jacobi);
-#else
-        for(c=0; c<N_Jacobi; c++) {
-          Jacobi_Smearing_Step_one(g_gauge_field, g_spinor_field[is], work, kappa_Jacobi);
-        }
-#endif
-      }
     } else {  // of if do_gt == 0
       // apply gt
       apply_gt_prop(gauge_trafo, g_spinor_field[is], is/n_c, is%n_c, 4, filename_prefix, g_source_location);
     } // of if do_gt == 0
   }
+  if(do_gt == 0 && N_Jacobi > 0) {
+    fprintf(stdout, "# [] Jacobi smearing up-type propagator with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+         N_Jacobi, kappa_Jacobi);
+    Jacobi_Smearing_Propagator(g_gauge_field, g_spinor_field, n_s*n_c, N_Jacobi, kappa_Jacobi);
+  }
 
   if(fermion_type == _TM_FERMION) {
     // read 12 down-type propagators, smear them
@@ -355,22 +351,16 @@ int main(int argc, char **argv) {
           fprintf(stderr, "[] Error, could not read propagator from file %s\n", filename);
           exit(102);
         }
-        if(N_Jacobi > 0) {
-          fprintf(stdout, "# [] Jacobi smearing propagator no. %d with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
-               is, N_Jacobi, kappa_Jacobi);
-#ifdef OPENMP
-          Jacobi_Smearing_Step_one_threads(g_gauge_field, g_spinor_field[n_s*n_c+is], work, N_Jacobi, kappa_Jacobi);
-#else
-          for(c=0; c<N_Jacobi; c++) {
-            Jacobi_Smearing_Step_one(g_gauge_field, g_spinor_field[n_s*n_c+is], work, kappa_Jacobi);
-          }
-#endif
-        }
       } else {  // of if do_gt == 0
         // apply gt
         apply_gt_prop(gauge_trafo, g_spinor_field[n_s*n_c+is], is/n_c, is%n_c, 4, filename_prefix, g_source_location);
       } // of if do_gt == 0
     }
+    if(do_gt == 0 && N_Jacobi > 0) {
+      fprintf(stdout, "# [] Jacobi smearing down-type propagator with paramters N_Jacobi=%d, kappa_Jacobi=%f\n",
+           N_Jacobi, kappa_Jacobi);
+      Jacobi_Smearing_Propagator(g_gauge_field, g_spinor_field+n_s*n_c, n_s*n_c, N_Jacobi, kappa_Jacobi);
+    }
   }
 
 
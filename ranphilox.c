@@ -0,0 +1,158 @@
+/********************
+ * ranphilox.c
+ *
+ * counter-based random number generator Philox4x32-10
+ * (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11)
+ * and stochastic noise fields built on it
+ *
+ * - the complex noise component c of sample isample at global
+ *   site gx is drawn from one Philox block with
+ *     counter = ( gx mod 2^32, gx / 2^32, isample, c )
+ *     key     = ( seed, conf )
+ * - gx = ((t*LX_global + x)*LY_global + y)*LZ_global + z
+ *   with global coordinates
+ ********************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+#include "cvc_complex.h"
+#include "cvc_linalg.h"
+#include "global.h"
+#include "ranphilox.h"
+
+#define _PHILOX_M0 0xD2511F53U
+#define _PHILOX_M1 0xCD9E8D57U
+#define _PHILOX_W0 0x9E3779B9U
+#define _PHILOX_W1 0xBB67AE85U
+
+/* uniform in [0,1) with 53 random bits from two 32-bit words */
+#define _PHILOX_U53(_a,_b) ( ( (double)((_a)>>5) * 67108864. + (double)((_b)>>6) ) * (1./9007199254740992.) )
+
+/********************
+ * one Philox4x32 block, 10 rounds
+ ********************/
+void philox4x32(unsigned int *out, unsigned int *ctr, unsigned int *key) {
+  int i;
+  uint32_t c0=ctr[0], c1=ctr[1], c2=ctr[2], c3=ctr[3];
+  uint32_t k0=key[0], k1=key[1];
+  uint64_t p0, p1;
+
+  for(i=0; i<10; i++) {
+    p0 = (uint64_t)_PHILOX_M0 * c0;
+    p1 = (uint64_t)_PHILOX_M1 * c2;
+    c0 = (uint32_t)(p1>>32) ^ c1 ^ k0;
+    c2 = (uint32_t)(p0>>32) ^ c3 ^ k1;
+    c1 = (uint32_t)p1;
+    c3 = (uint32_t)p0;
+    k0 += _PHILOX_W0;
+    k1 += _PHILOX_W1;
+  }
+  out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+/********************
+ * ncomp complex noise numbers for (site, sample)
+ * - Gaussian: Box-Muller, as rangauss
+ * - Z2: re, im = +/- 1/sqrt(2), as ranz2
+ * - Z4: one of 1, i, -1, -i
+ * - U1: exp(i phi), phi uniform
+ ********************/
+void ranphilox_noise(double *r, int noise_type, unsigned long int site, int sample, int ncomp, unsigned int seed, int conf) {
+  int c;
+  unsigned int ctr[4], key[2], u[4];
+  double x1, x2, rho;
+  const double sqrt2inv = 1. / sqrt(2.);
+
+  key[0] = seed;
+  key[1] = (unsigned int)conf;
+  ctr[0] = (unsigned int)(site & 0xffffffffUL);
+  ctr[1] = (unsigned int)(site >> 16 >> 16);
+  ctr[2] = (unsigned int)sample;
+
+  for(c=0; c<ncomp; c++) {
+    ctr[3] = (unsigned int)c;
+    philox4x32(u, ctr, key);
+    switch(noise_type) {
+      case _NOISE_GAUSS:
+        x1  = 1. - _PHILOX_U53(u[0], u[1]);
+        x2  = _PHILOX_U53(u[2], u[3]);
+        rho = sqrt(-2.*log(x1));
+        r[2*c  ] = rho * cos(2*M_PI*x2);
+        r[2*c+1] = rho * sin(2*M_PI*x2);
+        break;
+      case _NOISE_Z2:
+        r[2*c  ] = (u[0] >> 31) ? sqrt2inv : -sqrt2inv;
+        r[2*c+1] = (u[1] >> 31) ? sqrt2inv : -sqrt2inv;
+        break;
+      case _NOISE_Z4:
+        switch(u[0] >> 30) {
+          case 0: r[2*c] =  1.; r[2*c+1] =  0.; break;
+          case 1: r[2*c] =  0.; r[2*c+1] =  1.; break;
+          case 2: r[2*c] = -1.; r[2*c+1] =  0.; break;
+          case 3: r[2*c] =  0.; r[2*c+1] = -1.; break;
+        }
+        break;
+      case _NOISE_U1:
+        x1 = _PHILOX_U53(u[0], u[1]);
+        r[2*c  ] = cos(2*M_PI*x1);
+        r[2*c+1] = sin(2*M_PI*x1);
+        break;
+    }
+  }
+}
+
+/********************
+ * fill the spinor fields s[0,...,nsample-1] with noise
+ * for samples sample0, ..., sample0+nsample-1
+ * - timeslice >= 0: only the global timeslice timeslice,
+ *   zero elsewhere; timeslice < 0: full volume
+ * - boundary sites are not touched
+ ********************/
+int ranphilox_spinor_field(double **s, int nsample, int sample0, int noise_type, int timeslice, unsigned int seed, int conf) {
+
+  int isample, x0, x1, x2, x3;
+  unsigned int ix, iix;
+  unsigned long int gx;
+  unsigned int VOL3 = LX*LY*LZ;
+  double ran[24];
+
+  if(noise_type < _NOISE_GAUSS || noise_type > _NOISE_U1) {
+    if(g_cart_id==0) fprintf(stderr, "[ranphilox_spinor_field] Error, unknown noise type %d\n", noise_type);
+    return(1);
+  }
+
+#ifdef OPENMP
+#pragma omp parallel for private(isample, x0, x1, x2, x3, iix, gx, ran)
+#endif
+  for(ix=0; ix<T*VOL3; ix++) {
+    x0 =  ix / VOL3;
+    x1 = (ix % VOL3) / (LY*LZ);
+    x2 = (ix % (LY*LZ)) / LZ;
+    x3 =  ix % LZ;
+    iix = g_ipt[x0][x1][x2][x3];
+
+    if(timeslice >= 0 && x0 + Tstart != timeslice) {
+      for(isample=0; isample<nsample; isample++) {
+        _fv_eq_zero(s[isample] + _GSI(iix));
+      }
+      continue;
+    }
+
+    gx = (( (unsigned long int)(x0 + Tstart) * LX_global + (x1 + LXstart) ) * LY_global
+        + (x2 + LYstart) ) * LZ_global + (x3 + LZstart);
+
+    for(isample=0; isample<nsample; isample++) {
+      ranphilox_noise(ran, noise_type, gx, sample0 + isample, 12, seed, conf);
+      _fv_eq_fv(s[isample] + _GSI(iix), ran);
+    }
+  }
+  return(0);
+}
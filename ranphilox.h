@@ -0,0 +1,23 @@
+/********************
+ * ranphilox.h
+ *
+ * counter-based random numbers (Philox4x32-10);
+ * each draw is a pure function of
+ *   key     = (seed, configuration)
+ *   counter = (global site, sample, component)
+ * so sources need no rng state and do not depend on the
+ * process grid or on the number of threads
+ ********************/
+#ifndef _RANPHILOX_H
+#define _RANPHILOX_H
+
+/* noise types, 1 and 2 as for g_noise_type */
+#define _NOISE_GAUSS 1
+#define _NOISE_Z2    2
+#define _NOISE_Z4    3
+#define _NOISE_U1    4
+
+void philox4x32(unsigned int *out, unsigned int *ctr, unsigned int *key);
+void ranphilox_noise(double *r, int noise_type, unsigned long int site, int sample, int ncomp, unsigned int seed, int conf);
+int ranphilox_spinor_field(double **s, int nsample, int sample0, int noise_type, int timeslice, unsigned int seed, int conf);
+#endif
@@ -19,6 +19,8 @@
 #include "mpi_init.h"
 #include "cvc_geometry.h"
 #include "cvc_utils.h"
+#include "io.h"
+#include "gauge_io.h"
 #include "smearing_techniques.h"
 
 /******************************************
@@ -780,3 +782,455 @@ int Jacobi_Smearing_Step_one_Timeslice(double *smeared_gauge_field, double *psi,
 //  }    // of istep
   return(0);
 }
+
+/*****************************************************
+ * APE smearing of link U_mu(ix), mu = 1,2,3
+ *
+ * old = unsmeared links, link nu at site iy is at
+ *       old + _GGI(iy-base, nu)
+ * - same operations and order as in APE_Smearing_Step
+ *****************************************************/
+static void APE_Smearing_link(double *U, double *old, int ix, int mu, int base, double APE_smearing_alpha) {
+  int nu;
+  double M1[18], M2[18];
+
+  _cm_eq_zero(U);
+  for(nu=1; nu<4; nu++) {
+    if(nu == mu) continue;
+
+    /* negative nu-direction */
+    _cm_eq_cm_ti_cm(M1, old + _GGI(g_idn[ix][nu]-base, mu), old + _GGI(g_idn[g_iup[ix][mu]][nu]-base, nu));
+    _cm_eq_cm_dag_ti_cm(M2, old + _GGI(g_idn[ix][nu]-base, nu), M1);
+    _cm_pl_eq_cm(U, M2);
+
+    /* positive nu-direction */
+    _cm_eq_cm_ti_cm_dag(M1, old + _GGI(g_iup[ix][nu]-base, mu), old + _GGI(g_iup[ix][mu]-base, nu));
+    _cm_eq_cm_ti_cm(M2, old + _GGI(ix-base, nu), M1);
+    _cm_pl_eq_cm(U, M2);
+  }
+  _cm_ti_eq_re(U, APE_smearing_alpha);
+
+  /* center */
+  _cm_pl_eq_cm(U, old + _GGI(ix-base, mu));
+
+  /* Projection to SU(3). */
+  cm_proj(U);
+}
+
+/*****************************************************
+ * nstep APE smearing steps of the spatial links
+ *
+ * - without spatial domain decomposition the staples
+ *   never leave the timeslice; all nstep steps are
+ *   done on one timeslice (in cache) before the next
+ *   one is loaded, the timeslices are distributed
+ *   over the threads
+ * - with spatial domain decomposition one sweep per
+ *   step with halo exchange in between
+ * - smeared_gauge_field is exchanged at the end
+ *****************************************************/
+int APE_Smearing(double *smeared_gauge_field, int nstep, double APE_smearing_alpha) {
+  int istep, ix, mu;
+  double *buf[2]={NULL, NULL};
+  int exitstatus = 0;
+#if !(defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ)
+  int VOL3 = LX*LY*LZ;
+  int it, i;
+  double *sp=NULL;
+#endif
+
+  if(nstep <= 0) return(0);
+
+#if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
+  alloc_gauge_field(&(buf[0]), VOLUMEPLUSRAND);
+  if(buf[0] == NULL) {
+    fprintf(stderr, "[APE_Smearing] Error, could not allocate buffer\n");
+    return(1);
+  }
+  for(istep=0; istep<nstep; istep++) {
+    xchange_gauge_field(smeared_gauge_field);
+    memcpy(buf[0], smeared_gauge_field, 72*VOLUMEPLUSRAND*sizeof(double));
+#ifdef OPENMP
+#pragma omp parallel for private(mu)
+#endif
+    for(ix=0; ix<VOLUME; ix++) {
+      for(mu=1; mu<4; mu++) {
+        APE_Smearing_link(smeared_gauge_field+_GGI(ix,mu), buf[0], ix, mu, 0, APE_smearing_alpha);
+      }
+    }
+  }
+  free(buf[0]);
+#else
+#ifdef OPENMP
+#pragma omp parallel private(buf, sp, istep, it, i, ix, mu)
+{
+#endif
+  buf[0] = (double*)malloc(144*VOL3*sizeof(double));
+  buf[1] = buf[0] == NULL ? NULL : buf[0] + 72*VOL3;
+  if(buf[0] == NULL) {
+    fprintf(stderr, "[APE_Smearing] Error, could not allocate buffer\n");
+    exitstatus = 1;
+  }
+#ifdef OPENMP
+#pragma omp for
+#endif
+  for(it=0; it<T; it++) {
+    if(buf[0] == NULL) continue;
+    memcpy(buf[0], smeared_gauge_field+_GGI(it*VOL3,0), 72*VOL3*sizeof(double));
+    memcpy(buf[1], buf[0], 72*VOL3*sizeof(double));
+    for(istep=0; istep<nstep; istep++) {
+      for(i=0; i<VOL3; i++) {
+        ix = it*VOL3 + i;
+        for(mu=1; mu<4; mu++) {
+          APE_Smearing_link(buf[1]+_GGI(i,mu), buf[0], ix, mu, it*VOL3, APE_smearing_alpha);
+        }
+      }
+      sp = buf[0]; buf[0] = buf[1]; buf[1] = sp;
+    }
+    memcpy(smeared_gauge_field+_GGI(it*VOL3,0), buf[0], 72*VOL3*sizeof(double));
+  }
+  if(buf[0] != NULL) free(buf[0] < buf[1] ? buf[0] : buf[1]);
+#ifdef OPENMP
+}
+#endif
+#endif
+
+#ifdef MPI
+  xchange_gauge_field(smeared_gauge_field);
+#endif
+  return(exitstatus);
+}
+
+/*****************************************************
+ * nstep APE smearing steps of a gauge field timeslice
+ *
+ * - smeared_gauge_field as for APE_Smearing_Step_Timeslice,
+ *   no spatial domain decomposition
+ * - one timeslice buffer for all steps, the sites are
+ *   distributed over the threads
+ *****************************************************/
+int APE_Smearing_Timeslice(double *smeared_gauge_field, int nstep, double APE_smearing_alpha) {
+  int VOL3 = LX*LY*LZ;
+  int istep, ix, mu;
+  double *buf = NULL;
+
+  if(nstep <= 0) return(0);
+
+  buf = (double*)malloc(72*VOL3*sizeof(double));
+  if(buf == NULL) {
+    fprintf(stderr, "[APE_Smearing_Timeslice] Error, could not allocate buffer\n");
+    return(1);
+  }
+  for(istep=0; istep<nstep; istep++) {
+    memcpy(buf, smeared_gauge_field, 72*VOL3*sizeof(double));
+#ifdef OPENMP
+#pragma omp parallel for private(mu)
+#endif
+    for(ix=0; ix<VOL3; ix++) {
+      for(mu=1; mu<4; mu++) {
+        APE_Smearing_link(smeared_gauge_field+_GGI(ix,mu), buf, ix, mu, 0, APE_smearing_alpha);
+      }
+    }
+  }
+  free(buf);
+  return(0);
+}
+
+/*****************************************************
+ * APE smearing with the smeared links cached in
+ *   <prefix>.<nconf>.apeN<nstep>a<alpha>
+ *
+ * - if the file exists, the smeared links are read
+ *   from it, otherwise APE_Smearing is called and the
+ *   result is written (64 bit lime) for later jobs
+ *****************************************************/
+int APE_Smearing_cached(double *smeared_gauge_field, int nstep, double APE_smearing_alpha, char *prefix, int nconf) {
+  char filename[400];
+  int exitstatus, have_file = 0;
+  double plaq = 0., *gauge_field_save = g_gauge_field;
+  FILE *ofs = NULL;
+
+  if(nstep <= 0) return(0);
+
+  sprintf(filename, "%s.%.4d.apeN%da%.6f", prefix, nconf, nstep, APE_smearing_alpha);
+  if(g_cart_id == 0) {
+    if( (ofs = fopen(filename, "r")) != NULL ) {
+      have_file = 1;
+      fclose(ofs);
+    }
+  }
+#ifdef MPI
+  MPI_Bcast(&have_file, 1, MPI_INT, 0, g_cart_grid);
+#endif
+
+  /* the lime reader and writer work on g_gauge_field */
+  g_gauge_field = smeared_gauge_field;
+  if(have_file) {
+    exitstatus = read_lime_gauge_field_doubleprec(filename);
+    if(exitstatus == 0) {
+#ifdef MPI
+      xchange_gauge_field(smeared_gauge_field);
+#endif
+      if(g_cart_id == 0) fprintf(stdout, "# [APE_Smearing_cached] read APE smeared gauge field from file %s\n", filename);
+      g_gauge_field = gauge_field_save;
+      return(0);
+    }
+    if(g_cart_id == 0) fprintf(stderr, "[APE_Smearing_cached] Warning, could not read %s, smearing again\n", filename);
+  }
+  g_gauge_field = gauge_field_save;
+
+  exitstatus = APE_Smearing(smeared_gauge_field, nstep, APE_smearing_alpha);
+  if(exitstatus != 0) return(exitstatus);
+
+  g_gauge_field = smeared_gauge_field;
+  plaquette(&plaq);
+  exitstatus = write_lime_gauge_field(filename, plaq, nconf, 64);
+  g_gauge_field = gauge_field_save;
+  if(exitstatus != 0) {
+    if(g_cart_id == 0) fprintf(stderr, "[APE_Smearing_cached] Warning, could not write %s\n", filename);
+  } else {
+    if(g_cart_id == 0) fprintf(stdout, "# [APE_Smearing_cached] wrote APE smeared gauge field to file %s\n", filename);
+  }
+  return(0);
+}
+
+/*****************************************************
+ * one Jacobi smearing step at site ix for ncol fields
+ *
+ * s[k]  = smeared spinor of field k at ix
+ * old   = unsmeared fields, spinor of field k at
+ *         slot j is at old + 24*(j*js+k*ks)
+ * iy    = slots of the neighbours -x,+x,-y,+y,-z,+z
+ *         and of ix itself
+ * - the 6 links are loaded once for all ncol fields
+ * - same operations and order as in Jacobi_Smearing_Step_one
+ *****************************************************/
+static void Jacobi_Smearing_site(double **s, double *old, int js, int ks, int ncol, double *smeared_gauge_field, int ix, int *iy, double kappa) {
+  int k, dir;
+  double *U[6], spinor[24];
+  double norm = 1.0 / (1.0 + 6.0*kappa);
+
+  for(dir=0; dir<3; dir++) {
+    U[2*dir  ]  = smeared_gauge_field + _GGI(g_idn[ix][dir+1], dir+1);
+    U[2*dir+1]  = smeared_gauge_field + _GGI(ix, dir+1);
+  }
+
+  for(k=0; k<ncol; k++) {
+    _fv_eq_zero(s[k]);
+    for(dir=0; dir<3; dir++) {
+      /* negative direction */
+      _fv_eq_cm_dag_ti_fv(spinor, U[2*dir], old + 24*(iy[2*dir]*js+k*ks));
+      _fv_pl_eq_fv(s[k], spinor);
+
+      /* positive direction */
+      _fv_eq_cm_ti_fv(spinor, U[2*dir+1], old + 24*(iy[2*dir+1]*js+k*ks));
+      _fv_pl_eq_fv(s[k], spinor);
+    }
+
+    /* Put everything together; normalization. */
+    _fv_ti_eq_re(s[k], kappa);
+    _fv_pl_eq_fv(s[k], old + 24*(iy[6]*js+k*ks));
+    _fv_ti_eq_re(s[k], norm);
+  }
+}
+
+/*****************************************************
+ * slots of the spatial neighbours of ix and of ix
+ * itself for Jacobi_Smearing_site, slot = site - base
+ *****************************************************/
+static void Jacobi_Smearing_neighbours(int *iy, int ix, int base) {
+  int dir;
+  for(dir=0; dir<3; dir++) {
+    iy[2*dir  ] = g_idn[ix][dir+1] - base;
+    iy[2*dir+1] = g_iup[ix][dir+1] - base;
+  }
+  iy[6] = ix - base;
+}
+
+/*****************************************************
+ * nstep Jacobi smearing steps applied to the ncol
+ * fields psi[0],...,psi[ncol-1] (e.g. the 12
+ * spin-colour columns of a propagator)
+ *
+ * - the fields are smeared together, site by site
+ * - without spatial domain decomposition all nstep
+ *   steps are done on one timeslice before the next
+ *   one, the buffer holds 2 timeslices of ncol fields
+ * - with spatial domain decomposition one sweep per
+ *   step with halo exchange in between, the buffer
+ *   holds ncol fields with halo
+ * - psi only needs VOLUME sites
+ *****************************************************/
+int Jacobi_Smearing_Propagator(double *smeared_gauge_field, double **psi, int ncol, int nstep, double kappa) {
+  int istep, ix, k, iy[7];
+  double *buf[2]={NULL, NULL}, **s=NULL;
+#if !(defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ)
+  int VOL3 = LX*LY*LZ;
+  int it, i;
+  double *sp=NULL;
+#endif
+
+  if(nstep <= 0 || ncol <= 0) return(0);
+
+#if defined PARALLELTX || defined PARALLELTXY || defined PARALLELTXYZ
+  buf[0] = (double*)malloc(24*(size_t)ncol*(VOLUME+RAND)*sizeof(double));
+  if(buf[0] == NULL) {
+    fprintf(stderr, "[Jacobi_Smearing_Propagator] Error, could not allocate buffer\n");
+    return(1);
+  }
+  for(istep=0; istep<nstep; istep++) {
+    for(k=0; k<ncol; k++) {
+      memcpy(buf[0]+_GSI(k*(VOLUME+RAND)), psi[k], 24*VOLUME*sizeof(double));
+      xchange_field(buf[0]+_GSI(k*(VOLUME+RAND)));
+    }
+#ifdef OPENMP
+#pragma omp parallel private(s, k, iy)
+{
+#endif
+    s = (double**)malloc(ncol*sizeof(double*));
+#ifdef OPENMP
+#pragma omp for
+#endif
+    for(ix=0; ix<VOLUME; ix++) {
+      for(k=0; k<ncol; k++) s[k] = psi[k] + _GSI(ix);
+      Jacobi_Smearing_neighbours(iy, ix, 0);
+      Jacobi_Smearing_site(s, buf[0], 1, VOLUME+RAND, ncol, smeared_gauge_field, ix, iy, kappa);
+    }
+    free(s);
+#ifdef OPENMP
+}
+#endif
+  }
+  free(buf[0]);
+#else
+  buf[0] = (double*)malloc(48*(size_t)ncol*VOL3*sizeof(double));
+  if(buf[0] == NULL) {
+    fprintf(stderr, "[Jacobi_Smearing_Propagator] Error, could not allocate buffer\n");
+    return(1);
+  }
+  buf[1] = buf[0] + 24*ncol*VOL3;
+
+  for(it=0; it<T; it++) {
+    for(k=0; k<ncol; k++) {
+      memcpy(buf[0]+_GSI(k*VOL3), psi[k]+_GSI(it*VOL3), 24*VOL3*sizeof(double));
+    }
+    for(istep=0; istep<nstep; istep++) {
+#ifdef OPENMP
+#pragma omp parallel private(s, k, ix, iy)
+{
+#endif
+      s = (double**)malloc(ncol*sizeof(double*));
+#ifdef OPENMP
+#pragma omp for
+#endif
+      for(i=0; i<VOL3; i++) {
+        for(k=0; k<ncol; k++) s[k] = buf[1] + _GSI(k*VOL3+i);
+        ix = it*VOL3 + i;
+        Jacobi_Smearing_neighbours(iy, ix, it*VOL3);
+        Jacobi_Smearing_site(s, buf[0], 1, VOL3, ncol, smeared_gauge_field, ix, iy, kappa);
+      }
+      free(s);
+#ifdef OPENMP
+}
+#endif
+      sp = buf[0]; buf[0] = buf[1]; buf[1] = sp;
+    }
+    for(k=0; k<ncol; k++) {
+      memcpy(psi[k]+_GSI(it*VOL3), buf[0]+_GSI(k*VOL3), 24*VOL3*sizeof(double));
+    }
+  }
+  free(buf[0] < buf[1] ? buf[0] : buf[1]);
+#endif
+  return(0);
+}
+
+/*****************************************************
+ * nstep Jacobi smearing steps on a block of n
+ * timeslice fields psi[0],...,psi[n-1] (e.g. the 12
+ * columns of a propagator or a set of sequential
+ * sources)
+ *
+ * - fields and smeared_gauge_field as for
+ *   Jacobi_Smearing_Step_one_Timeslice, the fields
+ *   need the spatial halo of xchange_field_timeslice
+ * - one halo exchange per step for the whole block
+ * - threads over the 3d sites, each site loads its
+ *   links once for all n fields
+ *****************************************************/
+int Jacobi_Smearing_Timeslice_block(double *smeared_gauge_field, double **psi, int n, int nstep, double kappa) {
+  int VOL3 = LX*LY*LZ;
+  int istep, ix, j, k, dir, nh=0;
+  int *nb=NULL, *halo_map=NULL, *halo_site=NULL;
+  double *buf=NULL, **s=NULL;
+
+  if(nstep <= 0 || n <= 0) return(0);
+
+  /* compact slots: VOL3 interior sites, then the halo sites */
+  nb        = (int*)malloc(7*VOL3*sizeof(int));
+  halo_site = (int*)malloc(6*VOL3*sizeof(int));
+  halo_map  = (int*)malloc((RAND>0 ? RAND : 1)*sizeof(int));
+  if(nb == NULL || halo_site == NULL || halo_map == NULL) {
+    fprintf(stderr, "[Jacobi_Smearing_Timeslice_block] Error, could not allocate neighbour tables\n");
+    free(nb);
+    free(halo_site);
+    free(halo_map);
+    return(1);
+  }
+  for(j=0; j<RAND; j++) halo_map[j] = -1;
+  for(ix=0; ix<VOL3; ix++) {
+    Jacobi_Smearing_neighbours(nb+7*ix, ix, 0);
+    for(dir=0; dir<6; dir++) {
+      j = nb[7*ix+dir];
+      if(j < VOL3) continue;
+      if(halo_map[j-VOLUME] < 0) {
+        halo_map[j-VOLUME] = nh;
+        halo_site[nh++] = j;
+      }
+      nb[7*ix+dir] = VOL3 + halo_map[j-VOLUME];
+    }
+  }
+  free(halo_map);
+
+  buf = (double*)malloc(24*(size_t)n*(VOL3+nh)*sizeof(double));
+  if(buf == NULL) {
+    fprintf(stderr, "[Jacobi_Smearing_Timeslice_block] Error, could not allocate buffer\n");
+    free(nb);
+    free(halo_site);
+    return(1);
+  }
+
+  for(istep=0; istep<nstep; istep++) {
+    xchange_field_timeslice_block(psi, n);
+
+#ifdef OPENMP
+#pragma omp parallel private(s, j, k, ix)
+{
+#endif
+    s = (double**)malloc(n*sizeof(double*));
+
+#ifdef OPENMP
+#pragma omp for
+#endif
+    for(k=0; k<n; k++) {
+      memcpy(buf+24*k*(VOL3+nh), psi[k], 24*VOL3*sizeof(double));
+      for(j=0; j<nh; j++) memcpy(buf+24*(k*(VOL3+nh)+VOL3+j), psi[k]+_GSI(halo_site[j]), 24*sizeof(double));
+    }
+
+#ifdef OPENMP
+#pragma omp for
+#endif
+    for(ix=0; ix<VOL3; ix++) {
+      for(k=0; k<n; k++) s[k] = psi[k] + _GSI(ix);
+      Jacobi_Smearing_site(s, buf, 1, VOL3+nh, n, smeared_gauge_field, ix, nb+7*ix, kappa);
+    }
+    free(s);
+#ifdef OPENMP
+}
+#endif
+  }
+
+  free(buf);
+  free(nb);
+  free(halo_site);
+  return(0);
+}
@@ -23,6 +23,12 @@ int Jacobi_Smearing_Steps(double *smeared_gauge_field, double *psi, int N, doubl
 
 int Jacobi_Smearing_Step_one(double *smeared_gauge_field, double *psi, double *psi_old, double kappa);
 int Jacobi_Smearing_Step_one_Timeslice(double *smeared_gauge_field, double *psi, double *psi_old, double kappa);
+
+int APE_Smearing(double *smeared_gauge_field, int nstep, double APE_smearing_alpha);
+int APE_Smearing_Timeslice(double *smeared_gauge_field, int nstep, double APE_smearing_alpha);
+int APE_Smearing_cached(double *smeared_gauge_field, int nstep, double APE_smearing_alpha, char *prefix, int nconf);
+int Jacobi_Smearing_Propagator(double *smeared_gauge_field, double **psi, int ncol, int nstep, double kappa);
+int Jacobi_Smearing_Timeslice_block(double *smeared_gauge_field, double **psi, int n, int nstep, double kappa);
 #ifdef OPENMP
 int APE_Smearing_Step_threads(double *smeared_gauge_field, int nstep, double APE_smearing_alpha);
 int APE_Smearing_Step_Timeslice_threads(double *smeared_gauge_field, int nstep, double APE_smearing_alpha);
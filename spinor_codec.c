@@ -0,0 +1,203 @@
+/********************
+ * spinor_codec.c
+ *
+ * one chunk = one global timeslice, sites in file order (t,z,y,x);
+ * a site record is the unit of the checksum and of random access
+ *
+ * - _SPINOR_CODEC_HALF16: site record of 52 bytes, the maximal
+ *   modulus s of the 24 real components as big endian float,
+ *   followed by the components as big endian 16 bit integers
+ *   q = round(32767 v / s); the absolute error per component is
+ *   below s / 65534; the chunk is the sequence of site records
+ * - _SPINOR_CODEC_SHUFFLE32: site record of 96 bytes, the 24
+ *   components as big endian float (the same bytes as in a 32 bit
+ *   scidac-binary-data record); the chunk holds byte 0 of all floats,
+ *   then byte 1, ... (byte shuffle, sign and exponent bytes become
+ *   long runs of similar values), compressed with zlib (HAVE_ZLIB)
+ ********************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
+#include "lime.h"
+#include "dml.h"
+#include "io_utils.h"
+#include "spinor_codec.h"
+
+#define _HALF16_SITE_BYTES 52
+#define _SHUFFLE32_SITE_BYTES 96
+#define _HALF16_QMAX 32767.
+
+size_t spinor_codec_site_bytes(const int codec) {
+  if(codec == _SPINOR_CODEC_HALF16)    return(_HALF16_SITE_BYTES);
+  if(codec == _SPINOR_CODEC_SHUFFLE32) return(_SHUFFLE32_SITE_BYTES);
+  return(0);
+}
+
+/********************
+ * maximal size of a chunk of nsites sites
+ ********************/
+size_t spinor_codec_bound(const int codec, const unsigned int nsites) {
+  size_t bytes = spinor_codec_site_bytes(codec) * (size_t)nsites;
+#ifdef HAVE_ZLIB
+  if(codec == _SPINOR_CODEC_SHUFFLE32) return( (size_t)compressBound((uLong)bytes) );
+#endif
+  return(bytes);
+}
+
+static void half16_site(unsigned char *r, double * const v) {
+  int k;
+  long q;
+  float s = 0.;
+  double m = 0., f;
+  unsigned int u;
+
+  for(k=0; k<24; k++) if(fabs(v[k]) > m) m = fabs(v[k]);
+  s = (float)m;
+  if(s < m) s = nextafterf(s, 2.*s);
+  memcpy(&u, &s, 4);
+  r[0] = u >> 24; r[1] = (u >> 16) & 0xff; r[2] = (u >> 8) & 0xff; r[3] = u & 0xff;
+  f = s > 0. ? _HALF16_QMAX / (double)s : 0.;
+  for(k=0; k<24; k++) {
+    q = lrint(v[k] * f);
+    if(q >  32767) q =  32767;
+    if(q < -32767) q = -32767;
+    r[4+2*k  ] = ((unsigned long)q >> 8) & 0xff;
+    r[4+2*k+1] =  (unsigned long)q       & 0xff;
+  }
+}
+
+/********************
+ * field = nsites sites of 24 doubles in file order;
+ * the checksum of the site records (rank0 + site index)
+ * is added to ans
+ ********************/
+int spinor_codec_encode(char *chunk, size_t *chunk_bytes, double * const field, const unsigned int nsites,
+    const int codec, const DML_SiteRank rank0, DML_Checksum *ans) {
+
+  unsigned int i;
+#ifdef HAVE_ZLIB
+  int b;
+  size_t nf = 24 * (size_t)nsites;
+  char *rec = NULL, *planes = NULL;
+  int words_bigendian = big_endian();
+#endif
+
+  if(codec == _SPINOR_CODEC_HALF16) {
+    for(i=0; i<nsites; i++) {
+      half16_site((unsigned char*)chunk + i*_HALF16_SITE_BYTES, field + 24*(size_t)i);
+      DML_checksum_accum(ans, rank0 + i, chunk + i*_HALF16_SITE_BYTES, _HALF16_SITE_BYTES);
+    }
+    *chunk_bytes = _HALF16_SITE_BYTES * (size_t)nsites;
+    return(0);
+  }
+
+  if(codec == _SPINOR_CODEC_SHUFFLE32) {
+#ifdef HAVE_ZLIB
+    uLongf dest_bytes = (uLongf)(*chunk_bytes);
+    rec    = (char*)malloc(4*nf);
+    planes = (char*)malloc(4*nf);
+    if(rec == NULL || planes == NULL) {
+      fprintf(stderr, "[spinor_codec_encode] Error, could not allocate buffers\n");
+      if(rec    != NULL) free(rec);
+      if(planes != NULL) free(planes);
+      return(1);
+    }
+    for(i=0; i<nsites; i++) {
+      if(!words_bigendian) byte_swap_assign_double2single(rec + i*_SHUFFLE32_SITE_BYTES, field + 24*(size_t)i, 24);
+      else                 double2single(rec + i*_SHUFFLE32_SITE_BYTES, field + 24*(size_t)i, 24);
+      DML_checksum_accum(ans, rank0 + i, rec + i*_SHUFFLE32_SITE_BYTES, _SHUFFLE32_SITE_BYTES);
+    }
+    for(b=0; b<4; b++) {
+      for(i=0; i<nf; i++) planes[b*nf+i] = rec[4*(size_t)i+b];
+    }
+    if(compress2((Bytef*)chunk, &dest_bytes, (Bytef*)planes, (uLong)(4*nf), 1) != Z_OK) {
+      fprintf(stderr, "[spinor_codec_encode] Error from compress2\n");
+      free(rec); free(planes);
+      return(2);
+    }
+    *chunk_bytes = (size_t)dest_bytes;
+    free(rec);
+    free(planes);
+    return(0);
+#else
+    fprintf(stderr, "[spinor_codec_encode] Error, byte-shuffle codec needs HAVE_ZLIB\n");
+    return(3);
+#endif
+  }
+
+  fprintf(stderr, "[spinor_codec_encode] Error, unknown codec %d\n", codec);
+  return(4);
+}
+
+/********************
+ * chunk -> nsites site records
+ ********************/
+int spinor_codec_unpack(char *sites, char * const chunk, const size_t chunk_bytes, const unsigned int nsites, const int codec) {
+
+  if(codec == _SPINOR_CODEC_HALF16) {
+    if(chunk_bytes != _HALF16_SITE_BYTES * (size_t)nsites) {
+      fprintf(stderr, "[spinor_codec_unpack] Error, wrong chunk length %lu\n", (unsigned long)chunk_bytes);
+      return(1);
+    }
+    memcpy(sites, chunk, chunk_bytes);
+    return(0);
+  }
+
+  if(codec == _SPINOR_CODEC_SHUFFLE32) {
+#ifdef HAVE_ZLIB
+    size_t i, nf = 24 * (size_t)nsites;
+    int b;
+    uLongf bytes = (uLongf)(4*nf);
+    char *planes = (char*)malloc(4*nf);
+    if(planes == NULL) {
+      fprintf(stderr, "[spinor_codec_unpack] Error, could not allocate buffer\n");
+      return(2);
+    }
+    if(uncompress((Bytef*)planes, &bytes, (Bytef*)chunk, (uLong)chunk_bytes) != Z_OK || bytes != 4*nf) {
+      fprintf(stderr, "[spinor_codec_unpack] Error from uncompress\n");
+      free(planes);
+      return(3);
+    }
+    for(b=0; b<4; b++) {
+      for(i=0; i<nf; i++) sites[4*i+b] = planes[b*nf+i];
+    }
+    free(planes);
+    return(0);
+#else
+    fprintf(stderr, "[spinor_codec_unpack] Error, byte-shuffle codec needs HAVE_ZLIB\n");
+    return(4);
+#endif
+  }
+
+  fprintf(stderr, "[spinor_codec_unpack] Error, unknown codec %d\n", codec);
+  return(5);
+}
+
+/********************
+ * site record -> 24 doubles
+ ********************/
+void spinor_codec_site2double(double *v, char * const site, const int codec) {
+  int k;
+  unsigned char *r = (unsigned char*)site;
+  unsigned int u;
+  float s;
+  short q;
+  double f;
+
+  if(codec == _SPINOR_CODEC_HALF16) {
+    u = ((unsigned int)r[0] << 24) | ((unsigned int)r[1] << 16) | ((unsigned int)r[2] << 8) | r[3];
+    memcpy(&s, &u, 4);
+    f = (double)s / _HALF16_QMAX;
+    for(k=0; k<24; k++) {
+      q = (short)(((unsigned int)r[4+2*k] << 8) | r[4+2*k+1]);
+      v[k] = f * (double)q;
+    }
+  } else {
+    if(!big_endian()) byte_swap_assign_single2double(v, site, 24);
+    else              single2double(v, site, 24);
+  }
+}
@@ -0,0 +1,24 @@
+/********************
+ * spinor_codec.h
+ *
+ * encodings of one timeslice of a Dirac-fermion field for the
+ * compressed propagator records (propagator_io.c)
+ ********************/
+#ifndef _SPINOR_CODEC_H
+#define _SPINOR_CODEC_H
+
+#include <stddef.h>
+#include "dml.h"
+
+#define _SPINOR_CODEC_NONE      0
+#define _SPINOR_CODEC_HALF16    1  /* 16 bit per component, one scale per site */
+#define _SPINOR_CODEC_SHUFFLE32 2  /* 32 bit float, byte-shuffled and deflated (zlib) */
+
+size_t spinor_codec_site_bytes(const int codec);
+size_t spinor_codec_bound(const int codec, const unsigned int nsites);
+int spinor_codec_encode(char *chunk, size_t *chunk_bytes, double * const field, const unsigned int nsites,
+    const int codec, const DML_SiteRank rank0, DML_Checksum *ans);
+int spinor_codec_unpack(char *sites, char * const chunk, const size_t chunk_bytes, const unsigned int nsites, const int codec);
+void spinor_codec_site2double(double *v, char * const site, const int codec);
+
+#endif
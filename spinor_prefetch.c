@@ -0,0 +1,297 @@
+/********************
+ * spinor_prefetch.c
+ *
+ * prefetch queue for propagator reads
+ *
+ * - the queue is the list of (file name, record position) of all
+ *   fields in the order in which the program reads them, in sets of
+ *   nfield fields (e.g. the 12 spin-colour components of one propagator)
+ * - the I/O thread reads set j into buffer slot j % nbuf as soon as
+ *   set j - nbuf has been passed on completely, with
+ *   read_lime_spinor_local (propagator_io.c)
+ * - spinor_prefetch_read is a drop-in replacement for read_lime_spinor:
+ *   if (filename, position) is the next entry of the queue the field
+ *   is copied from the buffer (after combining the checksum), in all
+ *   other cases or if the prefetch failed it reads with read_lime_spinor
+ * - if the buffers or the I/O thread cannot be set up on some process,
+ *   init_spinor_prefetch disables the prefetch on all processes
+ * - fini_spinor_prefetch reports the time the I/O thread was busy,
+ *   the time the caller had to wait and the difference, i.e. the
+ *   I/O time hidden behind the contractions
+ ********************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#ifdef MPI
+#  include <mpi.h>
+#endif
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+#ifdef HAVE_PTHREAD
+#  include <pthread.h>
+#endif
+#include "global.h"
+#include "dml.h"
+#include "propagator_io.h"
+#include "spinor_prefetch.h"
+
+#ifdef HAVE_PTHREAD
+static double spinor_prefetch_time(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return((double)tv.tv_sec + 1.e-6 * (double)tv.tv_usec);
+}
+
+static void *spinor_prefetch_thread(void *arg) {
+  spinor_prefetch *p = (spinor_prefetch*)arg;
+  int iset, i, k, stop;
+  double ratime;
+
+#ifdef OPENMP
+  /* the site loops of the I/O thread do not compete with the contractions */
+  omp_set_num_threads(1);
+#endif
+
+  for(iset=0; iset<p->nset; iset++) {
+    pthread_mutex_lock(&p->lock);
+    while(iset - p->set_done >= p->nbuf && !p->stop) pthread_cond_wait(&p->cond, &p->lock);
+    stop = p->stop;
+    pthread_mutex_unlock(&p->lock);
+    if(stop) break;
+
+    ratime = spinor_prefetch_time();
+    for(i=0; i<p->nfield; i++) {
+      k = (iset % p->nbuf) * p->nfield + i;
+      p->status[k] = read_lime_spinor_local(p->field[k], p->filename[iset*p->nfield+i], p->position[iset*p->nfield+i],
+          p->checksum + k);
+    }
+
+    pthread_mutex_lock(&p->lock);
+    p->time_read += spinor_prefetch_time() - ratime;
+    p->set_read = iset + 1;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+  }
+  return(NULL);
+}
+#endif
+
+/********************
+ * filename[i + j*nfield], position[i + j*nfield] for field i of set j,
+ * j < nset; nbuf = number of sets held in the buffer (each nfield
+ * fields of VOLUME sites), 0 for no prefetch
+ ********************/
+int init_spinor_prefetch(spinor_prefetch *p, int nbuf, int nset, int nfield, char **filename, int *position) {
+  int i;
+#ifdef HAVE_PTHREAD
+  int status, status_max;
+#endif
+
+  p->nbuf      = 0;
+  p->nset      = nset;
+  p->nfield    = nfield;
+  p->set_read  = 0;
+  p->set_done  = 0;
+  p->next      = 0;
+  p->stop      = 0;
+  p->time_read = 0.;
+  p->time_wait = 0.;
+  p->field     = NULL;
+  p->checksum  = NULL;
+  p->status    = NULL;
+
+  p->filename = (char**)malloc(nset*nfield*sizeof(char*));
+  p->position = (int*)malloc(nset*nfield*sizeof(int));
+  if(p->filename == NULL || p->position == NULL) {
+    fprintf(stderr, "[init_spinor_prefetch] Error, could not allocate memory\n");
+    return(1);
+  }
+  for(i=0; i<nset*nfield; i++) {
+    p->filename[i] = strdup(filename[i]);
+    p->position[i] = position[i];
+  }
+
+#ifdef HAVE_PTHREAD
+#ifdef PARALLELTXYZ
+  if(g_cart_id == 0) fprintf(stdout, "# [init_spinor_prefetch] no prefetch with z-decomposition\n");
+  nbuf = 0;
+#endif
+  if(nbuf > nset) nbuf = nset;
+  if(nbuf <= 0 || nfield <= 0) return(0);
+
+  /* status 1 = no buffer, 2 = no I/O thread */
+  status = 0;
+  p->field    = (double**)calloc(nbuf*nfield, sizeof(double*));
+  p->checksum = (DML_Checksum*)malloc(nbuf*nfield*sizeof(DML_Checksum));
+  p->status   = (int*)malloc(nbuf*nfield*sizeof(int));
+  if(p->field == NULL || p->checksum == NULL || p->status == NULL) {
+    fprintf(stderr, "[init_spinor_prefetch] Warning, could not allocate memory\n");
+    status = 1;
+  }
+  for(i=0; i<nbuf*nfield && status == 0; i++) {
+    p->field[i] = (double*)malloc(24*VOLUME*sizeof(double));
+    if(p->field[i] == NULL) {
+      fprintf(stderr, "[init_spinor_prefetch] Warning, could not allocate buffer field %d\n", i);
+      status = 1;
+    }
+  }
+
+  p->nbuf = nbuf;
+  if(status == 0) {
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->cond, NULL);
+    if(pthread_create(&p->thread, NULL, spinor_prefetch_thread, (void*)p) != 0) {
+      fprintf(stderr, "[init_spinor_prefetch] Warning, could not start I/O thread\n");
+      pthread_mutex_destroy(&p->lock);
+      pthread_cond_destroy(&p->cond);
+      status = 2;
+    }
+  }
+
+  /* spinor_prefetch_read combines the checksums of the buffered fields,
+   * so either all processes prefetch or none does */
+#ifdef MPI
+  MPI_Allreduce(&status, &status_max, 1, MPI_INT, MPI_MAX, g_cart_grid);
+#else
+  status_max = status;
+#endif
+  if(status_max != 0) {
+    if(status == 0) {
+      pthread_mutex_lock(&p->lock);
+      p->stop = 1;
+      pthread_cond_broadcast(&p->cond);
+      pthread_mutex_unlock(&p->lock);
+      pthread_join(p->thread, NULL);
+      pthread_mutex_destroy(&p->lock);
+      pthread_cond_destroy(&p->cond);
+    }
+    if(p->field != NULL) {
+      for(i=0; i<nbuf*nfield; i++) free(p->field[i]);
+      free(p->field);
+    }
+    if(p->checksum != NULL) free(p->checksum);
+    if(p->status   != NULL) free(p->status);
+    p->field    = NULL;
+    p->checksum = NULL;
+    p->status   = NULL;
+    p->nbuf     = 0;
+    p->set_read = 0;
+    p->stop     = 0;
+    if(g_cart_id == 0) fprintf(stdout, "# [init_spinor_prefetch] prefetch disabled, reading with read_lime_spinor\n");
+    return(0);
+  }
+  if(g_cart_id == 0) fprintf(stdout, "# [init_spinor_prefetch] prefetching %d set(s) of %d fields, %d sets in total\n",
+      nbuf, nfield, nset);
+#else
+  if(g_cart_id == 0 && nbuf > 0) fprintf(stdout, "# [init_spinor_prefetch] built without HAVE_PTHREAD, no prefetch\n");
+#endif
+  return(0);
+}
+
+/********************
+ * s = field in filename at record position position
+ ********************/
+int spinor_prefetch_read(spinor_prefetch *p, double *s, char *filename, int position) {
+#ifdef HAVE_PTHREAD
+  int iset, k, status;
+  double ratime;
+  DML_Checksum checksum;
+
+  if(p->nbuf == 0 || p->next >= p->nset*p->nfield ||
+      position != p->position[p->next] || strcmp(filename, p->filename[p->next]) != 0) {
+    return(read_lime_spinor(s, filename, position));
+  }
+
+  iset = p->next / p->nfield;
+  k    = (iset % p->nbuf) * p->nfield + p->next % p->nfield;
+
+  ratime = spinor_prefetch_time();
+  pthread_mutex_lock(&p->lock);
+  while(p->set_read <= iset) pthread_cond_wait(&p->cond, &p->lock);
+  pthread_mutex_unlock(&p->lock);
+  p->time_wait += spinor_prefetch_time() - ratime;
+
+  status = p->status[k];
+#ifdef MPI
+  MPI_Allreduce(&p->status[k], &status, 1, MPI_INT, MPI_MIN, g_cart_grid);
+#endif
+  if(status == 0) {
+    memcpy(s, p->field[k], 24*VOLUME*sizeof(double));
+    checksum = p->checksum[k];
+#ifdef MPI
+    DML_checksum_combine(&checksum);
+#endif
+    if(g_cart_id == 0) fprintf(stdout, "# [spinor_prefetch_read] checksum for DiracFermion field in file %s position %d is %#x %#x\n",
+        filename, position, checksum.suma, checksum.sumb);
+  }
+
+  p->next++;
+  if(p->next % p->nfield == 0) {
+    pthread_mutex_lock(&p->lock);
+    p->set_done++;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+  }
+
+  if(status != 0) {
+    if(g_cart_id == 0) fprintf(stderr, "[spinor_prefetch_read] Warning, prefetch of %s failed, reading again\n", filename);
+    status = read_lime_spinor(s, filename, position);
+  }
+  return(status);
+#else
+  return(read_lime_spinor(s, filename, position));
+#endif
+}
+
+/********************
+ * stop the I/O thread, print the overlap statistics
+ * (maximum over all processes), free the buffers
+ ********************/
+void fini_spinor_prefetch(spinor_prefetch *p) {
+  int i;
+
+#ifdef HAVE_PTHREAD
+  if(p->nbuf > 0) {
+    double t[2], tmax[2];
+    pthread_mutex_lock(&p->lock);
+    p->stop = 1;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+    pthread_join(p->thread, NULL);
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->cond);
+
+    t[0] = p->time_read;
+    t[1] = p->time_wait;
+#ifdef MPI
+    MPI_Reduce(t, tmax, 2, MPI_DOUBLE, MPI_MAX, 0, g_cart_grid);
+#else
+    tmax[0] = t[0]; tmax[1] = t[1];
+#endif
+    if(g_cart_id == 0) {
+      fprintf(stdout, "# [fini_spinor_prefetch] %d of %d sets of %d fields read ahead, %d buffer set(s)\n",
+          p->set_read, p->nset, p->nfield, p->nbuf);
+      fprintf(stdout, "# [fini_spinor_prefetch] I/O thread busy %12.4e s, waiting for I/O %12.4e s, hidden I/O %12.4e s (%5.1f%%)\n",
+          tmax[0], tmax[1], tmax[0] > tmax[1] ? tmax[0] - tmax[1] : 0.,
+          tmax[0] > tmax[1] ? 100. * (tmax[0] - tmax[1]) / tmax[0] : 0.);
+    }
+  }
+#endif
+
+  if(p->field != NULL) {
+    for(i=0; i<p->nbuf*p->nfield; i++) free(p->field[i]);
+    free(p->field);
+  }
+  if(p->checksum != NULL) free(p->checksum);
+  if(p->status   != NULL) free(p->status);
+  if(p->filename != NULL) {
+    for(i=0; i<p->nset*p->nfield; i++) free(p->filename[i]);
+    free(p->filename);
+  }
+  if(p->position != NULL) free(p->position);
+  p->field = NULL; p->checksum = NULL; p->status = NULL;
+  p->filename = NULL; p->position = NULL;
+  p->nbuf = 0; p->nset = 0;
+}
@@ -0,0 +1,45 @@
+/********************
+ * spinor_prefetch.h
+ *
+ * background prefetch of propagator sets: a dedicated I/O thread
+ * reads the next set(s) of spinor fields from LIME files while the
+ * current set is contracted
+ * - needs HAVE_PTHREAD, otherwise spinor_prefetch_read is a plain
+ *   read_lime_spinor
+ * - the I/O thread makes no MPI calls; checksum combination and
+ *   halo exchange stay with the calling (MPI) thread
+ ********************/
+#ifndef _SPINOR_PREFETCH_H
+#define _SPINOR_PREFETCH_H
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#include "dml.h"
+
+typedef struct {
+  int nbuf;               /* number of sets held in the buffer, 0 = no prefetch */
+  int nset, nfield;       /* sets in the queue, fields per set */
+  char **filename;        /* file name and record position */
+  int *position;          /*   of field i of set j at i + j*nfield */
+  double **field;         /* nbuf*nfield buffer fields, VOLUME sites each */
+  DML_Checksum *checksum; /* local checksum and read status */
+  int *status;            /*   per buffer field */
+  int set_read;           /* number of sets read by the I/O thread */
+  int set_done;           /* number of sets passed on completely */
+  int next;               /* next field in the queue */
+  int stop;
+  double time_read;       /* I/O thread busy */
+  double time_wait;       /* caller blocked */
+#ifdef HAVE_PTHREAD
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+#endif
+} spinor_prefetch;
+
+int init_spinor_prefetch(spinor_prefetch *p, int nbuf, int nset, int nfield, char **filename, int *position);
+int spinor_prefetch_read(spinor_prefetch *p, double *s, char *filename, int position);
+void fini_spinor_prefetch(spinor_prefetch *p);
+
+#endif